@@ -0,0 +1,205 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/algorithms/common/mont_batch.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "yacl/base/exception.h"
+#include "yacl/utils/parallel.h"
+
+namespace heu::algos {
+
+namespace {
+
+// 2^12 buckets of n^2-sized BigInts per worker is still cache friendly
+constexpr size_t kMaxWindowBits = 12;
+// Bases are processed in blocks to bound the memory of digits
+constexpr int64_t kBlockSize = 4096;
+
+// acc = acc * x, where an empty acc stands for the identity
+void MulInto(const MontgomerySpace &m_space, std::optional<BigInt> *acc,
+             const BigInt &x) {
+  if (acc->has_value()) {
+    **acc = m_space.MulMod(**acc, x);
+  } else {
+    *acc = x;
+  }
+}
+
+void MulInto(const MontgomerySpace &m_space, std::optional<BigInt> *acc,
+             const std::optional<BigInt> &x) {
+  if (x.has_value()) {
+    MulInto(m_space, acc, *x);
+  }
+}
+
+// The window size c that minimizes the number of MulMod in BucketPowMod, i.e.
+// ceil(max_bits / c) * (num_bases + 2 * 2^c)
+size_t ChooseWindowBits(size_t num_bases, size_t max_bits) {
+  size_t best = 1;
+  size_t best_cost = std::numeric_limits<size_t>::max();
+  for (size_t c = 1; c <= kMaxWindowBits; ++c) {
+    size_t cost = (max_bits + c - 1) / c * (num_bases + (size_t{2} << c));
+    if (cost < best_cost) {
+      best = c;
+      best_cost = cost;
+    }
+  }
+  return best;
+}
+
+// prod(*bases[i] ^ *exps[i]) for non-negative exponents. Returns nullopt if
+// the result is the identity.
+std::optional<BigInt> BucketPowMod(const MontgomerySpace &m_space,
+                                   const std::vector<const BigInt *> &bases,
+                                   const std::vector<const BigInt *> &exps) {
+  size_t max_bits = 0;
+  for (const auto *e : exps) {
+    max_bits = std::max(max_bits, e->BitCount());
+  }
+  if (max_bits == 0) {
+    return std::nullopt;
+  }
+
+  size_t c = ChooseWindowBits(bases.size(), max_bits);
+  size_t num_windows = (max_bits + c - 1) / c;
+  // digits[i * num_windows + w] is the w-th c-bit digit of *exps[i]
+  std::vector<uint16_t> digits(bases.size() * num_windows);
+  for (size_t i = 0; i < exps.size(); ++i) {
+    size_t bits = exps[i]->BitCount();
+    for (size_t b = 0; b < bits; ++b) {
+      if (exps[i]->GetBit(b)) {
+        digits[i * num_windows + b / c] |= 1U << (b % c);
+      }
+    }
+  }
+
+  std::optional<BigInt> res;
+  std::vector<std::optional<BigInt>> buckets(size_t{1} << c);
+  for (size_t w = num_windows; w-- > 0;) {
+    if (res.has_value()) {
+      for (size_t s = 0; s < c; ++s) {
+        *res = m_space.MulMod(*res, *res);
+      }
+    }
+
+    for (auto &bucket : buckets) {
+      bucket.reset();
+    }
+    for (size_t i = 0; i < bases.size(); ++i) {
+      auto d = digits[i * num_windows + w];
+      if (d != 0) {
+        MulInto(m_space, &buckets[d], *bases[i]);
+      }
+    }
+
+    // prod(buckets[d] ^ d) == prod_d (prod_{d' >= d} buckets[d'])
+    std::optional<BigInt> running;
+    for (size_t d = buckets.size() - 1; d > 0; --d) {
+      MulInto(m_space, &running, buckets[d]);
+      MulInto(m_space, &res, running);
+    }
+  }
+  return res;
+}
+
+}  // namespace
+
+void BatchInvMod(const MontgomerySpace &m_space, const BigInt &modulus,
+                 absl::Span<BigInt *const> xs) {
+  yacl::parallel_for(0, xs.size(), [&](int64_t beg, int64_t end) {
+    // prefix[i] = xs[beg] * ... * xs[beg + i]
+    std::vector<BigInt> prefix(end - beg);
+    prefix[0] = *xs[beg];
+    for (int64_t i = 1; i < end - beg; ++i) {
+      prefix[i] = m_space.MulMod(prefix[i - 1], *xs[beg + i]);
+    }
+
+    BigInt inv = prefix.back();
+    m_space.MapBackToZSpace(inv);
+    inv = inv.InvMod(modulus);
+    m_space.MapIntoMSpace(inv);
+
+    // now inv = (xs[beg] * ... * xs[beg + i])^{-1}
+    for (int64_t i = end - beg - 1; i > 0; --i) {
+      BigInt xi_inv = m_space.MulMod(inv, prefix[i - 1]);
+      inv = m_space.MulMod(inv, *xs[beg + i]);
+      *xs[beg + i] = std::move(xi_inv);
+    }
+    *xs[beg] = std::move(inv);
+  });
+}
+
+BigInt MultiPowMod(const MontgomerySpace &m_space, const BigInt &modulus,
+                   absl::Span<const BigInt *const> bases,
+                   absl::Span<const BigInt> exps) {
+  YACL_ENFORCE_EQ(bases.size(), exps.size(),
+                  "bases and exponents must have the same length");
+
+  std::mutex mutex;
+  std::optional<BigInt> pos_prod;
+  std::optional<BigInt> neg_prod;  // the part to be inverted
+  yacl::parallel_for(0, bases.size(), [&](int64_t beg, int64_t end) {
+    std::optional<BigInt> local_pos;
+    std::optional<BigInt> local_neg;
+    for (int64_t blk_beg = beg; blk_beg < end; blk_beg += kBlockSize) {
+      int64_t blk_end = std::min(end, blk_beg + kBlockSize);
+
+      std::vector<const BigInt *> pos_bases;
+      std::vector<const BigInt *> pos_exps;
+      std::vector<const BigInt *> neg_bases;
+      std::vector<const BigInt *> neg_exps;
+      std::vector<BigInt> abs_exps;
+      abs_exps.reserve(blk_end - blk_beg);  // keeps the pointers valid
+      for (int64_t i = blk_beg; i < blk_end; ++i) {
+        if (exps[i].IsZero()) {
+          continue;
+        }
+        if (exps[i].IsNegative()) {
+          abs_exps.push_back(exps[i].Abs());
+          neg_bases.push_back(bases[i]);
+          neg_exps.push_back(&abs_exps.back());
+        } else {
+          pos_bases.push_back(bases[i]);
+          pos_exps.push_back(&exps[i]);
+        }
+      }
+
+      MulInto(m_space, &local_pos, BucketPowMod(m_space, pos_bases, pos_exps));
+      MulInto(m_space, &local_neg, BucketPowMod(m_space, neg_bases, neg_exps));
+    }
+
+    std::lock_guard<std::mutex> guard(mutex);
+    MulInto(m_space, &pos_prod, local_pos);
+    MulInto(m_space, &neg_prod, local_neg);
+  });
+
+  BigInt res = pos_prod.has_value() ? *pos_prod : BigInt(m_space.Identity());
+  if (neg_prod.has_value()) {
+    BigInt inv = *neg_prod;
+    m_space.MapBackToZSpace(inv);
+    inv = inv.InvMod(modulus);
+    m_space.MapIntoMSpace(inv);
+    res = m_space.MulMod(res, inv);
+  }
+  return res;
+}
+
+}  // namespace heu::algos
@@ -0,0 +1,40 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "absl/types/span.h"
+
+#include "heu/algorithms/common/type_alias.h"
+
+// Batch kernels that share one MontgomerySpace across a whole vector of
+// elements. All BigInts passed in or returned are in the Montgomery form of
+// 'm_space', whose modulus is 'modulus'.
+
+namespace heu::algos {
+
+// Inverts each *xs[i] in place with Montgomery's trick: every worker inverts
+// the product of its chunk once and then recovers the single inverses with 3
+// modular multiplications per element.
+void BatchInvMod(const MontgomerySpace &m_space, const BigInt &modulus,
+                 absl::Span<BigInt *const> xs);
+
+// Returns prod(*bases[i] ^ exps[i]) with Pippenger's bucket method, so the
+// squarings are shared by all bases instead of being repeated per base.
+// Negative exponents are allowed, their bases share one modular inversion.
+BigInt MultiPowMod(const MontgomerySpace &m_space, const BigInt &modulus,
+                   absl::Span<const BigInt *const> bases,
+                   absl::Span<const BigInt> exps);
+
+}  // namespace heu::algos
@@ -0,0 +1,108 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/algorithms/common/mont_batch.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace heu::algos::test {
+
+class MontBatchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    modulus_ = BigInt::RandPrimeOver(512) * BigInt::RandPrimeOver(512);
+    m_space_ = BigInt::CreateMontgomerySpace(modulus_);
+  }
+
+  BigInt ToMSpace(BigInt x) const {
+    m_space_->MapIntoMSpace(x);
+    return x;
+  }
+
+  BigInt ToZSpace(BigInt x) const {
+    m_space_->MapBackToZSpace(x);
+    return x;
+  }
+
+  // Check MultiPowMod against one PowMod per base
+  void CheckMultiPowMod(const std::vector<BigInt> &exps) {
+    std::vector<BigInt> bases(exps.size());
+    std::vector<BigInt> m_bases(exps.size());
+    std::vector<const BigInt *> ptrs(exps.size());
+    BigInt expected(1);
+    for (size_t i = 0; i < exps.size(); ++i) {
+      bases[i] = BigInt::RandomLtN(modulus_);
+      m_bases[i] = ToMSpace(bases[i]);
+      ptrs[i] = &m_bases[i];
+
+      BigInt base =
+          exps[i].IsNegative() ? bases[i].InvMod(modulus_) : bases[i];
+      expected =
+          expected.MulMod(base.PowMod(exps[i].Abs(), modulus_), modulus_);
+    }
+
+    auto res = MultiPowMod(*m_space_, modulus_, ptrs, exps);
+    EXPECT_EQ(ToZSpace(res), expected);
+  }
+
+  BigInt modulus_;
+  std::shared_ptr<MontgomerySpace> m_space_;
+};
+
+TEST_F(MontBatchTest, BatchInvMod) {
+  for (size_t n : {1, 2, 7, 100}) {
+    std::vector<BigInt> xs(n);
+    std::vector<BigInt> m_xs(n);
+    std::vector<BigInt *> ptrs(n);
+    for (size_t i = 0; i < n; ++i) {
+      xs[i] = BigInt::RandomLtN(modulus_);
+      m_xs[i] = ToMSpace(xs[i]);
+      ptrs[i] = &m_xs[i];
+    }
+
+    BatchInvMod(*m_space_, modulus_, ptrs);
+    for (size_t i = 0; i < n; ++i) {
+      EXPECT_EQ(ToZSpace(m_xs[i]), xs[i].InvMod(modulus_)) << "i=" << i;
+    }
+  }
+
+  // nothing to do
+  BatchInvMod(*m_space_, modulus_, {});
+}
+
+TEST_F(MontBatchTest, MultiPowMod) {
+  // empty or all zero exponents
+  CheckMultiPowMod({});
+  CheckMultiPowMod({BigInt(0), BigInt(0)});
+
+  CheckMultiPowMod({BigInt(1)});
+  CheckMultiPowMod({BigInt(-1)});
+  CheckMultiPowMod({BigInt(0), BigInt(1), BigInt(-1), BigInt(123),
+                    BigInt(-456), BigInt::RandomExactBits(1000),
+                    -BigInt::RandomExactBits(300)});
+
+  // more bases than a block
+  std::vector<BigInt> exps(5000);
+  for (size_t i = 0; i < exps.size(); ++i) {
+    exps[i] = BigInt::RandomExactBits(1 + i % 64);
+    if (i % 3 == 0) {
+      exps[i] = -exps[i];
+    }
+  }
+  CheckMultiPowMod(exps);
+}
+
+}  // namespace heu::algos::test
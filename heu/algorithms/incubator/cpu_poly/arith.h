@@ -0,0 +1,160 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define HEU_CPU_POLY_AVX2 1
+#define HEU_CPU_POLY_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+// Modular arithmetic shared by the kernels of cpu_poly. All moduli are below
+// 2^62, so that lazy values in [0, 4q) fit in 64 bits.
+namespace heu::algos::cpu_poly {
+
+// Whether the AVX2 kernels are used on this CPU
+inline bool UseAVX2() {
+#ifdef HEU_CPU_POLY_AVX2
+  static const bool kHasAVX2 = __builtin_cpu_supports("avx2");
+  return kHasAVX2;
+#else
+  return false;
+#endif
+}
+
+namespace internal {
+
+using u128 = unsigned __int128;
+
+inline uint64_t MulHi(uint64_t a, uint64_t b) {
+  return static_cast<uint64_t>((static_cast<u128>(a) * b) >> 64);
+}
+
+// floor(w * 2^64 / q), w < q
+inline uint64_t ShoupQuotient(uint64_t w, uint64_t q) {
+  return static_cast<uint64_t>((static_cast<u128>(w) << 64) / q);
+}
+
+// x * w mod q in [0, 2q) for any 64-bit x
+inline uint64_t MulShoupLazy(uint64_t x, uint64_t w, uint64_t w_shoup,
+                             uint64_t q) {
+  return x * w - MulHi(x, w_shoup) * q;
+}
+
+inline uint64_t SubIfGE(uint64_t x, uint64_t bound) {
+  return x >= bound ? x - bound : x;
+}
+
+// Barrett constants of a modulus 2 <= q < 2^62
+struct ModulusConsts {
+  uint64_t q;
+  uint64_t ratio64;   // floor((2^64 - 1) / q)
+  uint64_t ratio_lo;  // floor((2^128 - 1) / q), low and high words
+  uint64_t ratio_hi;
+};
+
+inline ModulusConsts MakeModulusConsts(uint64_t q) {
+  auto ratio = static_cast<u128>(-1) / q;
+  return {q, static_cast<uint64_t>(-1) / q, static_cast<uint64_t>(ratio),
+          static_cast<uint64_t>(ratio >> 64)};
+}
+
+// x mod q for any 64-bit x
+inline uint64_t BarrettReduce64(uint64_t x, const ModulusConsts &c) {
+  return SubIfGE(x - MulHi(x, c.ratio64) * c.q, c.q);
+}
+
+// x mod q for any 128-bit x. The estimate floor(x * ratio / 2^128) is exact
+// and at most 1 less than floor(x / q).
+inline uint64_t BarrettReduce128(u128 x, const ModulusConsts &c) {
+  auto x0 = static_cast<uint64_t>(x);
+  auto x1 = static_cast<uint64_t>(x >> 64);
+  u128 t = static_cast<u128>(x0) * c.ratio_hi + MulHi(x0, c.ratio_lo);
+  u128 s = static_cast<u128>(x1) * c.ratio_lo + static_cast<uint64_t>(t);
+  uint64_t est = x1 * c.ratio_hi + static_cast<uint64_t>(t >> 64) +
+                 static_cast<uint64_t>(s >> 64);
+  return SubIfGE(x0 - est * c.q, c.q);
+}
+
+#ifdef HEU_CPU_POLY_AVX2
+
+namespace avx2 {
+
+// AVX2 has no 64 x 64 bit multiplication, the products are assembled from
+// 32 x 32 -> 64 bit _mm256_mul_epu32 of the halves.
+
+HEU_CPU_POLY_AVX2_TARGET inline __m256i MulLo64(__m256i a, __m256i b) {
+  __m256i cross = _mm256_add_epi64(
+      _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)),
+      _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b));
+  return _mm256_add_epi64(_mm256_mul_epu32(a, b),
+                          _mm256_slli_epi64(cross, 32));
+}
+
+HEU_CPU_POLY_AVX2_TARGET inline __m256i MulHi64(__m256i a, __m256i b) {
+  const __m256i lo32 = _mm256_set1_epi64x(0xffffffff);
+  __m256i ah = _mm256_srli_epi64(a, 32);
+  __m256i bh = _mm256_srli_epi64(b, 32);
+  __m256i ll = _mm256_mul_epu32(a, b);
+  __m256i lh = _mm256_mul_epu32(a, bh);
+  __m256i hl = _mm256_mul_epu32(ah, b);
+  __m256i hh = _mm256_mul_epu32(ah, bh);
+
+  __m256i mid = _mm256_add_epi64(_mm256_srli_epi64(ll, 32),
+                                 _mm256_and_si256(lh, lo32));
+  mid = _mm256_add_epi64(mid, _mm256_and_si256(hl, lo32));
+  __m256i hi = _mm256_add_epi64(hh, _mm256_srli_epi64(lh, 32));
+  hi = _mm256_add_epi64(hi, _mm256_srli_epi64(hl, 32));
+  return _mm256_add_epi64(hi, _mm256_srli_epi64(mid, 32));
+}
+
+// x >= bound ? x - bound : x, for unsigned 64-bit lanes
+HEU_CPU_POLY_AVX2_TARGET inline __m256i SubIfGE(__m256i x, __m256i bound) {
+  const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+  __m256i lt = _mm256_cmpgt_epi64(_mm256_xor_si256(bound, sign),
+                                  _mm256_xor_si256(x, sign));
+  return _mm256_sub_epi64(x, _mm256_andnot_si256(lt, bound));
+}
+
+// Lazy Shoup products of 4 lanes in [0, 2q), for any 64-bit x
+struct ShoupMul64 {
+  __m256i w, w_shoup, q;
+
+  HEU_CPU_POLY_AVX2_TARGET inline __m256i operator()(__m256i x) const {
+    return _mm256_sub_epi64(MulLo64(x, w), MulLo64(MulHi64(x, w_shoup), q));
+  }
+};
+
+// The same for q < 2^30, where x < 4q < 2^32 and the 32-bit quotient
+// floor(w * 2^32 / q) is precise enough, so each product is a single
+// _mm256_mul_epu32.
+struct ShoupMul32 {
+  __m256i w, w_shoup, q;
+
+  HEU_CPU_POLY_AVX2_TARGET inline __m256i operator()(__m256i x) const {
+    __m256i est = _mm256_srli_epi64(_mm256_mul_epu32(x, w_shoup), 32);
+    return _mm256_sub_epi64(_mm256_mul_epu32(x, w), _mm256_mul_epu32(est, q));
+  }
+};
+
+}  // namespace avx2
+
+#endif  // HEU_CPU_POLY_AVX2
+
+}  // namespace internal
+
+}  // namespace heu::algos::cpu_poly
@@ -0,0 +1,370 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/algorithms/incubator/cpu_poly/ntt.h"
+
+#include <algorithm>
+
+#include "yacl/base/exception.h"
+#include "yacl/utils/parallel.h"
+
+#include "heu/algorithms/incubator/cpu_poly/arith.h"
+#include "heu/spi/utils/math_tool.h"
+
+namespace heu::algos::cpu_poly {
+
+namespace {
+
+using namespace internal;
+
+inline uint64_t MulMod(uint64_t a, uint64_t b, uint64_t q) {
+  return static_cast<uint64_t>(static_cast<u128>(a) * b % q);
+}
+
+uint64_t PowMod(uint64_t base, uint64_t exp, uint64_t q) {
+  uint64_t res = 1;
+  for (; exp > 0; exp >>= 1) {
+    if (exp & 1) {
+      res = MulMod(res, base, q);
+    }
+    base = MulMod(base, base, q);
+  }
+  return res;
+}
+
+// Deterministic Miller-Rabin, the bases are enough for all 64-bit integers
+bool IsPrime(uint64_t q) {
+  constexpr uint64_t kBases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+  if (q < 2) {
+    return false;
+  }
+  for (uint64_t p : kBases) {
+    if (q % p == 0) {
+      return q == p;
+    }
+  }
+  uint64_t d = q - 1;
+  int s = 0;
+  for (; (d & 1) == 0; d >>= 1) {
+    ++s;
+  }
+  for (uint64_t a : kBases) {
+    uint64_t x = PowMod(a, d, q);
+    if (x == 1 || x == q - 1) {
+      continue;
+    }
+    bool composite = true;
+    for (int r = 1; r < s && composite; ++r) {
+      x = MulMod(x, x, q);
+      composite = x != q - 1;
+    }
+    if (composite) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The minimal primitive 2N-th root of unity mod q
+uint64_t MinimalPrimitiveRoot(uint64_t two_n, uint64_t q) {
+  uint64_t psi = 0;
+  for (uint64_t g = 2; g < q && psi == 0; ++g) {
+    uint64_t cand = PowMod(g, (q - 1) / two_n, q);
+    // the order divides 2N, and it is exactly 2N iff cand^N = -1
+    if (PowMod(cand, two_n / 2, q) == q - 1) {
+      psi = cand;
+    }
+  }
+  YACL_ENFORCE(psi != 0, "no primitive {}-th root of unity mod {}", two_n, q);
+
+  // the primitive roots are the odd powers of psi
+  uint64_t psi_sqr = MulMod(psi, psi, q);
+  uint64_t cur = psi;
+  uint64_t res = psi;
+  for (uint64_t i = 0; i < two_n / 2; ++i) {
+    res = std::min(res, cur);
+    cur = MulMod(cur, psi_sqr, q);
+  }
+  return res;
+}
+
+uint32_t ReverseBits(uint32_t x, uint32_t bits) {
+  uint32_t res = 0;
+  for (uint32_t i = 0; i < bits; ++i, x >>= 1) {
+    res = (res << 1) | (x & 1);
+  }
+  return res;
+}
+
+// One level of the Cooley-Tukey butterflies: m groups of distance t. Inputs
+// and outputs are in [0, 4q).
+void ForwardLevelScalar(uint64_t *x, size_t m, size_t t, const uint64_t *w,
+                        const uint64_t *w_shoup, uint64_t q) {
+  const uint64_t two_q = 2 * q;
+  for (size_t i = 0; i < m; ++i) {
+    uint64_t *xa = x + 2 * i * t;
+    uint64_t *xb = xa + t;
+    const uint64_t wi = w[m + i];
+    const uint64_t wi_shoup = w_shoup[m + i];
+    for (size_t j = 0; j < t; ++j) {
+      uint64_t u = SubIfGE(xa[j], two_q);
+      uint64_t v = MulShoupLazy(xb[j], wi, wi_shoup, q);
+      xa[j] = u + v;
+      xb[j] = u - v + two_q;
+    }
+  }
+}
+
+// One level of the Gentleman-Sande butterflies. Inputs and outputs are in
+// [0, 2q).
+void InverseLevelScalar(uint64_t *x, size_t m, size_t t, const uint64_t *w,
+                        const uint64_t *w_shoup, uint64_t q) {
+  const uint64_t two_q = 2 * q;
+  for (size_t i = 0; i < m; ++i) {
+    uint64_t *xa = x + 2 * i * t;
+    uint64_t *xb = xa + t;
+    const uint64_t wi = w[m + i];
+    const uint64_t wi_shoup = w_shoup[m + i];
+    for (size_t j = 0; j < t; ++j) {
+      uint64_t u = xa[j];
+      uint64_t v = xb[j];
+      xa[j] = SubIfGE(u + v, two_q);
+      xb[j] = MulShoupLazy(u - v + two_q, wi, wi_shoup, q);
+    }
+  }
+}
+
+#ifdef HEU_CPU_POLY_AVX2
+
+// The levels with t >= 4, where the 4 lanes share the twiddle
+template <typename ShoupMul>
+HEU_CPU_POLY_AVX2_TARGET void ForwardLevelAVX2(uint64_t *x, size_t m, size_t t,
+                                               const uint64_t *w,
+                                               const uint64_t *w_shoup,
+                                               uint64_t q) {
+  const __m256i two_q = _mm256_set1_epi64x(2 * q);
+  ShoupMul mul;
+  mul.q = _mm256_set1_epi64x(q);
+  for (size_t i = 0; i < m; ++i) {
+    auto *xa = reinterpret_cast<__m256i *>(x + 2 * i * t);
+    auto *xb = reinterpret_cast<__m256i *>(x + 2 * i * t + t);
+    mul.w = _mm256_set1_epi64x(w[m + i]);
+    mul.w_shoup = _mm256_set1_epi64x(w_shoup[m + i]);
+    for (size_t j = 0; j < t / 4; ++j) {
+      __m256i u = avx2::SubIfGE(_mm256_loadu_si256(xa + j), two_q);
+      __m256i v = mul(_mm256_loadu_si256(xb + j));
+      _mm256_storeu_si256(xa + j, _mm256_add_epi64(u, v));
+      _mm256_storeu_si256(xb + j,
+                          _mm256_add_epi64(_mm256_sub_epi64(u, v), two_q));
+    }
+  }
+}
+
+template <typename ShoupMul>
+HEU_CPU_POLY_AVX2_TARGET void InverseLevelAVX2(uint64_t *x, size_t m, size_t t,
+                                               const uint64_t *w,
+                                               const uint64_t *w_shoup,
+                                               uint64_t q) {
+  const __m256i two_q = _mm256_set1_epi64x(2 * q);
+  ShoupMul mul;
+  mul.q = _mm256_set1_epi64x(q);
+  for (size_t i = 0; i < m; ++i) {
+    auto *xa = reinterpret_cast<__m256i *>(x + 2 * i * t);
+    auto *xb = reinterpret_cast<__m256i *>(x + 2 * i * t + t);
+    mul.w = _mm256_set1_epi64x(w[m + i]);
+    mul.w_shoup = _mm256_set1_epi64x(w_shoup[m + i]);
+    for (size_t j = 0; j < t / 4; ++j) {
+      __m256i u = _mm256_loadu_si256(xa + j);
+      __m256i v = _mm256_loadu_si256(xb + j);
+      _mm256_storeu_si256(xa + j, avx2::SubIfGE(_mm256_add_epi64(u, v), two_q));
+      _mm256_storeu_si256(
+          xb + j, mul(_mm256_add_epi64(_mm256_sub_epi64(u, v), two_q)));
+    }
+  }
+}
+
+#endif  // HEU_CPU_POLY_AVX2
+
+}  // namespace
+
+NttTables::NttTables(size_t poly_degree, uint64_t modulus)
+    : n_(poly_degree), q_(modulus) {
+  YACL_ENFORCE(n_ >= 2 && spi::utils::IsPowerOf2(n_),
+               "poly degree {} must be a power of two", n_);
+  YACL_ENFORCE(q_ < (1ULL << 62), "modulus {} is too large", q_);
+  YACL_ENFORCE(IsPrime(q_) && (q_ - 1) % (2 * n_) == 0,
+               "modulus {} must be a prime = 1 mod {}", q_, 2 * n_);
+  log_n_ = 0;
+  while ((size_t{1} << log_n_) < n_) {
+    ++log_n_;
+  }
+
+  uint64_t psi = MinimalPrimitiveRoot(2 * n_, q_);
+  uint64_t inv_psi = PowMod(psi, q_ - 2, q_);
+  roots_.resize(n_);
+  inv_roots_.resize(n_);
+  uint64_t power = 1;
+  uint64_t inv_power = 1;
+  for (size_t i = 0; i < n_; ++i) {
+    uint32_t idx = ReverseBits(static_cast<uint32_t>(i), log_n_);
+    roots_[idx] = power;
+    inv_roots_[idx] = inv_power;
+    power = MulMod(power, psi, q_);
+    inv_power = MulMod(inv_power, inv_psi, q_);
+  }
+
+  roots_shoup_.resize(n_);
+  inv_roots_shoup_.resize(n_);
+  for (size_t i = 0; i < n_; ++i) {
+    roots_shoup_[i] = ShoupQuotient(roots_[i], q_);
+    inv_roots_shoup_[i] = ShoupQuotient(inv_roots_[i], q_);
+  }
+  inv_n_ = PowMod(n_ % q_, q_ - 2, q_);
+  inv_n_shoup_ = ShoupQuotient(inv_n_, q_);
+
+  if (q_ < (1ULL << 30)) {
+    roots_shoup32_.resize(n_);
+    inv_roots_shoup32_.resize(n_);
+    for (size_t i = 0; i < n_; ++i) {
+      roots_shoup32_[i] = (roots_[i] << 32) / q_;
+      inv_roots_shoup32_[i] = (inv_roots_[i] << 32) / q_;
+    }
+  }
+}
+
+void NttTables::Forward(uint64_t *coeffs) const {
+  size_t t = n_;
+  for (size_t m = 1; m < n_; m <<= 1) {
+    t >>= 1;
+#ifdef HEU_CPU_POLY_AVX2
+    if (t >= 4 && UseAVX2()) {
+      if (roots_shoup32_.empty()) {
+        ForwardLevelAVX2<avx2::ShoupMul64>(coeffs, m, t, roots_.data(),
+                                           roots_shoup_.data(), q_);
+      } else {
+        ForwardLevelAVX2<avx2::ShoupMul32>(coeffs, m, t, roots_.data(),
+                                           roots_shoup32_.data(), q_);
+      }
+      continue;
+    }
+#endif
+    ForwardLevelScalar(coeffs, m, t, roots_.data(), roots_shoup_.data(), q_);
+  }
+
+  // [0, 4q) -> [0, q)
+  const uint64_t two_q = 2 * q_;
+  for (size_t i = 0; i < n_; ++i) {
+    coeffs[i] = SubIfGE(SubIfGE(coeffs[i], two_q), q_);
+  }
+}
+
+void NttTables::Inverse(uint64_t *values) const {
+  size_t t = 1;
+  for (size_t m = n_ >> 1; m >= 1; m >>= 1) {
+#ifdef HEU_CPU_POLY_AVX2
+    if (t >= 4 && UseAVX2()) {
+      if (inv_roots_shoup32_.empty()) {
+        InverseLevelAVX2<avx2::ShoupMul64>(values, m, t, inv_roots_.data(),
+                                           inv_roots_shoup_.data(), q_);
+      } else {
+        InverseLevelAVX2<avx2::ShoupMul32>(values, m, t, inv_roots_.data(),
+                                           inv_roots_shoup32_.data(), q_);
+      }
+      t <<= 1;
+      continue;
+    }
+#endif
+    InverseLevelScalar(values, m, t, inv_roots_.data(),
+                       inv_roots_shoup_.data(), q_);
+    t <<= 1;
+  }
+
+  // [0, 2q) -> N^-1 * x in [0, q)
+  for (size_t i = 0; i < n_; ++i) {
+    values[i] = SubIfGE(MulShoupLazy(values[i], inv_n_, inv_n_shoup_, q_), q_);
+  }
+}
+
+spi::Moduli GenerateNttPrimes(size_t poly_degree, uint32_t bit_size,
+                              size_t count) {
+  YACL_ENFORCE(spi::utils::IsPowerOf2(poly_degree),
+               "poly degree {} must be a power of two", poly_degree);
+  YACL_ENFORCE(bit_size >= 2 && bit_size <= 62, "invalid bit size {}",
+               bit_size);
+  uint64_t step = 2 * poly_degree;
+  uint64_t upper = 1ULL << bit_size;
+  YACL_ENFORCE(upper > step, "bit size {} is too small for poly degree {}",
+               bit_size, poly_degree);
+
+  spi::Moduli res;
+  // the largest q = 1 mod 2N below 2^bit_size
+  for (uint64_t q = upper - step + 1; q > step && res.size() < count;
+       q -= step) {
+    if (IsPrime(q)) {
+      res.push_back(q);
+    }
+  }
+  YACL_ENFORCE(res.size() == count, "not enough {}-bit primes for degree {}",
+               bit_size, poly_degree);
+  return res;
+}
+
+CpuNttOperator::CpuNttOperator(size_t poly_degree, const spi::Moduli &moduli)
+    : poly_degree_(poly_degree), moduli_(moduli) {
+  YACL_ENFORCE(!moduli_.empty(), "empty moduli");
+  tables_.reserve(moduli_.size());
+  for (uint64_t q : moduli_) {
+    tables_.emplace_back(poly_degree_, q);
+  }
+}
+
+void CpuNttOperator::CheckShape(const spi::Polys &polys) const {
+  YACL_ENFORCE(polys.PolyDegree() == poly_degree_,
+               "poly degree mismatch, expect {}, got {}", poly_degree_,
+               polys.PolyDegree());
+}
+
+spi::Polys CpuNttOperator::Forward(const spi::Polys &polys_in) const {
+  spi::Polys res = polys_in;
+  ForwardInplace(&res);
+  return res;
+}
+
+void CpuNttOperator::ForwardInplace(spi::Polys *polys) const {
+  CheckShape(*polys);
+  size_t num_moduli = tables_.size();
+  yacl::parallel_for(0, polys->NumPolys(), 1, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      tables_[i % num_moduli].Forward((*polys)[i].data());
+    }
+  });
+}
+
+spi::Polys CpuNttOperator::Inverse(const spi::Polys &polys_in) const {
+  spi::Polys res = polys_in;
+  InverseInplace(&res);
+  return res;
+}
+
+void CpuNttOperator::InverseInplace(spi::Polys *polys) const {
+  CheckShape(*polys);
+  size_t num_moduli = tables_.size();
+  yacl::parallel_for(0, polys->NumPolys(), 1, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      tables_[i % num_moduli].Inverse((*polys)[i].data());
+    }
+  });
+}
+
+}  // namespace heu::algos::cpu_poly
@@ -0,0 +1,96 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "heu/spi/poly/ntt_op.h"
+
+namespace heu::algos::cpu_poly {
+
+// Precomputed tables of the nega-cyclic NTT over Z_q[X]/(X^N + 1) for one
+// prime q = 1 mod 2N, q < 2^62.
+//
+// The butterflies follow Harvey's lazy reduction: the twiddles carry their
+// Shoup quotients floor(w * 2^64 / q), intermediate values stay in [0, 4q)
+// and are only reduced to [0, q) at the end. The root is the minimal
+// primitive 2N-th root of unity, which makes the outputs agree with SEAL.
+class NttTables {
+ public:
+  NttTables(size_t poly_degree, uint64_t modulus);
+
+  size_t PolyDegree() const { return n_; }
+
+  uint64_t Modulus() const { return q_; }
+
+  // Coefficients to evaluations in the bit-reversed order, in place. The
+  // inputs should be in [0, q), the outputs are in [0, q).
+  void Forward(uint64_t *coeffs) const;
+
+  // The reverse of Forward()
+  void Inverse(uint64_t *values) const;
+
+ private:
+  size_t n_;
+  uint32_t log_n_;
+  uint64_t q_;
+
+  // psi^bitrev(i) and psi^-bitrev(i) for the minimal 2N-th root psi
+  std::vector<uint64_t> roots_;
+  std::vector<uint64_t> roots_shoup_;
+  std::vector<uint64_t> inv_roots_;
+  std::vector<uint64_t> inv_roots_shoup_;
+  uint64_t inv_n_;
+  uint64_t inv_n_shoup_;
+
+  // floor(w * 2^32 / q) of the twiddles if q < 2^30, for which the AVX2
+  // butterflies only need 32 x 32 bit products
+  std::vector<uint64_t> roots_shoup32_;
+  std::vector<uint64_t> inv_roots_shoup32_;
+};
+
+// NttOperator on the CPU. Poly i of the input is transformed modulo
+// moduli[i % moduli.size()], see spi::Polys. The polys are transformed in
+// parallel, and the butterflies use AVX2 if the CPU supports it.
+class CpuNttOperator : public spi::NttOperator {
+ public:
+  CpuNttOperator(size_t poly_degree, const spi::Moduli &moduli);
+
+  size_t PolyDegree() const { return poly_degree_; }
+
+  const spi::Moduli &GetModuli() const { return moduli_; }
+
+  spi::Polys Forward(const spi::Polys &polys_in) const override;
+  void ForwardInplace(spi::Polys *polys) const override;
+
+  spi::Polys Inverse(const spi::Polys &polys_in) const override;
+  void InverseInplace(spi::Polys *polys) const override;
+
+ private:
+  void CheckShape(const spi::Polys &polys) const;
+
+  size_t poly_degree_;
+  spi::Moduli moduli_;
+  std::vector<NttTables> tables_;
+};
+
+// The count largest primes below 2^bit_size that are 1 mod 2 * poly_degree,
+// in descending order, e.g. the moduli of an RnsPoly
+spi::Moduli GenerateNttPrimes(size_t poly_degree, uint32_t bit_size,
+                              size_t count);
+
+}  // namespace heu::algos::cpu_poly
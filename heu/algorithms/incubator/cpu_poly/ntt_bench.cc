@@ -0,0 +1,75 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <random>
+
+#include "benchmark/benchmark.h"
+
+#include "heu/algorithms/incubator/cpu_poly/arith.h"
+#include "heu/algorithms/incubator/cpu_poly/ntt.h"
+
+namespace heu::algos::cpu_poly::bench {
+
+// One RnsPoly of range(0) coefficients over range(2) primes of range(1) bits
+static void SetUpArgs(benchmark::internal::Benchmark *b) {
+  for (int64_t n : {4096, 8192, 16384}) {
+    for (int64_t bits : {30, 60}) {
+      for (int64_t num_moduli : {1, 4}) {
+        b->Args({n, bits, num_moduli});
+      }
+    }
+  }
+}
+
+static spi::Polys RandomPolys(size_t poly_degree, const spi::Moduli &moduli) {
+  std::mt19937_64 rdv(42);
+  spi::Polys polys(moduli.size(), poly_degree);
+  for (size_t i = 0; i < moduli.size(); ++i) {
+    for (auto &c : polys[i]) {
+      c = rdv() % moduli[i];
+    }
+  }
+  return polys;
+}
+
+static void BM_Forward(benchmark::State &state) {
+  size_t n = state.range(0);
+  auto moduli = GenerateNttPrimes(n, state.range(1), state.range(2));
+  CpuNttOperator ntt(n, moduli);
+  auto polys = RandomPolys(n, moduli);
+  for (auto _ : state) {
+    ntt.ForwardInplace(&polys);
+    benchmark::DoNotOptimize(polys.Data());
+  }
+  state.SetItemsProcessed(state.iterations() * moduli.size());
+  state.SetLabel(UseAVX2() ? "avx2" : "scalar");
+}
+
+static void BM_Inverse(benchmark::State &state) {
+  size_t n = state.range(0);
+  auto moduli = GenerateNttPrimes(n, state.range(1), state.range(2));
+  CpuNttOperator ntt(n, moduli);
+  auto polys = RandomPolys(n, moduli);
+  for (auto _ : state) {
+    ntt.InverseInplace(&polys);
+    benchmark::DoNotOptimize(polys.Data());
+  }
+  state.SetItemsProcessed(state.iterations() * moduli.size());
+  state.SetLabel(UseAVX2() ? "avx2" : "scalar");
+}
+
+BENCHMARK(BM_Forward)->Apply(SetUpArgs);
+BENCHMARK(BM_Inverse)->Apply(SetUpArgs);
+
+}  // namespace heu::algos::cpu_poly::bench
@@ -0,0 +1,135 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/algorithms/incubator/cpu_poly/ntt.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace heu::algos::cpu_poly::test {
+
+using u128 = unsigned __int128;
+
+static spi::Polys RandomPolys(size_t num_polys, size_t poly_degree,
+                              const spi::Moduli &moduli, uint64_t seed) {
+  std::mt19937_64 rdv(seed);
+  spi::Polys polys(num_polys, poly_degree);
+  for (size_t i = 0; i < num_polys; ++i) {
+    for (auto &c : polys[i]) {
+      c = rdv() % moduli[i % moduli.size()];
+    }
+  }
+  return polys;
+}
+
+// a * b mod (X^N + 1, q) by the schoolbook multiplication
+static std::vector<uint64_t> NegacyclicMul(absl::Span<const uint64_t> a,
+                                           absl::Span<const uint64_t> b,
+                                           uint64_t q) {
+  size_t n = a.size();
+  std::vector<uint64_t> res(n, 0);
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      auto prod = static_cast<uint64_t>(static_cast<u128>(a[i]) * b[j] % q);
+      size_t k = (i + j) % n;
+      if (i + j < n) {
+        res[k] = (res[k] + prod) % q;
+      } else {
+        res[k] = (res[k] + q - prod) % q;
+      }
+    }
+  }
+  return res;
+}
+
+class NttTest : public testing::TestWithParam<uint32_t> {};
+
+// 30-bit primes take the 32-bit AVX2 butterflies
+INSTANTIATE_TEST_SUITE_P(ModulusBits, NttTest, testing::Values(20, 30, 50, 60));
+
+TEST_P(NttTest, RoundTrip) {
+  const size_t n = 4096;
+  auto moduli = GenerateNttPrimes(n, GetParam(), 3);
+  CpuNttOperator ntt(n, moduli);
+  // two RnsPolys one after another
+  auto polys = RandomPolys(2 * moduli.size(), n, moduli, GetParam());
+
+  auto evals = ntt.Forward(polys);
+  ASSERT_EQ(evals.NumPolys(), polys.NumPolys());
+  EXPECT_NE(evals, polys);
+  for (size_t i = 0; i < evals.NumPolys(); ++i) {
+    for (uint64_t v : evals[i]) {
+      ASSERT_LT(v, moduli[i % moduli.size()]);
+    }
+  }
+
+  ntt.InverseInplace(&evals);
+  EXPECT_EQ(evals, polys);
+}
+
+TEST_P(NttTest, NegacyclicConvolution) {
+  const size_t n = 256;
+  auto moduli = GenerateNttPrimes(n, GetParam(), 2);
+  CpuNttOperator ntt(n, moduli);
+  auto a = RandomPolys(moduli.size(), n, moduli, 1);
+  auto b = RandomPolys(moduli.size(), n, moduli, 2);
+
+  auto a_evals = ntt.Forward(a);
+  auto b_evals = ntt.Forward(b);
+  for (size_t l = 0; l < moduli.size(); ++l) {
+    for (size_t i = 0; i < n; ++i) {
+      a_evals[l][i] = static_cast<uint64_t>(
+          static_cast<u128>(a_evals[l][i]) * b_evals[l][i] % moduli[l]);
+    }
+  }
+  ntt.InverseInplace(&a_evals);
+
+  for (size_t l = 0; l < moduli.size(); ++l) {
+    auto expected = NegacyclicMul(a[l], b[l], moduli[l]);
+    EXPECT_EQ(a_evals.GetPoly(l), spi::Poly(expected.begin(), expected.end()));
+  }
+}
+
+TEST(NttTablesTest, Basic) {
+  // X -> (psi, -psi, ...) in the bit-reversed order, psi^N = -1
+  const size_t n = 8;
+  const uint64_t q = 17;
+  NttTables tables(n, q);
+  std::vector<uint64_t> x(n, 0);
+  x[1] = 1;
+  tables.Forward(x.data());
+  // 3 is the minimal primitive 16-th root mod 17
+  EXPECT_EQ(x[0], 3U);
+  for (size_t i = 0; i < n; i += 2) {
+    EXPECT_EQ((x[i] + x[i + 1]) % q, 0U);
+  }
+  tables.Inverse(x.data());
+  EXPECT_EQ(x, std::vector<uint64_t>({0, 1, 0, 0, 0, 0, 0, 0}));
+}
+
+TEST(NttTablesTest, InvalidParams) {
+  EXPECT_ANY_THROW(NttTables(1000, 12289));
+  // 12289 = 1 mod 2^12 but not mod 2^14
+  EXPECT_NO_THROW(NttTables(2048, 12289));
+  EXPECT_ANY_THROW(NttTables(8192, 12289));
+  // not a prime
+  EXPECT_ANY_THROW(NttTables(4, 65));
+
+  CpuNttOperator ntt(1024, GenerateNttPrimes(1024, 40, 2));
+  spi::Polys polys(2, 2048);
+  EXPECT_ANY_THROW(ntt.ForwardInplace(&polys));
+}
+
+}  // namespace heu::algos::cpu_poly::test
@@ -0,0 +1,553 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/algorithms/incubator/cpu_poly/poly_op.h"
+
+#include <algorithm>
+
+#include "yacl/base/exception.h"
+#include "yacl/utils/parallel.h"
+
+#include "heu/algorithms/incubator/cpu_poly/arith.h"
+#include "heu/spi/utils/math_tool.h"
+
+namespace heu::algos::cpu_poly {
+
+namespace {
+
+using namespace internal;
+
+#ifdef HEU_CPU_POLY_AVX2
+
+HEU_CPU_POLY_AVX2_TARGET inline __m256i Load(const uint64_t *p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+HEU_CPU_POLY_AVX2_TARGET inline void Store(uint64_t *p, __m256i v) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+}
+
+#endif  // HEU_CPU_POLY_AVX2
+
+// The lane operations. Each has a scalar version, and an AVX2 version on 4
+// lanes if kHasAVX2.
+
+// The 64-bit Barrett products take 7 _mm256_mul_epu32 per 4 lanes, which is
+// no faster than the scalar mulx.
+struct ModOp {
+  static constexpr bool kHasAVX2 = false;
+  ModulusConsts c;
+
+  uint64_t operator()(uint64_t x) const { return BarrettReduce64(x, c); }
+};
+
+struct NegateOp {
+  static constexpr bool kHasAVX2 = true;
+  uint64_t q;
+
+  uint64_t operator()(uint64_t x) const {
+    return (q - x) & -static_cast<uint64_t>(x != 0);
+  }
+
+#ifdef HEU_CPU_POLY_AVX2
+  HEU_CPU_POLY_AVX2_TARGET __m256i operator()(__m256i x) const {
+    __m256i zero = _mm256_cmpeq_epi64(x, _mm256_setzero_si256());
+    return _mm256_andnot_si256(zero,
+                               _mm256_sub_epi64(_mm256_set1_epi64x(q), x));
+  }
+#endif
+};
+
+// x + s mod q for s in [0, q]
+struct AddScalarOp {
+  static constexpr bool kHasAVX2 = true;
+  uint64_t s;
+  uint64_t q;
+
+  uint64_t operator()(uint64_t x) const { return SubIfGE(x + s, q); }
+
+#ifdef HEU_CPU_POLY_AVX2
+  HEU_CPU_POLY_AVX2_TARGET __m256i operator()(__m256i x) const {
+    return avx2::SubIfGE(_mm256_add_epi64(x, _mm256_set1_epi64x(s)),
+                         _mm256_set1_epi64x(q));
+  }
+#endif
+};
+
+// x * w mod q by Shoup's multiplication
+struct MulScalarOp {
+  static constexpr bool kHasAVX2 = true;
+  uint64_t w;
+  uint64_t w_shoup;
+  uint64_t q;
+
+  uint64_t operator()(uint64_t x) const {
+    return SubIfGE(MulShoupLazy(x, w, w_shoup, q), q);
+  }
+
+#ifdef HEU_CPU_POLY_AVX2
+  HEU_CPU_POLY_AVX2_TARGET __m256i operator()(__m256i x) const {
+    avx2::ShoupMul64 mul{_mm256_set1_epi64x(w), _mm256_set1_epi64x(w_shoup),
+                         _mm256_set1_epi64x(q)};
+    return avx2::SubIfGE(mul(x), mul.q);
+  }
+#endif
+};
+
+// The same for q < 2^30, whose AVX2 version takes the 32-bit quotient
+struct MulScalarOp32 {
+  static constexpr bool kHasAVX2 = true;
+  uint64_t w;
+  uint64_t w_shoup;
+  uint64_t w_shoup32;  // floor(w * 2^32 / q)
+  uint64_t q;
+
+  uint64_t operator()(uint64_t x) const {
+    return SubIfGE(MulShoupLazy(x, w, w_shoup, q), q);
+  }
+
+#ifdef HEU_CPU_POLY_AVX2
+  HEU_CPU_POLY_AVX2_TARGET __m256i operator()(__m256i x) const {
+    avx2::ShoupMul32 mul{_mm256_set1_epi64x(w), _mm256_set1_epi64x(w_shoup32),
+                         _mm256_set1_epi64x(q)};
+    return avx2::SubIfGE(mul(x), mul.q);
+  }
+#endif
+};
+
+struct AddOp {
+  static constexpr bool kHasAVX2 = true;
+  uint64_t q;
+
+  uint64_t operator()(uint64_t a, uint64_t b) const {
+    return SubIfGE(a + b, q);
+  }
+
+#ifdef HEU_CPU_POLY_AVX2
+  HEU_CPU_POLY_AVX2_TARGET __m256i operator()(__m256i a, __m256i b) const {
+    return avx2::SubIfGE(_mm256_add_epi64(a, b), _mm256_set1_epi64x(q));
+  }
+#endif
+};
+
+struct SubOp {
+  static constexpr bool kHasAVX2 = true;
+  uint64_t q;
+
+  uint64_t operator()(uint64_t a, uint64_t b) const {
+    return SubIfGE(a + q - b, q);
+  }
+
+#ifdef HEU_CPU_POLY_AVX2
+  HEU_CPU_POLY_AVX2_TARGET __m256i operator()(__m256i a, __m256i b) const {
+    __m256i vq = _mm256_set1_epi64x(q);
+    return avx2::SubIfGE(_mm256_sub_epi64(_mm256_add_epi64(a, vq), b), vq);
+  }
+#endif
+};
+
+// a * b mod q by Barrett reduction of the 128-bit product
+struct MulOp {
+  static constexpr bool kHasAVX2 = false;
+  ModulusConsts c;
+
+  uint64_t operator()(uint64_t a, uint64_t b) const {
+    return BarrettReduce128(static_cast<u128>(a) * b, c);
+  }
+};
+
+// The same for q < 2^30 by the classic Barrett reduction: with k the bit
+// length of q and mu = floor(2^2k / q) < 2^31, the estimate
+// ((a * b) >> (k - 1)) * mu >> (k + 1) is at most 2 less than floor(a * b / q),
+// and all the AVX2 products are 32 x 32 bits.
+struct MulOpSmall {
+  static constexpr bool kHasAVX2 = true;
+  ModulusConsts c;
+  uint64_t k;
+  uint64_t mu;
+
+  explicit MulOpSmall(const ModulusConsts &consts) : c(consts) {
+    k = 64 - __builtin_clzll(c.q);
+    mu = static_cast<uint64_t>((static_cast<u128>(1) << (2 * k)) / c.q);
+  }
+
+  uint64_t operator()(uint64_t a, uint64_t b) const {
+    return BarrettReduce64(a * b, c);
+  }
+
+#ifdef HEU_CPU_POLY_AVX2
+  HEU_CPU_POLY_AVX2_TARGET __m256i operator()(__m256i a, __m256i b) const {
+    __m256i q = _mm256_set1_epi64x(c.q);
+    __m256i x = _mm256_mul_epu32(a, b);
+    __m256i t = _mm256_srli_epi64(x, static_cast<int>(k - 1));
+    __m256i est = _mm256_srli_epi64(
+        _mm256_mul_epu32(t, _mm256_set1_epi64x(mu)), static_cast<int>(k + 1));
+    __m256i r = _mm256_sub_epi64(x, _mm256_mul_epu32(est, q));
+    return avx2::SubIfGE(avx2::SubIfGE(r, q), q);
+  }
+#endif
+};
+
+#ifdef HEU_CPU_POLY_AVX2
+
+template <typename Op>
+HEU_CPU_POLY_AVX2_TARGET size_t UnaryAVX2(const uint64_t *x, size_t n,
+                                          const Op &op, uint64_t *out) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    Store(out + i, op(Load(x + i)));
+  }
+  return i;
+}
+
+template <typename Op>
+HEU_CPU_POLY_AVX2_TARGET size_t BinaryAVX2(const uint64_t *a,
+                                           const uint64_t *b, size_t n,
+                                           const Op &op, uint64_t *out) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    Store(out + i, op(Load(a + i), Load(b + i)));
+  }
+  return i;
+}
+
+#endif  // HEU_CPU_POLY_AVX2
+
+// out[i] = op(x[i]), AVX2 on whole groups of 4 and scalar on the rest
+template <typename Op>
+void Unary(const uint64_t *x, size_t n, const Op &op, uint64_t *out) {
+  size_t i = 0;
+#ifdef HEU_CPU_POLY_AVX2
+  if constexpr (Op::kHasAVX2) {
+    if (UseAVX2()) {
+      i = UnaryAVX2(x, n, op, out);
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    out[i] = op(x[i]);
+  }
+}
+
+// out[i] = op(a[i], b[i])
+template <typename Op>
+void Binary(const uint64_t *a, const uint64_t *b, size_t n, const Op &op,
+            uint64_t *out) {
+  size_t i = 0;
+#ifdef HEU_CPU_POLY_AVX2
+  if constexpr (Op::kHasAVX2) {
+    if (UseAVX2()) {
+      i = BinaryAVX2(a, b, n, op, out);
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    out[i] = op(a[i], b[i]);
+  }
+}
+
+void CheckModuli(const spi::Moduli &coeff_modulus) {
+  YACL_ENFORCE(!coeff_modulus.empty(), "empty moduli");
+  for (uint64_t q : coeff_modulus) {
+    YACL_ENFORCE(q >= 2 && q < (1ULL << 62), "invalid modulus {}", q);
+  }
+}
+
+void CheckSameShape(const spi::Polys &in1, const spi::Polys &in2) {
+  YACL_ENFORCE(in1.NumPolys() == in2.NumPolys() &&
+                   in1.PolyDegree() == in2.PolyDegree(),
+               "shape mismatch, {}x{} vs {}x{}", in1.NumPolys(),
+               in1.PolyDegree(), in2.NumPolys(), in2.PolyDegree());
+}
+
+// Runs fn(i, consts of the modulus of poly i) on each poly in parallel
+template <typename Fn>
+void ForEachPoly(size_t num_polys, const spi::Moduli &coeff_modulus,
+                 const Fn &fn) {
+  CheckModuli(coeff_modulus);
+  yacl::parallel_for(0, num_polys, 1, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      fn(i, MakeModulusConsts(coeff_modulus[i % coeff_modulus.size()]));
+    }
+  });
+}
+
+void AddScalar(spi::Polys *polys, const std::vector<uint64_t> &scalar_in,
+               const spi::Moduli &coeff_modulus, bool negate) {
+  YACL_ENFORCE(!scalar_in.empty(), "empty scalars");
+  size_t n = polys->PolyDegree();
+  ForEachPoly(polys->NumPolys(), coeff_modulus,
+              [&](size_t i, const ModulusConsts &c) {
+                uint64_t s =
+                    BarrettReduce64(scalar_in[i % scalar_in.size()], c);
+                AddScalarOp op{negate ? c.q - s : s, c.q};
+                Unary((*polys)[i].data(), n, op, (*polys)[i].data());
+              });
+}
+
+}  // namespace
+
+spi::Polys CpuPolyOperator::Mod(const spi::Polys &in,
+                                const spi::Moduli &coeff_modulus) const {
+  spi::Polys res = in;
+  ModInplace(&res, coeff_modulus);
+  return res;
+}
+
+void CpuPolyOperator::ModInplace(spi::Polys *polys,
+                                 const spi::Moduli &coeff_modulus) const {
+  size_t n = polys->PolyDegree();
+  ForEachPoly(polys->NumPolys(), coeff_modulus,
+              [&](size_t i, const ModulusConsts &c) {
+                Unary((*polys)[i].data(), n, ModOp{c}, (*polys)[i].data());
+              });
+}
+
+spi::Polys CpuPolyOperator::NegateMod(const spi::Polys &in,
+                                      const spi::Moduli &coeff_modulus) const {
+  spi::Polys res = in;
+  NegateModInplace(&res, coeff_modulus);
+  return res;
+}
+
+void CpuPolyOperator::NegateModInplace(spi::Polys *polys,
+                                       const spi::Moduli &coeff_modulus) const {
+  size_t n = polys->PolyDegree();
+  ForEachPoly(polys->NumPolys(), coeff_modulus,
+              [&](size_t i, const ModulusConsts &c) {
+                Unary((*polys)[i].data(), n, NegateOp{c.q},
+                      (*polys)[i].data());
+              });
+}
+
+spi::Polys CpuPolyOperator::AddMod(const spi::Polys &in1, const spi::Polys &in2,
+                                   const spi::Moduli &coeff_modulus) const {
+  spi::Polys res = in1;
+  AddModInplace(&res, in2, coeff_modulus);
+  return res;
+}
+
+void CpuPolyOperator::AddModInplace(spi::Polys *polys_1,
+                                    const spi::Polys &polys_2,
+                                    const spi::Moduli &coeff_modulus) const {
+  CheckSameShape(*polys_1, polys_2);
+  size_t n = polys_1->PolyDegree();
+  ForEachPoly(polys_1->NumPolys(), coeff_modulus,
+              [&](size_t i, const ModulusConsts &c) {
+                Binary((*polys_1)[i].data(), polys_2[i].data(), n, AddOp{c.q},
+                       (*polys_1)[i].data());
+              });
+}
+
+spi::Polys CpuPolyOperator::AddMod(const spi::Polys &polys_in,
+                                   const std::vector<uint64_t> &scalar_in,
+                                   const spi::Moduli &coeff_modulus) const {
+  spi::Polys res = polys_in;
+  AddModInplace(&res, scalar_in, coeff_modulus);
+  return res;
+}
+
+void CpuPolyOperator::AddModInplace(spi::Polys *polys,
+                                    const std::vector<uint64_t> &scalar_in,
+                                    const spi::Moduli &coeff_modulus) const {
+  AddScalar(polys, scalar_in, coeff_modulus, /*negate*/ false);
+}
+
+spi::Polys CpuPolyOperator::SubMod(const spi::Polys &in1, const spi::Polys &in2,
+                                   const spi::Moduli &coeff_modulus) const {
+  spi::Polys res = in1;
+  SubModInplace(&res, in2, coeff_modulus);
+  return res;
+}
+
+void CpuPolyOperator::SubModInplace(spi::Polys *polys_1,
+                                    const spi::Polys &polys_2,
+                                    const spi::Moduli &coeff_modulus) const {
+  CheckSameShape(*polys_1, polys_2);
+  size_t n = polys_1->PolyDegree();
+  ForEachPoly(polys_1->NumPolys(), coeff_modulus,
+              [&](size_t i, const ModulusConsts &c) {
+                Binary((*polys_1)[i].data(), polys_2[i].data(), n, SubOp{c.q},
+                       (*polys_1)[i].data());
+              });
+}
+
+spi::Polys CpuPolyOperator::SubMod(const spi::Polys &polys_in,
+                                   const std::vector<uint64_t> &scalar_in,
+                                   const spi::Moduli &coeff_modulus) const {
+  spi::Polys res = polys_in;
+  SubModInplace(&res, scalar_in, coeff_modulus);
+  return res;
+}
+
+void CpuPolyOperator::SubModInplace(spi::Polys *polys,
+                                    const std::vector<uint64_t> &scalar_in,
+                                    const spi::Moduli &coeff_modulus) const {
+  AddScalar(polys, scalar_in, coeff_modulus, /*negate*/ true);
+}
+
+spi::Polys CpuPolyOperator::MulMod(const spi::Polys &in1, const spi::Polys &in2,
+                                   const spi::Moduli &coeff_modulus) const {
+  spi::Polys res = in1;
+  MulModInplace(&res, in2, coeff_modulus);
+  return res;
+}
+
+void CpuPolyOperator::MulModInplace(spi::Polys *polys_1,
+                                    const spi::Polys &polys_2,
+                                    const spi::Moduli &coeff_modulus) const {
+  CheckSameShape(*polys_1, polys_2);
+  size_t n = polys_1->PolyDegree();
+  ForEachPoly(polys_1->NumPolys(), coeff_modulus,
+              [&](size_t i, const ModulusConsts &c) {
+                uint64_t *x = (*polys_1)[i].data();
+                if (c.q < (1ULL << 30)) {
+                  Binary(x, polys_2[i].data(), n, MulOpSmall(c), x);
+                } else {
+                  Binary(x, polys_2[i].data(), n, MulOp{c}, x);
+                }
+              });
+}
+
+spi::Polys CpuPolyOperator::MulMod(const spi::Polys &polys_in,
+                                   const std::vector<uint64_t> &scalar_in,
+                                   const spi::Moduli &coeff_modulus) const {
+  spi::Polys res = polys_in;
+  MulModInplace(&res, scalar_in, coeff_modulus);
+  return res;
+}
+
+void CpuPolyOperator::MulModInplace(spi::Polys *polys,
+                                    const std::vector<uint64_t> &scalar_in,
+                                    const spi::Moduli &coeff_modulus) const {
+  YACL_ENFORCE(!scalar_in.empty(), "empty scalars");
+  size_t n = polys->PolyDegree();
+  ForEachPoly(polys->NumPolys(), coeff_modulus,
+              [&](size_t i, const ModulusConsts &c) {
+                uint64_t *x = (*polys)[i].data();
+                uint64_t w =
+                    BarrettReduce64(scalar_in[i % scalar_in.size()], c);
+                uint64_t w_shoup = ShoupQuotient(w, c.q);
+                if (c.q < (1ULL << 30)) {
+                  MulScalarOp32 op{w, w_shoup, (w << 32) / c.q, c.q};
+                  Unary(x, n, op, x);
+                } else {
+                  Unary(x, n, MulScalarOp{w, w_shoup, c.q}, x);
+                }
+              });
+}
+
+spi::Polys CpuPolyOperator::Automorphism(
+    const spi::Polys &in, size_t offset,
+    const spi::Moduli &coeff_modulus) const {
+  spi::Polys res = in;
+  AutomorphismInplace(&res, offset, coeff_modulus);
+  return res;
+}
+
+void CpuPolyOperator::AutomorphismInplace(
+    spi::Polys *polys, size_t offset, const spi::Moduli &coeff_modulus) const {
+  CheckModuli(coeff_modulus);
+  size_t n = polys->PolyDegree();
+  YACL_ENFORCE(spi::utils::IsPowerOf2(n),
+               "poly degree {} must be a power of two", n);
+  YACL_ENFORCE(offset % 2 == 1, "offset {} should be odd", offset);
+  // X -> X^offset permutes the coefficients mod X^N + 1, up to the signs
+  size_t mask = 2 * n - 1;
+  yacl::parallel_for(0, polys->NumPolys(), 1, [&](int64_t beg, int64_t end) {
+    std::vector<uint64_t> scratch(n);
+    for (int64_t i = beg; i < end; ++i) {
+      uint64_t q = coeff_modulus[i % coeff_modulus.size()];
+      NegateOp negate{q};
+      auto x = (*polys)[i];
+      for (size_t j = 0; j < n; ++j) {
+        size_t k = (j * offset) & mask;
+        if (k < n) {
+          scratch[k] = x[j];
+        } else {
+          scratch[k - n] = negate(x[j]);
+        }
+      }
+      std::copy(scratch.begin(), scratch.end(), x.begin());
+    }
+  });
+}
+
+void CpuPolyOperator::MulAddModInplace(spi::Polys *acc, const spi::Polys &in1,
+                                       const spi::Polys &in2,
+                                       const spi::Moduli &coeff_modulus) const {
+  CheckSameShape(*acc, in1);
+  CheckSameShape(in1, in2);
+  size_t n = acc->PolyDegree();
+  ForEachPoly(acc->NumPolys(), coeff_modulus,
+              [&](size_t i, const ModulusConsts &c) {
+                uint64_t *r = (*acc)[i].data();
+                const uint64_t *a = in1[i].data();
+                const uint64_t *b = in2[i].data();
+                for (size_t j = 0; j < n; ++j) {
+                  r[j] = BarrettReduce128(static_cast<u128>(a[j]) * b[j] + r[j],
+                                          c);
+                }
+              });
+}
+
+spi::Polys CpuPolyOperator::InnerProductMod(
+    absl::Span<const spi::Polys> in1, absl::Span<const spi::Polys> in2,
+    const spi::Moduli &coeff_modulus) const {
+  YACL_ENFORCE(!in1.empty() && in1.size() == in2.size(),
+               "size mismatch, {} vs {}", in1.size(), in2.size());
+  for (size_t k = 0; k < in1.size(); ++k) {
+    CheckSameShape(in1[0], in1[k]);
+    CheckSameShape(in1[0], in2[k]);
+  }
+
+  size_t n = in1[0].PolyDegree();
+  spi::Polys res(in1[0].NumPolys(), n);
+  CheckModuli(coeff_modulus);
+  yacl::parallel_for(0, res.NumPolys(), 1, [&](int64_t beg, int64_t end) {
+    std::vector<u128> sum(n);
+    for (int64_t i = beg; i < end; ++i) {
+      auto c = MakeModulusConsts(coeff_modulus[i % coeff_modulus.size()]);
+      // the number of products sum can take after a reduction to [0, q)
+      u128 max_sqr = static_cast<u128>(c.q - 1) * (c.q - 1);
+      u128 max_lazy =
+          (static_cast<u128>(-1) - c.q) / std::max<u128>(max_sqr, 1);
+
+      std::fill(sum.begin(), sum.end(), 0);
+      u128 num_lazy = 0;
+      for (size_t k = 0; k < in1.size(); ++k) {
+        if (num_lazy == max_lazy) {
+          for (auto &s : sum) {
+            s = BarrettReduce128(s, c);
+          }
+          num_lazy = 0;
+        }
+        const uint64_t *a = in1[k][i].data();
+        const uint64_t *b = in2[k][i].data();
+        for (size_t j = 0; j < n; ++j) {
+          sum[j] += static_cast<u128>(a[j]) * b[j];
+        }
+        ++num_lazy;
+      }
+
+      auto out = res[i];
+      for (size_t j = 0; j < n; ++j) {
+        out[j] = BarrettReduce128(sum[j], c);
+      }
+    }
+  });
+  return res;
+}
+
+}  // namespace heu::algos::cpu_poly
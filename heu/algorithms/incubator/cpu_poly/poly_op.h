@@ -0,0 +1,104 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "heu/spi/poly/poly_op.h"
+
+namespace heu::algos::cpu_poly {
+
+// ElementWisePolyOperator on the CPU, see spi::Polys for the layout.
+//
+// The inputs should be reduced to [0, q) except for Mod(), and the outputs
+// are always in [0, q). Every modulus should be in [2, 2^62). Products of two
+// polys are reduced by Barrett reduction, products with a broadcast scalar by
+// Shoup's precomputed quotient. For the broadcast versions, poly i takes
+// scalar_in[i % scalar_in.size()], e.g. one scalar per modulus of an RnsPoly.
+//
+// The polys are processed in parallel. Add/Sub/Negate and the scalar
+// multiplication use AVX2 if the CPU supports it, and so does MulMod for
+// moduli below 2^30. The *Inplace versions do not allocate, except
+// AutomorphismInplace() which needs one poly of scratch per worker.
+class CpuPolyOperator : public spi::ElementWisePolyOperator {
+ public:
+  spi::Polys Mod(const spi::Polys &in,
+                 const spi::Moduli &coeff_modulus) const override;
+  void ModInplace(spi::Polys *polys,
+                  const spi::Moduli &coeff_modulus) const override;
+
+  spi::Polys NegateMod(const spi::Polys &in,
+                       const spi::Moduli &coeff_modulus) const override;
+  void NegateModInplace(spi::Polys *polys,
+                        const spi::Moduli &coeff_modulus) const override;
+
+  spi::Polys AddMod(const spi::Polys &in1, const spi::Polys &in2,
+                    const spi::Moduli &coeff_modulus) const override;
+  void AddModInplace(spi::Polys *polys_1, const spi::Polys &polys_2,
+                     const spi::Moduli &coeff_modulus) const override;
+
+  spi::Polys AddMod(const spi::Polys &polys_in,
+                    const std::vector<uint64_t> &scalar_in,
+                    const spi::Moduli &coeff_modulus) const override;
+  void AddModInplace(spi::Polys *polys, const std::vector<uint64_t> &scalar_in,
+                     const spi::Moduli &coeff_modulus) const override;
+
+  spi::Polys SubMod(const spi::Polys &in1, const spi::Polys &in2,
+                    const spi::Moduli &coeff_modulus) const override;
+  void SubModInplace(spi::Polys *polys_1, const spi::Polys &polys_2,
+                     const spi::Moduli &coeff_modulus) const override;
+
+  spi::Polys SubMod(const spi::Polys &polys_in,
+                    const std::vector<uint64_t> &scalar_in,
+                    const spi::Moduli &coeff_modulus) const override;
+  void SubModInplace(spi::Polys *polys, const std::vector<uint64_t> &scalar_in,
+                     const spi::Moduli &coeff_modulus) const override;
+
+  spi::Polys MulMod(const spi::Polys &in1, const spi::Polys &in2,
+                    const spi::Moduli &coeff_modulus) const override;
+  void MulModInplace(spi::Polys *polys_1, const spi::Polys &polys_2,
+                     const spi::Moduli &coeff_modulus) const override;
+
+  spi::Polys MulMod(const spi::Polys &polys_in,
+                    const std::vector<uint64_t> &scalar_in,
+                    const spi::Moduli &coeff_modulus) const override;
+  void MulModInplace(spi::Polys *polys, const std::vector<uint64_t> &scalar_in,
+                     const spi::Moduli &coeff_modulus) const override;
+
+  spi::Polys Automorphism(const spi::Polys &in, size_t offset,
+                          const spi::Moduli &coeff_modulus) const override;
+  void AutomorphismInplace(spi::Polys *polys, size_t offset,
+                           const spi::Moduli &coeff_modulus) const override;
+
+  //=== Fused operations ===//
+
+  // acc += in1 * in2, with a single reduction of the 128-bit acc + in1 * in2
+  void MulAddModInplace(spi::Polys *acc, const spi::Polys &in1,
+                        const spi::Polys &in2,
+                        const spi::Moduli &coeff_modulus) const;
+
+  // sum_k in1[k] * in2[k]. The 128-bit products are accumulated without
+  // reduction as long as they cannot overflow, e.g. 2^(128 - 2 * 60) = 256
+  // terms for 60-bit moduli.
+  spi::Polys InnerProductMod(absl::Span<const spi::Polys> in1,
+                             absl::Span<const spi::Polys> in2,
+                             const spi::Moduli &coeff_modulus) const;
+};
+
+}  // namespace heu::algos::cpu_poly
@@ -0,0 +1,149 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <random>
+
+#include "benchmark/benchmark.h"
+
+#include "heu/algorithms/incubator/cpu_poly/arith.h"
+#include "heu/algorithms/incubator/cpu_poly/poly_op.h"
+
+namespace heu::algos::cpu_poly::bench {
+
+constexpr static size_t kPolyDeg = 8192;
+constexpr static size_t kNumModuli = 4;
+
+// One RnsPoly of kNumModuli moduli of range(0) bits
+struct Inputs {
+  explicit Inputs(uint32_t bits) {
+    for (size_t l = 0; l < kNumModuli; ++l) {
+      moduli.push_back((1ULL << bits) - 1 - 2 * l);
+    }
+    std::mt19937_64 rdv(42);
+    for (auto *polys : {&a, &b}) {
+      polys->Resize(kNumModuli, kPolyDeg);
+      for (size_t i = 0; i < kNumModuli; ++i) {
+        for (auto &c : (*polys)[i]) {
+          c = rdv() % moduli[i];
+        }
+      }
+    }
+    scalars.assign(kNumModuli, rdv());
+  }
+
+  spi::Moduli moduli;
+  spi::Polys a;
+  spi::Polys b;
+  std::vector<uint64_t> scalars;
+};
+
+static void Finish(benchmark::State &state) {
+  state.SetItemsProcessed(state.iterations() * kPolyDeg * kNumModuli);
+  state.SetLabel(UseAVX2() ? "avx2" : "scalar");
+}
+
+static void BM_AddMod(benchmark::State &state) {
+  Inputs in(state.range(0));
+  CpuPolyOperator op;
+  for (auto _ : state) {
+    op.AddModInplace(&in.a, in.b, in.moduli);
+    benchmark::DoNotOptimize(in.a.Data());
+  }
+  Finish(state);
+}
+
+static void BM_SubMod(benchmark::State &state) {
+  Inputs in(state.range(0));
+  CpuPolyOperator op;
+  for (auto _ : state) {
+    op.SubModInplace(&in.a, in.b, in.moduli);
+    benchmark::DoNotOptimize(in.a.Data());
+  }
+  Finish(state);
+}
+
+static void BM_NegateMod(benchmark::State &state) {
+  Inputs in(state.range(0));
+  CpuPolyOperator op;
+  for (auto _ : state) {
+    op.NegateModInplace(&in.a, in.moduli);
+    benchmark::DoNotOptimize(in.a.Data());
+  }
+  Finish(state);
+}
+
+static void BM_Mod(benchmark::State &state) {
+  Inputs in(state.range(0));
+  CpuPolyOperator op;
+  for (auto _ : state) {
+    op.ModInplace(&in.a, in.moduli);
+    benchmark::DoNotOptimize(in.a.Data());
+  }
+  Finish(state);
+}
+
+static void BM_MulMod(benchmark::State &state) {
+  Inputs in(state.range(0));
+  CpuPolyOperator op;
+  for (auto _ : state) {
+    op.MulModInplace(&in.a, in.b, in.moduli);
+    benchmark::DoNotOptimize(in.a.Data());
+  }
+  Finish(state);
+}
+
+static void BM_MulScalarMod(benchmark::State &state) {
+  Inputs in(state.range(0));
+  CpuPolyOperator op;
+  for (auto _ : state) {
+    op.MulModInplace(&in.a, in.scalars, in.moduli);
+    benchmark::DoNotOptimize(in.a.Data());
+  }
+  Finish(state);
+}
+
+static void BM_MulAddMod(benchmark::State &state) {
+  Inputs in(state.range(0));
+  CpuPolyOperator op;
+  spi::Polys acc(kNumModuli, kPolyDeg);
+  for (auto _ : state) {
+    op.MulAddModInplace(&acc, in.a, in.b, in.moduli);
+    benchmark::DoNotOptimize(acc.Data());
+  }
+  Finish(state);
+}
+
+// 16 products per output coefficient
+static void BM_InnerProductMod(benchmark::State &state) {
+  Inputs in(state.range(0));
+  CpuPolyOperator op;
+  std::vector<spi::Polys> in1(16, in.a);
+  std::vector<spi::Polys> in2(16, in.b);
+  for (auto _ : state) {
+    auto res = op.InnerProductMod(in1, in2, in.moduli);
+    benchmark::DoNotOptimize(res.Data());
+  }
+  Finish(state);
+}
+
+BENCHMARK(BM_AddMod)->Arg(30)->Arg(60);
+BENCHMARK(BM_SubMod)->Arg(30)->Arg(60);
+BENCHMARK(BM_NegateMod)->Arg(30)->Arg(60);
+BENCHMARK(BM_Mod)->Arg(30)->Arg(60);
+BENCHMARK(BM_MulMod)->Arg(30)->Arg(60);
+BENCHMARK(BM_MulScalarMod)->Arg(30)->Arg(60);
+BENCHMARK(BM_MulAddMod)->Arg(30)->Arg(60);
+BENCHMARK(BM_InnerProductMod)->Arg(30)->Arg(60);
+
+}  // namespace heu::algos::cpu_poly::bench
@@ -0,0 +1,187 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/algorithms/incubator/cpu_poly/poly_op.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace heu::algos::cpu_poly::test {
+
+using u128 = unsigned __int128;
+
+class PolyOpTest : public testing::TestWithParam<uint32_t> {
+ protected:
+  // Not a multiple of 4, so that the scalar tails of the AVX2 kernels run
+  static constexpr size_t kDegree = 1027;
+
+  void SetUp() override {
+    uint32_t bits = GetParam();
+    // element-wise operations do not need primes
+    moduli_ = {(1ULL << bits) - 1, (1ULL << bits) - 59,
+               (1ULL << (bits - 1)) + 4};
+    rdv_.seed(bits);
+  }
+
+  // 2 RnsPolys, optionally with unreduced coefficients
+  spi::Polys RandomPolys(size_t poly_degree = kDegree, bool reduce = true) {
+    spi::Polys polys(2 * moduli_.size(), poly_degree);
+    for (size_t i = 0; i < polys.NumPolys(); ++i) {
+      for (auto &c : polys[i]) {
+        c = reduce ? rdv_() % Q(i) : rdv_();
+      }
+    }
+    return polys;
+  }
+
+  uint64_t Q(size_t i) const { return moduli_[i % moduli_.size()]; }
+
+  // Checks out[i][j] == fn(i, j) for the scalar reference fn
+  template <typename Fn>
+  void Check(const spi::Polys &out, const Fn &fn) {
+    for (size_t i = 0; i < out.NumPolys(); ++i) {
+      for (size_t j = 0; j < out.PolyDegree(); ++j) {
+        ASSERT_EQ(out[i][j], fn(i, j)) << "poly " << i << ", coeff " << j;
+      }
+    }
+  }
+
+  std::mt19937_64 rdv_;
+  spi::Moduli moduli_;
+  CpuPolyOperator op_;
+};
+
+// 20 and 30: 32-bit AVX2 Shoup products, 40: Barrett for 128-bit products
+INSTANTIATE_TEST_SUITE_P(ModulusBits, PolyOpTest,
+                         testing::Values(20, 30, 40, 61));
+
+TEST_P(PolyOpTest, ModAndNegate) {
+  auto x = RandomPolys(kDegree, /*reduce*/ false);
+  auto reduced = op_.Mod(x, moduli_);
+  Check(reduced, [&](size_t i, size_t j) { return x[i][j] % Q(i); });
+
+  auto neg = op_.NegateMod(reduced, moduli_);
+  Check(neg, [&](size_t i, size_t j) {
+    return (Q(i) - reduced[i][j]) % Q(i);
+  });
+  op_.NegateModInplace(&neg, moduli_);
+  EXPECT_EQ(neg, reduced);
+}
+
+TEST_P(PolyOpTest, AddSubMul) {
+  auto a = RandomPolys();
+  auto b = RandomPolys();
+  // zeros take the edge cases of negation and subtraction
+  a[0][0] = 0;
+  b[0][0] = 0;
+  b[1][0] = a[1][0];
+
+  auto sum = op_.AddMod(a, b, moduli_);
+  Check(sum, [&](size_t i, size_t j) {
+    return static_cast<uint64_t>((static_cast<u128>(a[i][j]) + b[i][j]) %
+                                 Q(i));
+  });
+  auto diff = op_.SubMod(a, b, moduli_);
+  Check(diff,
+        [&](size_t i, size_t j) { return (a[i][j] + Q(i) - b[i][j]) % Q(i); });
+  auto prod = op_.MulMod(a, b, moduli_);
+  Check(prod, [&](size_t i, size_t j) {
+    return static_cast<uint64_t>(static_cast<u128>(a[i][j]) * b[i][j] % Q(i));
+  });
+
+  op_.SubModInplace(&sum, b, moduli_);
+  EXPECT_EQ(sum, a);
+  EXPECT_ANY_THROW(op_.AddMod(a, RandomPolys(kDegree - 1), moduli_));
+}
+
+TEST_P(PolyOpTest, Scalar) {
+  auto a = RandomPolys();
+  // one scalar per modulus, larger than the moduli
+  std::vector<uint64_t> scalars = {rdv_(), rdv_(), 0};
+
+  auto s = [&](size_t i) { return scalars[i % scalars.size()] % Q(i); };
+  auto sum = op_.AddMod(a, scalars, moduli_);
+  Check(sum, [&](size_t i, size_t j) { return (a[i][j] + s(i)) % Q(i); });
+  auto diff = op_.SubMod(a, scalars, moduli_);
+  Check(diff,
+        [&](size_t i, size_t j) { return (a[i][j] + Q(i) - s(i)) % Q(i); });
+  auto prod = op_.MulMod(a, scalars, moduli_);
+  Check(prod, [&](size_t i, size_t j) {
+    return static_cast<uint64_t>(static_cast<u128>(a[i][j]) * s(i) % Q(i));
+  });
+
+  EXPECT_ANY_THROW(op_.MulMod(a, std::vector<uint64_t>{}, moduli_));
+}
+
+TEST_P(PolyOpTest, Automorphism) {
+  const size_t n = 1024;
+  auto a = RandomPolys(n);
+  const size_t offset = 5;
+
+  auto res = op_.Automorphism(a, offset, moduli_);
+  spi::Polys expected(a.NumPolys(), n);
+  for (size_t i = 0; i < a.NumPolys(); ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      size_t k = j * offset % (2 * n);
+      if (k < n) {
+        expected[i][k] = a[i][j];
+      } else {
+        expected[i][k - n] = (Q(i) - a[i][j]) % Q(i);
+      }
+    }
+  }
+  EXPECT_EQ(res, expected);
+
+  // X -> X^-1 is an involution
+  auto b = a;
+  op_.AutomorphismInplace(&b, 2 * n - 1, moduli_);
+  EXPECT_NE(b, a);
+  op_.AutomorphismInplace(&b, 2 * n - 1, moduli_);
+  EXPECT_EQ(b, a);
+  EXPECT_ANY_THROW(op_.Automorphism(a, 2, moduli_));
+  // the permutation is only computed mod 2N for power-of-two degrees
+  EXPECT_ANY_THROW(op_.Automorphism(RandomPolys(), offset, moduli_));
+}
+
+TEST_P(PolyOpTest, MulAddAndInnerProduct) {
+  auto acc = RandomPolys();
+  auto a = RandomPolys();
+  auto b = RandomPolys();
+  auto expected = op_.AddMod(acc, op_.MulMod(a, b, moduli_), moduli_);
+  op_.MulAddModInplace(&acc, a, b, moduli_);
+  EXPECT_EQ(acc, expected);
+
+  // more terms than the lazy bound 2^6 of 61-bit moduli
+  const size_t num_terms = 100;
+  std::vector<spi::Polys> in1;
+  std::vector<spi::Polys> in2;
+  spi::Polys sum(2 * moduli_.size(), 64);
+  for (size_t k = 0; k < num_terms; ++k) {
+    in1.push_back(RandomPolys(64));
+    in2.push_back(RandomPolys(64));
+    op_.MulAddModInplace(&sum, in1.back(), in2.back(), moduli_);
+  }
+  EXPECT_EQ(op_.InnerProductMod(in1, in2, moduli_), sum);
+}
+
+TEST(CpuPolyOperatorTest, InvalidModuli) {
+  CpuPolyOperator op;
+  spi::Polys polys(2, 16);
+  EXPECT_ANY_THROW(op.ModInplace(&polys, {}));
+  EXPECT_ANY_THROW(op.ModInplace(&polys, {1ULL << 62}));
+  EXPECT_NO_THROW(op.ModInplace(&polys, {(1ULL << 62) - 1}));
+}
+
+}  // namespace heu::algos::cpu_poly::test
@@ -14,7 +14,12 @@
 
 #include "heu/algorithms/ou/evaluator.h"
 
+#include <vector>
+
+#include "yacl/utils/parallel.h"
+
 #include "heu/algorithms/common/he_assert.h"
+#include "heu/algorithms/common/mont_batch.h"
 
 namespace heu::algos::ou {
 
@@ -48,15 +53,8 @@ Ciphertext Evaluator::Add(const Ciphertext &a, const Plaintext &p) const {
                "plaintext number out of range, message={}, max (abs)={}",
                p.ToHexString(), pk_->PlaintextBound());
 
-  BigInt gm;
-  if (p.IsNegative()) {
-    gm = pk_->m_space_->PowMod(*pk_->cgi_table_, p.Abs());
-  } else {
-    gm = pk_->m_space_->PowMod(*pk_->cg_table_, p);
-  }
-
   Ciphertext out;
-  out.c_ = pk_->m_space_->MulMod(a.c_, gm);
+  out.c_ = pk_->m_space_->MulMod(a.c_, EncodeGm(p));
   return out;
 }
 
@@ -114,6 +112,130 @@ void Evaluator::MulInplace(Ciphertext *a, const Plaintext &p) const {
   *a = Mul(*a, p);
 }
 
+BigInt Evaluator::EncodeGm(const Plaintext &m) const {
+  if (m.IsNegative()) {
+    return pk_->m_space_->PowMod(*pk_->cgi_table_, m.Abs());
+  }
+  return pk_->m_space_->PowMod(*pk_->cg_table_, m);
+}
+
+template <typename GmAt>
+void Evaluator::AddImpl(absl::Span<const Ciphertext> a, const GmAt &gm_at,
+                        absl::Span<Ciphertext> out) const {
+  YACL_ENFORCE_EQ(out.size(), a.size(), "output size mismatch");
+  yacl::parallel_for(0, a.size(), [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      out[i].c_ = pk_->m_space_->MulMod(a[i].c_, gm_at(i));
+    }
+  });
+}
+
+template <typename PtAt>
+void Evaluator::MulImpl(absl::Span<const Ciphertext> a, const PtAt &p_at,
+                        absl::Span<Ciphertext> out) const {
+  YACL_ENFORCE_EQ(out.size(), a.size(), "output size mismatch");
+  for (const auto &ct : a) {
+    VALIDATE(ct);
+  }
+
+  yacl::parallel_for(0, a.size(), [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      const auto &p = p_at(i);
+      auto p_bits = p.BitCount();
+      if (p_bits == 0) {
+        out[i].c_ = pk_->m_space_->Identity();
+      } else if (p_bits == 1) {
+        if (&out[i] != &a[i]) {
+          out[i].c_ = a[i].c_;
+        }
+      } else {
+        BigInt c(a[i].c_);
+        pk_->m_space_->MapBackToZSpace(c);
+        out[i].c_ = c.PowMod(p.Abs(), pk_->n_);
+        pk_->m_space_->MapIntoMSpace(out[i].c_);
+      }
+    }
+  });
+
+  // c^p = (c^-1)^|p|, invert all outputs of negative p with one inversion
+  // per chunk
+  std::vector<BigInt *> negs;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (p_at(i).IsNegative()) {
+      negs.push_back(&out[i].c_);
+    }
+  }
+  BatchInvMod(*pk_->m_space_, pk_->n_, absl::MakeSpan(negs));
+}
+
+void Evaluator::Add(absl::Span<const Ciphertext> a, const Plaintext &p,
+                    absl::Span<Ciphertext> out) const {
+  YACL_ENFORCE(p.CompareAbs(pk_->PlaintextBound()) <= 0,
+               "plaintext number out of range, message={}, max (abs)={}",
+               p.ToHexString(), pk_->PlaintextBound());
+  for (const auto &ct : a) {
+    VALIDATE(ct);
+  }
+
+  // g^m is the same for all elements, compute it only once
+  BigInt gm = EncodeGm(p);
+  AddImpl(a, [&](int64_t) -> const BigInt & { return gm; }, out);
+}
+
+void Evaluator::Add(const Plaintext &p, absl::Span<const Ciphertext> b,
+                    absl::Span<Ciphertext> out) const {
+  Add(b, p, out);
+}
+
+void Evaluator::AddInplace(absl::Span<Ciphertext> a, const Plaintext &p) const {
+  Add(a, p, a);
+}
+
+void Evaluator::Add(absl::Span<const Ciphertext> a,
+                    absl::Span<const Plaintext> b,
+                    absl::Span<Ciphertext> out) const {
+  YACL_ENFORCE_EQ(a.size(), b.size(), "operands must have the same length");
+  for (size_t i = 0; i < a.size(); ++i) {
+    VALIDATE(a[i]);
+    YACL_ENFORCE(b[i].CompareAbs(pk_->PlaintextBound()) <= 0,
+                 "plaintext number out of range, message={}, max (abs)={}",
+                 b[i].ToHexString(), pk_->PlaintextBound());
+  }
+
+  AddImpl(a, [&](int64_t i) { return EncodeGm(b[i]); }, out);
+}
+
+void Evaluator::Sub(absl::Span<const Ciphertext> a, const Plaintext &p,
+                    absl::Span<Ciphertext> out) const {
+  Add(a, -p, out);
+}
+
+void Evaluator::SubInplace(absl::Span<Ciphertext> a, const Plaintext &p) const {
+  Add(a, -p, a);
+}
+
+void Evaluator::Mul(absl::Span<const Ciphertext> a, const Plaintext &p,
+                    absl::Span<Ciphertext> out) const {
+  MulImpl(a, [&](int64_t) -> const BigInt & { return p; }, out);
+}
+
+void Evaluator::Mul(const Plaintext &p, absl::Span<const Ciphertext> b,
+                    absl::Span<Ciphertext> out) const {
+  Mul(b, p, out);
+}
+
+void Evaluator::MulInplace(absl::Span<Ciphertext> a, const Plaintext &p) const {
+  Mul(a, p, a);
+}
+
+void Evaluator::Mul(absl::Span<const Ciphertext> a,
+                    absl::Span<const Plaintext> b,
+                    absl::Span<Ciphertext> out) const {
+  // No need to check size of p because ciphertext overflow is allowed
+  YACL_ENFORCE_EQ(a.size(), b.size(), "operands must have the same length");
+  MulImpl(a, [&](int64_t i) -> const BigInt & { return b[i]; }, out);
+}
+
 void Evaluator::Randomize(Ciphertext *ct) const {
   VALIDATE(*ct);
   ct->c_ = pk_->m_space_->MulMod(ct->c_, encryptor_.GetHr());
@@ -41,6 +41,29 @@ class Evaluator
   Ciphertext Mul(const Ciphertext &a, const Plaintext &b) const override;
   void MulInplace(Ciphertext *a, const Plaintext &b) const override;
 
+  // Broadcast kernels, b is preprocessed only once for the whole span
+  void Add(absl::Span<const Ciphertext> a, const Plaintext &b,
+           absl::Span<Ciphertext> out) const override;
+  void Add(const Plaintext &a, absl::Span<const Ciphertext> b,
+           absl::Span<Ciphertext> out) const override;
+  void AddInplace(absl::Span<Ciphertext> a, const Plaintext &b) const override;
+  void Sub(absl::Span<const Ciphertext> a, const Plaintext &b,
+           absl::Span<Ciphertext> out) const override;
+  void SubInplace(absl::Span<Ciphertext> a, const Plaintext &b) const override;
+  void Mul(absl::Span<const Ciphertext> a, const Plaintext &b,
+           absl::Span<Ciphertext> out) const override;
+  void Mul(const Plaintext &a, absl::Span<const Ciphertext> b,
+           absl::Span<Ciphertext> out) const override;
+  void MulInplace(absl::Span<Ciphertext> a, const Plaintext &b) const override;
+
+  // Element-wise out[i] = a[i] + b[i] and a[i] * b[i], out may alias a. They
+  // share the kernels of the broadcast versions, and VectorEvaluator forwards
+  // to them.
+  void Add(absl::Span<const Ciphertext> a, absl::Span<const Plaintext> b,
+           absl::Span<Ciphertext> out) const;
+  void Mul(absl::Span<const Ciphertext> a, absl::Span<const Plaintext> b,
+           absl::Span<Ciphertext> out) const;
+
   Plaintext Square(const Plaintext &a) const override;
   void SquareInplace(Plaintext *a) const override;
 
@@ -50,6 +73,17 @@ class Evaluator
   void Randomize(Ciphertext *ct) const override;
 
  private:
+  // gm_at(i) is g^m of element i in Montgomery form
+  template <typename GmAt>
+  void AddImpl(absl::Span<const Ciphertext> a, const GmAt &gm_at,
+               absl::Span<Ciphertext> out) const;
+  // p_at(i) is the scalar of element i
+  template <typename PtAt>
+  void MulImpl(absl::Span<const Ciphertext> a, const PtAt &p_at,
+               absl::Span<Ciphertext> out) const;
+  // g^m in Montgomery form
+  BigInt EncodeGm(const Plaintext &m) const;
+
   std::shared_ptr<PublicKey> pk_;
   Encryptor encryptor_;
 };
@@ -0,0 +1,40 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/algorithms/ou/vector_decryptor.h"
+
+#include "yacl/utils/parallel.h"
+
+namespace heu::algos::ou {
+
+void VectorDecryptor::Decrypt(const absl::Span<const Ciphertext> &cts,
+                              absl::Span<Plaintext> out) const {
+  YACL_ENFORCE_EQ(cts.size(), out.size(),
+                  "output size mismatch, cts.len={}, out.len={}", cts.size(),
+                  out.size());
+  yacl::parallel_for(0, cts.size(), [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      decryptor_.Decrypt(cts[i], &out[i]);
+    }
+  });
+}
+
+std::vector<Plaintext> VectorDecryptor::Decrypt(
+    const absl::Span<const Ciphertext> &cts) const {
+  std::vector<Plaintext> res(cts.size());
+  Decrypt(cts, absl::MakeSpan(res));
+  return res;
+}
+
+}  // namespace heu::algos::ou
@@ -0,0 +1,41 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "heu/algorithms/ou/base.h"
+#include "heu/algorithms/ou/decryptor.h"
+#include "heu/spi/he/sketches/vector/decryptor.h"
+
+namespace heu::algos::ou {
+
+class VectorDecryptor
+    : public spi::DecryptorVectorSketch<Plaintext, Ciphertext> {
+ public:
+  explicit VectorDecryptor(const std::shared_ptr<PublicKey> &pk,
+                           const std::shared_ptr<SecretKey> &sk)
+      : decryptor_(pk, sk) {}
+
+  void Decrypt(const absl::Span<const Ciphertext> &cts,
+               absl::Span<Plaintext> out) const override;
+  std::vector<Plaintext> Decrypt(
+      const absl::Span<const Ciphertext> &cts) const override;
+
+ private:
+  ou::Decryptor decryptor_;  // per-element kernels
+};
+
+}  // namespace heu::algos::ou
@@ -0,0 +1,63 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/algorithms/ou/vector_encryptor.h"
+
+#include "yacl/utils/parallel.h"
+
+namespace heu::algos::ou {
+
+std::vector<Ciphertext> VectorEncryptor::EncryptZeroT(size_t count) const {
+  std::vector<Ciphertext> res(count);
+  yacl::parallel_for(0, count, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      res[i] = encryptor_.EncryptZeroT();
+    }
+  });
+  return res;
+}
+
+std::vector<Ciphertext> VectorEncryptor::Encrypt(
+    const absl::Span<const Plaintext> &pts) const {
+  std::vector<Ciphertext> res(pts.size());
+  Encrypt(pts, absl::MakeSpan(res));
+  return res;
+}
+
+void VectorEncryptor::Encrypt(const absl::Span<const Plaintext> &pts,
+                              absl::Span<Ciphertext> out) const {
+  YACL_ENFORCE_EQ(pts.size(), out.size(),
+                  "output size mismatch, pts.len={}, out.len={}", pts.size(),
+                  out.size());
+  yacl::parallel_for(0, pts.size(), [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      encryptor_.Encrypt(pts[i], &out[i]);
+    }
+  });
+}
+
+void VectorEncryptor::EncryptWithAudit(
+    const absl::Span<const Plaintext> &pts, absl::Span<Ciphertext> ct_out,
+    absl::Span<std::string> audit_out) const {
+  YACL_ENFORCE(pts.size() == ct_out.size() && pts.size() == audit_out.size(),
+               "output size mismatch, pts.len={}, ct.len={}, audit.len={}",
+               pts.size(), ct_out.size(), audit_out.size());
+  yacl::parallel_for(0, pts.size(), [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      encryptor_.EncryptWithAudit(pts[i], &ct_out[i], &audit_out[i]);
+    }
+  });
+}
+
+}  // namespace heu::algos::ou
@@ -0,0 +1,48 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "heu/algorithms/ou/base.h"
+#include "heu/algorithms/ou/encryptor.h"
+#include "heu/spi/he/sketches/vector/phe/encryptor.h"
+
+namespace heu::algos::ou {
+
+class VectorEncryptor
+    : public spi::PheEncryptorVectorSketch<Plaintext, Ciphertext> {
+ public:
+  explicit VectorEncryptor(const std::shared_ptr<PublicKey> &pk)
+      : encryptor_(pk) {}
+
+  [[nodiscard]] std::vector<Ciphertext> EncryptZeroT(
+      size_t count) const override;
+
+  [[nodiscard]] std::vector<Ciphertext> Encrypt(
+      const absl::Span<const Plaintext> &pts) const override;
+  void Encrypt(const absl::Span<const Plaintext> &pts,
+               absl::Span<Ciphertext> out) const override;
+
+  void EncryptWithAudit(const absl::Span<const Plaintext> &pts,
+                        absl::Span<Ciphertext> ct_out,
+                        absl::Span<std::string> audit_out) const override;
+
+ private:
+  ou::Encryptor encryptor_;  // per-element kernels
+};
+
+}  // namespace heu::algos::ou
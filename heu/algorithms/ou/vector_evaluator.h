@@ -0,0 +1,96 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "heu/algorithms/ou/base.h"
+#include "heu/algorithms/ou/encryptor.h"
+#include "heu/algorithms/ou/evaluator.h"
+#include "heu/spi/he/sketches/vector/phe/word_evaluator.h"
+
+namespace heu::algos::ou {
+
+class VectorEvaluator
+    : public spi::PheWordEvaluatorVectorSketch<Plaintext, Ciphertext> {
+ public:
+  explicit VectorEvaluator(const std::shared_ptr<PublicKey> &pk)
+      : pk_(pk), encryptor_(pk), evaluator_(pk) {}
+
+  std::vector<Plaintext> Negate(
+      const absl::Span<const Plaintext> &a) const override;
+  void NegateInplace(absl::Span<Plaintext> a) const override;
+  std::vector<Ciphertext> Negate(
+      const absl::Span<const Ciphertext> &a) const override;
+  void NegateInplace(absl::Span<Ciphertext> a) const override;
+
+  std::vector<Plaintext> Add(
+      const absl::Span<const Plaintext> &a,
+      const absl::Span<const Plaintext> &b) const override;
+  std::vector<Ciphertext> Add(
+      const absl::Span<const Ciphertext> &a,
+      const absl::Span<const Plaintext> &b) const override;
+  std::vector<Ciphertext> Add(
+      const absl::Span<const Ciphertext> &a,
+      const absl::Span<const Ciphertext> &b) const override;
+  void AddInplace(absl::Span<Ciphertext> a,
+                  const absl::Span<const Plaintext> &b) const override;
+  void AddInplace(absl::Span<Ciphertext> a,
+                  const absl::Span<const Ciphertext> &b) const override;
+
+  std::vector<Plaintext> Mul(
+      const absl::Span<const Plaintext> &a,
+      const absl::Span<const Plaintext> &b) const override;
+  std::vector<Ciphertext> Mul(
+      const absl::Span<const Ciphertext> &a,
+      const absl::Span<const Plaintext> &b) const override;
+  void MulInplace(absl::Span<Ciphertext> a,
+                  const absl::Span<const Plaintext> &b) const override;
+
+  // Broadcast a plaintext, forwarded to the kernels of the scalar evaluator
+  // as the element-wise ciphertext-plaintext ops above
+  std::vector<Ciphertext> Add(const absl::Span<const Ciphertext> &a,
+                              const Plaintext &b) const override;
+  void AddInplace(absl::Span<Ciphertext> a, const Plaintext &b) const override;
+  std::vector<Ciphertext> Mul(const absl::Span<const Ciphertext> &a,
+                              const Plaintext &b) const override;
+  void MulInplace(absl::Span<Ciphertext> a, const Plaintext &b) const override;
+
+  std::vector<Plaintext> Square(
+      const absl::Span<const Plaintext> &a) const override;
+  void SquareInplace(absl::Span<Plaintext> a) const override;
+
+  std::vector<Plaintext> Pow(const absl::Span<const Plaintext> &a,
+                             int64_t exponent) const override;
+  void PowInplace(absl::Span<Plaintext> a, int64_t exponent) const override;
+
+  void Randomize(absl::Span<Ciphertext> ct) const override;
+
+  // Returns sum(a[i] * b[i]) in one multi-exponentiation, i.e. the squarings
+  // of prod(a[i]^b[i]) are shared by the whole vector
+  Ciphertext MulSum(absl::Span<const Ciphertext> a,
+                    absl::Span<const Plaintext> b) const;
+
+ private:
+  // out may alias a
+  void AddImpl(absl::Span<const Ciphertext> a, absl::Span<const Ciphertext> b,
+               absl::Span<Ciphertext> out) const;
+
+  std::shared_ptr<PublicKey> pk_;
+  Encryptor encryptor_;
+  Evaluator evaluator_;  // ciphertext-plaintext kernels
+};
+
+}  // namespace heu::algos::ou
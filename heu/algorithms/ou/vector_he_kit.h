@@ -0,0 +1,34 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "heu/algorithms/ou/he_kit.h"
+
+namespace heu::algos::ou {
+
+// Same keys and wire format as HeKit, but the operators take a whole vector of
+// items at a time, so batch algorithms (e.g. batch inversion) can be applied
+class VectorHeKit : public HeKit {
+ public:
+  std::string GetLibraryName() const override;
+
+  static std::unique_ptr<spi::HeKit> Create(spi::Schema schema,
+                                            const spi::SpiArgs &args);
+
+ protected:
+  void InitOperators() override;
+};
+
+}  // namespace heu::algos::ou
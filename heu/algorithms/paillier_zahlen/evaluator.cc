@@ -14,7 +14,12 @@
 
 #include "heu/algorithms/paillier_zahlen/evaluator.h"
 
+#include <vector>
+
+#include "yacl/utils/parallel.h"
+
 #include "heu/algorithms/common/he_assert.h"
+#include "heu/algorithms/common/mont_batch.h"
 
 namespace heu::algos::paillier_z {
 
@@ -113,6 +118,133 @@ void Evaluator::MulInplace(Ciphertext *a, const Plaintext &p) const {
   *a = Mul(*a, p);
 }
 
+template <typename PtAt>
+void Evaluator::AddImpl(absl::Span<const Ciphertext> a, const PtAt &m_at,
+                        absl::Span<Ciphertext> out) const {
+  YACL_ENFORCE_EQ(out.size(), a.size(), "output size mismatch");
+  // Let X be the Montgomery form of c, then the Montgomery form of g^m * c is
+  //   (1 + n*m) * X = X + n * (m * X mod n)  (mod n^2)
+  // so each element costs one n-bit MulMod instead of an n^2-bit one
+  const auto &n = pk_->n_;
+  const auto &n_square = pk_->n_square_;
+  yacl::parallel_for(0, a.size(), [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      BigInt c = a[i].c_ + n * m_at(i).MulMod(a[i].c_, n);
+      if (c >= n_square) {
+        c -= n_square;
+      }
+      out[i].c_ = std::move(c);
+    }
+  });
+}
+
+template <typename PtAt>
+void Evaluator::MulImpl(absl::Span<const Ciphertext> a, const PtAt &p_at,
+                        absl::Span<Ciphertext> out) const {
+  YACL_ENFORCE_EQ(out.size(), a.size(), "output size mismatch");
+  for (const auto &ct : a) {
+    VALIDATE(ct);
+  }
+
+  yacl::parallel_for(0, a.size(), [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      const auto &p = p_at(i);
+      auto p_bits = p.BitCount();
+      if (p_bits == 0) {
+        out[i].c_ = pk_->m_space_->Identity();
+      } else if (p_bits == 1) {
+        if (&out[i] != &a[i]) {
+          out[i].c_ = a[i].c_;
+        }
+      } else {
+        BigInt c(a[i].c_);
+        pk_->m_space_->MapBackToZSpace(c);
+        out[i].c_ = c.PowMod(p.Abs(), pk_->n_square_);
+        pk_->m_space_->MapIntoMSpace(out[i].c_);
+      }
+    }
+  });
+
+  // c^p = (c^-1)^|p|, invert all outputs of negative p with one inversion
+  // per chunk
+  std::vector<BigInt *> negs;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (p_at(i).IsNegative()) {
+      negs.push_back(&out[i].c_);
+    }
+  }
+  BatchInvMod(*pk_->m_space_, pk_->n_square_, absl::MakeSpan(negs));
+}
+
+void Evaluator::Add(absl::Span<const Ciphertext> a, const Plaintext &p,
+                    absl::Span<Ciphertext> out) const {
+  YACL_ENFORCE(p.CompareAbs(pk_->PlaintextBound()) <= 0,
+               "plaintext out of range, message={}, max (abs)={}",
+               p.ToHexString(), pk_->PlaintextBound());
+  for (const auto &ct : a) {
+    VALIDATE(ct);
+  }
+
+  BigInt m = p.IsNegative() ? p + pk_->n_ : p;
+  AddImpl(a, [&](int64_t) -> const BigInt & { return m; }, out);
+}
+
+void Evaluator::Add(const Plaintext &p, absl::Span<const Ciphertext> b,
+                    absl::Span<Ciphertext> out) const {
+  Add(b, p, out);
+}
+
+void Evaluator::AddInplace(absl::Span<Ciphertext> a, const Plaintext &p) const {
+  Add(a, p, a);
+}
+
+void Evaluator::Add(absl::Span<const Ciphertext> a,
+                    absl::Span<const Plaintext> b,
+                    absl::Span<Ciphertext> out) const {
+  YACL_ENFORCE_EQ(a.size(), b.size(), "operands must have the same length");
+  for (size_t i = 0; i < a.size(); ++i) {
+    VALIDATE(a[i]);
+    YACL_ENFORCE(b[i].CompareAbs(pk_->PlaintextBound()) <= 0,
+                 "plaintext out of range, message={}, max (abs)={}",
+                 b[i].ToHexString(), pk_->PlaintextBound());
+  }
+
+  const auto &n = pk_->n_;
+  AddImpl(
+      a, [&](int64_t i) { return b[i].IsNegative() ? b[i] + n : b[i]; }, out);
+}
+
+void Evaluator::Sub(absl::Span<const Ciphertext> a, const Plaintext &p,
+                    absl::Span<Ciphertext> out) const {
+  Add(a, -p, out);
+}
+
+void Evaluator::SubInplace(absl::Span<Ciphertext> a, const Plaintext &p) const {
+  Add(a, -p, a);
+}
+
+void Evaluator::Mul(absl::Span<const Ciphertext> a, const Plaintext &p,
+                    absl::Span<Ciphertext> out) const {
+  MulImpl(a, [&](int64_t) -> const BigInt & { return p; }, out);
+}
+
+void Evaluator::Mul(const Plaintext &p, absl::Span<const Ciphertext> b,
+                    absl::Span<Ciphertext> out) const {
+  Mul(b, p, out);
+}
+
+void Evaluator::MulInplace(absl::Span<Ciphertext> a, const Plaintext &p) const {
+  Mul(a, p, a);
+}
+
+void Evaluator::Mul(absl::Span<const Ciphertext> a,
+                    absl::Span<const Plaintext> b,
+                    absl::Span<Ciphertext> out) const {
+  // No need to check size of p because ciphertext overflow is allowed
+  YACL_ENFORCE_EQ(a.size(), b.size(), "operands must have the same length");
+  MulImpl(a, [&](int64_t i) -> const BigInt & { return b[i]; }, out);
+}
+
 void Evaluator::Randomize(Ciphertext *ct) const {
   VALIDATE(*ct);
   ct->c_ = pk_->m_space_->MulMod(ct->c_, encryptor_.GetRn());
@@ -48,23 +48,27 @@ std::unique_ptr<spi::HeKit> HeKit::Create(spi::Schema schema,
                                           const spi::SpiArgs &args) {
   YACL_ENFORCE(schema == spi::Schema::Paillier, "Schema {} not supported by {}",
                schema, kLibName);
+
+  auto kit = std::make_unique<HeKit>();
+  kit->InitKeys(args);
+  kit->InitOperators();
+  return kit;
+}
+
+void HeKit::InitKeys(const spi::SpiArgs &args) {
   YACL_ENFORCE(
       args.Exist(spi::ArgGenNewPkSk) || args.Exist(spi::ArgPkFrom),
       "Neither ArgGenNewPkSk nor ArgPkFrom is set, you must set one of them");
 
-  auto kit = std::make_unique<HeKit>();
   if (args.GetOptional(spi::ArgGenNewPkSk) == true) {
-    kit->GenPkSk(args.GetOrDefault(spi::ArgKeySize, 2048));
+    GenPkSk(args.GetOrDefault(spi::ArgKeySize, 2048));
   } else {
     // recover pk/sk from buffer
-    kit->pk_ = PublicKey::LoadFrom(args.GetRequired(spi::ArgPkFrom));
+    pk_ = PublicKey::LoadFrom(args.GetRequired(spi::ArgPkFrom));
     if (args.Exist(spi::ArgSkFrom)) {
-      kit->sk_ = SecretKey::LoadFrom(args.GetRequired(spi::ArgSkFrom));
+      sk_ = SecretKey::LoadFrom(args.GetRequired(spi::ArgSkFrom));
     }
   }
-
-  kit->InitOperators();
-  return kit;
 }
 
 void HeKit::InitOperators() {
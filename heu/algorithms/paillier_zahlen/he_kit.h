@@ -36,8 +36,10 @@ class HeKit : public spi::PheHeKitSketch<Plaintext, SecretKey, PublicKey> {
                                             const spi::SpiArgs &args);
   static bool Check(spi::Schema schema, const spi::SpiArgs &);
 
- private:
-  void InitOperators();
+ protected:
+  // Generates or loads pk/sk according to args
+  void InitKeys(const spi::SpiArgs &args);
+  virtual void InitOperators();
 
   void GenPkSk(size_t key_size);
 };
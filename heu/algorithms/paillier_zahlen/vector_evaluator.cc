@@ -0,0 +1,222 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/algorithms/paillier_zahlen/vector_evaluator.h"
+
+#include "yacl/utils/parallel.h"
+
+#include "heu/algorithms/common/he_assert.h"
+#include "heu/algorithms/common/mont_batch.h"
+
+namespace heu::algos::paillier_z {
+
+#define VALIDATE(ct)                                           \
+  HE_ASSERT(!(ct).c_.IsNegative() && (ct).c_ < pk_->n_square_, \
+            "Evaluator: Invalid ciphertext")
+
+#define ENFORCE_SAME_LENGTH(a, b)                                           \
+  YACL_ENFORCE_EQ((a).size(), (b).size(),                                   \
+                  "operands must have the same length, a.len={}, b.len={}", \
+                  (a).size(), (b).size())
+
+std::vector<Plaintext> VectorEvaluator::Negate(
+    const absl::Span<const Plaintext> &a) const {
+  std::vector<Plaintext> res;
+  res.reserve(a.size());
+  for (const auto &pt : a) {
+    res.push_back(-pt);
+  }
+  return res;
+}
+
+void VectorEvaluator::NegateInplace(absl::Span<Plaintext> a) const {
+  for (auto &pt : a) {
+    pt.NegateInplace();
+  }
+}
+
+std::vector<Ciphertext> VectorEvaluator::Negate(
+    const absl::Span<const Ciphertext> &a) const {
+  std::vector<Ciphertext> res(a.begin(), a.end());
+  NegateInplace(absl::MakeSpan(res));
+  return res;
+}
+
+void VectorEvaluator::NegateInplace(absl::Span<Ciphertext> a) const {
+  std::vector<BigInt *> xs;
+  xs.reserve(a.size());
+  for (auto &ct : a) {
+    VALIDATE(ct);
+    xs.push_back(&ct.c_);
+  }
+  BatchInvMod(*pk_->m_space_, pk_->n_square_, absl::MakeSpan(xs));
+}
+
+std::vector<Plaintext> VectorEvaluator::Add(
+    const absl::Span<const Plaintext> &a,
+    const absl::Span<const Plaintext> &b) const {
+  ENFORCE_SAME_LENGTH(a, b);
+  std::vector<Plaintext> res;
+  res.reserve(a.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    res.push_back(a[i] + b[i]);
+  }
+  return res;
+}
+
+std::vector<Ciphertext> VectorEvaluator::Add(
+    const absl::Span<const Ciphertext> &a,
+    const absl::Span<const Plaintext> &b) const {
+  std::vector<Ciphertext> res(a.size());
+  evaluator_.Add(a, b, absl::MakeSpan(res));
+  return res;
+}
+
+std::vector<Ciphertext> VectorEvaluator::Add(
+    const absl::Span<const Ciphertext> &a,
+    const absl::Span<const Ciphertext> &b) const {
+  std::vector<Ciphertext> res(a.size());
+  AddImpl(a, b, absl::MakeSpan(res));
+  return res;
+}
+
+void VectorEvaluator::AddInplace(absl::Span<Ciphertext> a,
+                                 const absl::Span<const Plaintext> &b) const {
+  evaluator_.Add(a, b, a);
+}
+
+void VectorEvaluator::AddInplace(absl::Span<Ciphertext> a,
+                                 const absl::Span<const Ciphertext> &b) const {
+  AddImpl(a, b, a);
+}
+
+void VectorEvaluator::AddImpl(absl::Span<const Ciphertext> a,
+                              absl::Span<const Ciphertext> b,
+                              absl::Span<Ciphertext> out) const {
+  ENFORCE_SAME_LENGTH(a, b);
+  for (size_t i = 0; i < a.size(); ++i) {
+    VALIDATE(a[i]);
+    VALIDATE(b[i]);
+  }
+
+  yacl::parallel_for(0, a.size(), [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      out[i].c_ = pk_->m_space_->MulMod(a[i].c_, b[i].c_);
+    }
+  });
+}
+
+std::vector<Plaintext> VectorEvaluator::Mul(
+    const absl::Span<const Plaintext> &a,
+    const absl::Span<const Plaintext> &b) const {
+  ENFORCE_SAME_LENGTH(a, b);
+  std::vector<Plaintext> res;
+  res.reserve(a.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    res.push_back(a[i] * b[i]);
+  }
+  return res;
+}
+
+std::vector<Ciphertext> VectorEvaluator::Mul(
+    const absl::Span<const Ciphertext> &a,
+    const absl::Span<const Plaintext> &b) const {
+  std::vector<Ciphertext> res(a.size());
+  evaluator_.Mul(a, b, absl::MakeSpan(res));
+  return res;
+}
+
+void VectorEvaluator::MulInplace(absl::Span<Ciphertext> a,
+                                 const absl::Span<const Plaintext> &b) const {
+  evaluator_.Mul(a, b, a);
+}
+
+std::vector<Ciphertext> VectorEvaluator::Add(
+    const absl::Span<const Ciphertext> &a, const Plaintext &b) const {
+  std::vector<Ciphertext> res(a.size());
+  evaluator_.Add(a, b, absl::MakeSpan(res));
+  return res;
+}
+
+void VectorEvaluator::AddInplace(absl::Span<Ciphertext> a,
+                                 const Plaintext &b) const {
+  evaluator_.AddInplace(a, b);
+}
+
+std::vector<Ciphertext> VectorEvaluator::Mul(
+    const absl::Span<const Ciphertext> &a, const Plaintext &b) const {
+  std::vector<Ciphertext> res(a.size());
+  evaluator_.Mul(a, b, absl::MakeSpan(res));
+  return res;
+}
+
+void VectorEvaluator::MulInplace(absl::Span<Ciphertext> a,
+                                 const Plaintext &b) const {
+  evaluator_.MulInplace(a, b);
+}
+
+void VectorEvaluator::Randomize(absl::Span<Ciphertext> ct) const {
+  for (const auto &c : ct) {
+    VALIDATE(c);
+  }
+  yacl::parallel_for(0, ct.size(), [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      ct[i].c_ = pk_->m_space_->MulMod(ct[i].c_, encryptor_.GetRn());
+    }
+  });
+}
+
+std::vector<Plaintext> VectorEvaluator::Square(
+    const absl::Span<const Plaintext> &a) const {
+  return Pow(a, 2);
+}
+
+void VectorEvaluator::SquareInplace(absl::Span<Plaintext> a) const {
+  PowInplace(a, 2);
+}
+
+std::vector<Plaintext> VectorEvaluator::Pow(
+    const absl::Span<const Plaintext> &a, int64_t exponent) const {
+  std::vector<Plaintext> res;
+  res.reserve(a.size());
+  for (const auto &pt : a) {
+    res.push_back(pt.Pow(exponent));
+  }
+  return res;
+}
+
+void VectorEvaluator::PowInplace(absl::Span<Plaintext> a,
+                                 int64_t exponent) const {
+  for (auto &pt : a) {
+    pt.PowInplace(exponent);
+  }
+}
+
+Ciphertext VectorEvaluator::MulSum(absl::Span<const Ciphertext> a,
+                                   absl::Span<const Plaintext> b) const {
+  ENFORCE_SAME_LENGTH(a, b);
+  std::vector<const BigInt *> bases;
+  bases.reserve(a.size());
+  for (const auto &ct : a) {
+    VALIDATE(ct);
+    bases.push_back(&ct.c_);
+  }
+
+  Ciphertext out;
+  out.c_ = MultiPowMod(*pk_->m_space_, pk_->n_square_, absl::MakeSpan(bases),
+                       b);
+  return out;
+}
+
+}  // namespace heu::algos::paillier_z
@@ -0,0 +1,57 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/algorithms/paillier_zahlen/vector_he_kit.h"
+
+#include "heu/algorithms/paillier_zahlen/vector_decryptor.h"
+#include "heu/algorithms/paillier_zahlen/vector_encryptor.h"
+#include "heu/algorithms/paillier_zahlen/vector_evaluator.h"
+#include "heu/spi/he/he.h"
+
+namespace heu::algos::paillier_z {
+
+namespace {
+const std::string kLibName = "paillier_zahlen_vector";  // do not change
+}  // namespace
+
+std::string VectorHeKit::GetLibraryName() const { return kLibName; }
+
+std::unique_ptr<spi::HeKit> VectorHeKit::Create(spi::Schema schema,
+                                                const spi::SpiArgs &args) {
+  YACL_ENFORCE(schema == spi::Schema::Paillier, "Schema {} not supported by {}",
+               schema, kLibName);
+
+  auto kit = std::make_unique<VectorHeKit>();
+  kit->InitKeys(args);
+  kit->InitOperators();
+  return kit;
+}
+
+void VectorHeKit::InitOperators() {
+  item_tool_ = std::make_shared<ItemTool>();
+
+  if (pk_) {
+    encryptor_ = std::make_shared<VectorEncryptor>(pk_);
+    word_evaluator_ = std::make_shared<VectorEvaluator>(pk_);
+
+    if (sk_) {
+      decryptor_ = std::make_shared<VectorDecryptor>(pk_, sk_);
+    }
+  }
+}
+
+// Ranks above the scalar lib, so it is the default for Paillier
+REGISTER_HE_LIBRARY(kLibName, 110, HeKit::Check, VectorHeKit::Create);
+
+}  // namespace heu::algos::paillier_z
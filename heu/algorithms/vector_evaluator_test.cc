@@ -0,0 +1,209 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "heu/algorithms/ou/evaluator.h"
+#include "heu/algorithms/ou/vector_decryptor.h"
+#include "heu/algorithms/ou/vector_encryptor.h"
+#include "heu/algorithms/ou/vector_evaluator.h"
+#include "heu/algorithms/paillier_zahlen/evaluator.h"
+#include "heu/algorithms/paillier_zahlen/vector_decryptor.h"
+#include "heu/algorithms/paillier_zahlen/vector_encryptor.h"
+#include "heu/algorithms/paillier_zahlen/vector_evaluator.h"
+#include "heu/spi/he/he.h"
+
+namespace heu::algos::test {
+
+struct PaillierZ {
+  using PublicKey = paillier_z::PublicKey;
+  using Ciphertext = paillier_z::Ciphertext;
+  using Evaluator = paillier_z::Evaluator;
+  using VectorEncryptor = paillier_z::VectorEncryptor;
+  using VectorEvaluator = paillier_z::VectorEvaluator;
+  using VectorDecryptor = paillier_z::VectorDecryptor;
+
+  static constexpr spi::Schema kSchema = spi::Schema::Paillier;
+  static constexpr const char *kLib = "paillier_zahlen_vector";
+};
+
+struct Ou {
+  using PublicKey = ou::PublicKey;
+  using Ciphertext = ou::Ciphertext;
+  using Evaluator = ou::Evaluator;
+  using VectorEncryptor = ou::VectorEncryptor;
+  using VectorEvaluator = ou::VectorEvaluator;
+  using VectorDecryptor = ou::VectorDecryptor;
+
+  static constexpr spi::Schema kSchema = spi::Schema::OU;
+  static constexpr const char *kLib = "ou_vector";
+};
+
+// Every vector op is checked against the scalar Evaluator of the same key
+template <typename T>
+class VectorEvaluatorTest : public ::testing::Test {
+ protected:
+  using Ciphertext = typename T::Ciphertext;
+
+  void SetUp() override {
+    kit_ = spi::HeFactory::Instance().Create(
+        T::kSchema, spi::ArgLib = std::string(T::kLib),
+        spi::ArgGenNewPkSk = true, spi::ArgKeySize = 1024);
+    encryptor_ = std::dynamic_pointer_cast<typename T::VectorEncryptor>(
+        kit_->GetEncryptor());
+    evaluator_ = std::dynamic_pointer_cast<typename T::VectorEvaluator>(
+        kit_->GetWordEvaluator());
+    decryptor_ = std::dynamic_pointer_cast<typename T::VectorDecryptor>(
+        kit_->GetDecryptor());
+    ASSERT_TRUE(encryptor_ && evaluator_ && decryptor_);
+
+    scalar_ = std::make_shared<typename T::Evaluator>(
+        std::make_shared<typename T::PublicKey>(
+            kit_->GetPublicKey().template As<typename T::PublicKey>()));
+
+    // mixed signs, zero and +-1, so every special case of Mul is hit
+    for (int64_t i = -8; i < 9; ++i) {
+      pts_.emplace_back(i * 100003);
+      scalars_.emplace_back(i % 3 == 0 ? i : i * 7919);
+    }
+    scalars_[7] = BigInt(-1);
+    scalars_[9] = BigInt(1);
+    cts_ = encryptor_->Encrypt(pts_);
+  }
+
+  std::vector<BigInt> Decrypt(const std::vector<Ciphertext> &cts) {
+    return decryptor_->Decrypt(cts);
+  }
+
+  std::unique_ptr<spi::HeKit> kit_;
+  std::shared_ptr<typename T::VectorEncryptor> encryptor_;
+  std::shared_ptr<typename T::VectorEvaluator> evaluator_;
+  std::shared_ptr<typename T::VectorDecryptor> decryptor_;
+  std::shared_ptr<typename T::Evaluator> scalar_;
+
+  std::vector<BigInt> pts_;
+  std::vector<BigInt> scalars_;
+  std::vector<Ciphertext> cts_;
+};
+
+using Schemes = ::testing::Types<PaillierZ, Ou>;
+TYPED_TEST_SUITE(VectorEvaluatorTest, Schemes);
+
+TYPED_TEST(VectorEvaluatorTest, NegateMatchesScalar) {
+  auto cts = this->cts_;
+  this->evaluator_->NegateInplace(absl::MakeSpan(cts));
+  for (size_t i = 0; i < cts.size(); ++i) {
+    EXPECT_EQ(cts[i], this->scalar_->Negate(this->cts_[i])) << "i=" << i;
+  }
+
+  auto pts = this->Decrypt(cts);
+  for (size_t i = 0; i < pts.size(); ++i) {
+    EXPECT_EQ(pts[i], -this->pts_[i]);
+  }
+  EXPECT_EQ(this->evaluator_->Negate(this->cts_), cts);
+}
+
+TYPED_TEST(VectorEvaluatorTest, MulMatchesScalar) {
+  auto res = this->evaluator_->Mul(this->cts_, this->scalars_);
+  ASSERT_EQ(res.size(), this->cts_.size());
+  for (size_t i = 0; i < res.size(); ++i) {
+    EXPECT_EQ(res[i], this->scalar_->Mul(this->cts_[i], this->scalars_[i]))
+        << "i=" << i << ", p=" << this->scalars_[i].ToString();
+  }
+
+  auto pts = this->Decrypt(res);
+  for (size_t i = 0; i < pts.size(); ++i) {
+    EXPECT_EQ(pts[i], this->pts_[i] * this->scalars_[i]);
+  }
+
+  auto cts = this->cts_;
+  this->evaluator_->MulInplace(absl::MakeSpan(cts), this->scalars_);
+  EXPECT_EQ(cts, res);
+
+  // broadcast scalars take the same kernels
+  for (const auto &p : {BigInt(0), BigInt(1), BigInt(-1), BigInt(-12345)}) {
+    res = this->evaluator_->Mul(this->cts_, p);
+    for (size_t i = 0; i < res.size(); ++i) {
+      EXPECT_EQ(res[i], this->scalar_->Mul(this->cts_[i], p))
+          << "p=" << p.ToString();
+    }
+  }
+}
+
+TYPED_TEST(VectorEvaluatorTest, AddMatchesScalar) {
+  auto res = this->evaluator_->Add(this->cts_, this->scalars_);
+  for (size_t i = 0; i < res.size(); ++i) {
+    EXPECT_EQ(res[i], this->scalar_->Add(this->cts_[i], this->scalars_[i]));
+  }
+
+  // out aliases a
+  auto cts = this->cts_;
+  auto other = this->encryptor_->Encrypt(this->scalars_);
+  this->evaluator_->AddInplace(absl::MakeSpan(cts), other);
+  for (size_t i = 0; i < cts.size(); ++i) {
+    EXPECT_EQ(cts[i], this->scalar_->Add(this->cts_[i], other[i]));
+  }
+
+  // out aliases both a and b
+  cts = this->cts_;
+  this->evaluator_->AddInplace(absl::MakeSpan(cts), cts);
+  auto pts = this->Decrypt(cts);
+  for (size_t i = 0; i < pts.size(); ++i) {
+    EXPECT_EQ(pts[i], this->pts_[i] + this->pts_[i]);
+  }
+}
+
+TYPED_TEST(VectorEvaluatorTest, SizeMismatchThrows) {
+  auto short_pts = absl::MakeConstSpan(this->scalars_).first(3);
+  auto short_cts = absl::MakeConstSpan(this->cts_).first(3);
+  auto cts = this->cts_;
+  auto out = absl::MakeSpan(cts);
+  const auto &eval = this->evaluator_;
+
+  EXPECT_ANY_THROW(eval->Add(this->cts_, short_pts));
+  EXPECT_ANY_THROW(eval->Add(this->cts_, short_cts));
+  EXPECT_ANY_THROW(eval->AddInplace(out, short_pts));
+  EXPECT_ANY_THROW(eval->AddInplace(out, short_cts));
+  EXPECT_ANY_THROW(eval->Mul(this->cts_, short_pts));
+  EXPECT_ANY_THROW(eval->MulInplace(out, short_pts));
+  EXPECT_ANY_THROW(eval->MulSum(this->cts_, short_pts));
+}
+
+TYPED_TEST(VectorEvaluatorTest, MulSumWorks) {
+  BigInt expected(0);
+  auto acc = this->scalar_->Mul(this->cts_[0], this->scalars_[0]);
+  for (size_t i = 0; i < this->pts_.size(); ++i) {
+    expected += this->pts_[i] * this->scalars_[i];
+    if (i > 0) {
+      this->scalar_->AddInplace(
+          &acc, this->scalar_->Mul(this->cts_[i], this->scalars_[i]));
+    }
+  }
+
+  auto res = this->evaluator_->MulSum(this->cts_, this->scalars_);
+  EXPECT_EQ(res, acc);
+  EXPECT_EQ(this->decryptor_->Decrypt({res})[0], expected);
+
+  // a single term is a plain Mul
+  res = this->evaluator_->MulSum(
+      absl::MakeConstSpan(this->cts_).subspan(2, 1),
+      absl::MakeConstSpan(this->scalars_).subspan(2, 1));
+  EXPECT_EQ(res, this->scalar_->Mul(this->cts_[2], this->scalars_[2]));
+}
+
+}  // namespace heu::algos::test
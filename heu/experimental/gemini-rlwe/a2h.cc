@@ -14,15 +14,56 @@
 
 #include "heu/experimental/gemini-rlwe/a2h.h"
 
+#include <algorithm>
+
 #include "seal/evaluator.h"
 #include "seal/valcheck.h"
 #include "yacl/base/exception.h"
+#include "yacl/crypto/block_cipher/symmetric_crypto.h"
+#include "yacl/crypto/rand/rand.h"
+#include "yacl/utils/parallel.h"
 
 #include "heu/experimental/gemini-rlwe/modswitch_helper.h"
 #include "heu/experimental/gemini-rlwe/poly_encoder.h"
 
 namespace heu::expt::rlwe {
 
+// Uniform values mod prime from the AES-CTR stream `stream_id`, i.e. the
+// blocks AES_k(stream_id || j) for j = 0, 1, ... Each block gives two 64-bit
+// candidates that are rejection sampled as in UniformOverPrime(). Accepting is
+// branch-free, the rare shortfall is refilled from the same stream.
+static void UniformOverPrimeCtr(const yacl::crypto::SymmetricCrypto &aes,
+                                uint64_t stream_id, const seal::Modulus &prime,
+                                absl::Span<uint64_t> out) {
+  using namespace seal::util;
+  constexpr uint64_t max_random = static_cast<uint64_t>(0xFFFFFFFFFFFFFFFFULL);
+  // sample from [0, n*p) such that n*p ~ 2^64
+  auto max_multiple = max_random - barrett_reduce_64(max_random, prime) - 1;
+
+  std::vector<uint128_t> ctr;
+  std::vector<uint128_t> blocks;
+  uint64_t next_block = 0;
+  size_t filled = 0;
+  while (filled < out.size()) {
+    size_t need = out.size() - filled;
+    // the rejection rate is below 1/8 for the primes of SEAL (< 2^61)
+    size_t num_blocks = (need + need / 8 + 2) / 2;
+    ctr.resize(num_blocks);
+    blocks.resize(num_blocks);
+    for (size_t j = 0; j < num_blocks; ++j) {
+      ctr[j] = yacl::MakeUint128(stream_id, next_block + j);
+    }
+    next_block += num_blocks;
+    aes.Encrypt(absl::MakeConstSpan(ctr), absl::MakeSpan(blocks));
+
+    auto words = reinterpret_cast<const uint64_t *>(blocks.data());
+    for (size_t j = 0; j < 2 * num_blocks && filled < out.size(); ++j) {
+      out[filled] = barrett_reduce_64(words[j], prime);
+      filled += words[j] < max_multiple;
+    }
+  }
+}
+
 ShareConverter::ShareConverter(const seal::SEALContext &context,
                                std::shared_ptr<ModulusSwitchHelper> ms_helper)
     : context_(context),
@@ -73,6 +114,77 @@ void ShareConverter::DoA2H(RLWECt &rlwe, absl::Span<const T> shr) const {
   evaluator.add_plain_inplace(rlwe, pt);
 }
 
+template <typename T>
+void ShareConverter::DoBatchA2H(absl::Span<RLWECt> rlwes,
+                                absl::Span<const T> shr) const {
+  size_t n = context_.first_context_data()->parms().poly_modulus_degree();
+  size_t num_rlwes = rlwes.size();
+  YACL_ENFORCE(num_rlwes > 0 && shr.size() > (num_rlwes - 1) * n &&
+                   shr.size() <= num_rlwes * n,
+               fmt::format("A2H: {} shares do not match {} RLWECt", shr.size(),
+                           num_rlwes));
+  for (const auto &rlwe : rlwes) {
+    YACL_ENFORCE(seal::is_metadata_valid_for(rlwe, context_));
+    YACL_ENFORCE(!rlwe.is_ntt_form() && rlwe.size() == 2, "invalid RLWE");
+  }
+
+  yacl::parallel_for(0, num_rlwes, 1, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      DoA2H(rlwes[i], shr.subspan(i * n, n));
+    }
+  });
+}
+
+template <typename T>
+void ShareConverter::DoBatchH2A(absl::Span<LWECt> lwes,
+                                absl::Span<T> out) const {
+  YACL_ENFORCE_EQ(lwes.size(), out.size());
+  for (const auto &lwe : lwes) {
+    YACL_ENFORCE(lwe.IsValid() && lwe.parms_id() == context_.first_parms_id());
+  }
+  if (lwes.empty()) return;
+
+  uint32_t nbit = ms_helper_->base_mod_bitlen();
+  T mask = static_cast<T>(-1);
+  if (nbit < sizeof(T) * 8) {
+    mask = (static_cast<T>(1) << nbit) - 1;
+  }
+
+  const auto &modulus = context_.first_context_data()->parms().coeff_modulus();
+  size_t num_modulus = modulus.size();
+  // One fresh key per batch. The AES-CTR streams of the workers are told
+  // apart by the index of their first LWECt and the prime.
+  uint128_t key = yacl::crypto::SecureRandSeed();
+  constexpr int64_t kGrain = 64;
+  yacl::parallel_for(0, lwes.size(), kGrain, [&](int64_t beg, int64_t end) {
+    yacl::crypto::SymmetricCrypto aes(
+        yacl::crypto::SymmetricCrypto::CryptoType::AES128_ECB, key);
+    size_t count = end - beg;
+    // r[l * count + i] is uniform from [0, q_l), the layout ModulusDownRNS
+    // takes
+    std::vector<uint64_t> random(num_modulus * count);
+    for (size_t l = 0; l < num_modulus; ++l) {
+      UniformOverPrimeCtr(aes, beg * num_modulus + l, modulus[l],
+                          absl::MakeSpan(random.data() + l * count, count));
+    }
+
+    std::vector<uint64_t> plain(num_modulus);
+    for (size_t i = 0; i < count; ++i) {
+      for (size_t l = 0; l < num_modulus; ++l) {
+        plain[l] = random[l * count + i];
+      }
+      // LWE(Delta*m) + r
+      lwes[beg + i].AddPlainInplace(plain, context_);
+    }
+
+    // out = -round(r/Delta) mod 2^k
+    auto shr = out.subspan(beg, count);
+    ms_helper_->ModulusDownRNS(random, shr);
+    std::transform(shr.begin(), shr.end(), shr.begin(),
+                   [mask](T x) { return (-x) & mask; });
+  });
+}
+
 void ShareConverter::UniformOverPrime(absl::Span<uint64_t> out,
                                       const seal::Modulus &prime,
                                       U8PRNG prng) const {
@@ -115,4 +227,34 @@ void ShareConverter::A2H(RLWECt &rlwe, absl::Span<const uint128_t> shr) const {
   DoA2H<uint128_t>(rlwe, shr);
 }
 
+void ShareConverter::A2H(absl::Span<RLWECt> rlwes,
+                         absl::Span<const uint32_t> shr) const {
+  DoBatchA2H<uint32_t>(rlwes, shr);
+}
+
+void ShareConverter::A2H(absl::Span<RLWECt> rlwes,
+                         absl::Span<const uint64_t> shr) const {
+  DoBatchA2H<uint64_t>(rlwes, shr);
+}
+
+void ShareConverter::A2H(absl::Span<RLWECt> rlwes,
+                         absl::Span<const uint128_t> shr) const {
+  DoBatchA2H<uint128_t>(rlwes, shr);
+}
+
+void ShareConverter::H2A(absl::Span<LWECt> lwes,
+                         absl::Span<uint32_t> out) const {
+  DoBatchH2A<uint32_t>(lwes, out);
+}
+
+void ShareConverter::H2A(absl::Span<LWECt> lwes,
+                         absl::Span<uint64_t> out) const {
+  DoBatchH2A<uint64_t>(lwes, out);
+}
+
+void ShareConverter::H2A(absl::Span<LWECt> lwes,
+                         absl::Span<uint128_t> out) const {
+  DoBatchH2A<uint128_t>(lwes, out);
+}
+
 }  // namespace heu::expt::rlwe
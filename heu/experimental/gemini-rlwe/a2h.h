@@ -44,6 +44,24 @@ class ShareConverter {
 
   void H2A(LWECt &lwe, U8PRNG prng, uint128_t *out) const;
 
+  // Batched A2H over ciphertexts in parallel. rlwes[i] takes the shares
+  // shr[i*n, (i+1)*n), so shr.size() should be in ((m-1)*n, m*n] for m RLWECt.
+  void A2H(absl::Span<RLWECt> rlwes, absl::Span<const uint32_t> shr) const;
+
+  void A2H(absl::Span<RLWECt> rlwes, absl::Span<const uint64_t> shr) const;
+
+  void A2H(absl::Span<RLWECt> rlwes, absl::Span<const uint128_t> shr) const;
+
+  // Batched H2A over ciphertexts in parallel, e.g. the outputs of MatVec,
+  // out[i] is the share of lwes[i]. The masks come from AES-CTR under a fresh
+  // secure seed, with one key expansion per worker instead of a PRNG call per
+  // ciphertext and prime.
+  void H2A(absl::Span<LWECt> lwes, absl::Span<uint32_t> out) const;
+
+  void H2A(absl::Span<LWECt> lwes, absl::Span<uint64_t> out) const;
+
+  void H2A(absl::Span<LWECt> lwes, absl::Span<uint128_t> out) const;
+
  protected:
   template <typename T>
   void DoH2A(LWECt &lwe, U8PRNG prng, T *out) const;
@@ -51,6 +69,12 @@ class ShareConverter {
   template <typename T>
   void DoA2H(RLWECt &rlwe, absl::Span<const T> shr) const;
 
+  template <typename T>
+  void DoBatchH2A(absl::Span<LWECt> lwes, absl::Span<T> out) const;
+
+  template <typename T>
+  void DoBatchA2H(absl::Span<RLWECt> rlwes, absl::Span<const T> shr) const;
+
   void UniformOverPrime(absl::Span<uint64_t> out, const seal::Modulus &prime,
                         U8PRNG prng) const;
 
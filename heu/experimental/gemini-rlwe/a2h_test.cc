@@ -119,6 +119,60 @@ class A2HTest : public ::testing::TestWithParam<size_t> {
     }
   }
 
+  // x = x0 + x1 over a few ciphertexts: RLWE(x0), x1 -> RLWE(x) by the batched
+  // A2H, then the batched H2A on some of the LWECt.
+  template <typename T>
+  void TestBatch() {
+    const T mask = MakeMask<T>(std::min(sizeof(T) * 8, bitlen_));
+    const size_t num_rlwes = 3;
+    const size_t num_shares = (num_rlwes - 1) * poly_deg + 100;
+
+    std::vector<T> x0(num_shares);
+    std::vector<T> x1(num_shares);
+    UniformRand(x0.data(), num_shares, bitlen_);
+    UniformRand(x1.data(), num_shares, bitlen_);
+
+    PolyEncoder encoder(*context_, *ms_helper_);
+    seal::Encryptor encryptor(*context_, *rlwe_sk_);
+    seal::Evaluator evaluator(*context_);
+    LWEDecryptor decryptor(*lwe_sk_, *context_, ms_helper_);
+    ShareConverter shr_conv(*context_, ms_helper_);
+
+    std::vector<RLWECt> rlwes(num_rlwes);
+    for (size_t i = 0; i < num_rlwes; ++i) {
+      RLWEPt pt;
+      encoder.Forward(absl::MakeConstSpan(x0).subspan(i * poly_deg, poly_deg),
+                      &pt);
+      transform_to_ntt_inplace(pt, *context_);
+      encryptor.encrypt_symmetric(pt, rlwes[i]);
+      evaluator.transform_from_ntt_inplace(rlwes[i]);
+    }
+    shr_conv.A2H(absl::MakeSpan(rlwes), absl::MakeConstSpan(x1));
+
+    std::vector<size_t> indices;
+    std::vector<LWECt> lwes;
+    for (size_t k = 0; k < num_shares; k += 7) {
+      indices.push_back(k);
+      lwes.emplace_back(rlwes[k / poly_deg], k % poly_deg, *context_);
+    }
+    std::vector<T> shr0(lwes.size());
+    shr_conv.H2A(absl::MakeSpan(lwes), absl::MakeSpan(shr0));
+
+    for (size_t i = 0; i < lwes.size(); ++i) {
+      EXPECT_LE(shr0[i], mask);
+      T shr1;
+      decryptor.Decrypt(lwes[i], &shr1);
+      size_t k = indices[i];
+      ASSERT_EQ((shr0[i] + shr1) & mask, (x0[k] + x1[k]) & mask);
+    }
+
+    // m RLWECt take ((m-1)*n, m*n] shares
+    EXPECT_ANY_THROW(shr_conv.A2H(absl::MakeSpan(rlwes).subspan(0, 2),
+                                  absl::MakeConstSpan(x1)));
+    EXPECT_ANY_THROW(
+        shr_conv.H2A(absl::MakeSpan(lwes), absl::MakeSpan(shr0).subspan(1)));
+  }
+
   std::mt19937_64 rdv_;
   size_t bitlen_;
 
@@ -228,4 +282,14 @@ TEST_P(A2HTest, Basic) {
   }
 }
 
+TEST_P(A2HTest, Batch) {
+  if (bitlen_ <= 32) {
+    TestBatch<uint32_t>();
+  } else if (bitlen_ <= 64) {
+    TestBatch<uint64_t>();
+  } else {
+    TestBatch<uint128_t>();
+  }
+}
+
 }  // namespace heu::expt::rlwe::test
@@ -0,0 +1,209 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/experimental/gemini-rlwe/lwe_packer.h"
+
+#include <algorithm>
+
+#include "absl/numeric/bits.h"
+#include "seal/evaluator.h"
+#include "seal/util/ntt.h"
+#include "seal/util/uintarithsmallmod.h"
+#include "yacl/base/exception.h"
+#include "yacl/utils/parallel.h"
+
+namespace heu::expt::rlwe {
+
+static size_t Log2(size_t x) { return absl::bit_width(x) - 1; }
+
+std::vector<uint32_t> LWEPacker::GaloisElements(
+    const seal::SEALContext &context) {
+  YACL_ENFORCE(context.parameters_set());
+  size_t n = context.first_context_data()->parms().poly_modulus_degree();
+  std::vector<uint32_t> galois_elts;
+  for (size_t l = 1; l <= Log2(n); ++l) {
+    galois_elts.push_back((1U << l) + 1);
+  }
+  return galois_elts;
+}
+
+LWEPacker::LWEPacker(const seal::SEALContext &context,
+                     const seal::GaloisKeys &galois_keys)
+    : poly_deg_(context.first_context_data()->parms().poly_modulus_degree()),
+      context_(context),
+      galois_keys_(galois_keys) {
+  YACL_ENFORCE(context_.parameters_set());
+  YACL_ENFORCE(context_.using_keyswitching(),
+               "packing requires a context with a special prime");
+  // SEAL applies automorphisms on NTT-form ciphertexts for CKKS only
+  YACL_ENFORCE(context_.first_context_data()->parms().scheme() ==
+                   seal::scheme_type::ckks,
+               "only the ckks scheme is supported");
+  for (uint32_t galois_elt : GaloisElements(context_)) {
+    YACL_ENFORCE(galois_keys_.has_key(galois_elt),
+                 fmt::format("missing the galois key of {}", galois_elt));
+  }
+}
+
+size_t LWEPacker::PackedStride(size_t num_lwes) const {
+  YACL_ENFORCE(num_lwes > 0 && num_lwes <= poly_deg_,
+               fmt::format("can not pack {} LWECt into one RLWECt of degree {}",
+                           num_lwes, poly_deg_));
+  return poly_deg_ / absl::bit_ceil(num_lwes);
+}
+
+void LWEPacker::LWEToRLWE(const LWECt &lwe, RLWECt *out) const {
+  YACL_ENFORCE(lwe.IsValid(), "invalid LWECt");
+  YACL_ENFORCE(lwe.lazy_counter_ == 0, "call LWECt::Reduce() first");
+
+  auto cntxt_dat = context_.get_context_data(lwe.parms_id());
+  YACL_ENFORCE(cntxt_dat != nullptr, "invalid LWECt.parms_id for the context");
+  const auto &modulus = cntxt_dat->parms().coeff_modulus();
+  size_t n = poly_deg_;
+  size_t num_modulus = lwe.coeff_modulus_size();
+  YACL_ENFORCE_EQ(num_modulus, modulus.size());
+  YACL_ENFORCE_EQ(lwe.poly_modulus_degree(), n);
+
+  out->resize(context_, lwe.parms_id(), 2);
+  out->is_ntt_form() = false;
+  out->scale() = lwe.vec_.scale();
+  std::fill_n(out->data(0), 2 * n * num_modulus, 0);
+
+  // The LWE decrypts as b + <a, s>. Let A = a_0 - sum_{j>0} a_{n-j} X^j, then
+  // the constant coefficient of A * s is <a, s>, so (b, A) decrypts to the
+  // message at X^0. Everything is multiplied by n^{-1} to cancel out the
+  // factor n that is introduced by packing.
+  auto src_ptr = lwe.vec_.data();
+  auto c0_ptr = out->data(0);
+  auto c1_ptr = out->data(1);
+  for (size_t l = 0; l < num_modulus; ++l) {
+    using namespace seal::util;
+    uint64_t inv_n;
+    YACL_ENFORCE(try_invert_uint_mod(n, modulus[l], inv_n));
+
+    c0_ptr[0] = multiply_uint_mod(lwe.cnst_term_[l], inv_n, modulus[l]);
+    c1_ptr[0] = multiply_uint_mod(src_ptr[0], inv_n, modulus[l]);
+    for (size_t j = 1; j < n; ++j) {
+      c1_ptr[j] = multiply_uint_mod(negate_uint_mod(src_ptr[n - j], modulus[l]),
+                                    inv_n, modulus[l]);
+    }
+
+    src_ptr += n;
+    c0_ptr += n;
+    c1_ptr += n;
+  }
+
+  seal::Evaluator evaluator(context_);
+  evaluator.transform_to_ntt_inplace(*out);
+}
+
+RLWEPt LWEPacker::Monomial(const seal::parms_id_type &parms_id,
+                           size_t degree) const {
+  auto cntxt_dat = context_.get_context_data(parms_id);
+  YACL_ENFORCE(cntxt_dat != nullptr);
+  size_t num_modulus = cntxt_dat->parms().coeff_modulus().size();
+  auto ntt_tables = cntxt_dat->small_ntt_tables();
+
+  RLWEPt out;
+  out.parms_id() = seal::parms_id_zero;
+  out.resize(poly_deg_ * num_modulus);
+  std::fill_n(out.data(), out.coeff_count(), 0);
+  auto dst_ptr = out.data();
+  for (size_t l = 0; l < num_modulus; ++l, dst_ptr += poly_deg_) {
+    dst_ptr[degree] = 1;
+    seal::util::ntt_negacyclic_harvey(dst_ptr, ntt_tables[l]);
+  }
+  out.parms_id() = parms_id;
+  out.scale() = 1.;
+  return out;
+}
+
+void LWEPacker::Pack(absl::Span<const LWECt> lwes, RLWECt *out) const {
+  yacl::CheckNotNull(out);
+  size_t num_lwes = lwes.size();
+  YACL_ENFORCE(num_lwes > 0 && num_lwes <= poly_deg_,
+               fmt::format("can not pack {} LWECt into one RLWECt of degree {}",
+                           num_lwes, poly_deg_));
+  auto parms_id = lwes[0].parms_id();
+  for (const auto &lwe : lwes) {
+    YACL_ENFORCE(lwe.parms_id() == parms_id,
+                 "all the LWECt must have the same parms_id");
+  }
+
+  // Pad to a power of two with empty ciphertexts, i.e. zeros. Since
+  // num_lwes > m / 2, only the odd halves of the first level can be empty.
+  size_t m = absl::bit_ceil(num_lwes);
+  std::vector<RLWECt> cts(m);
+  yacl::parallel_for(0, num_lwes, 1, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      LWEToRLWE(lwes[i], &cts[i]);
+    }
+  });
+
+  seal::Evaluator evaluator(context_);
+  // Bottom-up PackLWEs. At level l, cts[j] and cts[j + h] pack the messages
+  // of the indices j (mod 2h) and j + h (mod 2h), the result holds them at
+  // the coefficients of stride n / 2^l:
+  //   ct_even + X^{n/2^l} ct_odd + Auto_{2^l+1}(ct_even - X^{n/2^l} ct_odd)
+  // The merges of a level are independent and run in parallel.
+  for (size_t l = 1; l <= Log2(m); ++l) {
+    size_t h = m >> l;
+    uint32_t galois_elt = (1U << l) + 1;
+    RLWEPt monomial = Monomial(parms_id, poly_deg_ >> l);
+
+    yacl::parallel_for(0, h, 1, [&](int64_t beg, int64_t end) {
+      RLWECt tmp;
+      for (int64_t j = beg; j < end; ++j) {
+        auto &even = cts[j];
+        auto &odd = cts[j + h];
+        if (odd.size() == 0) {
+          // Auto(ct_even) + ct_even
+          evaluator.apply_galois(even, galois_elt, galois_keys_, tmp);
+          evaluator.add_inplace(even, tmp);
+          continue;
+        }
+
+        evaluator.multiply_plain_inplace(odd, monomial);
+        evaluator.sub(even, odd, tmp);
+        evaluator.apply_galois_inplace(tmp, galois_elt, galois_keys_);
+        evaluator.add_inplace(even, odd);
+        evaluator.add_inplace(even, tmp);
+        odd.release();
+      }
+    });
+  }
+
+  // Zero out the coefficients other than the multiples of the stride, which
+  // also brings the factor of the messages from m to n
+  RLWECt tmp;
+  for (size_t l = Log2(m) + 1; l <= Log2(poly_deg_); ++l) {
+    evaluator.apply_galois(cts[0], (1U << l) + 1, galois_keys_, tmp);
+    evaluator.add_inplace(cts[0], tmp);
+  }
+
+  *out = std::move(cts[0]);
+}
+
+void LWEPacker::Pack(absl::Span<const LWECt> lwes,
+                     std::vector<RLWECt> *out) const {
+  yacl::CheckNotNull(out);
+  YACL_ENFORCE(!lwes.empty(), "nothing to pack");
+  size_t num_packs = (lwes.size() + poly_deg_ - 1) / poly_deg_;
+  out->resize(num_packs);
+  for (size_t k = 0; k < num_packs; ++k) {
+    Pack(lwes.subspan(k * poly_deg_, poly_deg_), &out->at(k));
+  }
+}
+
+}  // namespace heu::expt::rlwe
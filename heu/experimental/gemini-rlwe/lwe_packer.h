@@ -0,0 +1,74 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "absl/types/span.h"
+#include "seal/galoiskeys.h"
+
+#include "heu/experimental/gemini-rlwe/lwe_types.h"
+
+namespace heu::expt::rlwe {
+
+/// Packs LWE ciphertexts, e.g. the output of MatVecProtocol::MatVec(), back
+/// into RLWE ciphertexts, following PackLWEs of Chen, Dai, Kim and Song
+/// (ACNS 2021). An LWECt carries n coefficients per message while a packed
+/// RLWECt carries up to n messages, so the traffic shrinks by a factor of up
+/// to n.
+///
+/// The packed RLWECt is in NTT form and can be serialized like any other
+/// RLWECt, e.g. with EncodeSEALObject() in util.h. The receiver gets message
+/// i back by extracting coefficient i * PackedStride() of it, see LWECt.
+class LWEPacker {
+ public:
+  /// The Galois elements of the keys required by the packer, i.e.
+  /// 2^l + 1 for l = 1, ..., log2(n)
+  static std::vector<uint32_t> GaloisElements(
+      const seal::SEALContext &context);
+
+  /// galois_keys must contain the keys of GaloisElements()
+  explicit LWEPacker(const seal::SEALContext &context,
+                     const seal::GaloisKeys &galois_keys);
+
+  /// Packs up to n LWE ciphertexts of the same parms_id into one RLWE
+  /// ciphertext. lwes[i] goes to coefficient i * PackedStride(lwes.size()).
+  void Pack(absl::Span<const LWECt> lwes, RLWECt *out) const;
+
+  /// Packs any number of LWE ciphertexts, the k-th RLWE ciphertext holds
+  /// lwes[k * n, (k + 1) * n).
+  void Pack(absl::Span<const LWECt> lwes, std::vector<RLWECt> *out) const;
+
+  /// The distance between two packed messages if num_lwes (<= n) LWE
+  /// ciphertexts are packed together
+  size_t PackedStride(size_t num_lwes) const;
+
+  inline size_t poly_degree() const { return poly_deg_; }
+
+ protected:
+  // RLWE in NTT form whose constant coefficient holds n^{-1} * lwe
+  void LWEToRLWE(const LWECt &lwe, RLWECt *out) const;
+
+  // NTT form of X^degree
+  RLWEPt Monomial(const seal::parms_id_type &parms_id, size_t degree) const;
+
+ private:
+  size_t poly_deg_{0};
+
+  seal::SEALContext context_;
+  seal::GaloisKeys galois_keys_;
+};
+
+}  // namespace heu::expt::rlwe
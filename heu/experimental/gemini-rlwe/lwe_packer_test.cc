@@ -0,0 +1,173 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/experimental/gemini-rlwe/lwe_packer.h"
+
+#include <algorithm>
+#include <random>
+
+#include "gtest/gtest.h"
+#include "seal/seal.h"
+#include "seal/util/ntt.h"
+
+#include "heu/experimental/gemini-rlwe/lwe_decryptor.h"
+#include "heu/experimental/gemini-rlwe/modswitch_helper.h"
+#include "heu/experimental/gemini-rlwe/poly_encoder.h"
+#include "heu/experimental/gemini-rlwe/util.h"
+
+namespace heu::expt::rlwe::test {
+
+class LWEPackerTest : public ::testing::TestWithParam<size_t> {
+ protected:
+  static constexpr size_t poly_deg = 4096;
+  static constexpr size_t bitlen = 64;
+
+  void SetUp() override {
+    rdv_.seed(std::time(0));
+    auto parms = seal::EncryptionParameters(seal::scheme_type::ckks);
+    std::vector<int> modulus_bits{59, 59, 59, 59};
+
+    parms.set_poly_modulus_degree(poly_deg);
+    auto modulus = seal::CoeffModulus::Create(poly_deg, modulus_bits);
+    parms.set_coeff_modulus(modulus);
+    context_ = std::make_shared<seal::SEALContext>(parms, true,
+                                                   seal::sec_level_type::none);
+
+    modulus.pop_back();
+    parms.set_coeff_modulus(modulus);
+    seal::SEALContext ms_context(parms, false, seal::sec_level_type::none);
+    ms_helper_ = std::make_shared<ModulusSwitchHelper>(ms_context, bitlen);
+
+    seal::KeyGenerator keygen(*context_);
+    rlwe_sk_ = std::make_shared<RLWESecretKey>(keygen.secret_key());
+    lwe_sk_ = std::make_shared<LWESecretKey>(*rlwe_sk_, *context_);
+    galois_keys_ = std::make_shared<seal::GaloisKeys>();
+    keygen.create_galois_keys(LWEPacker::GaloisElements(*context_),
+                              *galois_keys_);
+  }
+
+  // Encrypts random messages and extracts num LWECt of them
+  void MakeLWEs(size_t num, std::vector<LWECt> *lwes,
+                std::vector<uint64_t> *msgs) {
+    std::vector<uint64_t> coeffs(poly_deg);
+    std::uniform_int_distribution<uint64_t> uniform;
+    std::generate_n(coeffs.data(), poly_deg, [&]() { return uniform(rdv_); });
+
+    PolyEncoder encoder(*context_, *ms_helper_);
+    RLWEPt pt;
+    encoder.Forward(absl::MakeConstSpan(coeffs), &pt, /*scale*/ true);
+    auto ntt_tables = context_->first_context_data()->small_ntt_tables();
+    for (size_t l = 0; l < ms_helper_->coeff_modulus_size(); ++l) {
+      seal::util::ntt_negacyclic_harvey(pt.data() + l * poly_deg,
+                                        ntt_tables[l]);
+    }
+
+    RLWECt ct;
+    seal::Encryptor encryptor(*context_, *rlwe_sk_);
+    encryptor.encrypt_symmetric(pt, ct);
+    seal::Evaluator(*context_).transform_from_ntt_inplace(ct);
+
+    lwes->clear();
+    msgs->clear();
+    for (size_t i = 0; i < num; ++i) {
+      size_t idx = (i * 37) % poly_deg;
+      lwes->emplace_back(ct, idx, *context_);
+      msgs->push_back(coeffs[idx]);
+    }
+  }
+
+  std::mt19937_64 rdv_;
+  std::shared_ptr<ModulusSwitchHelper> ms_helper_;
+  std::shared_ptr<seal::SEALContext> context_;
+
+  std::shared_ptr<RLWESecretKey> rlwe_sk_;
+  std::shared_ptr<LWESecretKey> lwe_sk_;
+  std::shared_ptr<seal::GaloisKeys> galois_keys_;
+};
+
+INSTANTIATE_TEST_SUITE_P(NormalCase, LWEPackerTest,
+                         testing::Values(1, 2, 5, 64, 300));
+
+TEST_P(LWEPackerTest, Pack) {
+  size_t num = GetParam();
+  std::vector<LWECt> lwes;
+  std::vector<uint64_t> msgs;
+  MakeLWEs(num, &lwes, &msgs);
+
+  LWEPacker packer(*context_, *galois_keys_);
+  RLWECt packed;
+  packer.Pack(lwes, &packed);
+
+  // the packed ciphertext is what goes to the peer
+  auto buf = EncodeSEALObject(packed);
+  if (num > 2) {
+    EXPECT_LT(buf.size(), num * EncodeSEALObject(lwes[0]).size());
+  }
+  RLWECt received;
+  DecodeSEALObject(buf, *context_, &received);
+  seal::Evaluator(*context_).transform_from_ntt_inplace(received);
+
+  LWEDecryptor decryptor(*lwe_sk_, *context_, ms_helper_);
+  size_t stride = packer.PackedStride(num);
+  for (size_t i = 0; i < num; ++i) {
+    uint64_t out;
+    decryptor.Decrypt(LWECt(received, i * stride, *context_), &out);
+    EXPECT_EQ(out, msgs[i]);
+  }
+}
+
+TEST_P(LWEPackerTest, PackMany) {
+  std::vector<LWECt> lwes;
+  std::vector<uint64_t> msgs;
+  MakeLWEs(GetParam(), &lwes, &msgs);
+
+  LWEPacker packer(*context_, *galois_keys_);
+  std::vector<RLWECt> packed;
+  packer.Pack(lwes, &packed);
+  ASSERT_EQ(packed.size(), 1U);
+  EXPECT_ANY_THROW(packer.Pack({}, &packed));
+
+  seal::GaloisKeys no_keys;
+  EXPECT_ANY_THROW(LWEPacker bad_packer(*context_, no_keys));
+}
+
+// More than n LWEs are spread over several RLWE ciphertexts, the last of which
+// is only partially filled
+TEST_F(LWEPackerTest, PackManyMultiRLWE) {
+  size_t num = 2 * poly_deg + 37;
+  std::vector<LWECt> lwes;
+  std::vector<uint64_t> msgs;
+  MakeLWEs(num, &lwes, &msgs);
+
+  LWEPacker packer(*context_, *galois_keys_);
+  std::vector<RLWECt> packed;
+  packer.Pack(lwes, &packed);
+  ASSERT_EQ(packed.size(), 3U);
+
+  LWEDecryptor decryptor(*lwe_sk_, *context_, ms_helper_);
+  seal::Evaluator evaluator(*context_);
+  for (size_t k = 0; k < packed.size(); ++k) {
+    evaluator.transform_from_ntt_inplace(packed[k]);
+    size_t beg = k * poly_deg;
+    size_t cnt = std::min(poly_deg, num - beg);
+    size_t stride = packer.PackedStride(cnt);
+    for (size_t i = 0; i < cnt; ++i) {
+      uint64_t out;
+      decryptor.Decrypt(LWECt(packed[k], i * stride, *context_), &out);
+      ASSERT_EQ(out, msgs[beg + i]) << "pack " << k << ", slot " << i;
+    }
+  }
+}
+
+}  // namespace heu::expt::rlwe::test
@@ -31,6 +31,7 @@ using RLWECt = seal::Ciphertext;
 using RLWEPt = seal::Plaintext;
 
 class LWEDecryptor;
+class LWEPacker;
 
 class LWESecretKey {
  public:
@@ -144,6 +145,7 @@ class LWECt {
                     seal::SEALVersion version);
 
   friend class LWEDecryptor;
+  friend class LWEPacker;
   uint64_t maximum_lazy_{0};
   uint64_t lazy_counter_{0};
 
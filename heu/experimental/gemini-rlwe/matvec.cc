@@ -14,12 +14,14 @@
 
 #include "heu/experimental/gemini-rlwe/matvec.h"
 
+#include <algorithm>
 #include <array>
 
 #include "absl/numeric/bits.h"
 #include "seal/evaluator.h"
 #include "seal/util/numth.h"
 #include "yacl/base/exception.h"
+#include "yacl/utils/parallel.h"
 
 namespace heu::expt::rlwe {
 
@@ -122,6 +124,121 @@ void MatVecProtocol::DoEncodeVector(const Meta &meta,
   }
 }
 
+template <typename T>
+bool MatVecProtocol::EncodeBlock(const Meta &meta, absl::Span<const T> mat_view,
+                                 const std::array<size_t, 2> &submat_shape,
+                                 size_t rblk, size_t cblk, RLWEPt *out) const {
+  std::array<size_t, 2> starts{rblk * submat_shape[0],
+                               cblk * submat_shape[1]};
+  std::array<size_t, 2> extents{
+      std::min(meta.nrows, starts[0] + submat_shape[0]) - starts[0],
+      std::min(meta.ncols, starts[1] + submat_shape[1]) - starts[1]};
+
+  std::vector<T> concat_submat;
+  ConcatSubMatrix<T>(mat_view, meta, starts, extents, submat_shape,
+                     &concat_submat);
+  if (!std::any_of(concat_submat.begin(), concat_submat.end(),
+                   [](const T &x) { return x > 0; })) {
+    // submatrix of all-zero entries
+    return false;
+  }
+
+  if (out != nullptr) {
+    encoder_.Forward(concat_submat, out, /*scale*/ false);
+    transform_to_ntt_inplace(*out, context_);
+  }
+  return true;
+}
+
+/// Computes (*outs[i]) = M * (*vecs[i]) for every i.
+///
+/// get_block(rblk, cblk, scratch) returns the NTT-form polynomial of a block
+/// of M, or nullptr if the block is all-zero. It may encode the block into
+/// the thread-local scratch.
+///
+/// The work is split over the (row block x vector tile) grid. Within a task
+/// each matrix polynomial is fetched once and multiplied with all vectors of
+/// the tile while it is still hot in cache. Every task owns its accumulators
+/// and its rows of the outputs, so the tasks run without locking.
+template <typename GetBlock>
+void MatVecProtocol::MatMatByBlocks(
+    const Meta &meta, const std::array<size_t, 2> &submat_shape,
+    const std::vector<const std::vector<RLWECt> *> &vecs,
+    const GetBlock &get_block, const std::vector<std::vector<LWECt> *> &outs)
+    const {
+  // bounds the memory of the accumulators of a task
+  constexpr size_t kMaxVecTile = 32;
+
+  size_t num_vecs = vecs.size();
+  size_t num_row_blocks = CeilDiv(meta.nrows, submat_shape[0]);
+  size_t num_col_blocks = CeilDiv(meta.ncols, submat_shape[1]);
+  YACL_ENFORCE_EQ(num_vecs, outs.size());
+  if (num_vecs == 0) {
+    return;
+  }
+
+  // prefer large tiles for reuse, but leave enough tasks for all threads
+  size_t tasks_per_row_block = CeilDiv<size_t>(
+      std::max<size_t>(yacl::get_num_threads(), 1), num_row_blocks);
+  size_t vec_tile = std::min(kMaxVecTile,
+                             CeilDiv(num_vecs, tasks_per_row_block));
+  size_t num_vec_tiles = CeilDiv(num_vecs, vec_tile);
+
+  for (auto *out : outs) {
+    yacl::CheckNotNull(out);
+    out->resize(meta.nrows);
+  }
+  seal::Evaluator evaluator(context_);
+
+  size_t num_tasks = num_row_blocks * num_vec_tiles;
+  yacl::parallel_for(0, num_tasks, 1, [&](int64_t beg, int64_t end) {
+    RLWEPt scratch;
+    RLWECt tmp;
+    std::vector<RLWECt> accumulated;
+    for (auto task = static_cast<size_t>(beg); task < static_cast<size_t>(end);
+         ++task) {
+      size_t rblk = task / num_vec_tiles;
+      size_t vbgn = (task % num_vec_tiles) * vec_tile;
+      size_t vend = std::min(num_vecs, vbgn + vec_tile);
+
+      accumulated.clear();
+      accumulated.resize(vend - vbgn);
+      for (size_t cblk = 0; cblk < num_col_blocks; ++cblk) {
+        const RLWEPt *mat_poly = get_block(rblk, cblk, &scratch);
+        if (mat_poly == nullptr) {
+          continue;
+        }
+
+        for (size_t v = vbgn; v < vend; ++v) {
+          auto &acc = accumulated[v - vbgn];
+          if (acc.size() > 0) {
+            evaluator.multiply_plain(vecs[v]->at(cblk), *mat_poly, tmp);
+            evaluator.add_inplace(acc, tmp);
+          } else {
+            evaluator.multiply_plain(vecs[v]->at(cblk), *mat_poly, acc);
+          }
+        }
+      }
+
+      size_t rbgn = rblk * submat_shape[0];
+      for (size_t v = vbgn; v < vend; ++v) {
+        auto &acc = accumulated[v - vbgn];
+        YACL_ENFORCE(acc.size() > 0, fmt::format("all zero matrix is not "
+                                                 "supported for MatVec"));
+
+        // position form for RLWE2LWE
+        if (acc.is_ntt_form()) evaluator.transform_from_ntt_inplace(acc);
+
+        for (size_t r = 0; r < submat_shape[0]; ++r) {
+          if (rbgn + r >= meta.nrows) break;
+          size_t target_coeff = r * submat_shape[1];
+          outs[v]->at(rbgn + r) = LWECt(acc, target_coeff, context_);
+        }
+      }
+    }
+  });
+}
+
 template <typename T>
 void MatVecProtocol::DoMatVec(const Meta &meta, absl::Span<const T> mat_view,
                               const std::vector<RLWECt> &vec,
@@ -132,57 +249,138 @@ void MatVecProtocol::DoMatVec(const Meta &meta, absl::Span<const T> mat_view,
   yacl::CheckNotNull(out);
 
   auto submat_shape = GetSubMatrixShape(meta, poly_degree());
+  MatMatByBlocks(
+      meta, submat_shape, {&vec},
+      [&](size_t rblk, size_t cblk, RLWEPt *scratch) -> const RLWEPt * {
+        return EncodeBlock(meta, mat_view, submat_shape, rblk, cblk, scratch)
+                   ? scratch
+                   : nullptr;
+      },
+      {out});
+}
 
-  std::array<size_t, 2> starts{0}, extents{0};
-  std::vector<T> concat_submat(poly_deg_);
-  seal::Evaluator evaluator(context_);
-
-  out->resize(meta.nrows);
-  for (size_t rbgn = 0; rbgn < meta.nrows; rbgn += submat_shape[0]) {
-    starts[0] = rbgn;
-    extents[0] = std::min(meta.nrows, rbgn + submat_shape[0]) - rbgn;
+template <typename T>
+void MatVecProtocol::DoMatMat(const Meta &meta, absl::Span<const T> mat_view,
+                              const std::vector<std::vector<RLWECt>> &vecs,
+                              std::vector<std::vector<LWECt>> *out) const {
+  // every block is encoded once for all vectors
+  PreparedMatrix prepared;
+  DoPrepareMatrix<T>(meta, mat_view, &prepared,
+                     std::numeric_limits<size_t>::max());
+  DoPreparedMatMat<T>(prepared, {}, vecs, out);
+}
 
-    RLWECt accumulated;
-    for (size_t cbgn = 0; cbgn < meta.ncols; cbgn += submat_shape[1]) {
-      starts[1] = cbgn;
-      extents[1] = std::min(meta.ncols, cbgn + submat_shape[1]) - cbgn;
+bool MatVecProtocol::PreparedMatrix::IsComplete() const {
+  return std::none_of(states.begin(), states.end(), [](BlockState s) {
+    return s == BlockState::kNotCached;
+  });
+}
 
-      ConcatSubMatrix<T>(mat_view, meta, starts, extents, submat_shape,
-                         &concat_submat);
+template <typename T>
+void MatVecProtocol::DoPrepareMatrix(const Meta &meta,
+                                     absl::Span<const T> mat_view,
+                                     PreparedMatrix *out,
+                                     size_t max_bytes) const {
+  YACL_ENFORCE(IsValidMeta(meta));
+  YACL_ENFORCE_EQ(seal::util::mul_safe(meta.nrows, meta.ncols),
+                  mat_view.size());
+  yacl::CheckNotNull(out);
 
-      if (!std::any_of(concat_submat.begin(), concat_submat.end(),
-                       [](const T &x) { return x > 0; })) {
-        // submatrix of all-zero entries
-        continue;
+  out->meta = meta;
+  out->submat_shape = GetSubMatrixShape(meta, poly_degree());
+  out->num_row_blocks = CeilDiv(meta.nrows, out->submat_shape[0]);
+  out->num_col_blocks = CeilDiv(meta.ncols, out->submat_shape[1]);
+  size_t num_blocks = out->num_row_blocks * out->num_col_blocks;
+  auto block_index = [&](size_t k) {
+    return std::array<size_t, 2>{k / out->num_col_blocks,
+                                 k % out->num_col_blocks};
+  };
+
+  // 1. find the all-zero blocks
+  out->states.assign(num_blocks, BlockState::kNotCached);
+  yacl::parallel_for(0, num_blocks, 1, [&](int64_t beg, int64_t end) {
+    for (auto k = static_cast<size_t>(beg); k < static_cast<size_t>(end); ++k) {
+      auto [rblk, cblk] = block_index(k);
+      if (!EncodeBlock(meta, mat_view, out->submat_shape, rblk, cblk,
+                       nullptr)) {
+        out->states[k] = BlockState::kZero;
       }
+    }
+  });
+
+  // 2. pick the blocks to cache within the memory budget
+  size_t num_moduli =
+      context_.first_context_data()->parms().coeff_modulus().size();
+  size_t poly_bytes = poly_deg_ * num_moduli * sizeof(uint64_t);
+  out->cached_bytes = 0;
+  for (auto &state : out->states) {
+    if (state == BlockState::kNotCached &&
+        max_bytes - out->cached_bytes >= poly_bytes) {
+      state = BlockState::kCached;
+      out->cached_bytes += poly_bytes;
+    }
+  }
 
-      RLWEPt mat_poly;
-      encoder_.Forward(concat_submat, &mat_poly, /*scale*/ false);
-      transform_to_ntt_inplace(mat_poly, context_);
-
-      size_t col_block_idx = cbgn / submat_shape[1];
-      RLWECt tmp;
-      evaluator.multiply_plain(vec.at(col_block_idx), mat_poly, tmp);
-
-      if (accumulated.size() > 0) {
-        evaluator.add_inplace(accumulated, tmp);
-      } else {
-        accumulated = tmp;
+  // 3. encode them
+  out->polys.clear();
+  out->polys.resize(num_blocks);
+  yacl::parallel_for(0, num_blocks, 1, [&](int64_t beg, int64_t end) {
+    for (auto k = static_cast<size_t>(beg); k < static_cast<size_t>(end); ++k) {
+      if (out->states[k] == BlockState::kCached) {
+        auto [rblk, cblk] = block_index(k);
+        EncodeBlock(meta, mat_view, out->submat_shape, rblk, cblk,
+                    &out->polys[k]);
       }
     }
-    YACL_ENFORCE(accumulated.size() > 0,
-                 fmt::format("all zero matrix is not supported for MatVec"));
+  });
+}
 
-    // position form for RLWE2LWE
-    if (accumulated.is_ntt_form())
-      evaluator.transform_from_ntt_inplace(accumulated);
+template <typename T>
+void MatVecProtocol::DoPreparedMatMat(
+    const PreparedMatrix &mat, absl::Span<const T> mat_view,
+    const std::vector<const std::vector<RLWECt> *> &vecs,
+    const std::vector<std::vector<LWECt> *> &outs) const {
+  const auto &meta = mat.meta;
+  YACL_ENFORCE(IsValidMeta(meta));
+  YACL_ENFORCE_EQ(mat.states.size(), mat.num_row_blocks * mat.num_col_blocks);
+  YACL_ENFORCE(mat_view.empty() || mat_view.size() == meta.nrows * meta.ncols,
+               "the matrix does not match the prepared one, size {} vs {}",
+               mat_view.size(), meta.nrows * meta.ncols);
+
+  MatMatByBlocks(
+      meta, mat.submat_shape, vecs,
+      [&](size_t rblk, size_t cblk, RLWEPt *scratch) -> const RLWEPt * {
+        size_t k = rblk * mat.num_col_blocks + cblk;
+        switch (mat.states[k]) {
+          case BlockState::kZero:
+            return nullptr;
+          case BlockState::kCached:
+            return &mat.polys[k];
+          default:
+            YACL_ENFORCE(!mat_view.empty(),
+                         "the matrix is partially prepared, it must be "
+                         "passed to MatVec");
+            EncodeBlock(meta, mat_view, mat.submat_shape, rblk, cblk, scratch);
+            return scratch;
+        }
+      },
+      outs);
+}
 
-    for (size_t r = 0; r < submat_shape[0]; ++r) {
-      if (rbgn + r >= meta.nrows) break;
-      size_t target_coeff = r * submat_shape[1];
-      out->at(rbgn + r) = LWECt(accumulated, target_coeff, context_);
-    }
+template <typename T>
+void MatVecProtocol::DoPreparedMatMat(
+    const PreparedMatrix &mat, absl::Span<const T> mat_view,
+    const std::vector<std::vector<RLWECt>> &vecs,
+    std::vector<std::vector<LWECt>> *out) const {
+  yacl::CheckNotNull(out);
+  out->resize(vecs.size());
+  std::vector<const std::vector<RLWECt> *> vec_ptrs(vecs.size());
+  std::vector<std::vector<LWECt> *> out_ptrs(vecs.size());
+  for (size_t i = 0; i < vecs.size(); ++i) {
+    vec_ptrs[i] = &vecs[i];
+    out_ptrs[i] = &(*out)[i];
   }
+  DoPreparedMatMat<T>(mat, mat_view, vec_ptrs, out_ptrs);
 }
 
 void MatVecProtocol::EncodeVector(const Meta &meta,
@@ -224,4 +422,110 @@ void MatVecProtocol::MatVec(const Meta &meta,
   DoMatVec<uint128_t>(meta, mat_view, vec, out);
 }
 
+void MatVecProtocol::PrepareMatrix(const Meta &meta,
+                                   absl::Span<const uint32_t> mat_view,
+                                   PreparedMatrix *out,
+                                   size_t max_bytes) const {
+  DoPrepareMatrix<uint32_t>(meta, mat_view, out, max_bytes);
+}
+
+void MatVecProtocol::PrepareMatrix(const Meta &meta,
+                                   absl::Span<const uint64_t> mat_view,
+                                   PreparedMatrix *out,
+                                   size_t max_bytes) const {
+  DoPrepareMatrix<uint64_t>(meta, mat_view, out, max_bytes);
+}
+
+void MatVecProtocol::PrepareMatrix(const Meta &meta,
+                                   absl::Span<const uint128_t> mat_view,
+                                   PreparedMatrix *out,
+                                   size_t max_bytes) const {
+  DoPrepareMatrix<uint128_t>(meta, mat_view, out, max_bytes);
+}
+
+void MatVecProtocol::MatVec(const PreparedMatrix &mat,
+                            const std::vector<RLWECt> &vec,
+                            std::vector<LWECt> *out) const {
+  YACL_ENFORCE(mat.IsComplete(),
+               "the matrix is partially prepared, it must be passed to "
+               "MatVec");
+  yacl::CheckNotNull(out);
+  DoPreparedMatMat<uint64_t>(mat, {}, {&vec}, {out});
+}
+
+void MatVecProtocol::MatVec(const PreparedMatrix &mat,
+                            absl::Span<const uint32_t> mat_view,
+                            const std::vector<RLWECt> &vec,
+                            std::vector<LWECt> *out) const {
+  yacl::CheckNotNull(out);
+  DoPreparedMatMat<uint32_t>(mat, mat_view, {&vec}, {out});
+}
+
+void MatVecProtocol::MatVec(const PreparedMatrix &mat,
+                            absl::Span<const uint64_t> mat_view,
+                            const std::vector<RLWECt> &vec,
+                            std::vector<LWECt> *out) const {
+  yacl::CheckNotNull(out);
+  DoPreparedMatMat<uint64_t>(mat, mat_view, {&vec}, {out});
+}
+
+void MatVecProtocol::MatVec(const PreparedMatrix &mat,
+                            absl::Span<const uint128_t> mat_view,
+                            const std::vector<RLWECt> &vec,
+                            std::vector<LWECt> *out) const {
+  yacl::CheckNotNull(out);
+  DoPreparedMatMat<uint128_t>(mat, mat_view, {&vec}, {out});
+}
+
+void MatVecProtocol::MatMat(const Meta &meta,
+                            absl::Span<const uint32_t> mat_view,
+                            const std::vector<std::vector<RLWECt>> &vecs,
+                            std::vector<std::vector<LWECt>> *out) const {
+  DoMatMat<uint32_t>(meta, mat_view, vecs, out);
+}
+
+void MatVecProtocol::MatMat(const Meta &meta,
+                            absl::Span<const uint64_t> mat_view,
+                            const std::vector<std::vector<RLWECt>> &vecs,
+                            std::vector<std::vector<LWECt>> *out) const {
+  DoMatMat<uint64_t>(meta, mat_view, vecs, out);
+}
+
+void MatVecProtocol::MatMat(const Meta &meta,
+                            absl::Span<const uint128_t> mat_view,
+                            const std::vector<std::vector<RLWECt>> &vecs,
+                            std::vector<std::vector<LWECt>> *out) const {
+  DoMatMat<uint128_t>(meta, mat_view, vecs, out);
+}
+
+void MatVecProtocol::MatMat(const PreparedMatrix &mat,
+                            const std::vector<std::vector<RLWECt>> &vecs,
+                            std::vector<std::vector<LWECt>> *out) const {
+  YACL_ENFORCE(mat.IsComplete(),
+               "the matrix is partially prepared, it must be passed to "
+               "MatMat");
+  DoPreparedMatMat<uint64_t>(mat, {}, vecs, out);
+}
+
+void MatVecProtocol::MatMat(const PreparedMatrix &mat,
+                            absl::Span<const uint32_t> mat_view,
+                            const std::vector<std::vector<RLWECt>> &vecs,
+                            std::vector<std::vector<LWECt>> *out) const {
+  DoPreparedMatMat<uint32_t>(mat, mat_view, vecs, out);
+}
+
+void MatVecProtocol::MatMat(const PreparedMatrix &mat,
+                            absl::Span<const uint64_t> mat_view,
+                            const std::vector<std::vector<RLWECt>> &vecs,
+                            std::vector<std::vector<LWECt>> *out) const {
+  DoPreparedMatMat<uint64_t>(mat, mat_view, vecs, out);
+}
+
+void MatVecProtocol::MatMat(const PreparedMatrix &mat,
+                            absl::Span<const uint128_t> mat_view,
+                            const std::vector<std::vector<RLWECt>> &vecs,
+                            std::vector<std::vector<LWECt>> *out) const {
+  DoPreparedMatMat<uint128_t>(mat, mat_view, vecs, out);
+}
+
 }  // namespace heu::expt::rlwe
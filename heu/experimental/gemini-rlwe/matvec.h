@@ -13,6 +13,11 @@
 // limitations under the License.
 
 #pragma once
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
 #include "yacl/base/exception.h"
 
 #include "heu/experimental/gemini-rlwe/lwe_types.h"
@@ -28,6 +33,26 @@ class MatVecProtocol {
     size_t ncols;
   };
 
+  enum class BlockState : uint8_t { kZero, kCached, kNotCached };
+
+  /// A plaintext matrix whose submatrix polynomials are encoded and
+  /// NTT-transformed once by PrepareMatrix(), so that it can be multiplied
+  /// with many encrypted vectors without re-encoding.
+  struct PreparedMatrix {
+    Meta meta;
+    std::array<size_t, 2> submat_shape;
+    size_t num_row_blocks = 0;
+    size_t num_col_blocks = 0;
+    /// The block at (row block i, column block j) is at
+    /// i * num_col_blocks + j. polys[k] is empty unless states[k] is kCached.
+    std::vector<RLWEPt> polys;
+    std::vector<BlockState> states;
+    size_t cached_bytes = 0;
+
+    /// true if no block needs to be encoded on the fly
+    bool IsComplete() const;
+  };
+
   explicit MatVecProtocol(const seal::SEALContext &context,
                           const ModulusSwitchHelper &ms_helper);
 
@@ -49,6 +74,71 @@ class MatVecProtocol {
   void MatVec(const Meta &meta, absl::Span<const uint128_t> mat_view,
               const std::vector<RLWECt> &vec, std::vector<LWECt> *out) const;
 
+  /// Encodes the nonzero blocks of the matrix. If they take more than
+  /// max_bytes, only the first blocks in row-major order are cached and the
+  /// rest are left to be encoded on the fly by MatVec().
+  void PrepareMatrix(const Meta &meta, absl::Span<const uint32_t> mat_view,
+                     PreparedMatrix *out,
+                     size_t max_bytes = std::numeric_limits<size_t>::max())
+      const;
+
+  void PrepareMatrix(const Meta &meta, absl::Span<const uint64_t> mat_view,
+                     PreparedMatrix *out,
+                     size_t max_bytes = std::numeric_limits<size_t>::max())
+      const;
+
+  void PrepareMatrix(const Meta &meta, absl::Span<const uint128_t> mat_view,
+                     PreparedMatrix *out,
+                     size_t max_bytes = std::numeric_limits<size_t>::max())
+      const;
+
+  /// `mat` must be complete, see PreparedMatrix::IsComplete()
+  void MatVec(const PreparedMatrix &mat, const std::vector<RLWECt> &vec,
+              std::vector<LWECt> *out) const;
+
+  /// For a partially cached `mat`, mat_view is the matrix it was prepared
+  /// from, the uncached blocks are encoded from it.
+  void MatVec(const PreparedMatrix &mat, absl::Span<const uint32_t> mat_view,
+              const std::vector<RLWECt> &vec, std::vector<LWECt> *out) const;
+
+  void MatVec(const PreparedMatrix &mat, absl::Span<const uint64_t> mat_view,
+              const std::vector<RLWECt> &vec, std::vector<LWECt> *out) const;
+
+  void MatVec(const PreparedMatrix &mat, absl::Span<const uint128_t> mat_view,
+              const std::vector<RLWECt> &vec, std::vector<LWECt> *out) const;
+
+  /// Multiplies the matrix with k encrypted vectors, (*out)[i] = M * vecs[i],
+  /// e.g. the columns of an encrypted mini-batch. Every matrix polynomial is
+  /// encoded once and reused for all the vectors.
+  void MatMat(const Meta &meta, absl::Span<const uint32_t> mat_view,
+              const std::vector<std::vector<RLWECt>> &vecs,
+              std::vector<std::vector<LWECt>> *out) const;
+
+  void MatMat(const Meta &meta, absl::Span<const uint64_t> mat_view,
+              const std::vector<std::vector<RLWECt>> &vecs,
+              std::vector<std::vector<LWECt>> *out) const;
+
+  void MatMat(const Meta &meta, absl::Span<const uint128_t> mat_view,
+              const std::vector<std::vector<RLWECt>> &vecs,
+              std::vector<std::vector<LWECt>> *out) const;
+
+  /// Same as MatVec() with a PreparedMatrix, for k vectors
+  void MatMat(const PreparedMatrix &mat,
+              const std::vector<std::vector<RLWECt>> &vecs,
+              std::vector<std::vector<LWECt>> *out) const;
+
+  void MatMat(const PreparedMatrix &mat, absl::Span<const uint32_t> mat_view,
+              const std::vector<std::vector<RLWECt>> &vecs,
+              std::vector<std::vector<LWECt>> *out) const;
+
+  void MatMat(const PreparedMatrix &mat, absl::Span<const uint64_t> mat_view,
+              const std::vector<std::vector<RLWECt>> &vecs,
+              std::vector<std::vector<LWECt>> *out) const;
+
+  void MatMat(const PreparedMatrix &mat, absl::Span<const uint128_t> mat_view,
+              const std::vector<std::vector<RLWECt>> &vecs,
+              std::vector<std::vector<LWECt>> *out) const;
+
   template <typename T>
   void MatVecRandomMat(const Meta &meta, const std::vector<RLWECt> &vec,
                        std::function<void(T *, size_t)> prng,
@@ -76,6 +166,39 @@ class MatVecProtocol {
   void DoMatVec(const Meta &meta, absl::Span<const T> mat_view,
                 const std::vector<RLWECt> &vec, std::vector<LWECt> *out) const;
 
+  template <typename T>
+  void DoPrepareMatrix(const Meta &meta, absl::Span<const T> mat_view,
+                       PreparedMatrix *out, size_t max_bytes) const;
+
+  template <typename T>
+  void DoMatMat(const Meta &meta, absl::Span<const T> mat_view,
+                const std::vector<std::vector<RLWECt>> &vecs,
+                std::vector<std::vector<LWECt>> *out) const;
+
+  template <typename T>
+  void DoPreparedMatMat(const PreparedMatrix &mat,
+                        absl::Span<const T> mat_view,
+                        const std::vector<const std::vector<RLWECt> *> &vecs,
+                        const std::vector<std::vector<LWECt> *> &outs) const;
+
+  template <typename T>
+  void DoPreparedMatMat(const PreparedMatrix &mat,
+                        absl::Span<const T> mat_view,
+                        const std::vector<std::vector<RLWECt>> &vecs,
+                        std::vector<std::vector<LWECt>> *out) const;
+
+  template <typename T>
+  bool EncodeBlock(const Meta &meta, absl::Span<const T> mat_view,
+                   const std::array<size_t, 2> &submat_shape, size_t rblk,
+                   size_t cblk, RLWEPt *out) const;
+
+  template <typename GetBlock>
+  void MatMatByBlocks(const Meta &meta,
+                      const std::array<size_t, 2> &submat_shape,
+                      const std::vector<const std::vector<RLWECt> *> &vecs,
+                      const GetBlock &get_block,
+                      const std::vector<std::vector<LWECt> *> &outs) const;
+
  private:
   size_t poly_deg_{0};
 
@@ -134,6 +134,108 @@ class MatVecTest : public ::testing::TestWithParam<
     }
   }
 
+  template <typename T>
+  void CheckPreparedMatVec(const MatVecProtocol::Meta &meta) {
+    const T mask = MakeMask<T>(std::min(sizeof(T) * 8, bitlen_));
+    MatVecProtocol matvec_prot(*context_, *ms_helper_);
+    seal::Encryptor encryptor(*context_, *rlwe_sk_);
+    LWEDecryptor decryptor(*lwe_sk_, *context_, ms_helper_);
+
+    std::vector<T> mat(meta.nrows * meta.ncols);
+    UniformRand(mat.data(), mat.size(), bitlen_);
+    absl::Span<const T> _mat(mat.data(), mat.size());
+
+    MatVecProtocol::PreparedMatrix full;
+    MatVecProtocol::PreparedMatrix partial;
+    matvec_prot.PrepareMatrix(meta, _mat, &full);
+    // caches about half of the blocks
+    matvec_prot.PrepareMatrix(meta, _mat, &partial, full.cached_bytes / 2);
+    EXPECT_TRUE(full.IsComplete());
+    EXPECT_LE(partial.cached_bytes, full.cached_bytes / 2);
+
+    // the same prepared matrix is reused for several vectors
+    for (int round = 0; round < 2; ++round) {
+      std::vector<T> vec(meta.ncols);
+      UniformRand(vec.data(), vec.size(), bitlen_);
+      std::vector<RLWEPt> ecd_vec;
+      matvec_prot.EncodeVector(meta, absl::Span<const T>(vec), &ecd_vec);
+      std::vector<RLWECt> vec_cipher(ecd_vec.size());
+      for (size_t i = 0; i < ecd_vec.size(); ++i) {
+        transform_to_ntt_inplace(ecd_vec[i], *context_);
+        encryptor.encrypt_symmetric(ecd_vec[i], vec_cipher[i]);
+      }
+
+      std::vector<T> ground(meta.nrows);
+      MatVecPlain<T>(mat.data(), vec.data(), meta.nrows, meta.ncols,
+                     ground.data());
+
+      std::vector<LWECt> full_prod;
+      std::vector<LWECt> partial_prod;
+      matvec_prot.MatVec(full, vec_cipher, &full_prod);
+      matvec_prot.MatVec(partial, _mat, vec_cipher, &partial_prod);
+      for (size_t r = 0; r < meta.nrows; ++r) {
+        T out;
+        decryptor.Decrypt(full_prod[r], &out);
+        EXPECT_EQ(out, ground[r] & mask);
+        decryptor.Decrypt(partial_prod[r], &out);
+        EXPECT_EQ(out, ground[r] & mask);
+      }
+
+      if (!partial.IsComplete()) {
+        EXPECT_ANY_THROW(matvec_prot.MatVec(partial, vec_cipher, &full_prod));
+      }
+    }
+  }
+
+  template <typename T>
+  void CheckMatMat(const MatVecProtocol::Meta &meta, size_t num_vecs) {
+    const T mask = MakeMask<T>(std::min(sizeof(T) * 8, bitlen_));
+    MatVecProtocol matvec_prot(*context_, *ms_helper_);
+    seal::Encryptor encryptor(*context_, *rlwe_sk_);
+    LWEDecryptor decryptor(*lwe_sk_, *context_, ms_helper_);
+
+    std::vector<T> mat(meta.nrows * meta.ncols);
+    UniformRand(mat.data(), mat.size(), bitlen_);
+    absl::Span<const T> _mat(mat.data(), mat.size());
+
+    std::vector<std::vector<T>> vecs(num_vecs);
+    std::vector<std::vector<RLWECt>> vec_ciphers(num_vecs);
+    for (size_t k = 0; k < num_vecs; ++k) {
+      vecs[k].resize(meta.ncols);
+      UniformRand(vecs[k].data(), vecs[k].size(), bitlen_);
+      std::vector<RLWEPt> ecd_vec;
+      matvec_prot.EncodeVector(meta, absl::Span<const T>(vecs[k]), &ecd_vec);
+      vec_ciphers[k].resize(ecd_vec.size());
+      for (size_t i = 0; i < ecd_vec.size(); ++i) {
+        transform_to_ntt_inplace(ecd_vec[i], *context_);
+        encryptor.encrypt_symmetric(ecd_vec[i], vec_ciphers[k][i]);
+      }
+    }
+
+    MatVecProtocol::PreparedMatrix partial;
+    matvec_prot.PrepareMatrix(meta, _mat, &partial, 0);
+
+    std::vector<std::vector<LWECt>> prod;
+    std::vector<std::vector<LWECt>> partial_prod;
+    matvec_prot.MatMat(meta, _mat, vec_ciphers, &prod);
+    matvec_prot.MatMat(partial, _mat, vec_ciphers, &partial_prod);
+    ASSERT_EQ(prod.size(), num_vecs);
+    ASSERT_EQ(partial_prod.size(), num_vecs);
+
+    std::vector<T> ground(meta.nrows);
+    for (size_t k = 0; k < num_vecs; ++k) {
+      MatVecPlain<T>(mat.data(), vecs[k].data(), meta.nrows, meta.ncols,
+                     ground.data());
+      for (size_t r = 0; r < meta.nrows; ++r) {
+        T out;
+        decryptor.Decrypt(prod[k][r], &out);
+        EXPECT_EQ(out, ground[r] & mask);
+        decryptor.Decrypt(partial_prod[k][r], &out);
+        EXPECT_EQ(out, ground[r] & mask);
+      }
+    }
+  }
+
   std::mt19937_64 rdv_;
   size_t bitlen_;
 
@@ -280,6 +382,36 @@ TEST_P(MatVecTest, Basic) {
   }
 }
 
+TEST_P(MatVecTest, PreparedMatrix) {
+  MatVecProtocol::Meta meta;
+  meta.transposed = false;
+  meta.nrows = std::get<0>(std::get<1>(GetParam()));
+  meta.ncols = std::get<1>(std::get<1>(GetParam()));
+
+  if (bitlen_ <= 32) {
+    CheckPreparedMatVec<uint32_t>(meta);
+  } else if (bitlen_ <= 64) {
+    CheckPreparedMatVec<uint64_t>(meta);
+  } else {
+    CheckPreparedMatVec<uint128_t>(meta);
+  }
+}
+
+TEST_P(MatVecTest, MatMat) {
+  MatVecProtocol::Meta meta;
+  meta.transposed = false;
+  meta.nrows = std::get<0>(std::get<1>(GetParam()));
+  meta.ncols = std::get<1>(std::get<1>(GetParam()));
+
+  if (bitlen_ <= 32) {
+    CheckMatMat<uint32_t>(meta, 5);
+  } else if (bitlen_ <= 64) {
+    CheckMatMat<uint64_t>(meta, 5);
+  } else {
+    CheckMatMat<uint128_t>(meta, 5);
+  }
+}
+
 TEST_P(MatVecTest, RandomMat) {
   const uint32_t mask32 = MakeMask<uint32_t>(std::min(32UL, bitlen_));
   const uint64_t mask64 = MakeMask<uint64_t>(std::min(64UL, bitlen_));
@@ -0,0 +1,119 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "seal/seal.h"
+
+#include "heu/experimental/gemini-rlwe/modswitch_helper.h"
+#include "heu/experimental/gemini-rlwe/modswitch_kernels.h"
+
+namespace heu::expt::rlwe::bench {
+
+constexpr static size_t kPolyDeg = 8192;
+
+// The same moduli as the protocols use for each base bitlen
+static std::shared_ptr<ModulusSwitchHelper> MakeHelper(uint32_t bitlen) {
+  std::vector<int> modulus_bits;
+  if (bitlen <= 32) {
+    modulus_bits = {59, 59};
+  } else if (bitlen <= 64) {
+    modulus_bits = {59, 59, 59};
+  } else {
+    modulus_bits = {59, 59, 59, 59, 59};
+  }
+  auto parms = seal::EncryptionParameters(seal::scheme_type::ckks);
+  parms.set_poly_modulus_degree(kPolyDeg);
+  parms.set_coeff_modulus(seal::CoeffModulus::Create(kPolyDeg, modulus_bits));
+  seal::SEALContext context(parms, false, seal::sec_level_type::none);
+  return std::make_shared<ModulusSwitchHelper>(context, bitlen);
+}
+
+template <typename T>
+static std::vector<T> RandomVector(size_t n) {
+  std::mt19937_64 rdv(42);
+  std::vector<T> vec(n);
+  for (auto &v : vec) {
+    v = static_cast<T>(rdv());
+    if constexpr (sizeof(T) > sizeof(uint64_t)) {
+      v = (v << 64) | rdv();
+    }
+  }
+  return vec;
+}
+
+template <typename T>
+static void BM_ModulusUpAt(benchmark::State &state) {
+  auto helper = MakeHelper(sizeof(T) * 8);
+  auto src = RandomVector<T>(kPolyDeg);
+  std::vector<uint64_t> out(kPolyDeg);
+  for (auto _ : state) {
+    for (size_t l = 0; l < helper->coeff_modulus_size(); ++l) {
+      helper->ModulusUpAt(absl::MakeConstSpan(src), l, absl::MakeSpan(out));
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kPolyDeg *
+                          helper->coeff_modulus_size());
+  state.SetLabel(kernel::UseAVX2() ? "avx2" : "scalar");
+}
+
+template <typename T>
+static void BM_CenteralizeAt(benchmark::State &state) {
+  auto helper = MakeHelper(sizeof(T) * 8);
+  auto src = RandomVector<T>(kPolyDeg);
+  std::vector<uint64_t> out(kPolyDeg);
+  for (auto _ : state) {
+    for (size_t l = 0; l < helper->coeff_modulus_size(); ++l) {
+      helper->CenteralizeAt(absl::MakeConstSpan(src), l, absl::MakeSpan(out));
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kPolyDeg *
+                          helper->coeff_modulus_size());
+  state.SetLabel(kernel::UseAVX2() ? "avx2" : "scalar");
+}
+
+template <typename T>
+static void BM_ModulusDownRNS(benchmark::State &state) {
+  auto helper = MakeHelper(sizeof(T) * 8);
+  size_t num_modulus = helper->coeff_modulus_size();
+  auto src = RandomVector<T>(kPolyDeg);
+  std::vector<uint64_t> lifted(num_modulus * kPolyDeg);
+  for (size_t l = 0; l < num_modulus; ++l) {
+    helper->ModulusUpAt(absl::MakeConstSpan(src), l,
+                        absl::MakeSpan(lifted.data() + l * kPolyDeg, kPolyDeg));
+  }
+  std::vector<T> out(kPolyDeg);
+  for (auto _ : state) {
+    helper->ModulusDownRNS(absl::MakeConstSpan(lifted), absl::MakeSpan(out));
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kPolyDeg);
+}
+
+BENCHMARK_TEMPLATE(BM_ModulusUpAt, uint32_t);
+BENCHMARK_TEMPLATE(BM_ModulusUpAt, uint64_t);
+BENCHMARK_TEMPLATE(BM_ModulusUpAt, uint128_t);
+BENCHMARK_TEMPLATE(BM_CenteralizeAt, uint32_t);
+BENCHMARK_TEMPLATE(BM_CenteralizeAt, uint64_t);
+BENCHMARK_TEMPLATE(BM_CenteralizeAt, uint128_t);
+BENCHMARK_TEMPLATE(BM_ModulusDownRNS, uint32_t);
+BENCHMARK_TEMPLATE(BM_ModulusDownRNS, uint64_t);
+BENCHMARK_TEMPLATE(BM_ModulusDownRNS, uint128_t);
+
+}  // namespace heu::expt::rlwe::bench
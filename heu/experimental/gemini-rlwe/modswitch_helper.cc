@@ -16,6 +16,7 @@
 
 #include "heu/experimental/gemini-rlwe/modswitch_helper.h"
 
+#include <type_traits>
 #include <utility>
 
 #include "seal/util/numth.h"
@@ -24,6 +25,8 @@
 #include "seal/util/uintarithsmallmod.h"
 #include "yacl/base/exception.h"
 
+#include "heu/experimental/gemini-rlwe/modswitch_kernels.h"
+
 namespace heu::expt::rlwe {
 
 inline static uint64_t U64BitMask(size_t bw) {
@@ -140,6 +143,14 @@ struct ModulusSwitchHelper::Impl {
     YACL_ENFORCE(mod_idx < num_modulus,
                  fmt::format("ModulusUpAt: invalid mod_idx ({} >= {})", mod_idx,
                              num_modulus));
+    if constexpr (std::is_same_v<Scalar, uint32_t> ||
+                  std::is_same_v<Scalar, uint64_t>) {
+      if (!kernel_consts_.empty()) {
+        kernel::ModulusUp(src.data(), src.size(), kernel_consts_[mod_idx],
+                          out.data());
+        return;
+      }
+    }
     auto &modulus = context_.key_context_data()->parms().coeff_modulus();
 
     auto begin = src.data();
@@ -184,16 +195,15 @@ struct ModulusSwitchHelper::Impl {
       // Compute round(x * Q_mod_t / t) for 2^64 < x, t <= 2^128
       // round(x * Q_mod_t / t) = floor((x * Q_mod_t + t_half) / t)
       // We need 4 limbs to store the product x * Q_mod_t
-      std::vector<uint64_t> mul_limbs(2 * kU128Limbs);
-      std::vector<uint64_t> add_limbs(2 * kU128Limbs);
-      std::vector<uint64_t> rs_limbs(kU128Limbs + 1);
+      uint64_t mul_limbs[2 * kU128Limbs];
+      uint64_t add_limbs[2 * kU128Limbs];
+      uint64_t rs_limbs[kU128Limbs + 1];
       multiply_uint(Q_mod_t, kU128Limbs, xlimbs, kU128Limbs, 2 * kU128Limbs,
-                    mul_limbs.data());
-      add_uint(mul_limbs.data(), 2 * kU128Limbs, t_half, kU128Limbs,
-               /*carry*/ 0, 2 * kU128Limbs, add_limbs.data());
+                    mul_limbs);
+      add_uint(mul_limbs, 2 * kU128Limbs, t_half, kU128Limbs,
+               /*carry*/ 0, 2 * kU128Limbs, add_limbs);
       // NOTE(juhou) base_mod_bitlen_ > 64, we can direct drop the LSB here.
-      right_shift_uint192(add_limbs.data() + 1, base_mod_bitlen_ - 64,
-                          rs_limbs.data());
+      right_shift_uint192(add_limbs + 1, base_mod_bitlen_ - 64, rs_limbs);
       return BarrettReduce(u + AssignU128(rs_limbs[0], rs_limbs[1]),
                            modulus[mod_idx]);
     });
@@ -211,6 +221,14 @@ struct ModulusSwitchHelper::Impl {
     YACL_ENFORCE(mod_idx < coeff_modulus_size(),
                  "Centeralize: invalid mod_idx");
     YACL_ENFORCE(src.size() == out.size(), "Centeralize: size mismatch");
+    if constexpr (std::is_same_v<Scalar, uint32_t> ||
+                  std::is_same_v<Scalar, uint64_t>) {
+      if (!kernel_consts_.empty()) {
+        kernel::Centeralize(src.data(), src.size(), kernel_consts_[mod_idx],
+                            out.data());
+        return;
+      }
+    }
 
     auto begin = src.data();
     auto end = begin + src.size();
@@ -286,10 +304,12 @@ struct ModulusSwitchHelper::Impl {
                      });
     }
 
-    // 3-2 Then multiply with -Q^{-1} mod t
-    std::transform(
-        base_on_t.begin(), base_on_t.end(), base_on_t.data(),
-        [&](Scalar x) { return (x * neg_inv_Q_mod_t_) & mod_t_mask_; });
+    // 3-2 Then multiply with -Q^{-1} mod t. Everything is mod t from here on,
+    // so computing in Scalar instead of uint128_t is enough.
+    const auto neg_inv_Q_mod_t = static_cast<Scalar>(neg_inv_Q_mod_t_);
+    const auto mask = static_cast<Scalar>(mod_t_mask_);
+    std::transform(base_on_t.begin(), base_on_t.end(), base_on_t.data(),
+                   [&](Scalar x) { return (x * neg_inv_Q_mod_t) & mask; });
 
     // clang-format off
     // 4 Correct sign: (base_on_t - [base_on_gamma]_gamma) * gamma^{-1} mod t
@@ -304,18 +324,20 @@ struct ModulusSwitchHelper::Impl {
     // last term and gives `gamma*(x + t*r) mod t`.
     // Finally, multiply with `gamma^{-1} mod t` gives `x mod t`.
     // clang-format on
-    uint64_t gamma_div_2 = gamma_.value() >> 1;
-    std::transform(
-        base_on_gamma.get(), base_on_gamma.get() + coeff_count,
-        base_on_t.data(), out.data(), [&](uint64_t on_gamma, Scalar on_t) {
-          // [0, gamma) -> [-gamma/2, gamma/2]
-          if (on_gamma > gamma_div_2) {
-            return ((on_t + gamma_.value() - on_gamma) * inv_gamma_mod_t_) &
-                   mod_t_mask_;
-          } else {
-            return ((on_t - on_gamma) * inv_gamma_mod_t_) & mod_t_mask_;
-          }
-        });
+    // Branch-free so that the loop can be auto-vectorized
+    const uint64_t gamma = gamma_.value();
+    const uint64_t gamma_div_2 = gamma >> 1;
+    const auto inv_gamma_mod_t = static_cast<Scalar>(inv_gamma_mod_t_);
+    const uint64_t *on_gamma = base_on_gamma.get();
+    const Scalar *on_t = base_on_t.data();
+    Scalar *dst = out.data();
+    for (size_t i = 0; i < coeff_count; ++i) {
+      // [0, gamma) -> [-gamma/2, gamma/2]
+      uint64_t shift = on_gamma[i] > gamma_div_2 ? gamma : 0;
+      Scalar centered =
+          static_cast<Scalar>(on_gamma[i]) - static_cast<Scalar>(shift);
+      dst[i] = ((on_t[i] - centered) * inv_gamma_mod_t) & mask;
+    }
   }
 
  private:
@@ -336,6 +358,8 @@ struct ModulusSwitchHelper::Impl {
   uint128_t t_half_;
   uint128_t Q_mod_t_;
   std::vector<seal::util::MultiplyUIntModOperand> Q_div_t_mod_qi_;
+  // constants of the array kernels, empty if base_mod_bitlen_ > 64
+  std::vector<kernel::ModSwitchConsts> kernel_consts_;
 
   seal::SEALContext context_;
 };
@@ -385,6 +409,15 @@ void ModulusSwitchHelper::Impl::Init() {
     Q_div_t_mod_qi_[i].set(Q_div_t[i], coeff_modulus[i]);
   }
 
+  if (base_mod_bitlen_ <= 64) {
+    kernel_consts_.resize(num_modulus);
+    for (size_t i = 0; i < num_modulus; ++i) {
+      kernel_consts_[i] = kernel::MakeModSwitchConsts(
+          coeff_modulus[i].value(), Q_div_t_mod_qi_[i].operand, Lo64(Q_mod_t_),
+          base_mod_bitlen_);
+    }
+  }
+
   const auto &base_Q = *cntxt_dat->rns_tool()->base_q();
   base_Q_to_gamma_conv_ = std::make_shared<seal::util::BaseConverter>(
       base_Q, seal::util::RNSBase({gamma_}, pool), pool);
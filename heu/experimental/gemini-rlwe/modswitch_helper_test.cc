@@ -18,6 +18,8 @@
 #include "seal/seal.h"
 #include "seal/util/polyarithsmallmod.h"
 
+#include "heu/experimental/gemini-rlwe/modswitch_kernels.h"
+
 namespace heu::expt::rlwe::test {
 
 template <typename T>
@@ -331,4 +333,68 @@ TEST_P(ModSwitchTest, TestMul) {
   }
 }
 
+TEST(ModSwitchKernelTest, MatchesReference) {
+  std::mt19937_64 rdv(std::time(0));
+  // odd size to cover the scalar tail after the SIMD loop
+  constexpr size_t n = 1003;
+  // primes below and above 2^32, and a 61-bit one
+  std::vector<uint64_t> primes{1073479681ULL, 4294967311ULL,
+                               1152921504606830593ULL};
+
+  for (uint64_t q : primes) {
+    for (uint32_t k : {28U, 32U, 60U, 64U}) {
+      uint64_t mask = MakeMask<uint64_t>(k);
+      uint64_t w = rdv() % q;
+      uint64_t q_mod_t = rdv() & mask;
+      auto consts = kernel::MakeModSwitchConsts(q, w, q_mod_t, k);
+
+      std::vector<uint64_t> x64(n);
+      std::generate_n(x64.data(), n, [&]() { return rdv() & mask; });
+      // edge cases around 0 and t/2, and inputs out of [0, t)
+      x64[0] = 0;
+      x64[1] = mask;
+      x64[2] = consts.t_half - 1;
+      x64[3] = consts.t_half;
+      x64[4] = consts.t_half + 1;
+      x64[5] = rdv();
+      if (k <= 32) {
+        for (auto &x : x64) {
+          x = static_cast<uint32_t>(x);
+        }
+      }
+
+      auto expected_up = [&](uint64_t x) {
+        uint128_t u = static_cast<uint128_t>(w) * (x % q) % q;
+        uint128_t v = (static_cast<uint128_t>(q_mod_t) * x + consts.t_half) >>
+                      k;
+        return static_cast<uint64_t>((u + v % q) % q);
+      };
+      auto expected_centered = [&](uint64_t x) -> uint64_t {
+        if (x > consts.t_half) {
+          uint64_t r = (-x & mask) % q;
+          return r == 0 ? 0 : q - r;
+        }
+        return x % q;
+      };
+
+      std::vector<uint64_t> up(n);
+      std::vector<uint64_t> centered(n);
+      if (k <= 32) {
+        std::vector<uint32_t> x32(x64.begin(), x64.end());
+        kernel::ModulusUp(x32.data(), n, consts, up.data());
+        kernel::Centeralize(x32.data(), n, consts, centered.data());
+      } else {
+        kernel::ModulusUp(x64.data(), n, consts, up.data());
+        kernel::Centeralize(x64.data(), n, consts, centered.data());
+      }
+
+      for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(up[i], expected_up(x64[i])) << "q=" << q << ", k=" << k;
+        ASSERT_EQ(centered[i], expected_centered(x64[i]))
+            << "q=" << q << ", k=" << k;
+      }
+    }
+  }
+}
+
 }  // namespace heu::expt::rlwe::test
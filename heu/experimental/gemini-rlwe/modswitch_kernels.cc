@@ -0,0 +1,341 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/experimental/gemini-rlwe/modswitch_kernels.h"
+
+#include "yacl/base/exception.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define HEU_MODSWITCH_AVX2 1
+#endif
+
+namespace heu::expt::rlwe::kernel {
+
+using u128 = unsigned __int128;
+
+ModSwitchConsts MakeModSwitchConsts(uint64_t q, uint64_t q_div_t_mod_q,
+                                    uint64_t q_mod_t, uint32_t k) {
+  YACL_ENFORCE(q > 1 && q < (1ULL << 62), "prime {} is too large", q);
+  YACL_ENFORCE(q_div_t_mod_q < q);
+  YACL_ENFORCE(k >= 2 && k <= 64, "invalid base bitlen {}", k);
+
+  ModSwitchConsts c;
+  c.q = q;
+  c.barrett = static_cast<uint64_t>((static_cast<u128>(1) << 64) / q);
+  c.w = q_div_t_mod_q;
+  c.w_shoup = static_cast<uint64_t>((static_cast<u128>(c.w) << 64) / q);
+  c.t_mask = k == 64 ? static_cast<uint64_t>(-1) : (1ULL << k) - 1;
+  c.q_mod_t = q_mod_t & c.t_mask;
+  c.t_half = 1ULL << (k - 1);
+  c.k = k;
+  return c;
+}
+
+namespace {
+
+// Both reductions below leave the result in [0, 2q) before the final
+// conditional subtraction, which needs 2q < 2^63.
+
+inline uint64_t MulHi(uint64_t a, uint64_t b) {
+  return static_cast<uint64_t>((static_cast<u128>(a) * b) >> 64);
+}
+
+inline uint64_t ReduceOnce(uint64_t r, uint64_t q) {
+  return r >= q ? r - q : r;
+}
+
+inline uint64_t BarrettReduce(uint64_t x, const ModSwitchConsts &c) {
+  return ReduceOnce(x - MulHi(x, c.barrett) * c.q, c.q);
+}
+
+// x * w mod q
+inline uint64_t MulShoup(uint64_t x, const ModSwitchConsts &c) {
+  return ReduceOnce(x * c.w - MulHi(x, c.w_shoup) * c.q, c.q);
+}
+
+// round(Q/t * x) mod q = (floor(Q/t) * x + round((Q mod t) * x / t)) mod q
+inline uint64_t ModulusUpOne(uint64_t x, uint64_t v, const ModSwitchConsts &c) {
+  uint64_t u = MulShoup(BarrettReduce(x, c), c);
+  return ReduceOnce(u + BarrettReduce(v, c), c.q);
+}
+
+inline uint64_t CenteralizeOne(uint64_t x, const ModSwitchConsts &c) {
+  if (x > c.t_half) {
+    uint64_t r = BarrettReduce(-x & c.t_mask, c);
+    return r == 0 ? 0 : c.q - r;
+  }
+  return BarrettReduce(x, c);
+}
+
+void ModulusUpScalar(const uint32_t *x, size_t n, const ModSwitchConsts &c,
+                     uint64_t *out) {
+  for (size_t i = 0; i < n; ++i) {
+    // k <= 32, so the product fits in 64 bits
+    uint64_t v = (c.q_mod_t * x[i] + c.t_half) >> c.k;
+    out[i] = ModulusUpOne(x[i], v, c);
+  }
+}
+
+void ModulusUpScalar(const uint64_t *x, size_t n, const ModSwitchConsts &c,
+                     uint64_t *out) {
+  for (size_t i = 0; i < n; ++i) {
+    auto v = static_cast<uint64_t>(
+        (static_cast<u128>(c.q_mod_t) * x[i] + c.t_half) >> c.k);
+    out[i] = ModulusUpOne(x[i], v, c);
+  }
+}
+
+template <typename T>
+void CenteralizeScalar(const T *x, size_t n, const ModSwitchConsts &c,
+                       uint64_t *out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = CenteralizeOne(x[i], c);
+  }
+}
+
+#ifdef HEU_MODSWITCH_AVX2
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+// AVX2 has no 64 x 64 bit multiplication, the products are assembled from
+// 32 x 32 -> 64 bit _mm256_mul_epu32 of the halves.
+
+AVX2_TARGET inline __m256i MulLo64(__m256i a, __m256i b) {
+  __m256i cross = _mm256_add_epi64(
+      _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)),
+      _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b));
+  return _mm256_add_epi64(_mm256_mul_epu32(a, b),
+                          _mm256_slli_epi64(cross, 32));
+}
+
+AVX2_TARGET inline void MulFull64(__m256i a, __m256i b, __m256i *lo,
+                                  __m256i *hi) {
+  const __m256i lo32 = _mm256_set1_epi64x(0xffffffff);
+  __m256i ah = _mm256_srli_epi64(a, 32);
+  __m256i bh = _mm256_srli_epi64(b, 32);
+  __m256i ll = _mm256_mul_epu32(a, b);
+  __m256i lh = _mm256_mul_epu32(a, bh);
+  __m256i hl = _mm256_mul_epu32(ah, b);
+  __m256i hh = _mm256_mul_epu32(ah, bh);
+
+  __m256i mid = _mm256_add_epi64(_mm256_srli_epi64(ll, 32),
+                                 _mm256_and_si256(lh, lo32));
+  mid = _mm256_add_epi64(mid, _mm256_and_si256(hl, lo32));
+  *hi = _mm256_add_epi64(hh, _mm256_srli_epi64(lh, 32));
+  *hi = _mm256_add_epi64(*hi, _mm256_srli_epi64(hl, 32));
+  *hi = _mm256_add_epi64(*hi, _mm256_srli_epi64(mid, 32));
+  *lo = _mm256_or_si256(_mm256_slli_epi64(mid, 32), _mm256_and_si256(ll, lo32));
+}
+
+AVX2_TARGET inline __m256i MulHi64(__m256i a, __m256i b) {
+  __m256i lo, hi;
+  MulFull64(a, b, &lo, &hi);
+  return hi;
+}
+
+// r in [0, 2q) -> r mod q, signed comparison is fine since 2q < 2^63
+AVX2_TARGET inline __m256i ReduceOnce(__m256i r, __m256i q) {
+  __m256i lt = _mm256_cmpgt_epi64(q, r);
+  return _mm256_sub_epi64(r, _mm256_andnot_si256(lt, q));
+}
+
+AVX2_TARGET inline __m256i BarrettReduce(__m256i x, __m256i barrett,
+                                         __m256i q) {
+  __m256i est = MulHi64(x, barrett);
+  return ReduceOnce(_mm256_sub_epi64(x, MulLo64(est, q)), q);
+}
+
+AVX2_TARGET inline __m256i MulShoup(__m256i x, __m256i w, __m256i w_shoup,
+                                    __m256i q) {
+  __m256i est = MulHi64(x, w_shoup);
+  return ReduceOnce(_mm256_sub_epi64(MulLo64(x, w), MulLo64(est, q)), q);
+}
+
+// x > y as unsigned 64-bit integers
+AVX2_TARGET inline __m256i CmpGtU64(__m256i x, __m256i y) {
+  const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+  return _mm256_cmpgt_epi64(_mm256_xor_si256(x, sign),
+                            _mm256_xor_si256(y, sign));
+}
+
+AVX2_TARGET void ModulusUpAVX2(const uint32_t *x, size_t n,
+                               const ModSwitchConsts &c, uint64_t *out) {
+  const __m256i q = _mm256_set1_epi64x(c.q);
+  const __m256i q_mod_t = _mm256_set1_epi64x(c.q_mod_t);
+  const __m256i t_half = _mm256_set1_epi64x(c.t_half);
+  const __m128i k = _mm_cvtsi32_si128(static_cast<int>(c.k));
+  const __m256i w = _mm256_set1_epi64x(c.w);
+  const __m256i w_shoup = _mm256_set1_epi64x(c.w_shoup);
+  const __m256i barrett = _mm256_set1_epi64x(c.barrett);
+  // If q > 2^32, then x < q, and all of x, floor(x * w_shoup / 2^64) and v
+  // are 32-bit, so the products only take half of the partial products.
+  const bool small_x = c.q > (1ULL << 32);
+  const __m256i w_hi = _mm256_srli_epi64(w, 32);
+  const __m256i w_shoup_hi = _mm256_srli_epi64(w_shoup, 32);
+  const __m256i q_hi = _mm256_srli_epi64(q, 32);
+
+  for (size_t i = 0; i + 4 <= n; i += 4) {
+    __m256i xi = _mm256_cvtepu32_epi64(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(x + i)));
+    // k <= 32 and q_mod_t < 2^k, so the product fits in 64 bits
+    __m256i v = _mm256_srl_epi64(
+        _mm256_add_epi64(_mm256_mul_epu32(xi, q_mod_t), t_half), k);
+
+    __m256i res;
+    if (small_x) {
+      __m256i est = _mm256_srli_epi64(
+          _mm256_add_epi64(
+              _mm256_mul_epu32(xi, w_shoup_hi),
+              _mm256_srli_epi64(_mm256_mul_epu32(xi, w_shoup), 32)),
+          32);
+      __m256i xw = _mm256_add_epi64(
+          _mm256_mul_epu32(xi, w),
+          _mm256_slli_epi64(_mm256_mul_epu32(xi, w_hi), 32));
+      __m256i eq = _mm256_add_epi64(
+          _mm256_mul_epu32(est, q),
+          _mm256_slli_epi64(_mm256_mul_epu32(est, q_hi), 32));
+      __m256i u = ReduceOnce(_mm256_sub_epi64(xw, eq), q);
+      res = ReduceOnce(_mm256_add_epi64(u, v), q);
+    } else {
+      __m256i u = MulShoup(BarrettReduce(xi, barrett, q), w, w_shoup, q);
+      res = ReduceOnce(_mm256_add_epi64(u, BarrettReduce(v, barrett, q)), q);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), res);
+  }
+}
+
+AVX2_TARGET void ModulusUpAVX2(const uint64_t *x, size_t n,
+                               const ModSwitchConsts &c, uint64_t *out) {
+  const __m256i q = _mm256_set1_epi64x(c.q);
+  const __m256i q_mod_t = _mm256_set1_epi64x(c.q_mod_t);
+  const __m256i t_half = _mm256_set1_epi64x(c.t_half);
+  // v = floor((hi * 2^64 + lo) / 2^k), a shift by 64 gives zero
+  const __m128i k = _mm_cvtsi32_si128(static_cast<int>(c.k));
+  const __m128i k_comp = _mm_cvtsi32_si128(static_cast<int>(64 - c.k));
+  const __m256i w = _mm256_set1_epi64x(c.w);
+  const __m256i w_shoup = _mm256_set1_epi64x(c.w_shoup);
+  const __m256i barrett = _mm256_set1_epi64x(c.barrett);
+
+  for (size_t i = 0; i + 4 <= n; i += 4) {
+    __m256i xi =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + i));
+    __m256i lo, hi;
+    MulFull64(xi, q_mod_t, &lo, &hi);
+    __m256i sum = _mm256_add_epi64(lo, t_half);
+    // add the carry, the mask is -1 on carry
+    hi = _mm256_sub_epi64(hi, CmpGtU64(lo, sum));
+    __m256i v = _mm256_or_si256(_mm256_sll_epi64(hi, k_comp),
+                                _mm256_srl_epi64(sum, k));
+
+    __m256i u = MulShoup(BarrettReduce(xi, barrett, q), w, w_shoup, q);
+    __m256i res =
+        ReduceOnce(_mm256_add_epi64(u, BarrettReduce(v, barrett, q)), q);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), res);
+  }
+}
+
+AVX2_TARGET inline __m256i CenteralizeAVX2(__m256i x, const ModSwitchConsts &c,
+                                           bool small_x) {
+  const __m256i q = _mm256_set1_epi64x(c.q);
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i neg = CmpGtU64(x, _mm256_set1_epi64x(c.t_half));
+  __m256i y = _mm256_blendv_epi8(
+      x,
+      _mm256_and_si256(_mm256_sub_epi64(zero, x),
+                       _mm256_set1_epi64x(c.t_mask)),
+      neg);
+  if (!small_x) {
+    y = BarrettReduce(y, _mm256_set1_epi64x(c.barrett), q);
+  }
+  // q - y if x is negative and y != 0
+  __m256i flip = _mm256_andnot_si256(_mm256_cmpeq_epi64(y, zero), neg);
+  return _mm256_blendv_epi8(y, _mm256_sub_epi64(q, y), flip);
+}
+
+AVX2_TARGET void CenteralizeAVX2(const uint32_t *x, size_t n,
+                                 const ModSwitchConsts &c, uint64_t *out) {
+  // no reduction is needed for 32-bit x if q > 2^32
+  const bool small_x = c.q > (1ULL << 32);
+  for (size_t i = 0; i + 4 <= n; i += 4) {
+    __m256i xi = _mm256_cvtepu32_epi64(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(x + i)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+                        CenteralizeAVX2(xi, c, small_x));
+  }
+}
+
+AVX2_TARGET void CenteralizeAVX2(const uint64_t *x, size_t n,
+                                 const ModSwitchConsts &c, uint64_t *out) {
+  for (size_t i = 0; i + 4 <= n; i += 4) {
+    __m256i xi =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+                        CenteralizeAVX2(xi, c, false));
+  }
+}
+
+#undef AVX2_TARGET
+
+#endif  // HEU_MODSWITCH_AVX2
+
+// Runs the AVX2 kernel on whole groups of 4 and the scalar one on the rest
+#ifdef HEU_MODSWITCH_AVX2
+#define DISPATCH(name, x, n, c, out)            \
+  do {                                          \
+    size_t n4 = UseAVX2() ? (n) & ~size_t{3} : 0; \
+    if (n4 > 0) {                               \
+      name##AVX2(x, n4, c, out);                \
+    }                                           \
+    name##Scalar((x) + n4, (n) - n4, c, (out) + n4); \
+  } while (0)
+#else
+#define DISPATCH(name, x, n, c, out) name##Scalar(x, n, c, out)
+#endif
+
+}  // namespace
+
+bool UseAVX2() {
+#ifdef HEU_MODSWITCH_AVX2
+  static const bool kHasAVX2 = __builtin_cpu_supports("avx2");
+  return kHasAVX2;
+#else
+  return false;
+#endif
+}
+
+void ModulusUp(const uint32_t *x, size_t n, const ModSwitchConsts &c,
+               uint64_t *out) {
+  YACL_ENFORCE(c.k <= 32);
+  DISPATCH(ModulusUp, x, n, c, out);
+}
+
+void ModulusUp(const uint64_t *x, size_t n, const ModSwitchConsts &c,
+               uint64_t *out) {
+  DISPATCH(ModulusUp, x, n, c, out);
+}
+
+void Centeralize(const uint32_t *x, size_t n, const ModSwitchConsts &c,
+                 uint64_t *out) {
+  DISPATCH(Centeralize, x, n, c, out);
+}
+
+void Centeralize(const uint64_t *x, size_t n, const ModSwitchConsts &c,
+                 uint64_t *out) {
+  DISPATCH(Centeralize, x, n, c, out);
+}
+
+#undef DISPATCH
+
+}  // namespace heu::expt::rlwe::kernel
@@ -0,0 +1,55 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Array kernels behind ModulusSwitchHelper for base_mod_bitlen <= 64. An AVX2
+// version that processes 4 coefficients at a time is picked at runtime if the
+// CPU supports it, otherwise a portable scalar version runs.
+namespace heu::expt::rlwe::kernel {
+
+// Precomputed constants of a prime q < 2^62 and the ring Z_t, t = 2^k
+struct ModSwitchConsts {
+  uint64_t q;
+  uint64_t barrett;  // floor(2^64 / q)
+  uint64_t w;        // floor(Q / t) mod q
+  uint64_t w_shoup;  // floor(w * 2^64 / q)
+  uint64_t q_mod_t;  // Q mod t
+  uint64_t t_half;   // 2^{k-1}
+  uint64_t t_mask;   // 2^k - 1
+  uint32_t k;
+};
+
+ModSwitchConsts MakeModSwitchConsts(uint64_t q, uint64_t q_div_t_mod_q,
+                                    uint64_t q_mod_t, uint32_t k);
+
+// out[i] = round(Q/t * x[i]) mod q, for k <= 32 and k <= 64 respectively
+void ModulusUp(const uint32_t *x, size_t n, const ModSwitchConsts &c,
+               uint64_t *out);
+void ModulusUp(const uint64_t *x, size_t n, const ModSwitchConsts &c,
+               uint64_t *out);
+
+// out[i] = x[i] mod q, with x[i] viewed in [-t/2, t/2)
+void Centeralize(const uint32_t *x, size_t n, const ModSwitchConsts &c,
+                 uint64_t *out);
+void Centeralize(const uint64_t *x, size_t n, const ModSwitchConsts &c,
+                 uint64_t *out);
+
+// Whether the AVX2 kernels are used on this CPU
+bool UseAVX2();
+
+}  // namespace heu::expt::rlwe::kernel
@@ -0,0 +1,438 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/experimental/gemini-rlwe/seeded_ct.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "seal/util/ntt.h"
+#include "seal/util/polyarithsmallmod.h"
+#include "seal/util/rlwe.h"
+#include "seal/valcheck.h"
+#include "yacl/base/exception.h"
+#include "yacl/utils/parallel.h"
+
+namespace heu::expt::rlwe {
+
+// The c1 of modulus l is sampled from its own Blake2xb stream whose seed is
+// the ciphertext seed with l mixed in. Rejection sampling keeps it exactly
+// uniform, the same as seal::util::sample_poly_uniform().
+static void SampleUniformFromSeed(const seal::prng_seed_type &seed,
+                                  size_t mod_idx, const seal::Modulus &prime,
+                                  size_t num_coeff, uint64_t *dst) {
+  using namespace seal::util;
+  seal::prng_seed_type stream_seed = seed;
+  stream_seed[0] ^= static_cast<uint64_t>(mod_idx);
+  seal::Blake2xbPRNG prng(stream_seed);
+
+  constexpr uint64_t max_random = static_cast<uint64_t>(0xFFFFFFFFFFFFFFFFULL);
+  // sample from [0, n*p) such that n*p ~ 2^64
+  auto max_multiple = max_random - barrett_reduce_64(max_random, prime) - 1;
+  prng.generate(num_coeff * sizeof(uint64_t),
+                reinterpret_cast<seal::seal_byte *>(dst));
+  std::transform(dst, dst + num_coeff, dst, [&](uint64_t r) {
+    while (r >= max_multiple) {
+      prng.generate(sizeof(uint64_t), reinterpret_cast<seal::seal_byte *>(&r));
+    }
+    return barrett_reduce_64(r, prime);
+  });
+}
+
+SeededRLWECt::~SeededRLWECt() {}
+
+void SeededRLWECt::Expand(const seal::SEALContext &context,
+                          RLWECt *out) const {
+  yacl::CheckNotNull(out);
+  YACL_ENFORCE(IsValid(), "invalid SeededRLWECt");
+  auto cntxt_dat = context.get_context_data(parms_id());
+  YACL_ENFORCE(cntxt_dat != nullptr,
+               "invalid SeededRLWECt.parms_id for the context");
+  const auto &modulus = cntxt_dat->parms().coeff_modulus();
+  size_t num_coeff = cntxt_dat->parms().poly_modulus_degree();
+  size_t num_modulus = modulus.size();
+  YACL_ENFORCE_EQ(c0_.coeff_count(), num_coeff * num_modulus);
+
+  out->resize(context, parms_id(), 2);
+  out->is_ntt_form() = true;
+  out->scale() = c0_.scale();
+  std::copy_n(c0_.data(), num_coeff * num_modulus, out->data(0));
+  yacl::parallel_for(0, num_modulus, 1, [&](int64_t beg, int64_t end) {
+    for (int64_t l = beg; l < end; ++l) {
+      SampleUniformFromSeed(seed_, l, modulus[l], num_coeff,
+                            out->data(1) + l * num_coeff);
+    }
+  });
+}
+
+void SeededRLWECt::ExtractLWEs(absl::Span<const size_t> coeff_indices,
+                               const seal::SEALContext &context,
+                               std::vector<SeededLWECt> *out) const {
+  yacl::CheckNotNull(out);
+  YACL_ENFORCE(IsValid(), "invalid SeededRLWECt");
+  auto cntxt_dat = context.get_context_data(parms_id());
+  YACL_ENFORCE(cntxt_dat != nullptr,
+               "invalid SeededRLWECt.parms_id for the context");
+  size_t num_coeff = cntxt_dat->parms().poly_modulus_degree();
+  size_t num_modulus = cntxt_dat->parms().coeff_modulus().size();
+  auto ntt_tables = cntxt_dat->small_ntt_tables();
+
+  // the constant terms are taken from c0 in the coefficient form
+  std::vector<uint64_t> c0(c0_.data(), c0_.data() + num_coeff * num_modulus);
+  for (size_t l = 0; l < num_modulus; ++l) {
+    seal::util::inverse_ntt_negacyclic_harvey(c0.data() + l * num_coeff,
+                                              ntt_tables[l]);
+  }
+
+  out->resize(coeff_indices.size());
+  for (size_t i = 0; i < coeff_indices.size(); ++i) {
+    size_t coeff_index = coeff_indices[i];
+    YACL_ENFORCE(coeff_index < num_coeff,
+                 fmt::format("coefficient index out-of-bound {} >= {}",
+                             coeff_index, num_coeff));
+    auto &lwe = out->at(i);
+    lwe.poly_deg_ = num_coeff;
+    lwe.coeff_index_ = coeff_index;
+    lwe.scale_ = c0_.scale();
+    lwe.parms_id_ = parms_id();
+    lwe.seed_ = seed_;
+    lwe.cnst_term_.resize(num_modulus);
+    for (size_t l = 0; l < num_modulus; ++l) {
+      lwe.cnst_term_[l] = c0[l * num_coeff + coeff_index];
+    }
+  }
+}
+
+size_t SeededRLWECt::save_size(seal::compr_mode_type compr_mode) const {
+  using namespace seal;
+  size_t members_size = Serialization::ComprSizeEstimate(
+      util::add_safe(
+          util::safe_cast<size_t>(c0_.save_size(compr_mode_type::none)),
+          sizeof(seed_)),
+      compr_mode);
+
+  return util::add_safe(sizeof(Serialization::SEALHeader), members_size);
+}
+
+void SeededRLWECt::save(seal::seal_byte *buffer, size_t size,
+                        seal::compr_mode_type compr_mode) const {
+  using namespace std::placeholders;
+  seal::Serialization::Save(std::bind(&SeededRLWECt::save_members, this, _1),
+                            save_size(seal::compr_mode_type::none), buffer,
+                            size, compr_mode, false);
+}
+
+void SeededRLWECt::save_members(std::ostream &stream) const {
+  YACL_ENFORCE(IsValid(), "invalid SeededRLWECt");
+  auto old_except_mask = stream.exceptions();
+  try {
+    // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
+    stream.exceptions(std::ios_base::badbit | std::ios_base::failbit);
+    c0_.save(stream, seal::compr_mode_type::none);
+    stream.write(reinterpret_cast<const char *>(seed_.data()), sizeof(seed_));
+  } catch (const std::ios_base::failure &) {
+    stream.exceptions(old_except_mask);
+    YACL_THROW_IO_ERROR("failed to save SeededRLWECt due to I/O error");
+  } catch (...) {
+    stream.exceptions(old_except_mask);
+    YACL_THROW("failed to save SeededRLWECt");
+  }
+  stream.exceptions(old_except_mask);
+}
+
+void SeededRLWECt::load(const seal::SEALContext &context,
+                        const seal::seal_byte *buffer, size_t size) {
+  SeededRLWECt tmp;
+  tmp.unsafe_load(context, buffer, size);
+  YACL_ENFORCE(tmp.c0_.is_ntt_form() && seal::is_valid_for(tmp.c0_, context),
+               "invalid SeededRLWECt for the context");
+  std::swap(*this, tmp);
+}
+
+void SeededRLWECt::unsafe_load(const seal::SEALContext &context,
+                               const seal::seal_byte *buffer, size_t size) {
+  using namespace std::placeholders;
+  seal::Serialization::Load(
+      std::bind(&SeededRLWECt::load_members, this, context, _1, _2), buffer,
+      size, false);
+}
+
+void SeededRLWECt::load_members(const seal::SEALContext &context,
+                                std::istream &stream,
+                                SEAL_MAYBE_UNUSED seal::SEALVersion version) {
+  YACL_ENFORCE(context.parameters_set());
+  auto old_except_mask = stream.exceptions();
+  SeededRLWECt tmp;
+  try {
+    // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
+    stream.exceptions(std::ios_base::badbit | std::ios_base::failbit);
+    tmp.c0_.unsafe_load(context, stream);
+    stream.read(reinterpret_cast<char *>(tmp.seed_.data()), sizeof(seed_));
+  } catch (const std::ios_base::failure &) {
+    stream.exceptions(old_except_mask);
+    YACL_THROW_IO_ERROR("failed to load SeededRLWECt due to I/O error");
+  } catch (...) {
+    stream.exceptions(old_except_mask);
+    YACL_THROW("failed to load SeededRLWECt");
+  }
+  stream.exceptions(old_except_mask);
+
+  std::swap(*this, tmp);
+}
+
+SeededLWECt::~SeededLWECt() {}
+
+void SeededLWECt::Expand(const seal::SEALContext &context, LWECt *out) const {
+  yacl::CheckNotNull(out);
+  YACL_ENFORCE(IsValid(), "invalid SeededLWECt");
+  auto cntxt_dat = context.get_context_data(parms_id_);
+  YACL_ENFORCE(cntxt_dat != nullptr,
+               "invalid SeededLWECt.parms_id for the context");
+  const auto &modulus = cntxt_dat->parms().coeff_modulus();
+  size_t num_coeff = cntxt_dat->parms().poly_modulus_degree();
+  size_t num_modulus = modulus.size();
+  YACL_ENFORCE_EQ(num_coeff, poly_deg_);
+  YACL_ENFORCE_EQ(num_modulus, cnst_term_.size());
+  auto ntt_tables = cntxt_dat->small_ntt_tables();
+
+  // Only the coefficient coeff_index_ of c0 matters for the extraction
+  RLWECt rlwe;
+  rlwe.resize(context, parms_id_, 2);
+  rlwe.is_ntt_form() = false;
+  rlwe.scale() = scale_;
+  std::fill_n(rlwe.data(0), num_coeff * num_modulus, 0);
+  yacl::parallel_for(0, num_modulus, 1, [&](int64_t beg, int64_t end) {
+    for (int64_t l = beg; l < end; ++l) {
+      auto c1_ptr = rlwe.data(1) + l * num_coeff;
+      SampleUniformFromSeed(seed_, l, modulus[l], num_coeff, c1_ptr);
+      seal::util::inverse_ntt_negacyclic_harvey(c1_ptr, ntt_tables[l]);
+      rlwe.data(0)[l * num_coeff + coeff_index_] = cnst_term_[l];
+    }
+  });
+
+  *out = LWECt(rlwe, coeff_index_, context);
+}
+
+size_t SeededLWECt::save_size(seal::compr_mode_type compr_mode) const {
+  using namespace seal;
+  size_t members_size = Serialization::ComprSizeEstimate(
+      util::add_safe(sizeof(parms_id_), sizeof(scale_),
+                     sizeof(uint64_t),  // poly_deg
+                     sizeof(coeff_index_), sizeof(seed_),
+                     sizeof(uint32_t),  // num_modulus
+                     util::mul_safe(sizeof(uint64_t), cnst_term_.size())),
+      compr_mode);
+
+  return util::add_safe(sizeof(Serialization::SEALHeader), members_size);
+}
+
+void SeededLWECt::save(seal::seal_byte *buffer, size_t size,
+                       seal::compr_mode_type compr_mode) const {
+  using namespace std::placeholders;
+  seal::Serialization::Save(std::bind(&SeededLWECt::save_members, this, _1),
+                            save_size(seal::compr_mode_type::none), buffer,
+                            size, compr_mode, false);
+}
+
+void SeededLWECt::save_members(std::ostream &stream) const {
+  YACL_ENFORCE(IsValid(), "invalid SeededLWECt");
+  auto old_except_mask = stream.exceptions();
+  try {
+    // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
+    stream.exceptions(std::ios_base::badbit | std::ios_base::failbit);
+    uint64_t poly_deg = poly_deg_;
+    uint32_t num_modulus = static_cast<uint32_t>(cnst_term_.size());
+    stream.write(reinterpret_cast<const char *>(parms_id_.data()),
+                 sizeof(parms_id_));
+    stream.write(reinterpret_cast<const char *>(&scale_), sizeof(scale_));
+    stream.write(reinterpret_cast<const char *>(&poly_deg), sizeof(uint64_t));
+    stream.write(reinterpret_cast<const char *>(&coeff_index_),
+                 sizeof(coeff_index_));
+    stream.write(reinterpret_cast<const char *>(seed_.data()), sizeof(seed_));
+    stream.write(reinterpret_cast<const char *>(&num_modulus),
+                 sizeof(uint32_t));
+    for (uint64_t cnst : cnst_term_) {
+      stream.write(reinterpret_cast<const char *>(&cnst), sizeof(uint64_t));
+    }
+  } catch (const std::ios_base::failure &) {
+    stream.exceptions(old_except_mask);
+    YACL_THROW_IO_ERROR("failed to save SeededLWECt due to I/O error");
+  } catch (...) {
+    stream.exceptions(old_except_mask);
+    YACL_THROW("failed to save SeededLWECt");
+  }
+  stream.exceptions(old_except_mask);
+}
+
+void SeededLWECt::load(const seal::SEALContext &context,
+                       const seal::seal_byte *buffer, size_t size) {
+  SeededLWECt tmp;
+  tmp.unsafe_load(context, buffer, size);
+
+  auto cntxt_dat = context.get_context_data(tmp.parms_id_);
+  YACL_ENFORCE(cntxt_dat != nullptr,
+               "invalid SeededLWECt.parms_id for the context");
+  const auto &modulus = cntxt_dat->parms().coeff_modulus();
+  YACL_ENFORCE_EQ(tmp.poly_deg_, cntxt_dat->parms().poly_modulus_degree());
+  YACL_ENFORCE_EQ(tmp.cnst_term_.size(), modulus.size());
+  YACL_ENFORCE(tmp.coeff_index_ < tmp.poly_deg_);
+  for (size_t l = 0; l < modulus.size(); ++l) {
+    YACL_ENFORCE(tmp.cnst_term_[l] < modulus[l].value());
+  }
+
+  std::swap(*this, tmp);
+}
+
+void SeededLWECt::unsafe_load(const seal::SEALContext &context,
+                              const seal::seal_byte *buffer, size_t size) {
+  using namespace std::placeholders;
+  seal::Serialization::Load(
+      std::bind(&SeededLWECt::load_members, this, context, _1, _2), buffer,
+      size, false);
+}
+
+void SeededLWECt::load_members(const seal::SEALContext &context,
+                               std::istream &stream,
+                               SEAL_MAYBE_UNUSED seal::SEALVersion version) {
+  YACL_ENFORCE(context.parameters_set());
+  auto old_except_mask = stream.exceptions();
+  SeededLWECt tmp;
+  try {
+    // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
+    stream.exceptions(std::ios_base::badbit | std::ios_base::failbit);
+    uint64_t poly_deg;
+    uint32_t num_modulus;
+    stream.read(reinterpret_cast<char *>(tmp.parms_id_.data()),
+                sizeof(parms_id_));
+    stream.read(reinterpret_cast<char *>(&tmp.scale_), sizeof(scale_));
+    stream.read(reinterpret_cast<char *>(&poly_deg), sizeof(uint64_t));
+    stream.read(reinterpret_cast<char *>(&tmp.coeff_index_),
+                sizeof(coeff_index_));
+    stream.read(reinterpret_cast<char *>(tmp.seed_.data()), sizeof(seed_));
+    stream.read(reinterpret_cast<char *>(&num_modulus), sizeof(uint32_t));
+    YACL_ENFORCE(num_modulus <= SEAL_COEFF_MOD_COUNT_MAX);
+
+    tmp.poly_deg_ = poly_deg;
+    tmp.cnst_term_.resize(num_modulus);
+    for (size_t l = 0; l < num_modulus; ++l) {
+      stream.read(reinterpret_cast<char *>(&tmp.cnst_term_[l]),
+                  sizeof(uint64_t));
+    }
+  } catch (const std::ios_base::failure &) {
+    stream.exceptions(old_except_mask);
+    YACL_THROW_IO_ERROR("failed to load SeededLWECt due to I/O error");
+  } catch (...) {
+    stream.exceptions(old_except_mask);
+    YACL_THROW("failed to load SeededLWECt");
+  }
+  stream.exceptions(old_except_mask);
+
+  std::swap(*this, tmp);
+}
+
+SeededEncryptor::SeededEncryptor(const seal::SEALContext &context,
+                                 const RLWESecretKey &secret_key)
+    : context_(context), secret_key_(secret_key) {
+  YACL_ENFORCE(context_.parameters_set(), "invalid seal context");
+  YACL_ENFORCE(seal::is_valid_for(secret_key_, context_),
+               "invalid secret key for this context");
+}
+
+void SeededEncryptor::EncryptSymmetric(const RLWEPt &plain,
+                                       SeededRLWECt *out) const {
+  using namespace seal::util;
+  yacl::CheckNotNull(out);
+  YACL_ENFORCE(plain.is_ntt_form(), "plaintext should be in the NTT form");
+  YACL_ENFORCE(seal::is_valid_for(plain, context_),
+               "invalid plaintext for this context");
+
+  auto cntxt_dat = context_.get_context_data(plain.parms_id());
+  const auto &parms = cntxt_dat->parms();
+  const auto &modulus = parms.coeff_modulus();
+  size_t num_coeff = parms.poly_modulus_degree();
+  size_t num_modulus = modulus.size();
+  auto ntt_tables = cntxt_dat->small_ntt_tables();
+
+  auto prng_factory = parms.random_generator();
+  if (!prng_factory) {
+    prng_factory = seal::UniformRandomGeneratorFactory::DefaultFactory();
+  }
+  auto prng = prng_factory->create();
+
+  SeededRLWECt ct;
+  prng->generate(sizeof(ct.seed_),
+                 reinterpret_cast<seal::seal_byte *>(ct.seed_.data()));
+
+  // e in the coefficient form
+  std::vector<uint64_t> noise(num_coeff * num_modulus);
+  sample_poly_cbd(prng, parms, noise.data());
+
+  // c0 = -c1 * s + e + m in the NTT form. The secret key is at the key level
+  // whose moduli start with the ones of any other level.
+  ct.c0_.parms_id() = seal::parms_id_zero;
+  ct.c0_.resize(num_coeff * num_modulus);
+  std::vector<uint64_t> c1(num_coeff);
+  for (size_t l = 0; l < num_modulus; ++l) {
+    auto c0_ptr = ct.c0_.data() + l * num_coeff;
+    auto e_ptr = noise.data() + l * num_coeff;
+    SampleUniformFromSeed(ct.seed_, l, modulus[l], num_coeff, c1.data());
+    ntt_negacyclic_harvey(e_ptr, ntt_tables[l]);
+
+    dyadic_product_coeffmod(c1.data(),
+                            secret_key_.data().data() + l * num_coeff,
+                            num_coeff, modulus[l], c0_ptr);
+    sub_poly_coeffmod(e_ptr, c0_ptr, num_coeff, modulus[l], c0_ptr);
+    add_poly_coeffmod(c0_ptr, plain.data() + l * num_coeff, num_coeff,
+                      modulus[l], c0_ptr);
+  }
+  ct.c0_.parms_id() = plain.parms_id();
+  ct.c0_.scale() = plain.scale();
+
+  *out = std::move(ct);
+}
+
+void SeededEncryptor::EncryptSymmetric(absl::Span<const RLWEPt> plains,
+                                       std::vector<SeededRLWECt> *out) const {
+  yacl::CheckNotNull(out);
+  out->resize(plains.size());
+  yacl::parallel_for(0, plains.size(), 1, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      EncryptSymmetric(plains[i], &out->at(i));
+    }
+  });
+}
+
+void ExpandSeeded(absl::Span<const SeededRLWECt> seeded,
+                  const seal::SEALContext &context, std::vector<RLWECt> *out) {
+  yacl::CheckNotNull(out);
+  out->resize(seeded.size());
+  yacl::parallel_for(0, seeded.size(), 1, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      seeded[i].Expand(context, &out->at(i));
+    }
+  });
+}
+
+void ExpandSeeded(absl::Span<const SeededLWECt> seeded,
+                  const seal::SEALContext &context, std::vector<LWECt> *out) {
+  yacl::CheckNotNull(out);
+  out->resize(seeded.size());
+  yacl::parallel_for(0, seeded.size(), 1, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      seeded[i].Expand(context, &out->at(i));
+    }
+  });
+}
+
+}  // namespace heu::expt::rlwe
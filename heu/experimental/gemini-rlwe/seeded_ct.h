@@ -0,0 +1,156 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "absl/types/span.h"
+#include "seal/randomgen.h"
+
+#include "heu/experimental/gemini-rlwe/lwe_types.h"
+
+namespace heu::expt::rlwe {
+
+class SeededEncryptor;
+class SeededLWECt;
+
+/// A freshly encrypted symmetric RLWE ciphertext (c0, c1) whose c1 is the
+/// output of a PRNG on a short seed. Only c0 and the seed are serialized, which
+/// is about half the size of the RLWECt. The receiver calls Expand() to get
+/// the RLWECt back.
+class SeededRLWECt {
+ public:
+  SeededRLWECt() {}
+
+  ~SeededRLWECt();
+
+  inline bool IsValid() const { return c0_.coeff_count() > 0; }
+
+  seal::parms_id_type parms_id() const { return c0_.parms_id(); }
+
+  /// Expands to the RLWECt in the NTT form, i.e. the same ciphertext as
+  /// seal::Encryptor::encrypt_symmetric() outputs. The moduli are expanded in
+  /// parallel.
+  void Expand(const seal::SEALContext &context, RLWECt *out) const;
+
+  /// Extracts the LWE ciphertexts of the given coefficients, see LWECt. They
+  /// still carry the seed instead of the vector part.
+  void ExtractLWEs(absl::Span<const size_t> coeff_indices,
+                   const seal::SEALContext &context,
+                   std::vector<SeededLWECt> *out) const;
+
+  size_t save_size(seal::compr_mode_type compr_mode =
+                       seal::Serialization::compr_mode_default) const;
+
+  void save(seal::seal_byte *buffer, size_t size,
+            seal::compr_mode_type compr_mode =
+                seal::Serialization::compr_mode_default) const;
+
+  void load(const seal::SEALContext &context, const seal::seal_byte *buffer,
+            size_t size);
+
+  void unsafe_load(const seal::SEALContext &context,
+                   const seal::seal_byte *buffer, size_t size);
+
+ private:
+  void save_members(std::ostream &stream) const;
+
+  void load_members(const seal::SEALContext &context, std::istream &stream,
+                    seal::SEALVersion version);
+
+  friend class SeededEncryptor;
+
+  seal::prng_seed_type seed_{};
+  // c0 in the NTT form, which also keeps the parms_id and the scale
+  RLWEPt c0_;
+};
+
+/// LWECt extracted from a SeededRLWECt. It holds the constant terms and the
+/// seed, i.e. O(1) instead of O(n) words per modulus. Expand() regenerates
+/// the whole c1 to recover the vector part.
+class SeededLWECt {
+ public:
+  SeededLWECt() {}
+
+  ~SeededLWECt();
+
+  inline bool IsValid() const { return poly_deg_ > 0; }
+
+  seal::parms_id_type parms_id() const { return parms_id_; }
+
+  inline size_t poly_modulus_degree() const { return poly_deg_; }
+
+  inline size_t coeff_modulus_size() const { return cnst_term_.size(); }
+
+  void Expand(const seal::SEALContext &context, LWECt *out) const;
+
+  size_t save_size(seal::compr_mode_type compr_mode =
+                       seal::Serialization::compr_mode_default) const;
+
+  void save(seal::seal_byte *buffer, size_t size,
+            seal::compr_mode_type compr_mode =
+                seal::Serialization::compr_mode_default) const;
+
+  void load(const seal::SEALContext &context, const seal::seal_byte *buffer,
+            size_t size);
+
+  void unsafe_load(const seal::SEALContext &context,
+                   const seal::seal_byte *buffer, size_t size);
+
+ private:
+  void save_members(std::ostream &stream) const;
+
+  void load_members(const seal::SEALContext &context, std::istream &stream,
+                    seal::SEALVersion version);
+
+  friend class SeededRLWECt;
+
+  size_t poly_deg_{0};
+  uint64_t coeff_index_{0};
+  double scale_{1.};
+  seal::parms_id_type parms_id_{seal::parms_id_zero};
+  seal::prng_seed_type seed_{};
+  std::vector<uint64_t> cnst_term_;
+};
+
+/// Symmetric encryption that outputs SeededRLWECt. Each modulus of c1 is
+/// expanded from the seed by its own Blake2xb stream, so that both sides
+/// can generate them in parallel.
+class SeededEncryptor {
+ public:
+  explicit SeededEncryptor(const seal::SEALContext &context,
+                           const RLWESecretKey &secret_key);
+
+  /// Same as seal::Encryptor::encrypt_symmetric(), the plaintext should be in
+  /// the NTT form, e.g. a CKKS plaintext
+  void EncryptSymmetric(const RLWEPt &plain, SeededRLWECt *out) const;
+
+  /// Encrypts a batch of plaintexts in parallel
+  void EncryptSymmetric(absl::Span<const RLWEPt> plains,
+                        std::vector<SeededRLWECt> *out) const;
+
+ private:
+  seal::SEALContext context_;
+  RLWESecretKey secret_key_;
+};
+
+/// Expands a batch of received ciphertexts in parallel
+void ExpandSeeded(absl::Span<const SeededRLWECt> seeded,
+                  const seal::SEALContext &context, std::vector<RLWECt> *out);
+
+void ExpandSeeded(absl::Span<const SeededLWECt> seeded,
+                  const seal::SEALContext &context, std::vector<LWECt> *out);
+
+}  // namespace heu::expt::rlwe
@@ -0,0 +1,178 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/experimental/gemini-rlwe/seeded_ct.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+#include "seal/seal.h"
+#include "seal/util/ntt.h"
+
+#include "heu/experimental/gemini-rlwe/lwe_decryptor.h"
+#include "heu/experimental/gemini-rlwe/modswitch_helper.h"
+#include "heu/experimental/gemini-rlwe/poly_encoder.h"
+#include "heu/experimental/gemini-rlwe/util.h"
+
+namespace heu::expt::rlwe::test {
+
+class SeededCtTest : public ::testing::Test {
+ protected:
+  static constexpr size_t poly_deg = 4096;
+  static constexpr size_t bitlen = 64;
+
+  void SetUp() override {
+    rdv_.seed(std::time(0));
+    auto parms = seal::EncryptionParameters(seal::scheme_type::ckks);
+    std::vector<int> modulus_bits{59, 59, 59, 59};
+
+    parms.set_poly_modulus_degree(poly_deg);
+    auto modulus = seal::CoeffModulus::Create(poly_deg, modulus_bits);
+    parms.set_coeff_modulus(modulus);
+    context_ = std::make_shared<seal::SEALContext>(parms, true,
+                                                   seal::sec_level_type::none);
+
+    modulus.pop_back();
+    parms.set_coeff_modulus(modulus);
+    seal::SEALContext ms_context(parms, false, seal::sec_level_type::none);
+    ms_helper_ = std::make_shared<ModulusSwitchHelper>(ms_context, bitlen);
+
+    seal::KeyGenerator keygen(*context_);
+    rlwe_sk_ = std::make_shared<RLWESecretKey>(keygen.secret_key());
+    lwe_sk_ = std::make_shared<LWESecretKey>(*rlwe_sk_, *context_);
+  }
+
+  // Random messages encoded as a plaintext in the NTT form
+  void MakePlain(RLWEPt *pt, std::vector<uint64_t> *msgs) {
+    msgs->resize(poly_deg);
+    std::uniform_int_distribution<uint64_t> uniform;
+    std::generate_n(msgs->data(), poly_deg, [&]() { return uniform(rdv_); });
+
+    PolyEncoder encoder(*context_, *ms_helper_);
+    encoder.Forward(absl::MakeConstSpan(*msgs), pt, /*scale*/ true);
+    auto ntt_tables = context_->first_context_data()->small_ntt_tables();
+    for (size_t l = 0; l < ms_helper_->coeff_modulus_size(); ++l) {
+      seal::util::ntt_negacyclic_harvey(pt->data() + l * poly_deg,
+                                        ntt_tables[l]);
+    }
+  }
+
+  void CheckDecrypt(const RLWECt &ntt_ct, const std::vector<uint64_t> &msgs) {
+    RLWECt ct = ntt_ct;
+    seal::Evaluator(*context_).transform_from_ntt_inplace(ct);
+    LWEDecryptor decryptor(*lwe_sk_, *context_, ms_helper_);
+    for (size_t i = 0; i < poly_deg; i += 97) {
+      uint64_t out;
+      decryptor.Decrypt(LWECt(ct, i, *context_), &out);
+      ASSERT_EQ(out, msgs[i]);
+    }
+  }
+
+  std::mt19937_64 rdv_;
+  std::shared_ptr<ModulusSwitchHelper> ms_helper_;
+  std::shared_ptr<seal::SEALContext> context_;
+
+  std::shared_ptr<RLWESecretKey> rlwe_sk_;
+  std::shared_ptr<LWESecretKey> lwe_sk_;
+};
+
+TEST_F(SeededCtTest, RLWE) {
+  RLWEPt pt;
+  std::vector<uint64_t> msgs;
+  MakePlain(&pt, &msgs);
+
+  SeededEncryptor encryptor(*context_, *rlwe_sk_);
+  SeededRLWECt seeded;
+  encryptor.EncryptSymmetric(pt, &seeded);
+
+  // about half of a full ciphertext
+  RLWECt full;
+  seal::Encryptor(*context_, *rlwe_sk_).encrypt_symmetric(pt, full);
+  auto buf = EncodeSEALObject(seeded);
+  size_t full_size = EncodeSEALObject(full).size();
+  EXPECT_LT(buf.size(), full_size * 6 / 10);
+
+  SeededRLWECt received;
+  DecodeSEALObject(buf, *context_, &received);
+  RLWECt ct;
+  received.Expand(*context_, &ct);
+  ASSERT_TRUE(ct.is_ntt_form());
+  CheckDecrypt(ct, msgs);
+
+  // the same expansion on both sides
+  RLWECt local;
+  seeded.Expand(*context_, &local);
+  size_t num_words = 2 * poly_deg * ct.coeff_modulus_size();
+  EXPECT_TRUE(std::equal(ct.data(), ct.data() + num_words, local.data()));
+}
+
+TEST_F(SeededCtTest, RLWEBatch) {
+  constexpr size_t num = 5;
+  std::vector<RLWEPt> pts(num);
+  std::vector<std::vector<uint64_t>> msgs(num);
+  for (size_t i = 0; i < num; ++i) {
+    MakePlain(&pts[i], &msgs[i]);
+  }
+
+  SeededEncryptor encryptor(*context_, *rlwe_sk_);
+  std::vector<SeededRLWECt> seeded;
+  encryptor.EncryptSymmetric(pts, &seeded);
+  ASSERT_EQ(seeded.size(), num);
+
+  std::vector<SeededRLWECt> received(num);
+  for (size_t i = 0; i < num; ++i) {
+    DecodeSEALObject(EncodeSEALObject(seeded[i]), *context_, &received[i]);
+  }
+  std::vector<RLWECt> cts;
+  ExpandSeeded(received, *context_, &cts);
+  ASSERT_EQ(cts.size(), num);
+  for (size_t i = 0; i < num; ++i) {
+    CheckDecrypt(cts[i], msgs[i]);
+  }
+}
+
+TEST_F(SeededCtTest, LWE) {
+  RLWEPt pt;
+  std::vector<uint64_t> msgs;
+  MakePlain(&pt, &msgs);
+
+  SeededEncryptor encryptor(*context_, *rlwe_sk_);
+  SeededRLWECt seeded;
+  encryptor.EncryptSymmetric(pt, &seeded);
+
+  std::vector<size_t> indices{0, 1, 37, 1024, poly_deg - 1};
+  std::vector<SeededLWECt> seeded_lwes;
+  seeded.ExtractLWEs(indices, *context_, &seeded_lwes);
+  ASSERT_EQ(seeded_lwes.size(), indices.size());
+
+  std::vector<SeededLWECt> received(indices.size());
+  for (size_t i = 0; i < indices.size(); ++i) {
+    auto buf = EncodeSEALObject(seeded_lwes[i]);
+    EXPECT_LT(buf.size(), 256U);
+    DecodeSEALObject(buf, *context_, &received[i]);
+  }
+
+  std::vector<LWECt> lwes;
+  ExpandSeeded(received, *context_, &lwes);
+  LWEDecryptor decryptor(*lwe_sk_, *context_, ms_helper_);
+  for (size_t i = 0; i < indices.size(); ++i) {
+    uint64_t out;
+    decryptor.Decrypt(lwes[i], &out);
+    EXPECT_EQ(out, msgs[indices[i]]);
+  }
+
+  EXPECT_ANY_THROW(seeded.ExtractLWEs({poly_deg}, *context_, &seeded_lwes));
+}
+
+}  // namespace heu::expt::rlwe::test
@@ -18,11 +18,45 @@
 
 namespace heu::lib::algorithms::dj {
 
+#define VALIDATE(ct)                                               \
+  HE_ASSERT(!(ct).c_.IsNegative() && (ct).c_ < pk_.CipherModule(), \
+            "Decryptor: Invalid ciphertext")
+
 Plaintext Decryptor::Decrypt(const Ciphertext &ct) const {
-  HE_ASSERT(!ct.c_.IsNegative() && ct.c_ < pk_.CipherModule(),
-            "Decryptor: Invalid ciphertext");
+  VALIDATE(ct);
   Plaintext m{sk_.Decrypt(pk_.MapBackToZSpace(ct.c_))};
   return m > pk_.PlaintextBound() ? m - pk_.PlainModule() : m;
 }
 
+std::vector<Plaintext> Decryptor::Decrypt(ConstSpan<Ciphertext> cts) const {
+  std::vector<Plaintext> res(cts.size());
+  std::vector<Plaintext *> res_ptr(cts.size());
+  for (size_t i = 0; i < cts.size(); ++i) {
+    res_ptr[i] = &res[i];
+  }
+  Decrypt(cts, absl::MakeSpan(res_ptr));
+  return res;
+}
+
+void Decryptor::Decrypt(ConstSpan<Ciphertext> in_cts,
+                        Span<Plaintext> out_pts) const {
+  YACL_ENFORCE(in_cts.size() == out_pts.size(),
+               "Input and output size mismatch, in={}, out={}", in_cts.size(),
+               out_pts.size());
+  std::vector<BigInt> zs(in_cts.size());
+  std::vector<const BigInt *> zs_ptr(in_cts.size());
+  for (size_t i = 0; i < in_cts.size(); ++i) {
+    VALIDATE(*in_cts[i]);
+    zs[i] = pk_.MapBackToZSpace(in_cts[i]->c_);
+    zs_ptr[i] = &zs[i];
+  }
+
+  sk_.Decrypt(absl::MakeConstSpan(zs_ptr), out_pts);
+  for (auto *m : out_pts) {
+    if (*m > pk_.PlaintextBound()) {
+      *m -= pk_.PlainModule();
+    }
+  }
+}
+
 }  // namespace heu::lib::algorithms::dj
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <utility>
+#include <vector>
 
 #include "heu/library/algorithms/dj/ciphertext.h"
 #include "heu/library/algorithms/dj/public_key.h"
@@ -33,6 +34,10 @@ class Decryptor {
 
   Plaintext Decrypt(const Ciphertext &ct) const;
 
+  // Batch decryption, the CRT halves of all ciphertexts run in parallel
+  std::vector<Plaintext> Decrypt(ConstSpan<Ciphertext> cts) const;
+  void Decrypt(ConstSpan<Ciphertext> in_cts, Span<Plaintext> out_pts) const;
+
  private:
   PublicKey pk_;
   SecretKey sk_;
@@ -15,6 +15,7 @@
 #include "heu/library/algorithms/dj/dj.h"
 
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -176,6 +177,56 @@ TEST_F(DJTest, PlaintextEvaluate2) {
   EXPECT_EQ(plain.Get<int64_t>(), std::numeric_limits<int64_t>::max());
 }
 
+TEST_F(DJTest, BatchDecrypt) {
+  std::vector<Ciphertext> cts;
+  std::vector<Plaintext> pts;
+  for (int64_t i = -50; i < 50; ++i) {
+    pts.emplace_back(i * 1234567);
+    cts.push_back(encryptor_->Encrypt(pts.back()));
+  }
+  pts.push_back(pk_.PlaintextBound());
+  cts.push_back(encryptor_->Encrypt(pts.back()));
+  pts.push_back(-pk_.PlaintextBound());
+  cts.push_back(encryptor_->Encrypt(pts.back()));
+
+  std::vector<const Ciphertext *> cts_ptr;
+  for (const auto &ct : cts) {
+    cts_ptr.push_back(&ct);
+  }
+  auto res = decryptor_->Decrypt(absl::MakeConstSpan(cts_ptr));
+  ASSERT_EQ(res.size(), pts.size());
+  for (size_t i = 0; i < pts.size(); ++i) {
+    EXPECT_EQ(res[i], pts[i]);
+  }
+}
+
+TEST(DJLargeSTest, EncDec) {
+  SecretKey sk;
+  PublicKey pk;
+  KeyGenerator::Generate(1024, 3, &sk, &pk);
+  ASSERT_EQ(sk.S(), 3u);
+
+  Encryptor encryptor(pk);
+  Evaluator evaluator(pk);
+  Decryptor decryptor(pk, sk);
+
+  // plaintext beyond n, exercising all the lifting rounds
+  Plaintext m = pk.N() * pk.N() + Plaintext(12345);
+  auto ct = encryptor.Encrypt(m);
+  EXPECT_EQ(decryptor.Decrypt(ct), m);
+  EXPECT_EQ(decryptor.Decrypt(evaluator.Add(ct, ct)), m + m);
+  EXPECT_EQ(decryptor.Decrypt(encryptor.Encrypt(-m)), -m);
+
+  auto max = pk.PlaintextBound();
+  const std::vector<Ciphertext> cts = {encryptor.Encrypt(max),
+                                       encryptor.Encrypt(-max), ct};
+  auto res =
+      decryptor.Decrypt(absl::MakeConstSpan({&cts[0], &cts[1], &cts[2]}));
+  EXPECT_EQ(res[0], max);
+  EXPECT_EQ(res[1], -max);
+  EXPECT_EQ(res[2], m);
+}
+
 class BigNumberTest : public ::testing::TestWithParam<int64_t> {
  protected:
   static void SetUpTestSuite() { KeyGenerator::Generate(2048, &sk_, &pk_); }
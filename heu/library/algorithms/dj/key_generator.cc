@@ -19,7 +19,13 @@
 namespace heu::lib::algorithms::dj {
 
 void KeyGenerator::Generate(size_t key_size, SecretKey *sk, PublicKey *pk) {
+  Generate(key_size, s_, sk, pk);
+}
+
+void KeyGenerator::Generate(size_t key_size, uint32_t s, SecretKey *sk,
+                            PublicKey *pk) {
   YACL_ENFORCE(key_size % 2 == 0, "Key size must be even");
+  YACL_ENFORCE(s > 0, "s must be positive");
 
   BigInt q, gcd;
   BigInt p = BigInt::RandPrimeOver(key_size / 2, PrimeType::BBS);
@@ -27,8 +33,8 @@ void KeyGenerator::Generate(size_t key_size, SecretKey *sk, PublicKey *pk) {
     q = BigInt::RandPrimeOver(key_size / 2, PrimeType::BBS);
     gcd = (p - 1).Gcd(q - 1);
   } while (gcd != 2);
-  sk->Init(p, q, s_);
-  pk->Init(p * q, s_, BigInt{0});
+  sk->Init(p, q, s);
+  pk->Init(p * q, s, BigInt{0});
 }
 
 void KeyGenerator::Generate(SecretKey *sk, PublicKey *pk) {
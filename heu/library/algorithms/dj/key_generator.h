@@ -22,6 +22,9 @@ namespace heu::lib::algorithms::dj {
 class KeyGenerator {
  public:
   static void Generate(size_t key_size, SecretKey *sk, PublicKey *pk);
+  // Generate keys with an explicit s instead of the global s_
+  static void Generate(size_t key_size, uint32_t s, SecretKey *sk,
+                       PublicKey *pk);
   static void Generate(SecretKey *sk, PublicKey *pk);
 
   static inline uint32_t s_{2u};
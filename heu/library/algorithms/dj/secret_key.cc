@@ -14,40 +14,80 @@
 
 #include "heu/library/algorithms/dj/secret_key.h"
 
+#include <algorithm>
+
+#include "yacl/utils/parallel.h"
+
 namespace heu::lib::algorithms::dj {
 
+namespace {
+// Window size of the fixed-exponent recoding, table holds 2^(w-1) odd powers
+constexpr size_t kExpWindowBits = 5;
+}  // namespace
+
 void SecretKey::Init(const BigInt &p, const BigInt &q, uint32_t s) {
-  auto n{p * q};
   n_ = {p, q};
   s_ = s;
-  pmod_ = n.Pow(s);
-  lambda_ = (p - 1) * (q - 1) / 2;
-  mu_ = lambda_.InvMod(pmod_);
+  pmod_ = (p * q).Pow(s);
 
   lut_ = std::make_shared<LUT>();
-  lut_->pq_pow.resize(s + 2);
-  lut_->pq_pow[1] = {p, q};
-  for (auto i = 2u; i <= s + 1; ++i) {
-    lut_->pq_pow[i] = {lut_->pq_pow[i - 1].P * p, lut_->pq_pow[i - 1].Q * q};
+  InitPrimeCtx(p, q, &lut_->p);
+  InitPrimeCtx(q, p, &lut_->q);
+
+  inv_ps_ = lut_->p.pow[s].InvMod(lut_->q.pow[s]);
+}
+
+void SecretKey::InitPrimeCtx(const BigInt &prime, const BigInt &other,
+                             PrimeCtx *ctx) const {
+  auto n{prime * other};
+  ctx->pow.resize(s_ + 2);
+  ctx->pow[0] = BigInt(1);
+  for (auto j = 1u; j <= s_ + 1; ++j) {
+    ctx->pow[j] = ctx->pow[j - 1] * prime;
   }
-  const auto &[ps, qs] = lut_->pq_pow[s];
-  pp_ = ps * ps.InvMod(qs);
-  inv_pq_ = {q.InvMod(ps), p.InvMod(qs)};
-  lut_->precomp.resize(s + 1);
-  for (auto j = 2u; j <= s; ++j) {
-    lut_->precomp[j].resize(j + 1);
+
+  const auto &ps = ctx->pow[s_];
+  ctx->inv_other = other.InvMod(ps);
+  // We raise ct to (prime - 1) instead of λ, which halves the exponent size.
+  // This leaves m * (prime - 1) mod prime^s in the exponent of (1 + n).
+  ctx->inv_phi = (prime - 1).InvMod(ps);
+
+  ctx->precomp.resize(s_ + 1);
+  if (s_ > 1) {
+    ctx->precomp[1] = BigInt(1);
   }
-  if (s > 1) {
-    lut_->precomp[s][1] = {BigInt(1), BigInt(1)};
+  for (auto i = 2u; i <= s_; ++i) {
+    ctx->precomp[i] =
+        ctx->precomp[i - 1].MulMod(n, ps).MulMod(BigInt{i}.InvMod(ps), ps);
   }
-  for (auto i = 2u; i <= s; ++i) {
-    for (auto j = i; j <= s; ++j) {
-      lut_->precomp[j][i] = {lut_->precomp[s][i - 1].P.MulMod(n, ps).MulMod(
-                                 BigInt{i}.InvMod(ps), ps),
-                             lut_->precomp[s][i - 1].Q.MulMod(n, qs).MulMod(
-                                 BigInt{i}.InvMod(qs), qs)};
+
+  ctx->m_space = BigInt::CreateMontgomerySpace(ctx->pow[s_ + 1]);
+
+  // left-to-right sliding window recoding of (prime - 1)
+  auto e = prime - 1;
+  int64_t i = static_cast<int64_t>(e.BitCount()) - 1;
+  uint32_t zeros = 0;
+  ctx->exp_steps.clear();
+  while (i >= 0) {
+    if (e.GetBit(i) == 0) {
+      ++zeros;
+      --i;
+      continue;
+    }
+    int64_t j = std::max<int64_t>(i - kExpWindowBits + 1, 0);
+    while (e.GetBit(j) == 0) {
+      ++j;  // window must end with a set bit
+    }
+    uint32_t digit = 0;
+    for (int64_t k = i; k >= j; --k) {
+      digit = (digit << 1) | (e.GetBit(k) ? 1 : 0);
     }
+    ctx->exp_steps.push_back(
+        {zeros + static_cast<uint32_t>(i - j + 1), (digit - 1) / 2});
+    zeros = 0;
+    i = j - 1;
   }
+  ctx->exp_tail_sqr = zeros;
 }
 
 bool SecretKey::operator==(const SecretKey &sk) const {
@@ -62,33 +102,91 @@ std::string SecretKey::ToString() const {
                      n_.Q.BitCount(), s_);
 }
 
-BigInt SecretKey::Decrypt(const BigInt &ct) const {
-  MPInt2 z, ls;
-  // compute z = c^d mod n^(s+1)
-  const auto &[ps1, qs1] = lut_->pq_pow[s_ + 1];
-  z = {(ct % ps1).PowMod(lambda_, ps1), (ct % qs1).PowMod(lambda_, qs1)};
-  //  compute ls = L(z) mod n^s
-  const auto &[ps, qs] = lut_->pq_pow[s_];
-  ls = {inv_pq_.P.MulMod((z.P - 1) / n_.P, ps),
-        inv_pq_.Q.MulMod((z.Q - 1) / n_.Q, qs)};
-
-  MPInt2 ind{ls.P % lut_->pq_pow[1].P, ls.Q % lut_->pq_pow[1].Q};
-  MPInt2 l, tmp;
+BigInt SecretKey::DecryptHalf(const BigInt &ct, const PrimeCtx &ctx,
+                              std::vector<BigInt> *table) const {
+  const auto &ms = *ctx.m_space;
+  // compute z = c^(prime-1) mod prime^(s+1) using the cached recoding
+  table->resize(size_t{1} << (kExpWindowBits - 1));
+  (*table)[0] = ct % ctx.pow[s_ + 1];
+  ms.MapIntoMSpace((*table)[0]);
+  auto base2 = ms.MulMod((*table)[0], (*table)[0]);
+  for (size_t k = 1; k < table->size(); ++k) {
+    (*table)[k] = ms.MulMod((*table)[k - 1], base2);
+  }
+  BigInt z = (*table)[ctx.exp_steps[0].idx];
+  for (size_t k = 1; k < ctx.exp_steps.size(); ++k) {
+    for (uint32_t r = 0; r < ctx.exp_steps[k].sqr; ++r) {
+      z = ms.MulMod(z, z);
+    }
+    z = ms.MulMod(z, (*table)[ctx.exp_steps[k].idx]);
+  }
+  for (uint32_t r = 0; r < ctx.exp_tail_sqr; ++r) {
+    z = ms.MulMod(z, z);
+  }
+  ms.MapBackToZSpace(z);
+
+  // compute ls = L(z) mod prime^s
+  const auto &prime = ctx.pow[1];
+  BigInt ls = ((z - 1) / prime).MulMod(ctx.inv_other, ctx.pow[s_]);
+
+  // Hensel lifting, see README.md
+  BigInt ind = ls % prime;
+  BigInt l, tmp;
   for (auto j = 2u; j <= s_; ++j) {
     // compute l = L(c^d mod n^{j+1}) = ls mod n^j
-    l = {ls.P % lut_->pq_pow[j].P, ls.Q % lut_->pq_pow[j].Q};
+    l = ls % ctx.pow[j];
     // compute ind mod n^j
     tmp = ind;
     for (auto i = 2u; i <= j; ++i) {
-      tmp.P = tmp.P.MulMod(ind.P - (i - 1), lut_->pq_pow[j - i + 1].P);
-      tmp.Q = tmp.Q.MulMod(ind.Q - (i - 1), lut_->pq_pow[j - i + 1].Q);
-      l.P -= tmp.P.MulMod(lut_->precomp[j][i].P, lut_->pq_pow[j].P);
-      l.Q -= tmp.Q.MulMod(lut_->precomp[j][i].Q, lut_->pq_pow[j].Q);
+      tmp = tmp.MulMod(ind - (i - 1), ctx.pow[j - i + 1]);
+      l -= tmp.MulMod(ctx.precomp[i], ctx.pow[j]);
     }
-    ind = {l.P % lut_->pq_pow[j].P, l.Q % lut_->pq_pow[j].Q};
+    ind = l % ctx.pow[j];
+  }
+  return ind.MulMod(ctx.inv_phi, ctx.pow[s_]);
+}
+
+BigInt SecretKey::CrtCombine(const BigInt &mp, const BigInt &mq) const {
+  const auto &ps = lut_->p.pow[s_];
+  const auto &qs = lut_->q.pow[s_];
+  return mp + (mq - mp).MulMod(inv_ps_, qs) * ps;
+}
+
+BigInt SecretKey::Decrypt(const BigInt &ct) const {
+  MPInt2 m;
+  yacl::parallel_for(0, 2, 1, [&](int64_t beg, int64_t end) {
+    std::vector<BigInt> table;
+    for (int64_t i = beg; i < end; ++i) {
+      if (i == 0) {
+        m.P = DecryptHalf(ct, lut_->p, &table);
+      } else {
+        m.Q = DecryptHalf(ct, lut_->q, &table);
+      }
+    }
+  });
+  return CrtCombine(m.P, m.Q);
+}
+
+void SecretKey::Decrypt(ConstSpan<BigInt> cts, Span<BigInt> out) const {
+  YACL_ENFORCE(cts.size() == out.size(),
+               "Input and output size mismatch, in={}, out={}", cts.size(),
+               out.size());
+  // Task 2k computes the p half of cts[k], task 2k+1 computes the q half.
+  std::vector<MPInt2> m(cts.size());
+  yacl::parallel_for(0, cts.size() * 2, 1, [&](int64_t beg, int64_t end) {
+    std::vector<BigInt> table;
+    for (int64_t i = beg; i < end; ++i) {
+      if (i % 2 == 0) {
+        m[i / 2].P = DecryptHalf(*cts[i / 2], lut_->p, &table);
+      } else {
+        m[i / 2].Q = DecryptHalf(*cts[i / 2], lut_->q, &table);
+      }
+    }
+  });
+
+  for (size_t i = 0; i < cts.size(); ++i) {
+    *out[i] = CrtCombine(m[i].P, m[i].Q);
   }
-  auto m_lambda = (ind.P + (ind.Q - ind.P) * pp_) % pmod_;
-  return m_lambda.MulMod(mu_, pmod_);
 }
 
 }  // namespace heu::lib::algorithms::dj
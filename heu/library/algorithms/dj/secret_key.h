@@ -14,8 +14,13 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "heu/library/algorithms/util/big_int.h"
 #include "heu/library/algorithms/util/he_object.h"
+#include "heu/library/algorithms/util/spi_traits.h"
 
 namespace heu::lib::algorithms::dj {
 
@@ -35,19 +40,45 @@ class SecretKey : public HeObject<SecretKey> {
   bool operator!=(const SecretKey &) const;
   std::string ToString() const override;
 
+  // ct must be in Z-space. The p and q halves run concurrently.
   BigInt Decrypt(const BigInt &ct) const;
+  // Batch version, cts must be in Z-space.
+  void Decrypt(ConstSpan<BigInt> cts, Span<BigInt> out) const;
 
  private:
-  MPInt2 n_;            // (p, q)
-  BigInt lambda_, mu_;  // λ, μ
-  BigInt pmod_;         // n^s
-  uint32_t s_ = 0;      // Updated by Ant Group
-  BigInt pp_;           // p^s * (p^(-s) mod q^s), used for CRT
-  MPInt2 inv_pq_;       // ( q^(-1) mod p^s, p^(-1) mod q^s )
+  // Sliding-window recoding of a fixed exponent: square `sqr` times, then
+  // multiply by the odd power base^(2 * idx + 1). The `sqr` of the first step
+  // is ignored since the accumulator starts from the table entry directly.
+  struct ExpStep {
+    uint32_t sqr;
+    uint32_t idx;
+  };
+
+  // Everything needed to decrypt one CRT half, i.e. modulo p^(s+1)
+  struct PrimeCtx {
+    std::vector<BigInt> pow;      // prime^j, j = 0..s+1
+    std::vector<BigInt> precomp;  // n^(i-1)/i! mod prime^s
+    BigInt inv_other;             // (the other prime)^(-1) mod prime^s
+    BigInt inv_phi;               // (prime - 1)^(-1) mod prime^s
+    std::unique_ptr<MontgomerySpace> m_space;  // m-space for mod prime^(s+1)
+    std::vector<ExpStep> exp_steps;            // recoding of (prime - 1)
+    uint32_t exp_tail_sqr = 0;                 // squares after the last step
+  };
+
+  void InitPrimeCtx(const BigInt &prime, const BigInt &other,
+                    PrimeCtx *ctx) const;
+  // Returns m mod prime^s, `table` is a scratch buffer reused across calls
+  BigInt DecryptHalf(const BigInt &ct, const PrimeCtx &ctx,
+                     std::vector<BigInt> *table) const;
+  BigInt CrtCombine(const BigInt &mp, const BigInt &mq) const;
+
+  MPInt2 n_;        // (p, q)
+  BigInt pmod_;     // n^s
+  uint32_t s_ = 0;  // Updated by Ant Group
+  BigInt inv_ps_;   // p^(-s) mod q^s, used for CRT
 
   struct LUT {
-    std::vector<MPInt2> pq_pow;                // {p,q}^j
-    std::vector<std::vector<MPInt2>> precomp;  // n^(i-1)/i! mod {p,q}^j
+    PrimeCtx p, q;
   };
 
   std::shared_ptr<LUT> lut_;
@@ -14,7 +14,8 @@
 
 #include "heu/library/algorithms/paillier_float/evaluator.h"
 
-#include "heu/library/algorithms/paillier_float/internal/codec.h"
+#include <functional>
+#include <map>
 
 namespace heu::lib::algorithms::paillier_f {
 
@@ -43,17 +44,52 @@ void Evaluator::Randomize(Ciphertext *ct) const {
 }
 
 Ciphertext Evaluator::Add(const Ciphertext &a, const BigInt &b) const {
-  internal::EncodedNumber encoded_b = internal::Codec(pk_).Encode(b);
-
-  Ciphertext cipher_b = encryptor_.EncryptEncoded(encoded_b, 1);
-  return Add(a, cipher_b);
+  return AddEncoded(a, codec_.Encode(b));
 }
 
 Ciphertext Evaluator::Add(const Ciphertext &a, double b) const {
-  internal::EncodedNumber encoded_b = internal::Codec(pk_).Encode(b);
+  return AddEncoded(a, codec_.Encode(b));
+}
+
+Ciphertext Evaluator::AddEncoded(const Ciphertext &a,
+                                 internal::EncodedNumber b) const {
+  Ciphertext c = a;
+  if (b.exponent > a.exponent_) {
+    // align on the plaintext side, which is a cheap MulMod mod n instead of a
+    // PowMod mod n^2
+    b.encoding = b.encoding.MulMod(
+        internal::Codec::BasePow(b.exponent - a.exponent_), pk_.n_);
+  } else if (b.exponent < a.exponent_) {
+    DecreaseExponentTo(&c, b.exponent);
+  }
+  c.c_ = AddPlainRaw(c.c_, b.encoding);
+  return c;
+}
 
-  Ciphertext cipher_b = encryptor_.EncryptEncoded(encoded_b, 1);
-  return Add(a, cipher_b);
+std::vector<Ciphertext> Evaluator::Add(ConstSpan<Ciphertext> a,
+                                       ConstSpan<Ciphertext> b) const {
+  YACL_ENFORCE(a.size() == b.size(), "size mismatch, {} vs {}", a.size(),
+               b.size());
+  // each pair is aligned to its own smaller exponent, one tiny element must
+  // not scale the mantissas of the whole batch
+  std::vector<Ciphertext> res;
+  res.reserve(a.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    res.push_back(Add(*a[i], *b[i]));
+  }
+  return res;
+}
+
+std::vector<Ciphertext> Evaluator::Add(ConstSpan<Ciphertext> a,
+                                       ConstSpan<Plaintext> b) const {
+  YACL_ENFORCE(a.size() == b.size(), "size mismatch, {} vs {}", a.size(),
+               b.size());
+  std::vector<Ciphertext> res;
+  res.reserve(a.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    res.push_back(AddEncoded(*a[i], codec_.Encode(*b[i])));
+  }
+  return res;
 }
 
 void Evaluator::AddInplace(Ciphertext *a, const Ciphertext &b) const {
@@ -70,6 +106,13 @@ BigInt Evaluator::AddRaw(const BigInt &a, const BigInt &b) const {
   return a.MulMod(b, pk_.n_square_);
 }
 
+BigInt Evaluator::AddPlainRaw(const BigInt &c, const BigInt &m) const {
+  // m < n, so n * m + 1 < n^2 and no reduction is needed
+  BigInt gm = pk_.n_ * m;
+  ++gm;
+  return c.MulMod(gm, pk_.n_square_);
+}
+
 Ciphertext Evaluator::Sub(const Ciphertext &a, const Ciphertext &b) const {
   return Add(a, Negate(b));
 }
@@ -91,7 +134,7 @@ Ciphertext Evaluator::Sub(const BigInt &p, const Ciphertext &a) const {
 }
 
 Ciphertext Evaluator::Mul(const Ciphertext &a, const BigInt &b) const {
-  internal::EncodedNumber encoded_b = internal::Codec(pk_).Encode(b);
+  internal::EncodedNumber encoded_b = codec_.Encode(b);
 
   Ciphertext c;
   c.exponent_ = a.exponent_ + encoded_b.exponent;
@@ -100,7 +143,7 @@ Ciphertext Evaluator::Mul(const Ciphertext &a, const BigInt &b) const {
 }
 
 Ciphertext Evaluator::Mul(const Ciphertext &a, double b) const {
-  internal::EncodedNumber encoded_b = internal::Codec(pk_).Encode(b);
+  internal::EncodedNumber encoded_b = codec_.Encode(b);
 
   Ciphertext c;
   c.exponent_ = a.exponent_ + encoded_b.exponent;
@@ -108,6 +151,43 @@ Ciphertext Evaluator::Mul(const Ciphertext &a, double b) const {
   return c;
 }
 
+std::vector<Ciphertext> Evaluator::Mul(ConstSpan<Ciphertext> a,
+                                       ConstSpan<Plaintext> b) const {
+  YACL_ENFORCE(a.size() == b.size(), "size mismatch, {} vs {}", a.size(),
+               b.size());
+  // exponents just add up, so no alignment is needed
+  std::vector<Ciphertext> res;
+  res.reserve(a.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    res.push_back(Mul(*a[i], *b[i]));
+  }
+  return res;
+}
+
+Ciphertext Evaluator::ReduceSum(ConstSpan<Ciphertext> a) const {
+  YACL_ENFORCE(!a.empty(), "cannot sum an empty vector");
+
+  // terms of the same exponent are summed without any alignment, then the
+  // partial sums are folded from the highest exponent down, so each
+  // partial sum is scaled once per step instead of scaling every term to
+  // the minimum exponent up front
+  std::map<int, Ciphertext, std::greater<>> partial_sums;
+  for (const auto *ct : a) {
+    auto [it, inserted] = partial_sums.try_emplace(ct->exponent_, *ct);
+    if (!inserted) {
+      it->second.c_ = AddRaw(it->second.c_, ct->c_);
+    }
+  }
+
+  auto it = partial_sums.begin();
+  Ciphertext sum = std::move(it->second);
+  for (++it; it != partial_sums.end(); ++it) {
+    DecreaseExponentTo(&sum, it->first);
+    sum.c_ = AddRaw(sum.c_, it->second.c_);
+  }
+  return sum;
+}
+
 void Evaluator::MulInplace(Ciphertext *a, const BigInt &b) const {
   *a = Mul(*a, b);
 }
@@ -128,11 +208,10 @@ void Evaluator::DecreaseExponentTo(Ciphertext *cipher, int new_exp) const {
   YACL_ENFORCE(new_exp <= cipher->exponent_,
                "new_exp should <= cipher's exponent");
 
-  BigInt factor = internal::Codec::kBaseCache.Pow(cipher->exponent_ - new_exp);
+  BigInt factor = internal::Codec::BasePow(cipher->exponent_ - new_exp);
 
-  internal::EncodedNumber encoded_factor = internal::Codec(pk_).Encode(factor);
+  internal::EncodedNumber encoded_factor = codec_.Encode(factor);
 
-  // TODO: mutiply c_ and factor
   cipher->c_ = MulRaw(cipher->c_, encoded_factor.encoding);
   cipher->exponent_ = new_exp;
 }
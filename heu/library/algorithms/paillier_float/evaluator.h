@@ -14,8 +14,11 @@
 
 #pragma once
 
+#include <vector>
+
 #include "heu/library/algorithms/paillier_float/ciphertext.h"
 #include "heu/library/algorithms/paillier_float/encryptor.h"
+#include "heu/library/algorithms/paillier_float/internal/codec.h"
 #include "heu/library/algorithms/paillier_float/public_key.h"
 #include "heu/library/algorithms/util/spi_traits.h"
 
@@ -23,7 +26,8 @@ namespace heu::lib::algorithms::paillier_f {
 
 class Evaluator {
  public:
-  explicit Evaluator(const PublicKey &pk) : pk_(pk), encryptor_(pk) {}
+  explicit Evaluator(const PublicKey &pk)
+      : pk_(pk), encryptor_(pk), codec_(pk) {}
 
   void Randomize(Ciphertext *ct) const;
 
@@ -38,6 +42,12 @@ class Evaluator {
     return Add(b, a);
   }
 
+  // Vectorized c[i] = a[i] + b[i], each pair is aligned on its own
+  std::vector<Ciphertext> Add(ConstSpan<Ciphertext> a,
+                              ConstSpan<Ciphertext> b) const;
+  std::vector<Ciphertext> Add(ConstSpan<Ciphertext> a,
+                              ConstSpan<Plaintext> b) const;
+
   // a = a + b
   void AddInplace(Ciphertext *a, const Ciphertext &b) const;
   void AddInplace(Ciphertext *a, const BigInt &b) const;
@@ -68,6 +78,14 @@ class Evaluator {
     return Mul(b, a);
   }
 
+  // Vectorized c[i] = a[i] * b[i]
+  std::vector<Ciphertext> Mul(ConstSpan<Ciphertext> a,
+                              ConstSpan<Plaintext> b) const;
+
+  // Sum of all ciphertexts, terms of the same exponent are added without
+  // alignment
+  Ciphertext ReduceSum(ConstSpan<Ciphertext> a) const;
+
   // a = a * b
   void MulInplace(Ciphertext *a, const BigInt &b) const;
   void MulInplace(Ciphertext *a, double b) const;
@@ -84,6 +102,13 @@ class Evaluator {
 
   BigInt MulRaw(const BigInt &a, const BigInt &b) const;
 
+  // c * (1 + n * m) mod n^2, i.e. add an encoded plaintext m to cipher c.
+  // This is an encryption of m with randomness 1, so no PowMod is needed.
+  BigInt AddPlainRaw(const BigInt &c, const BigInt &m) const;
+
+  Ciphertext AddEncoded(const Ciphertext &a,
+                        internal::EncodedNumber b) const;
+
   /// decrease cipher's exponent to new_exp
   /// if new_exp > cipher's exponent, raise exception.
   /// @param [in,out] cipher
@@ -92,6 +117,7 @@ class Evaluator {
  private:
   PublicKey pk_;
   Encryptor encryptor_;
+  internal::Codec codec_;
 };
 
 }  // namespace heu::lib::algorithms::paillier_f
@@ -14,10 +14,31 @@
 
 #include "heu/library/algorithms/paillier_float/internal/codec.h"
 
+#include <vector>
+
 namespace heu::lib::algorithms::paillier_f::internal {
 
 const BigInt Codec::kBaseCache = BigInt(Codec::kBase);
 
+BigInt Codec::BasePow(int exp) {
+  YACL_ENFORCE(exp >= 0, "exponent should be non-negative, but get {}", exp);
+
+  static const std::vector<BigInt> kTable = [] {
+    std::vector<BigInt> table;
+    table.reserve(kBasePowCacheSize);
+    table.emplace_back(1);
+    for (int i = 1; i < kBasePowCacheSize; ++i) {
+      table.push_back(table.back() * kBaseCache);
+    }
+    return table;
+  }();
+
+  if (exp < kBasePowCacheSize) {
+    return kTable[exp];
+  }
+  return kBaseCache.Pow(exp);
+}
+
 EncodedNumber Codec::Encode(const BigInt &scalar, int exponent) const {
   YACL_ENFORCE(scalar.CompareAbs(pk_.PlaintextBound()) <= 0,
                "integer scalar should in +/- {}, but get {}",
@@ -95,12 +116,12 @@ void Codec::Decode(const EncodedNumber &in, double *x) const {
   BigInt mantissa = GetMantissa(in);
 
   if (in.exponent >= 0) {
-    BigInt factor = kBaseCache.Pow(in.exponent);
+    BigInt factor = BasePow(in.exponent);
     BigInt value = mantissa * factor;
 
     *x = value.Get<double>();
   } else {
-    BigInt divisor = kBaseCache.Pow(-in.exponent);
+    BigInt divisor = BasePow(-in.exponent);
 
     *x = mantissa.Get<double>() / divisor.Get<double>();
   }
@@ -110,11 +131,10 @@ void Codec::Decode(const EncodedNumber &in, BigInt *x) const {
   BigInt mantissa = GetMantissa(in);
 
   if (in.exponent >= 0) {
-    BigInt factor = kBaseCache.Pow(in.exponent);
+    BigInt factor = BasePow(in.exponent);
     *x = mantissa * factor;
   } else {
-    BigInt divisor = kBaseCache.Pow(-in.exponent);
-    divisor = kBaseCache.Pow(-in.exponent);
+    BigInt divisor = BasePow(-in.exponent);
     *x = mantissa / divisor;
   }
 }
@@ -34,6 +34,8 @@ class Codec {
   static const int kLog2Base = 4;
   static const int kDoubleMantissaBits = 53;
   static const BigInt kBaseCache;  // cache kBase in MPInt type
+  // kBase^exp for exp < kBasePowCacheSize are precomputed
+  static const int kBasePowCacheSize = 128;
 
  public:
   explicit Codec(PublicKey pk) : pk_(std::move(pk)) {}
@@ -48,6 +50,9 @@ class Codec {
 
   void Decode(const EncodedNumber &in, BigInt *out) const;
 
+  // returns kBase^exp, exp must be non-negative
+  static BigInt BasePow(int exp);
+
  private:
   BigInt GetMantissa(const EncodedNumber &encoded) const;
 
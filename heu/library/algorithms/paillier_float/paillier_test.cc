@@ -14,6 +14,8 @@
 
 #include "heu/library/algorithms/paillier_float/paillier.h"
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 namespace heu::lib::algorithms::paillier_f::test {
@@ -155,6 +157,119 @@ TEST_F(PaillierTest, CipherMultiplyDoubleWorks) {
             static_cast<int64_t>(p1.Get<double>() * p2));
 }
 
+TEST_F(PaillierTest, CipherAddPlainDoubleWorks) {
+  Encryptor encryptor(pub_key_);
+  Evaluator evaluator(pub_key_);
+  Decryptor decryptor(pub_key_, sec_key_);
+
+  // the plaintext exponent is lower than the ciphertext's
+  Ciphertext c1 = evaluator.Add(encryptor.Encrypt(BigInt(125)), 0.25);
+  double sum;
+  decryptor.Decrypt(c1, &sum);
+  EXPECT_DOUBLE_EQ(sum, 125.25);
+
+  // the plaintext exponent is higher than the ciphertext's
+  Ciphertext c2 = evaluator.Add(encryptor.Encrypt(0.0625), BigInt(-3));
+  decryptor.Decrypt(c2, &sum);
+  EXPECT_DOUBLE_EQ(sum, -2.9375);
+
+  // adding a plaintext must not break the homomorphism
+  evaluator.AddInplace(&c2, c1);
+  decryptor.Decrypt(c2, &sum);
+  EXPECT_DOUBLE_EQ(sum, 122.3125);
+}
+
+TEST_F(PaillierTest, VectorizedOpsWork) {
+  Encryptor encryptor(pub_key_);
+  Evaluator evaluator(pub_key_);
+  Decryptor decryptor(pub_key_, sec_key_);
+
+  // ciphertexts with different exponents
+  std::vector<Ciphertext> cts = {encryptor.Encrypt(BigInt(7)),
+                                 encryptor.Encrypt(0.5),
+                                 encryptor.Encrypt(-0.0625)};
+  std::vector<BigInt> pts = {BigInt(3), BigInt(-4), BigInt(16)};
+  const std::vector<const Ciphertext *> ct_ptrs = {&cts[0], &cts[1], &cts[2]};
+  const std::vector<const BigInt *> pt_ptrs = {&pts[0], &pts[1], &pts[2]};
+
+  double value;
+  auto sum = evaluator.Add(ct_ptrs, pt_ptrs);
+  ASSERT_EQ(sum.size(), 3u);
+  std::vector<double> expected = {10, -3.5, 15.9375};
+  for (size_t i = 0; i < sum.size(); ++i) {
+    decryptor.Decrypt(sum[i], &value);
+    EXPECT_DOUBLE_EQ(value, expected[i]);
+  }
+
+  const std::vector<const Ciphertext *> sum_ptrs = {&sum[2], &sum[1], &sum[0]};
+  auto sum2 = evaluator.Add(ct_ptrs, sum_ptrs);
+  expected = {22.9375, -3, 9.9375};
+  for (size_t i = 0; i < sum2.size(); ++i) {
+    decryptor.Decrypt(sum2[i], &value);
+    EXPECT_DOUBLE_EQ(value, expected[i]);
+  }
+
+  auto product = evaluator.Mul(ct_ptrs, pt_ptrs);
+  expected = {21, -2, -1};
+  for (size_t i = 0; i < product.size(); ++i) {
+    decryptor.Decrypt(product[i], &value);
+    EXPECT_DOUBLE_EQ(value, expected[i]);
+  }
+
+  decryptor.Decrypt(evaluator.ReduceSum(ct_ptrs), &value);
+  EXPECT_DOUBLE_EQ(value, 7.4375);
+}
+
+TEST_F(PaillierTest, VectorizedOpsMatchScalarOps) {
+  Encryptor encryptor(pub_key_);
+  Evaluator evaluator(pub_key_);
+  Decryptor decryptor(pub_key_, sec_key_);
+
+  // one tiny exponent in the batch must not affect the other elements
+  std::vector<double> xs = {1e-30, 1e30, -2.5e30, 3.75};
+  std::vector<double> ys = {-4e-30, 5e29, 1e-30, -1e30};
+  std::vector<BigInt> pts = {BigInt(3), BigInt(-7), BigInt(0), BigInt(12345)};
+  std::vector<Ciphertext> ct_x;
+  std::vector<Ciphertext> ct_y;
+  for (size_t i = 0; i < xs.size(); ++i) {
+    ct_x.push_back(encryptor.Encrypt(xs[i]));
+    ct_y.push_back(encryptor.Encrypt(ys[i]));
+  }
+  std::vector<const Ciphertext *> x_ptrs;
+  std::vector<const Ciphertext *> y_ptrs;
+  std::vector<const BigInt *> pt_ptrs;
+  for (size_t i = 0; i < xs.size(); ++i) {
+    x_ptrs.push_back(&ct_x[i]);
+    y_ptrs.push_back(&ct_y[i]);
+    pt_ptrs.push_back(&pts[i]);
+  }
+
+  auto check = [&](const Ciphertext &actual, const Ciphertext &expected) {
+    double value;
+    double expected_value;
+    decryptor.Decrypt(actual, &value);
+    decryptor.Decrypt(expected, &expected_value);
+    EXPECT_DOUBLE_EQ(value, expected_value);
+  };
+  auto sum = evaluator.Add(x_ptrs, y_ptrs);
+  auto plain_sum = evaluator.Add(x_ptrs, pt_ptrs);
+  auto product = evaluator.Mul(x_ptrs, pt_ptrs);
+  for (size_t i = 0; i < xs.size(); ++i) {
+    check(sum[i], evaluator.Add(ct_x[i], ct_y[i]));
+    check(plain_sum[i], evaluator.Add(ct_x[i], pts[i]));
+    check(product[i], evaluator.Mul(ct_x[i], pts[i]));
+  }
+
+  Ciphertext expected = ct_y[0];
+  for (size_t i = 1; i < ct_y.size(); ++i) {
+    evaluator.AddInplace(&expected, ct_y[i]);
+  }
+  check(evaluator.ReduceSum(y_ptrs), expected);
+  double value;
+  decryptor.Decrypt(evaluator.ReduceSum(y_ptrs), &value);
+  EXPECT_DOUBLE_EQ(value, -1e30 + 5e29);
+}
+
 class NegateInplaceTest : public ::testing::TestWithParam<int> {
  protected:
   void SetUp() override { KeyGenerator::Generate(2048, &sk_, &pk_); }
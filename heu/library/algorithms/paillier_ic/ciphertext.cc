@@ -22,7 +22,7 @@ namespace heu::lib::algorithms::paillier_ic {
 
 yacl::Buffer Ciphertext::Serialize() const {
   pb_ns::PaillierCiphertext pb_ct;
-  *pb_ct.mutable_c() = BigInt2PbBigint(c_);
+  *pb_ct.mutable_c() = BigInt2PbBigint(c_, m_space_.get());
 
   yacl::Buffer buffer(pb_ct.ByteSizeLong());
   YACL_ENFORCE(pb_ct.SerializeToArray(buffer.data<uint8_t>(), buffer.size()),
@@ -36,6 +36,7 @@ void Ciphertext::Deserialize(yacl::ByteContainerView in) {
                "deserialize ciphertext fail");
 
   PbBigint2BigInt(pk_ct.c(), c_);
+  m_space_.reset();
 }
 
 }  // namespace heu::lib::algorithms::paillier_ic
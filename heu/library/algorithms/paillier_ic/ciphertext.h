@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <utility>
+
 #include "heu/library/algorithms/util/big_int.h"
 #include "heu/library/algorithms/util/he_object.h"
 
@@ -21,15 +25,32 @@ namespace heu::lib::algorithms::paillier_ic {
 
 using Plaintext = BigInt;
 
+// Ciphertexts produced by Encryptor and Evaluator stay in the Montgomery form
+// of n^2, so chained operations never convert back and forth. The canonical
+// form required by the interconnection standard is only restored when
+// serializing. Deserialized ciphertexts are canonical until they are used by
+// an Evaluator.
 class Ciphertext {
  public:
   Ciphertext() = default;
 
+  // c is in canonical form
   explicit Ciphertext(BigInt c) : c_(std::move(c)) {}
 
-  [[nodiscard]] std::string ToString() const { return c_.ToString(); }
+  // c is in the Montgomery form of m_space
+  Ciphertext(BigInt c, std::shared_ptr<MontgomerySpace> m_space)
+      : c_(std::move(c)), m_space_(std::move(m_space)) {}
+
+  [[nodiscard]] std::string ToString() const {
+    return GetCanonical().ToString();
+  }
 
-  bool operator==(const Ciphertext &other) const { return c_ == other.c_; }
+  bool operator==(const Ciphertext &other) const {
+    if ((m_space_ == nullptr) == (other.m_space_ == nullptr)) {
+      return c_ == other.c_;
+    }
+    return GetCanonical() == other.GetCanonical();
+  }
 
   bool operator!=(const Ciphertext &other) const {
     return !this->operator==(other);
@@ -39,8 +60,21 @@ class Ciphertext {
 
   void Deserialize(yacl::ByteContainerView in);
 
+  [[nodiscard]] bool IsMontgomeryForm() const { return m_space_ != nullptr; }
+
+  // Returns c in canonical form
+  [[nodiscard]] BigInt GetCanonical() const {
+    BigInt c(c_);
+    if (m_space_) {
+      m_space_->MapBackToZSpace(c);
+    }
+    return c;
+  }
+
   // TODO: make this private.
   BigInt c_;
+  // m-space that c_ lives in, nullptr if c_ is in canonical form
+  std::shared_ptr<MontgomerySpace> m_space_;
 };
 
 }  // namespace heu::lib::algorithms::paillier_ic
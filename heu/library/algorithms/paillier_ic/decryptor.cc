@@ -25,10 +25,12 @@ namespace heu::lib::algorithms::paillier_ic {
 void Decryptor::Decrypt(const Ciphertext &ct, BigInt *out) const {
   VALIDATE(ct);
 
-  BigInt mp = ct.c_.PowMod(sk_.phi_p_, sk_.p_square_);
+  BigInt c = ct.GetCanonical();
+
+  BigInt mp = c.PowMod(sk_.phi_p_, sk_.p_square_);
   mp = ((mp - 1) / sk_.p_).MulMod(sk_.hp_, sk_.p_);
 
-  BigInt mq = ct.c_.PowMod(sk_.phi_q_, sk_.q_square_);
+  BigInt mq = c.PowMod(sk_.phi_q_, sk_.q_square_);
   mq = ((mq - 1) / sk_.q_).MulMod(sk_.hq_, sk_.q_);
 
   // Apply the CRT
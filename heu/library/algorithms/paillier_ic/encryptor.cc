@@ -26,10 +26,12 @@ Encryptor::Encryptor(const Encryptor &from) : Encryptor(from.pk_) {}
 BigInt Encryptor::GetRn() const {
   BigInt r = BigInt::RandomExactBits(pk_.key_size_ / 2);
   // (h_s_)^r
-  return pk_.h_s_.PowMod(r, pk_.n_square_);
+  return pk_.m_space_->PowMod(*pk_.hs_table_, r);
 }
 
-Ciphertext Encryptor::EncryptZero() const { return Ciphertext(GetRn()); }
+Ciphertext Encryptor::EncryptZero() const {
+  return Ciphertext(GetRn(), pk_.m_space_);
+}
 
 template <bool audit>
 Ciphertext Encryptor::EncryptImpl(const BigInt &m,
@@ -42,13 +44,15 @@ Ciphertext Encryptor::EncryptImpl(const BigInt &m,
   // It is also correct when m is negative
   BigInt gm = pk_.n_ * m + 1;  // no need mod
 
-  Ciphertext ct;
+  pk_.m_space_->MapIntoMSpace(gm);
   auto rn = GetRn();
-  ct.c_ = gm.MulMod(rn, pk_.n_square_);
+  Ciphertext ct(pk_.m_space_->MulMod(gm, rn), pk_.m_space_);
   if constexpr (audit) {
     YACL_ENFORCE(audit_str != nullptr);
+    // audit logs are checked by other parties, so print canonical values
+    pk_.m_space_->MapBackToZSpace(rn);
     *audit_str = fmt::format(FMT_COMPILE("p:{},rn:{},c:{}"), m.ToHexString(),
-                             rn.ToHexString(), ct.c_.ToHexString());
+                             rn.ToHexString(), ct.GetCanonical().ToHexString());
   }
   return ct;
 }
@@ -34,7 +34,7 @@ class Encryptor {
 
   const PublicKey &public_key() const { return pk_; }
 
-  // Get R^n
+  // Get R^n, in the Montgomery form of pk.m_space_
   BigInt GetRn() const;
 
  private:
@@ -22,22 +22,42 @@ namespace heu::lib::algorithms::paillier_ic {
   HE_ASSERT(!(ct).c_.IsNegative() && (ct).c_ < pk_.n_square_, \
             "Evaluator: Invalid ciphertext")
 
+const BigInt &Evaluator::GetMontgomery(const Ciphertext &ct,
+                                       BigInt *buf) const {
+  if (ct.IsMontgomeryForm()) {
+    return ct.c_;
+  }
+
+  *buf = ct.c_;
+  pk_.m_space_->MapIntoMSpace(*buf);
+  return *buf;
+}
+
 void Evaluator::Randomize(Ciphertext *ct) const {
   VALIDATE(*ct);
-  ct->c_ = ct->c_.MulMod(encryptor_.GetRn(), pk_.n_square_);
+  BigInt buf;
+  ct->c_ = pk_.m_space_->MulMod(GetMontgomery(*ct, &buf), encryptor_.GetRn());
+  ct->m_space_ = pk_.m_space_;
 }
 
 Ciphertext Evaluator::Add(const Ciphertext &a, const Ciphertext &b) const {
   VALIDATE(a);
   VALIDATE(b);
-  return Ciphertext{a.c_.MulMod(b.c_, pk_.n_square_)};
+
+  BigInt buf_a, buf_b;
+  return {pk_.m_space_->MulMod(GetMontgomery(a, &buf_a),
+                               GetMontgomery(b, &buf_b)),
+          pk_.m_space_};
 }
 
 void Evaluator::AddInplace(Ciphertext *a, const Ciphertext &b) const {
   VALIDATE(*a);
   VALIDATE(b);
 
-  a->c_ = a->c_.MulMod(b.c_, pk_.n_square_);
+  BigInt buf_a, buf_b;
+  a->c_ = pk_.m_space_->MulMod(GetMontgomery(*a, &buf_a),
+                               GetMontgomery(b, &buf_b));
+  a->m_space_ = pk_.m_space_;
 }
 
 Ciphertext Evaluator::Add(const Ciphertext &a, const Plaintext &p) const {
@@ -45,8 +65,13 @@ Ciphertext Evaluator::Add(const Ciphertext &a, const Plaintext &p) const {
   YACL_ENFORCE(p.CompareAbs(pk_.PlaintextBound()) <= 0,
                "plaintext out of range, message={}, max (abs)={}",
                p.ToHexString(), pk_.PlaintextBound());
+  // Note: g^m = (1 + n)^m = (1 + n*m) mod n^2
+  // It is also correct when m is negative
   BigInt gm = pk_.n_ * p + 1;  // no need mod
-  return Ciphertext{a.c_.MulMod(gm, pk_.n_square_)};
+  pk_.m_space_->MapIntoMSpace(gm);
+
+  BigInt buf;
+  return {pk_.m_space_->MulMod(GetMontgomery(a, &buf), gm), pk_.m_space_};
 }
 
 void Evaluator::AddInplace(Ciphertext *a, const Plaintext &p) const {
@@ -75,14 +100,29 @@ Ciphertext Evaluator::Sub(const Plaintext &p, const Ciphertext &a) const {
 
 Ciphertext Evaluator::Negate(const Ciphertext &a) const {
   VALIDATE(a);
-  return Ciphertext(a.c_.InvMod(pk_.n_square_));
+
+  BigInt c = a.GetCanonical().InvMod(pk_.n_square_);
+  pk_.m_space_->MapIntoMSpace(c);
+  return {std::move(c), pk_.m_space_};
 }
 
 void Evaluator::NegateInplace(Ciphertext *a) const { *a = Negate(*a); }
 
 Ciphertext Evaluator::Mul(const Ciphertext &a, const Plaintext &p) const {
   VALIDATE(a);
-  return Ciphertext(a.c_.PowMod(p, pk_.n_square_));
+
+  // Handle some values specially to speed up computation
+  auto p_bits = p.BitCount();
+  if (p_bits == 0) {
+    return {pk_.m_space_->Identity(), pk_.m_space_};
+  } else if (p_bits == 1) {
+    // p = -1 or 1
+    return p.IsNegative() ? Negate(a) : a;
+  }
+
+  BigInt c = a.GetCanonical().PowMod(p, pk_.n_square_);
+  pk_.m_space_->MapIntoMSpace(c);
+  return {std::move(c), pk_.m_space_};
 }
 
 void Evaluator::MulInplace(Ciphertext *a, const Plaintext &p) const {
@@ -83,6 +83,10 @@ class Evaluator {
   void NegateInplace(Ciphertext *a) const;
 
  private:
+  // Returns the value of ct in the Montgomery form of pk_. A canonical ct,
+  // e.g. one just received from peer, is converted into buf.
+  const BigInt &GetMontgomery(const Ciphertext &ct, BigInt *buf) const;
+
   PublicKey pk_;
   Encryptor encryptor_;
 };
@@ -177,4 +177,30 @@ TEST_F(IcPaillierTest, PlaintextEvaluate2) {
   EXPECT_EQ(plain.Get<int64_t>(), std::numeric_limits<int64_t>::max());
 }
 
+TEST_F(IcPaillierTest, SerializeCanonicalForm) {
+  Ciphertext ct0 = encryptor_->Encrypt(BigInt(-12345));
+  Ciphertext ct1 = evaluator_->Add(ct0, BigInt(100));
+  EXPECT_TRUE(ct1.IsMontgomeryForm());
+
+  // the wire format holds the canonical value
+  Ciphertext ct2;
+  ct2.Deserialize(ct1.Serialize());
+  EXPECT_FALSE(ct2.IsMontgomeryForm());
+  EXPECT_EQ(ct2.c_, ct1.GetCanonical());
+  EXPECT_EQ(ct2, ct1);
+
+  // canonical and Montgomery ciphertexts can be mixed
+  BigInt plain;
+  decryptor_->Decrypt(ct2, &plain);
+  EXPECT_EQ(plain, -12345 + 100);
+  decryptor_->Decrypt(evaluator_->Add(ct2, ct0), &plain);
+  EXPECT_EQ(plain, -12345 * 2 + 100);
+  decryptor_->Decrypt(evaluator_->Mul(ct2, BigInt(3)), &plain);
+  EXPECT_EQ(plain, (-12345 + 100) * 3);
+  evaluator_->SubInplace(&ct2, BigInt(100));
+  EXPECT_TRUE(ct2.IsMontgomeryForm());
+  decryptor_->Decrypt(ct2, &plain);
+  EXPECT_EQ(plain, -12345);
+}
+
 }  // namespace heu::lib::algorithms::paillier_ic::test
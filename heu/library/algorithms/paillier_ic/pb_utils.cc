@@ -26,6 +26,17 @@ pb_ns::Bigint BigInt2PbBigint(const BigInt &bigint) {
   return bi;
 }
 
+pb_ns::Bigint BigInt2PbBigint(const BigInt &bi,
+                              const MontgomerySpace *m_space) {
+  if (m_space == nullptr) {
+    return BigInt2PbBigint(bi);
+  }
+
+  BigInt canonical(bi);
+  m_space->MapBackToZSpace(canonical);
+  return BigInt2PbBigint(canonical);
+}
+
 void PbBigint2BigInt(const pb_ns::Bigint &bi, BigInt &bigint) {
   bigint.FromMagBytes(bi.little_endian_value(), yacl::Endian::little);
   if (bi.is_neg()) {
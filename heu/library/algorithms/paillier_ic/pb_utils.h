@@ -23,6 +23,10 @@ namespace heu::lib::algorithms::paillier_ic {
 namespace pb_ns = ::org::interconnection::v2::runtime;
 
 pb_ns::Bigint BigInt2PbBigint(const BigInt &bi);
+// If m_space is not null, bi is in the Montgomery form of m_space and is
+// mapped back to the canonical form first, as required by the interconnection
+// standard
+pb_ns::Bigint BigInt2PbBigint(const BigInt &bi, const MontgomerySpace *m_space);
 void PbBigint2BigInt(const pb_ns::Bigint &pb_bi, BigInt &bigint);
 
 }  // namespace heu::lib::algorithms::paillier_ic
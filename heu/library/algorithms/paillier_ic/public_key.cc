@@ -15,6 +15,7 @@
 #include "heu/library/algorithms/paillier_ic/public_key.h"
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #include "yacl/base/buffer.h"
@@ -24,10 +25,22 @@
 
 namespace heu::lib::algorithms::paillier_ic {
 
+namespace {
+constexpr size_t kExpUnitBits = 10;
+}  // namespace
+
 void PublicKey::Init() {
   n_square_ = n_ * n_;
   n_half_ = n_ / 2;
   key_size_ = n_.BitCount();
+
+  m_space_ = BigInt::CreateMontgomerySpace(n_square_);
+  hs_table_ = std::make_shared<BaseTable>();
+  size_t word_size = m_space_->GetWordBitSize();
+  m_space_->MakeBaseTable(
+      h_s_, kExpUnitBits,
+      // make max_exp_bits divisible by word_size
+      (key_size_ / 2 + word_size - 1) / word_size * word_size, hs_table_.get());
 }
 
 std::string PublicKey::ToString() const {
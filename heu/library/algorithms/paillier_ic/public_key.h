@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+
 #include "heu/library/algorithms/util/big_int.h"
 #include "heu/library/algorithms/util/he_object.h"
 
@@ -28,6 +31,9 @@ class PublicKey {
 
   size_t key_size_;
 
+  std::shared_ptr<MontgomerySpace> m_space_;  // m-space for mod n^2
+  std::shared_ptr<BaseTable> hs_table_;       // h_s_ table mod n^2
+
   // Init pk based on n_ and h_s_
   void Init();
   [[nodiscard]] std::string ToString() const;
@@ -0,0 +1,151 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/numpy/async.h"
+
+#include <algorithm>
+
+namespace heu::lib::numpy {
+
+namespace {
+
+// R is the result type of fn
+template <typename R, typename T, typename F>
+std::vector<Future<R>> SubmitInChunks(HeThreadPool *pool,
+                                      const DenseMatrix<T> &in,
+                                      int64_t rows_per_chunk, F &&fn,
+                                      TaskPriority priority) {
+  YACL_ENFORCE(rows_per_chunk > 0, "rows_per_chunk must be positive, got {}",
+               rows_per_chunk);
+  std::vector<Future<R>> res;
+  for (int64_t beg = 0; beg < in.rows(); beg += rows_per_chunk) {
+    auto len = std::min(rows_per_chunk, in.rows() - beg);
+    auto chunk = in.GetItem(Eigen::seqN(beg, len), Eigen::placeholders::all);
+    res.push_back(pool->Submit(
+        [fn, chunk = std::move(chunk)] { return fn(chunk); }, priority));
+  }
+  return res;
+}
+
+}  // namespace
+
+HeThreadPool::HeThreadPool(size_t num_threads) {
+  YACL_ENFORCE(num_threads > 0, "num_threads must be positive");
+  workers_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.emplace_back([this] { WorkerLoop(); });
+  }
+}
+
+HeThreadPool::~HeThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+const std::shared_ptr<HeThreadPool> &HeThreadPool::Default() {
+  // Never destroyed: joining threads during static destruction may deadlock
+  // with the yacl pool, which could have been destroyed already.
+  static auto *pool =
+      new std::shared_ptr<HeThreadPool>(std::make_shared<HeThreadPool>());
+  return *pool;
+}
+
+void HeThreadPool::Enqueue(std::function<void()> fn, TaskPriority priority) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    YACL_ENFORCE(!stopping_, "Cannot submit a task to a stopping pool");
+    tasks_.push({priority, next_seq_++, std::move(fn)});
+  }
+  cv_.notify_one();
+}
+
+void HeThreadPool::WorkerLoop() {
+  while (true) {
+    std::function<void()> fn;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;  // stopping and drained
+      }
+      fn = tasks_.top().fn;
+      tasks_.pop();
+    }
+    // exceptions are caught by packaged_task and rethrown in Future::get()
+    fn();
+  }
+}
+
+AsyncEncryptor::AsyncEncryptor(std::shared_ptr<const Encryptor> encryptor,
+                               std::shared_ptr<HeThreadPool> pool)
+    : encryptor_(std::move(encryptor)), pool_(std::move(pool)) {}
+
+Future<CMatrix> AsyncEncryptor::Encrypt(PMatrix in,
+                                        TaskPriority priority) const {
+  return pool_->Submit(
+      [encryptor = encryptor_, in = std::move(in)] {
+        return encryptor->Encrypt(in);
+      },
+      priority);
+}
+
+std::vector<Future<CMatrix>> AsyncEncryptor::EncryptInChunks(
+    const PMatrix &in, int64_t rows_per_chunk, TaskPriority priority) const {
+  return SubmitInChunks<CMatrix>(
+      pool_.get(), in, rows_per_chunk,
+      [encryptor = encryptor_](const PMatrix &chunk) {
+        return encryptor->Encrypt(chunk);
+      },
+      priority);
+}
+
+AsyncDecryptor::AsyncDecryptor(std::shared_ptr<const Decryptor> decryptor,
+                               std::shared_ptr<HeThreadPool> pool)
+    : decryptor_(std::move(decryptor)), pool_(std::move(pool)) {}
+
+Future<PMatrix> AsyncDecryptor::Decrypt(CMatrix in,
+                                        TaskPriority priority) const {
+  return pool_->Submit(
+      [decryptor = decryptor_, in = std::move(in)] {
+        return decryptor->Decrypt(in);
+      },
+      priority);
+}
+
+Future<PMatrix> AsyncDecryptor::DecryptInRange(CMatrix in, size_t range_bits,
+                                               TaskPriority priority) const {
+  return pool_->Submit(
+      [decryptor = decryptor_, in = std::move(in), range_bits] {
+        return decryptor->DecryptInRange(in, range_bits);
+      },
+      priority);
+}
+
+std::vector<Future<PMatrix>> AsyncDecryptor::DecryptInChunks(
+    const CMatrix &in, int64_t rows_per_chunk, TaskPriority priority) const {
+  return SubmitInChunks<PMatrix>(
+      pool_.get(), in, rows_per_chunk,
+      [decryptor = decryptor_](const CMatrix &chunk) {
+        return decryptor->Decrypt(chunk);
+      },
+      priority);
+}
+
+}  // namespace heu::lib::numpy
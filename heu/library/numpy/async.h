@@ -0,0 +1,199 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "heu/library/numpy/numpy.h"
+
+namespace heu::lib::numpy {
+
+// Tasks with higher priority are picked first, tasks with the same priority
+// run in submission order.
+enum class TaskPriority : int {
+  kLow = 0,
+  kNormal = 1,
+  kHigh = 2,
+};
+
+// Use get() to wait for the result, or wait_for(0s) to poll it. get() throws
+// if the task throws.
+template <typename T>
+using Future = std::shared_future<T>;
+
+// A dedicated pool which runs whole HE operations (encrypt a matrix, decrypt a
+// matrix, ...). Each operation is still split by yacl::parallel_for inside, so
+// a few threads are enough to overlap the stages of a protocol.
+class HeThreadPool {
+ public:
+  explicit HeThreadPool(size_t num_threads = 2);
+  // Pending tasks are finished before the pool exits
+  ~HeThreadPool();
+
+  HeThreadPool(const HeThreadPool &) = delete;
+  HeThreadPool &operator=(const HeThreadPool &) = delete;
+
+  // The pool shared by all async wrappers by default
+  static const std::shared_ptr<HeThreadPool> &Default();
+
+  template <typename F>
+  auto Submit(F &&fn, TaskPriority priority = TaskPriority::kNormal)
+      -> Future<std::invoke_result_t<std::decay_t<F>>> {
+    using R = std::invoke_result_t<std::decay_t<F>>;
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+    Future<R> res = task->get_future().share();
+    Enqueue([task] { (*task)(); }, priority);
+    return res;
+  }
+
+  size_t NumThreads() const { return workers_.size(); }
+
+ private:
+  struct Task {
+    TaskPriority priority;
+    uint64_t seq;
+    std::function<void()> fn;
+  };
+
+  struct TaskOrder {
+    bool operator()(const Task &a, const Task &b) const {
+      if (a.priority != b.priority) {
+        return a.priority < b.priority;
+      }
+      return a.seq > b.seq;
+    }
+  };
+
+  void Enqueue(std::function<void()> fn, TaskPriority priority);
+  void WorkerLoop();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::priority_queue<Task, std::vector<Task>, TaskOrder> tasks_;
+  uint64_t next_seq_ = 0;
+  bool stopping_ = false;
+  std::vector<std::thread> workers_;
+};
+
+// Async wrappers of numpy::Encryptor/Decryptor/Evaluator. Inputs are taken by
+// value, so the caller is free to destroy or modify its own copy once the call
+// returns. Use std::move to avoid the copy if the input is no longer needed.
+class AsyncEncryptor {
+ public:
+  explicit AsyncEncryptor(
+      std::shared_ptr<const Encryptor> encryptor,
+      std::shared_ptr<HeThreadPool> pool = HeThreadPool::Default());
+
+  Future<CMatrix> Encrypt(PMatrix in,
+                          TaskPriority priority = TaskPriority::kNormal) const;
+
+  // Encrypt every rows_per_chunk rows as a separate task. The caller can
+  // serialize and send the first chunks while the rest is still running.
+  std::vector<Future<CMatrix>> EncryptInChunks(
+      const PMatrix &in, int64_t rows_per_chunk,
+      TaskPriority priority = TaskPriority::kNormal) const;
+
+ private:
+  std::shared_ptr<const Encryptor> encryptor_;
+  std::shared_ptr<HeThreadPool> pool_;
+};
+
+class AsyncDecryptor {
+ public:
+  explicit AsyncDecryptor(
+      std::shared_ptr<const Decryptor> decryptor,
+      std::shared_ptr<HeThreadPool> pool = HeThreadPool::Default());
+
+  Future<PMatrix> Decrypt(CMatrix in,
+                          TaskPriority priority = TaskPriority::kNormal) const;
+  Future<PMatrix> DecryptInRange(
+      CMatrix in, size_t range_bits = 128,
+      TaskPriority priority = TaskPriority::kNormal) const;
+
+  // Decrypt every rows_per_chunk rows as a separate task
+  std::vector<Future<PMatrix>> DecryptInChunks(
+      const CMatrix &in, int64_t rows_per_chunk,
+      TaskPriority priority = TaskPriority::kNormal) const;
+
+ private:
+  std::shared_ptr<const Decryptor> decryptor_;
+  std::shared_ptr<HeThreadPool> pool_;
+};
+
+class AsyncEvaluator {
+ public:
+  explicit AsyncEvaluator(
+      std::shared_ptr<const Evaluator> evaluator,
+      std::shared_ptr<HeThreadPool> pool = HeThreadPool::Default())
+      : evaluator_(std::move(evaluator)), pool_(std::move(pool)) {}
+
+  template <typename X, typename Y>
+  auto Add(X x, Y y, TaskPriority priority = TaskPriority::kNormal) const {
+    return pool_->Submit(
+        [ev = evaluator_, x = std::move(x), y = std::move(y)] {
+          return ev->Add(x, y);
+        },
+        priority);
+  }
+
+  template <typename X, typename Y>
+  auto Sub(X x, Y y, TaskPriority priority = TaskPriority::kNormal) const {
+    return pool_->Submit(
+        [ev = evaluator_, x = std::move(x), y = std::move(y)] {
+          return ev->Sub(x, y);
+        },
+        priority);
+  }
+
+  template <typename X, typename Y>
+  auto Mul(X x, Y y, TaskPriority priority = TaskPriority::kNormal) const {
+    return pool_->Submit(
+        [ev = evaluator_, x = std::move(x), y = std::move(y)] {
+          return ev->Mul(x, y);
+        },
+        priority);
+  }
+
+  template <typename X, typename Y>
+  auto MatMul(X x, Y y, TaskPriority priority = TaskPriority::kNormal) const {
+    return pool_->Submit(
+        [ev = evaluator_, x = std::move(x), y = std::move(y)] {
+          return ev->MatMul(x, y);
+        },
+        priority);
+  }
+
+  template <typename T>
+  Future<T> Sum(DenseMatrix<T> x,
+                TaskPriority priority = TaskPriority::kNormal) const {
+    return pool_->Submit(
+        [ev = evaluator_, x = std::move(x)] { return ev->Sum(x); }, priority);
+  }
+
+ private:
+  std::shared_ptr<const Evaluator> evaluator_;
+  std::shared_ptr<HeThreadPool> pool_;
+};
+
+}  // namespace heu::lib::numpy
@@ -14,88 +14,118 @@
 
 #include "heu/library/numpy/decryptor.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace heu::lib::numpy {
 
 template <typename CLAZZ, typename CT>
 using kHasVectorizedDecrypt = decltype(std::declval<const CLAZZ &>().Decrypt(
     absl::Span<const CT *const>()));
 
-// CT is each algorithm's Ciphertext
-template <typename CLAZZ, typename CT, bool CheckRange>
-auto DoCallDecrypt(const CLAZZ &sub_decryptor, const CMatrix &in,
-                   size_t range_bits, PMatrix *out)
-    -> std::enable_if_t<
-        std::experimental::is_detected_v<kHasVectorizedDecrypt, CLAZZ, CT>> {
-  yacl::parallel_for(0, in.size(), 1, [&](int64_t beg, int64_t end) {
-    std::vector<const CT *> cts;
-    cts.reserve(end - beg);
-    for (int64_t i = beg; i < end; ++i) {
-      cts.push_back(&(in.data()[i].As<CT>()));
-    }
-    auto res = sub_decryptor.Decrypt(cts);
-    for (int64_t i = beg; i < end; ++i) {
-      out->data()[i] = std::move(res[i - beg]);
-      if constexpr (CheckRange) {
-        YACL_ENFORCE(
-            out->data()[i].BitCount() <= range_bits,
-            "Dangerous!!! HE ciphertext range check failed, there may be a "
-            "malicious party stealing your data, please stop computing "
-            "immediately. max_allowed_bits={}",
-            range_bits);
-      }
-    }
-  });
+// Decrypt small batches at a time, so the scratch plaintexts of all threads
+// stay small no matter how large the input is
+constexpr int64_t kDecryptBatchSize = 256;
+
+template <bool CheckRange>
+void CheckPlaintextRange(const phe::Plaintext &pt, size_t range_bits) {
+  if constexpr (CheckRange) {
+    YACL_ENFORCE(
+        pt.BitCount() <= range_bits,
+        "Dangerous!!! HE ciphertext range check failed, there may be a "
+        "malicious party stealing your data, please stop computing "
+        "immediately. found pt.BitCount()={}, expected {}",
+        pt.BitCount(), range_bits);
+  }
 }
 
 // CT is each algorithm's Ciphertext
 template <typename CLAZZ, typename CT, bool CheckRange>
-auto DoCallDecrypt(const CLAZZ &sub_decryptor, const CMatrix &in,
-                   size_t range_bits, PMatrix *out)
-    -> std::enable_if_t<
-        !std::experimental::is_detected_v<kHasVectorizedDecrypt, CLAZZ, CT>> {
+void DoCallDecrypt(const CLAZZ &sub_decryptor, const CMatrixView &in,
+                   size_t range_bits, const Decryptor::PlaintextSink &sink) {
+  int64_t rows = in.rows();
   yacl::parallel_for(0, in.size(), 1, [&](int64_t beg, int64_t end) {
-    for (int64_t i = beg; i < end; ++i) {
-      out->data()[i] = sub_decryptor.Decrypt(in.data()[i].As<CT>());
-      if constexpr (CheckRange) {
-        YACL_ENFORCE(
-            out->data()[i].BitCount() <= range_bits,
-            "Dangerous!!! HE ciphertext range check failed, there may be a "
-            "malicious party stealing your data, please stop computing "
-            "immediately. found pt.BitCount()={}, expected {}",
-            out->data()[i].BitCount(), range_bits);
+    std::vector<phe::Plaintext> pts;
+    pts.reserve(std::min(kDecryptBatchSize, end - beg));
+    for (int64_t b = beg; b < end; b += kDecryptBatchSize) {
+      int64_t e = std::min(end, b + kDecryptBatchSize);
+      pts.clear();
+      if constexpr (std::experimental::is_detected_v<kHasVectorizedDecrypt,
+                                                     CLAZZ, CT>) {
+        std::vector<const CT *> cts;
+        cts.reserve(e - b);
+        for (int64_t i = b; i < e; ++i) {
+          cts.push_back(&(in(i % rows, i / rows).As<CT>()));
+        }
+        for (auto &pt : sub_decryptor.Decrypt(cts)) {
+          pts.emplace_back(std::move(pt));
+        }
+      } else {
+        for (int64_t i = b; i < e; ++i) {
+          pts.emplace_back(
+              sub_decryptor.Decrypt(in(i % rows, i / rows).As<CT>()));
+        }
+      }
+
+      for (const auto &pt : pts) {
+        CheckPlaintextRange<CheckRange>(pt, range_bits);
       }
+      sink(b, absl::MakeSpan(pts));
     }
   });
 }
 
 PMatrix Decryptor::Decrypt(const CMatrix &in) const {
+  return Decrypt(CMatrixView(in));
+}
+
+PMatrix Decryptor::Decrypt(const CMatrixView &in) const {
   PMatrix out(in.rows(), in.cols(), in.ndim());
+  DecryptTo(in, [&](int64_t beg, absl::Span<phe::Plaintext> pts) {
+    std::move(pts.begin(), pts.end(), out.data() + beg);
+  });
+  return out;
+}
+
+PMatrix Decryptor::DecryptInRange(const CMatrix &in, size_t range_bits) const {
+  return DecryptInRange(CMatrixView(in), range_bits);
+}
+
+PMatrix Decryptor::DecryptInRange(const CMatrixView &in,
+                                  size_t range_bits) const {
+  PMatrix out(in.rows(), in.cols(), in.ndim());
+  DecryptInRangeTo(
+      in,
+      [&](int64_t beg, absl::Span<phe::Plaintext> pts) {
+        std::move(pts.begin(), pts.end(), out.data() + beg);
+      },
+      range_bits);
+  return out;
+}
 
+void Decryptor::DecryptTo(const CMatrixView &in,
+                          const PlaintextSink &sink) const {
 #define FUNC(ns)                                                              \
   [&](const ns::Decryptor &sub_decryptor) {                                   \
     DoCallDecrypt<ns::Decryptor, ns::Ciphertext, false>(sub_decryptor, in, 0, \
-                                                        &out);                \
+                                                        sink);                \
   }
 
   std::visit(HE_DISPATCH(FUNC), decryptor_ptr_);
 #undef FUNC
-
-  return out;
 }
 
-PMatrix Decryptor::DecryptInRange(const CMatrix &in, size_t range_bits) const {
-  PMatrix out(in.rows(), in.cols(), in.ndim());
-
+void Decryptor::DecryptInRangeTo(const CMatrixView &in,
+                                 const PlaintextSink &sink,
+                                 size_t range_bits) const {
 #define FUNC(ns)                                                          \
   [&](const ns::Decryptor &sub_decryptor) {                               \
     DoCallDecrypt<ns::Decryptor, ns::Ciphertext, true>(sub_decryptor, in, \
-                                                       range_bits, &out); \
+                                                       range_bits, sink); \
   }
 
   std::visit(HE_DISPATCH(FUNC), decryptor_ptr_);
 #undef FUNC
-
-  return out;
 }
 
 }  // namespace heu::lib::numpy
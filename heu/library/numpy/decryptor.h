@@ -14,8 +14,11 @@
 
 #pragma once
 
+#include <functional>
 #include <utility>
 
+#include "absl/types/span.h"
+
 #include "heu/library/numpy/matrix.h"
 #include "heu/library/phe/phe.h"
 
@@ -28,6 +31,7 @@ class Decryptor : public phe::Decryptor {
 
   using phe::Decryptor::Decrypt;
   PMatrix Decrypt(const CMatrix &in) const;
+  PMatrix Decrypt(const CMatrixView &in) const;
 
   // Decrypt ct and make sure pt is in range (-2^range_bits, 2^range_bits)
   // throws an exception if plaintext is out of range.
@@ -35,6 +39,19 @@ class Decryptor : public phe::Decryptor {
   // documentation for details
   using phe::Decryptor::DecryptInRange;
   PMatrix DecryptInRange(const CMatrix &in, size_t range_bits = 128) const;
+  PMatrix DecryptInRange(const CMatrixView &in, size_t range_bits = 128) const;
+
+  // Receives the plaintexts of elements [beg, beg + pts.size()) of in, in
+  // column-major order. The sink may move them away. It is called
+  // concurrently on disjoint ranges.
+  using PlaintextSink =
+      std::function<void(int64_t beg, absl::Span<phe::Plaintext> pts)>;
+
+  // Decrypt batch by batch and hand each batch to sink instead of building a
+  // PMatrix, e.g. to decode the plaintexts into the final output directly
+  void DecryptTo(const CMatrixView &in, const PlaintextSink &sink) const;
+  void DecryptInRangeTo(const CMatrixView &in, const PlaintextSink &sink,
+                        size_t range_bits = 128) const;
 };
 
 }  // namespace heu::lib::numpy
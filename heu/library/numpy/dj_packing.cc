@@ -0,0 +1,237 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/numpy/dj_packing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include "yacl/utils/parallel.h"
+
+namespace heu::lib::numpy {
+
+namespace {
+
+size_t BitLength(uint64_t x) {
+  size_t bits = 0;
+  while (x != 0) {
+    ++bits;
+    x >>= 1;
+  }
+  return bits;
+}
+
+}  // namespace
+
+DjPackingParams::DjPackingParams(size_t key_size, uint32_t s, int64_t scale,
+                                 size_t padding_bits)
+    : key_size(key_size), s(s), scale(scale), padding_bits(padding_bits) {
+  YACL_ENFORCE(s > 0, "s must be positive");
+  YACL_ENFORCE(scale > 0, "scale must be positive, got {}", scale);
+  YACL_ENFORCE(SlotsPerPlaintext() > 0,
+               "key_size {} with s={} cannot hold a single {}-bit slot",
+               key_size, s, SlotBits());
+}
+
+size_t DjPackingParams::SlotsPerPlaintext(uint32_t s) const {
+  // n has at least key_size - 1 bits, and a plaintext must stay below n^s / 2
+  // to be decrypted as a positive number.
+  size_t capacity_bits = s * (key_size - 2) - 1;
+  return capacity_bits / SlotBits();
+}
+
+DjPackingParams DjPackingParams::Select(size_t vector_len, int64_t scale,
+                                        size_t padding_bits, size_t key_size,
+                                        uint32_t max_s) {
+  YACL_ENFORCE(vector_len > 0, "vector_len must be positive");
+  YACL_ENFORCE(max_s > 0, "max_s must be positive");
+
+  DjPackingParams params;
+  params.key_size = key_size;
+  params.scale = scale;
+  params.padding_bits = padding_bits;
+
+  size_t best_cost = std::numeric_limits<size_t>::max();
+  for (uint32_t s = 1; s <= max_s; ++s) {
+    size_t slots = params.SlotsPerPlaintext(s);
+    if (slots == 0) {
+      continue;
+    }
+    // total ciphertext size in units of key_size bits
+    size_t cost = (vector_len + slots - 1) / slots * (s + 1);
+    if (cost < best_cost) {
+      best_cost = cost;
+      params.s = s;
+    }
+  }
+  YACL_ENFORCE(best_cost != std::numeric_limits<size_t>::max(),
+               "key_size {} is too small to hold a {}-bit slot", key_size,
+               params.SlotBits());
+  return params;
+}
+
+std::string DjPackingParams::ToString() const {
+  return fmt::format(
+      "DjPackingParams(key_size={}, s={}, scale={}, padding_bits={}, "
+      "slots_per_plaintext={})",
+      key_size, s, scale, padding_bits, SlotsPerPlaintext());
+}
+
+std::string DjPackedCMatrix::ToString() const {
+  return fmt::format(
+      "DjPackedCMatrix(size={}, num_ciphertexts={}, used_padding_bits={})",
+      size, cts.size(), used_padding_bits);
+}
+
+DjPacker::DjPacker(DjPackingParams params) : params_(std::move(params)) {}
+
+HeKit DjPacker::SetupHeKit() const {
+  algorithms::dj::SecretKey sk;
+  algorithms::dj::PublicKey pk;
+  algorithms::dj::KeyGenerator::Generate(params_.key_size, params_.s, &sk,
+                                         &pk);
+  return HeKit(phe::HeKit(std::make_shared<phe::PublicKey>(std::move(pk)),
+                          std::make_shared<phe::SecretKey>(std::move(sk))));
+}
+
+int64_t DjPacker::NumPlaintexts(int64_t size) const {
+  auto slots = static_cast<int64_t>(params_.SlotsPerPlaintext());
+  return (size + slots - 1) / slots;
+}
+
+void DjPacker::CheckPadding(size_t used_padding_bits) const {
+  YACL_ENFORCE(used_padding_bits <= params_.padding_bits,
+               "Slot overflow: the operation needs {} padding bits, but only "
+               "{} bits are reserved. Please use a larger padding_bits",
+               used_padding_bits, params_.padding_bits);
+}
+
+PMatrix DjPacker::Pack(absl::Span<const double> values) const {
+  auto slots = static_cast<int64_t>(params_.SlotsPerPlaintext());
+  auto size = static_cast<int64_t>(values.size());
+  PMatrix res(NumPlaintexts(size));
+  yacl::parallel_for(0, res.size(), 1, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      // fill from the highest slot, so each step is a shift and an or
+      phe::Plaintext pt(schema_, 0);
+      for (int64_t j = std::min(size, (i + 1) * slots) - 1; j >= i * slots;
+           --j) {
+        // round to nearest, truncation would turn 0.29 * 100 into 28
+        int64_t v = std::llround(values[j] * params_.scale);
+        pt <<= params_.SlotBits();
+        // get raw buffer (means 2's complement code) and encode it
+        pt |= phe::Plaintext(schema_, static_cast<uint64_t>(v));
+      }
+      res(i) = std::move(pt);
+    }
+  });
+  return res;
+}
+
+std::vector<double> DjPacker::Unpack(const PMatrix &pts, int64_t size) const {
+  auto slots = static_cast<int64_t>(params_.SlotsPerPlaintext());
+  YACL_ENFORCE(pts.size() == NumPlaintexts(size),
+               "Cannot unpack {} elements from {} plaintexts", size,
+               pts.size());
+  std::vector<double> res(size);
+  yacl::parallel_for(0, pts.size(), 1, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      phe::Plaintext pt = pts.data()[i];
+      for (int64_t j = i * slots; j < std::min(size, (i + 1) * slots); ++j) {
+        // GetValue<int64_t> takes the low 64 bits, carries in the padding
+        // bits are dropped
+        res[j] = pt.GetValue<int64_t>() / static_cast<double>(params_.scale);
+        pt >>= params_.SlotBits();
+      }
+    }
+  });
+  return res;
+}
+
+DjPackedCMatrix DjPacker::Encrypt(const Encryptor &encryptor,
+                                  absl::Span<const double> values) const {
+  return {encryptor.Encrypt(Pack(values)), static_cast<int64_t>(values.size()),
+          0};
+}
+
+std::vector<double> DjPacker::Decrypt(const Decryptor &decryptor,
+                                      const DjPackedCMatrix &in) const {
+  return Unpack(decryptor.Decrypt(in.cts), in.size);
+}
+
+DjPackedCMatrix DjPacker::Add(const Evaluator &evaluator,
+                              const DjPackedCMatrix &x,
+                              const DjPackedCMatrix &y) const {
+  YACL_ENFORCE(x.size == y.size, "Size mismatch, x.size={}, y.size={}", x.size,
+               y.size);
+  auto used = std::max(x.used_padding_bits, y.used_padding_bits) + 1;
+  CheckPadding(used);
+  return {evaluator.Add(x.cts, y.cts), x.size, used};
+}
+
+DjPackedCMatrix DjPacker::Add(const Evaluator &evaluator,
+                              const DjPackedCMatrix &x,
+                              absl::Span<const double> y) const {
+  YACL_ENFORCE(x.size == static_cast<int64_t>(y.size()),
+               "Size mismatch, x.size={}, y.size={}", x.size, y.size());
+  auto used = x.used_padding_bits + 1;
+  CheckPadding(used);
+  return {evaluator.Add(x.cts, Pack(y)), x.size, used};
+}
+
+DjPackedCMatrix DjPacker::Sub(const Evaluator &evaluator,
+                              const DjPackedCMatrix &x,
+                              const DjPackedCMatrix &y) const {
+  return Add(evaluator, x, Negate(evaluator, y));
+}
+
+phe::Plaintext DjPacker::SlotWiseConstant(size_t bits) const {
+  phe::Plaintext one(schema_, 1);
+  phe::Plaintext pt(schema_, 0);
+  for (size_t i = 0; i < params_.SlotsPerPlaintext(); ++i) {
+    pt <<= params_.SlotBits();
+    pt |= one << bits;
+  }
+  return pt;
+}
+
+DjPackedCMatrix DjPacker::Negate(const Evaluator &evaluator,
+                                 const DjPackedCMatrix &x) const {
+  // Each slot u < 2^(64 + used) is mapped to 2^(64 + used) - u, which is
+  // non-negative and equals -u modulo 2^64. Negating the whole plaintext
+  // instead would make borrows run across slots.
+  auto used = x.used_padding_bits + 1;
+  CheckPadding(used);
+  PMatrix c(1, 1, 0);
+  c(0, 0) = SlotWiseConstant(DjPackingParams::kValueBits + x.used_padding_bits);
+  return {evaluator.Sub(c, x.cts), x.size, used};
+}
+
+DjPackedCMatrix DjPacker::Mul(const Evaluator &evaluator,
+                              const DjPackedCMatrix &x, int64_t scalar) const {
+  auto abs = scalar < 0 ? -static_cast<uint64_t>(scalar)
+                        : static_cast<uint64_t>(scalar);
+  auto used = x.used_padding_bits + BitLength(abs);
+  CheckPadding(used);
+
+  PMatrix c(1, 1, 0);
+  c(0, 0) = phe::Plaintext(schema_, abs);
+  DjPackedCMatrix res = {evaluator.Mul(x.cts, c), x.size, used};
+  return scalar < 0 ? Negate(evaluator, res) : res;
+}
+
+}  // namespace heu::lib::numpy
@@ -0,0 +1,117 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "heu/library/numpy/numpy.h"
+
+namespace heu::lib::numpy {
+
+// Parameters of the Damgard-Jurik packing mode.
+//
+// A DJ plaintext with parameter s holds about s * key_size bits, which is
+// split into fixed-width slots. Each slot holds one int64 fixed-point number
+// (value * scale, in 2's complement) followed by padding_bits of headroom that
+// absorbs the carries of slot-wise additions and multiplications.
+struct DjPackingParams : algorithms::HeObject<DjPackingParams> {
+  size_t key_size = 2048;
+  uint32_t s = 1;
+  int64_t scale = 1e6;
+  size_t padding_bits = 32;
+
+  MSGPACK_DEFINE(key_size, s, scale, padding_bits);
+
+  DjPackingParams() = default;
+  DjPackingParams(size_t key_size, uint32_t s, int64_t scale,
+                  size_t padding_bits);
+
+  // Choose the s which minimizes the total ciphertext size of a vector with
+  // vector_len elements. Ties are broken by the smaller s, since the cost of
+  // DJ operations grows with s.
+  static DjPackingParams Select(size_t vector_len, int64_t scale = 1e6,
+                                size_t padding_bits = 32,
+                                size_t key_size = 2048, uint32_t max_s = 8);
+
+  size_t SlotBits() const { return kValueBits + padding_bits; }
+
+  size_t SlotsPerPlaintext() const { return SlotsPerPlaintext(s); }
+
+  [[nodiscard]] std::string ToString() const override;
+
+  static constexpr size_t kValueBits = 64;
+
+ private:
+  size_t SlotsPerPlaintext(uint32_t s) const;
+};
+
+// An encrypted vector in packing mode, element i is stored in slot
+// (i % slots_per_plaintext) of ciphertext (i / slots_per_plaintext)
+struct DjPackedCMatrix {
+  CMatrix cts;
+  int64_t size;
+  // The padding bits consumed by carries so far. All slots share the same
+  // history of operations, so one counter covers every slot.
+  size_t used_padding_bits = 0;
+
+  [[nodiscard]] std::string ToString() const;
+};
+
+// SIMD-style operations over packed DJ ciphertexts
+class DjPacker {
+ public:
+  explicit DjPacker(DjPackingParams params);
+
+  // Generate a Damgard-Jurik HeKit whose s matches the params
+  HeKit SetupHeKit() const;
+
+  const DjPackingParams &GetParams() const { return params_; }
+
+  PMatrix Pack(absl::Span<const double> values) const;
+  std::vector<double> Unpack(const PMatrix &pts, int64_t size) const;
+
+  DjPackedCMatrix Encrypt(const Encryptor &encryptor,
+                          absl::Span<const double> values) const;
+  std::vector<double> Decrypt(const Decryptor &decryptor,
+                              const DjPackedCMatrix &in) const;
+
+  // slot-wise operations
+  DjPackedCMatrix Add(const Evaluator &evaluator, const DjPackedCMatrix &x,
+                      const DjPackedCMatrix &y) const;
+  DjPackedCMatrix Add(const Evaluator &evaluator, const DjPackedCMatrix &x,
+                      absl::Span<const double> y) const;
+  DjPackedCMatrix Sub(const Evaluator &evaluator, const DjPackedCMatrix &x,
+                      const DjPackedCMatrix &y) const;
+  DjPackedCMatrix Negate(const Evaluator &evaluator,
+                         const DjPackedCMatrix &x) const;
+  // Multiply every slot by the same integer scalar. The scale of the result
+  // is not changed.
+  DjPackedCMatrix Mul(const Evaluator &evaluator, const DjPackedCMatrix &x,
+                      int64_t scalar) const;
+
+ private:
+  int64_t NumPlaintexts(int64_t size) const;
+  void CheckPadding(size_t used_padding_bits) const;
+  // A plaintext whose every slot is 2^bits, i.e. 0 modulo 2^kValueBits
+  phe::Plaintext SlotWiseConstant(size_t bits) const;
+
+  DjPackingParams params_;
+  phe::SchemaType schema_ = phe::SchemaType::DJ;
+};
+
+}  // namespace heu::lib::numpy
@@ -22,14 +22,16 @@ using kHasVectorizedEncrypt = decltype(std::declval<const CLAZZ &>().Encrypt(
 
 // PT is each algorithm's Plaintext
 template <typename CLAZZ, typename PT>
-auto DoCallEncrypt(const CLAZZ &sub_encryptor, const PMatrix &in, CMatrix *out)
+auto DoCallEncrypt(const CLAZZ &sub_encryptor, const PMatrixView &in,
+                   CMatrix *out)
     -> std::enable_if_t<
         std::experimental::is_detected_v<kHasVectorizedEncrypt, CLAZZ, PT>> {
+  int64_t rows = in.rows();
   yacl::parallel_for(0, in.size(), 1, [&](int64_t beg, int64_t end) {
     std::vector<const PT *> pts;
     pts.reserve(end - beg);
     for (int64_t i = beg; i < end; ++i) {
-      pts.push_back(&(in.data()[i].As<PT>()));
+      pts.push_back(&(in(i % rows, i / rows).As<PT>()));
     }
     auto res = sub_encryptor.Encrypt(pts);
     for (int64_t i = beg; i < end; ++i) {
@@ -40,18 +42,24 @@ auto DoCallEncrypt(const CLAZZ &sub_encryptor, const PMatrix &in, CMatrix *out)
 
 // PT is each algorithm's Plaintext
 template <typename CLAZZ, typename PT>
-auto DoCallEncrypt(const CLAZZ &sub_encryptor, const PMatrix &in, CMatrix *out)
+auto DoCallEncrypt(const CLAZZ &sub_encryptor, const PMatrixView &in,
+                   CMatrix *out)
     -> std::enable_if_t<
         !std::experimental::is_detected_v<kHasVectorizedEncrypt, CLAZZ, PT>> {
+  int64_t rows = in.rows();
   yacl::parallel_for(0, in.size(), 1, [&](int64_t beg, int64_t end) {
     for (int64_t i = beg; i < end; ++i) {
-      out->data()[i] =
-          phe::Ciphertext(sub_encryptor.Encrypt(in.data()[i].As<PT>()));
+      out->data()[i] = phe::Ciphertext(
+          sub_encryptor.Encrypt(in(i % rows, i / rows).As<PT>()));
     }
   });
 }
 
 CMatrix Encryptor::Encrypt(const PMatrix &in) const {
+  return Encrypt(PMatrixView(in));
+}
+
+CMatrix Encryptor::Encrypt(const PMatrixView &in) const {
   CMatrix z(in.rows(), in.cols(), in.ndim());
 
 #define FUNC(ns)                                                        \
@@ -28,6 +28,8 @@ class Encryptor : public phe::Encryptor {
 
   using phe::Encryptor::Encrypt;
   CMatrix Encrypt(const PMatrix &in) const;
+  // Encrypt a sliced/transposed view without copying the plaintexts
+  CMatrix Encrypt(const PMatrixView &in) const;
 
   std::pair<CMatrix, DenseMatrix<std::string>> EncryptWithAudit(
       const PMatrix &in) const;
@@ -13,8 +13,11 @@
 // limitations under the License.
 #include "heu/library/numpy/evaluator.h"
 
+#include <algorithm>
+#include <optional>
 #include <type_traits>
 #include <typeinfo>
+#include <vector>
 
 #include "fmt/ranges.h"
 #include "yacl/utils/parallel.h"
@@ -60,14 +63,6 @@ struct Dimension {
   }
 };
 
-std::array<int64_t, 2> ComputeCastStride(const std::array<int64_t, 2> &strides,
-                                         const Dimension &sizes,
-                                         const Dimension &new_sizes) {
-  int64_t stride0 = (sizes.rows == new_sizes.rows) ? strides[0] : 0;
-  int64_t stride1 = (sizes.cols == new_sizes.cols) ? strides[1] : 0;
-  return {stride0, stride1};
-}
-
 int64_t MatmulDim(const Shape &x, const Shape &y) {
   int64_t newd;
   auto mind = std::min(x.Ndim(), y.Ndim());
@@ -103,86 +98,79 @@ template <typename CLAZZ, typename T>
 using kHasReduceSum = decltype(std::declval<const CLAZZ &>().ReduceSum(
     absl::Span<const T *const>()));
 
-#define DO_CALL_OP(ns, OP, TX, TY)                                           \
-  [&](const ns::Evaluator &sub_encryptor) {                                  \
-    DoCall##OP<ns::Evaluator, ns::TX, ns::TY>(sub_encryptor, x, x_stride, y, \
-                                              y_stride, &out);               \
+#define DO_CALL_OP(ns, OP, TX, TY)                                            \
+  [&](const ns::Evaluator &sub_encryptor) {                                   \
+    DoCall##OP<ns::Evaluator, ns::TX, ns::TY>(sub_encryptor, bx, by, &out);   \
   }
 
-#define IMPLEMENT_DENSE_OP(OP, RET, TX, TY)                                  \
-  template <typename CLAZZ, typename SUB_TX, typename SUB_TY>                \
-  auto DoCall##OP(const CLAZZ &sub_evaluator, const DenseMatrix<phe::TX> &x, \
-                  std::array<int64_t, 2> x_stride,                           \
-                  const DenseMatrix<phe::TY> &y,                             \
-                  std::array<int64_t, 2> y_stride, RET *out)                 \
-      ->std::enable_if_t<std::experimental::is_detected_v<                   \
-          kHasVectorized##OP, CLAZZ, SUB_TX, SUB_TY>> {                      \
-    const auto *x_base = x.data();                                           \
-    const auto *y_base = y.data();                                           \
-    RET::value_type *out_base = out->data();                                 \
-    int64_t rows = out->rows();                                              \
-    yacl::parallel_for(0, out->size(), 1, [&](int64_t beg, int64_t end) {    \
-      std::vector<const SUB_TX *> in_x;                                      \
-      std::vector<const SUB_TY *> in_y;                                      \
-      in_x.reserve(end - beg);                                               \
-      in_y.reserve(end - beg);                                               \
-      for (int64_t i = beg; i < end; ++i) {                                  \
-        int64_t row = i % rows;                                              \
-        int64_t col = i / rows;                                              \
-        in_x.push_back(                                                      \
-            &(x_base[row * x_stride[0] + col * x_stride[1]].As<SUB_TX>()));  \
-        in_y.push_back(                                                      \
-            &(y_base[row * y_stride[0] + col * y_stride[1]].As<SUB_TY>()));  \
-      }                                                                      \
-      auto res = sub_evaluator.OP(in_x, in_y);                               \
-      for (int64_t i = beg; i < end; ++i) {                                  \
-        out_base[i] = RET::value_type(std::move(res[i - beg]));              \
-      }                                                                      \
-    });                                                                      \
-  }                                                                          \
-                                                                             \
-  template <typename CLAZZ, typename SUB_TX, typename SUB_TY>                \
-  auto DoCall##OP(const CLAZZ &sub_evaluator, const DenseMatrix<phe::TX> &x, \
-                  std::array<int64_t, 2> x_stride,                           \
-                  const DenseMatrix<phe::TY> &y,                             \
-                  std::array<int64_t, 2> y_stride, RET *out)                 \
-      ->std::enable_if_t<!std::experimental::is_detected_v<                  \
-          kHasVectorized##OP, CLAZZ, SUB_TX, SUB_TY>> {                      \
-    const auto *x_base = x.data();                                           \
-    const auto *y_base = y.data();                                           \
-    RET::value_type *out_base = out->data();                                 \
-    int64_t rows = out->rows();                                              \
-    yacl::parallel_for(0, out->size(), 1, [&](int64_t beg, int64_t end) {    \
-      for (int64_t i = beg; i < end; ++i) {                                  \
-        int64_t row = i % rows;                                              \
-        int64_t col = i / rows;                                              \
-        out_base[i] = RET::value_type(                                       \
-            sub_evaluator.OP(x_base[row * x_stride[0] + col * x_stride[1]]   \
-                                 .template As<SUB_TX>(),                     \
-                             y_base[row * y_stride[0] + col * y_stride[1]]   \
-                                 .template As<SUB_TY>()));                   \
-      }                                                                      \
-    });                                                                      \
-  }                                                                          \
-                                                                             \
-  RET Evaluator::OP(const DenseMatrix<phe::TX> &x,                           \
-                    const DenseMatrix<phe::TY> &y) const {                   \
-    Dimension sx(x);                                                         \
-    Dimension sy(y);                                                         \
-    YACL_ENFORCE(sx.IsCompatibleShape(sy),                                   \
-                 "{} not supported for dim(x)={}, dim(y)={}", __func__,      \
-                 (x).shape().ToString(), (y).shape().ToString());            \
-                                                                             \
-    auto sz = sx.ComputeCastShape(sy);                                       \
-                                                                             \
-    std::array<int64_t, 2> x_old_stride = {1, x.rows()};                     \
-    std::array<int64_t, 2> y_old_stride = {1, y.rows()};                     \
-    const auto x_stride = ComputeCastStride(x_old_stride, sx, sz);           \
-    const auto y_stride = ComputeCastStride(y_old_stride, sy, sz);           \
-                                                                             \
-    RET out(sz.rows, sz.cols, sz.ndim);                                      \
-    std::visit(HE_DISPATCH(DO_CALL_OP, OP, TX, TY), evaluator_ptr_);         \
-    return out;                                                              \
+// x and y are already broadcast to the shape of out
+#define IMPLEMENT_DENSE_OP(OP, RET, TX, TY)                                   \
+  template <typename CLAZZ, typename SUB_TX, typename SUB_TY>                 \
+  auto DoCall##OP(const CLAZZ &sub_evaluator,                                 \
+                  const DenseMatrixView<phe::TX> &x,                          \
+                  const DenseMatrixView<phe::TY> &y, RET *out)                \
+      ->std::enable_if_t<std::experimental::is_detected_v<                    \
+          kHasVectorized##OP, CLAZZ, SUB_TX, SUB_TY>> {                       \
+    RET::value_type *out_base = out->data();                                  \
+    int64_t rows = out->rows();                                               \
+    yacl::parallel_for(0, out->size(), 1, [&](int64_t beg, int64_t end) {     \
+      std::vector<const SUB_TX *> in_x;                                       \
+      std::vector<const SUB_TY *> in_y;                                       \
+      in_x.reserve(end - beg);                                                \
+      in_y.reserve(end - beg);                                                \
+      for (int64_t i = beg; i < end; ++i) {                                   \
+        int64_t row = i % rows;                                               \
+        int64_t col = i / rows;                                               \
+        in_x.push_back(&(x(row, col).template As<SUB_TX>()));                 \
+        in_y.push_back(&(y(row, col).template As<SUB_TY>()));                 \
+      }                                                                       \
+      auto res = sub_evaluator.OP(in_x, in_y);                                \
+      for (int64_t i = beg; i < end; ++i) {                                   \
+        out_base[i] = RET::value_type(std::move(res[i - beg]));               \
+      }                                                                       \
+    });                                                                       \
+  }                                                                           \
+                                                                              \
+  template <typename CLAZZ, typename SUB_TX, typename SUB_TY>                 \
+  auto DoCall##OP(const CLAZZ &sub_evaluator,                                 \
+                  const DenseMatrixView<phe::TX> &x,                          \
+                  const DenseMatrixView<phe::TY> &y, RET *out)                \
+      ->std::enable_if_t<!std::experimental::is_detected_v<                   \
+          kHasVectorized##OP, CLAZZ, SUB_TX, SUB_TY>> {                       \
+    RET::value_type *out_base = out->data();                                  \
+    int64_t rows = out->rows();                                               \
+    yacl::parallel_for(0, out->size(), 1, [&](int64_t beg, int64_t end) {     \
+      for (int64_t i = beg; i < end; ++i) {                                   \
+        int64_t row = i % rows;                                               \
+        int64_t col = i / rows;                                               \
+        out_base[i] = RET::value_type(                                        \
+            sub_evaluator.OP(x(row, col).template As<SUB_TX>(),               \
+                             y(row, col).template As<SUB_TY>()));             \
+      }                                                                       \
+    });                                                                       \
+  }                                                                           \
+                                                                              \
+  RET Evaluator::OP(const DenseMatrixView<phe::TX> &x,                        \
+                    const DenseMatrixView<phe::TY> &y) const {                \
+    Dimension sx(x);                                                          \
+    Dimension sy(y);                                                          \
+    YACL_ENFORCE(sx.IsCompatibleShape(sy),                                    \
+                 "{} not supported for dim(x)={}, dim(y)={}", __func__,       \
+                 (x).shape().ToString(), (y).shape().ToString());             \
+                                                                              \
+    auto sz = sx.ComputeCastShape(sy);                                        \
+    /* broadcasting only changes the strides, nothing is copied */            \
+    auto bx = x.BroadcastTo(sz.rows, sz.cols, sz.ndim);                       \
+    auto by = y.BroadcastTo(sz.rows, sz.cols, sz.ndim);                       \
+                                                                              \
+    RET out(sz.rows, sz.cols, sz.ndim);                                       \
+    std::visit(HE_DISPATCH(DO_CALL_OP, OP, TX, TY), evaluator_ptr_);          \
+    return out;                                                               \
+  }                                                                           \
+                                                                              \
+  RET Evaluator::OP(const DenseMatrix<phe::TX> &x,                            \
+                    const DenseMatrix<phe::TY> &y) const {                    \
+    return OP(DenseMatrixView<phe::TX>(x), DenseMatrixView<phe::TY>(y));      \
   }
 
 IMPLEMENT_DENSE_OP(Add, CMatrix, Ciphertext, Ciphertext);
@@ -193,6 +181,10 @@ CMatrix Evaluator::Add(const PMatrix &x, const CMatrix &y) const {
   return Add(y, x);
 };
 
+CMatrix Evaluator::Add(const PMatrixView &x, const CMatrixView &y) const {
+  return Add(y, x);
+};
+
 IMPLEMENT_DENSE_OP(Sub, CMatrix, Ciphertext, Ciphertext);
 IMPLEMENT_DENSE_OP(Sub, CMatrix, Ciphertext, Plaintext);
 IMPLEMENT_DENSE_OP(Sub, CMatrix, Plaintext, Ciphertext);
@@ -205,6 +197,10 @@ CMatrix Evaluator::Mul(const PMatrix &x, const CMatrix &y) const {
   return Mul(y, x);
 };
 
+CMatrix Evaluator::Mul(const PMatrixView &x, const CMatrixView &y) const {
+  return Mul(y, x);
+};
+
 /*********   MatMul  ***********/
 template <typename SUB_T1, typename SUB_T2, typename CLAZZ, typename M1,
           typename M2, typename RET>
@@ -213,29 +209,23 @@ auto DoCallMatMul(const CLAZZ &sub_evaluator, const M1 &mx, const M2 &my,
     -> std::enable_if_t<std::experimental::is_detected_v<
         kHasVectorizedMul, CLAZZ, SUB_T1, SUB_T2>> {
   // convert type for mx
-  auto mx_buf = mx.data();
   auto mx_rows = mx.rows();
   std::vector<std::vector<const SUB_T1 *>> in_x;
   in_x.resize(mx_rows);
   for (int64_t i = 0; i < mx_rows; ++i) {
     in_x[i].resize(mx.cols());
     for (int64_t j = 0; j < mx.cols(); ++j) {
-      // There is a weird problem: mx(i, j) doesn't return a reference, it
-      // returns a copy. maybe an eigen bug?
-      // So we direct access underlying buffer.
-      in_x[i][j] = &(mx_buf[j * mx_rows + i].template As<SUB_T1>());
+      in_x[i][j] = &(mx(i, j).template As<SUB_T1>());
     }
   }
 
   // convert type for my
   std::vector<std::vector<const SUB_T2 *>> in_y;
   in_y.resize(my.cols());
-  auto my_buf = my.data();
-  int pos = 0;
   for (int64_t i = 0; i < my.cols(); ++i) {
     in_y[i].resize(my.rows());
     for (int64_t j = 0; j < my.rows(); ++j) {
-      in_y[i][j] = &(my_buf[pos++].template As<SUB_T2>());
+      in_y[i][j] = &(my(j, i).template As<SUB_T2>());
     }
   }
 
@@ -320,8 +310,8 @@ auto DoCallMatMul(const CLAZZ &sub_evaluator, const M1 &mx, const M2 &my,
     return out;                                                                \
   }                                                                            \
                                                                                \
-  RET Evaluator::MatMul(const DenseMatrix<phe::TX> &x,                         \
-                        const DenseMatrix<phe::TY> &y) const {                 \
+  RET Evaluator::MatMul(const DenseMatrixView<phe::TX> &x,                     \
+                        const DenseMatrixView<phe::TY> &y) const {             \
     YACL_ENFORCE(                                                              \
         x.ndim() > 0 && y.ndim() > 0,                                          \
         "Input operands do not have enough dimensions, x-dim={}, y-dim{}",     \
@@ -336,35 +326,155 @@ auto DoCallMatMul(const CLAZZ &sub_evaluator, const M1 &mx, const M2 &my,
                  "HEU does not support empty tensor currently");               \
                                                                                \
     if (x.ndim() == 1) {                                                       \
-      auto &mx = x.EigenMatrix().transpose();                                  \
-      auto &my = y.EigenMatrix();                                              \
-      return DoMatMul##TX##TY(mx, my, MatmulDim(x_shape, y_shape),             \
+      /* take the vector as a 1xn matrix */                                    \
+      DenseMatrixView<phe::TX> mx(x.data(), 1, x.rows(), 2, 0,                 \
+                                  x.row_stride());                             \
+      return DoMatMul##TX##TY(mx, y, MatmulDim(x_shape, y_shape),              \
                               evaluator_ptr_);                                 \
     } else {                                                                   \
-      auto &mx = x.EigenMatrix();                                              \
-      auto &my = y.EigenMatrix();                                              \
-      return DoMatMul##TX##TY(mx, my, MatmulDim(x_shape, y_shape),             \
+      return DoMatMul##TX##TY(x, y, MatmulDim(x_shape, y_shape),               \
                               evaluator_ptr_);                                 \
     }                                                                          \
+  }                                                                            \
+                                                                               \
+  RET Evaluator::MatMul(const DenseMatrix<phe::TX> &x,                         \
+                        const DenseMatrix<phe::TY> &y) const {                 \
+    return MatMul(DenseMatrixView<phe::TX>(x), DenseMatrixView<phe::TY>(y));   \
   }
 
 IMPLEMENT_DENSE_MATMUL(CMatrix, Ciphertext, Plaintext);
 IMPLEMENT_DENSE_MATMUL(CMatrix, Plaintext, Ciphertext);
 IMPLEMENT_DENSE_MATMUL(PMatrix, Plaintext, Plaintext);
 
+/*********   Sparse MatMul  ***********/
+namespace {
+
+// 1 or -1 if the entry is a unit, otherwise 0
+std::vector<int8_t> UnitEntries(const SparsePMatrix &m) {
+  std::vector<int8_t> res(m.nnz(), 0);
+  if (m.nnz() == 0) {
+    return res;
+  }
+
+  phe::Plaintext one(m.GetSchemaType(), 1);
+  phe::Plaintext neg_one(m.GetSchemaType(), -1);
+  for (int64_t k = 0; k < m.nnz(); ++k) {
+    if (m.values()[k] == one) {
+      res[k] = 1;
+    } else if (m.values()[k] == neg_one) {
+      res[k] = -1;
+    }
+  }
+  return res;
+}
+
+// Returns sum_k m(row, k) * get_y(k), only the nonzeros of row are visited
+template <typename GetY>
+phe::Ciphertext SparseRowDot(const phe::Evaluator &evaluator,
+                             const SparsePMatrix &m,
+                             const std::vector<int8_t> &units, int64_t row,
+                             const phe::Ciphertext &zero, const GetY &get_y) {
+  auto beg = m.indptr()[row];
+  auto end = m.indptr()[row + 1];
+  if (beg == end) {
+    return zero;
+  }
+
+  auto term = [&](int64_t k) {
+    switch (units[k]) {
+      case 1:
+        return get_y(m.indices()[k]);
+      case -1:
+        return evaluator.Negate(get_y(m.indices()[k]));
+      default:
+        return evaluator.Mul(get_y(m.indices()[k]), m.values()[k]);
+    }
+  };
+
+  phe::Ciphertext sum = term(beg);
+  for (auto k = beg + 1; k < end; ++k) {
+    const auto &y = get_y(m.indices()[k]);
+    switch (units[k]) {
+      case 1:
+        evaluator.AddInplace(&sum, y);
+        break;
+      case -1:
+        evaluator.SubInplace(&sum, y);
+        break;
+      default:
+        evaluator.AddInplace(&sum, evaluator.Mul(y, m.values()[k]));
+    }
+  }
+  return sum;
+}
+
+}  // namespace
+
+CMatrix Evaluator::MatMul(const SparsePMatrix &x, const CMatrixView &y) const {
+  YACL_ENFORCE(y.ndim() > 0 && y.size() > 0,
+               "Input operand y is empty or a scalar, y-dim={}", y.ndim());
+  YACL_ENFORCE(x.cols() == y.rows(),
+               "dimension mismatch for matmul, x-shape={}, y-shape={}",
+               x.shape().ToString(), y.shape().ToString());
+
+  auto units = UnitEntries(x);
+  auto zero = phe::Evaluator::Sub(y(0, 0), y(0, 0));
+  CMatrix out(x.rows(), y.cols(), MatmulDim(x.shape(), y.shape()));
+  out.ForEach([&](int64_t row, int64_t col, phe::Ciphertext *element) {
+    *element = SparseRowDot(*this, x, units, row, zero,
+                            [&](int64_t k) -> const phe::Ciphertext & {
+                              return y(k, col);
+                            });
+  });
+  return out;
+}
+
+CMatrix Evaluator::MatMul(const CMatrixView &x, const SparsePMatrix &y) const {
+  YACL_ENFORCE(x.ndim() > 0 && x.size() > 0,
+               "Input operand x is empty or a scalar, x-dim={}", x.ndim());
+  auto x_shape = x.shape();
+  YACL_ENFORCE(x_shape[-1] == y.rows(),
+               "dimension mismatch for matmul, x-shape={}, y-shape={}",
+               x_shape.ToString(), y.shape().ToString());
+
+  // (x @ y)[r, j] = sum_k x[r, k] * y^T[j, k], y^T is y in CSC form
+  auto yt = y.Transpose();
+  auto units = UnitEntries(yt);
+  auto zero = phe::Evaluator::Sub(x(0, 0), x(0, 0));
+  if (x.ndim() == 1) {
+    // the result is a vector of length y.cols()
+    CMatrix out(y.cols(), 1, 1);
+    out.ForEach([&](int64_t row, int64_t, phe::Ciphertext *element) {
+      *element = SparseRowDot(
+          *this, yt, units, row, zero,
+          [&](int64_t k) -> const phe::Ciphertext & { return x(k, 0); });
+    });
+    return out;
+  }
+
+  CMatrix out(x.rows(), y.cols(), 2);
+  out.ForEach([&](int64_t row, int64_t col, phe::Ciphertext *element) {
+    *element = SparseRowDot(*this, yt, units, col, zero,
+                            [&](int64_t k) -> const phe::Ciphertext & {
+                              return x(row, k);
+                            });
+  });
+  return out;
+}
+
 template <typename T>
-T Evaluator::Sum(const DenseMatrix<T> &x) const {
+T Evaluator::Sum(const DenseMatrixView<T> &x) const {
   YACL_ENFORCE(x.cols() > 0 && x.rows() > 0,
                "you cannot sum an empty tensor, shape={}x{}", x.rows(),
                x.cols());
 
-  auto buf = x.data();
+  int64_t rows = x.rows();
   return yacl::parallel_reduce<T>(
       0, x.size(), kHeOpGrainSize,
       [&](int64_t beg, int64_t end) {
-        T sum = buf[beg];
+        T sum = x(beg % rows, beg / rows);
         for (auto i = beg + 1; i < end; ++i) {
-          phe::Evaluator::AddInplace(&sum, buf[i]);
+          phe::Evaluator::AddInplace(&sum, x(i % rows, i / rows));
         }
         return sum;
       },
@@ -372,8 +482,227 @@ T Evaluator::Sum(const DenseMatrix<T> &x) const {
       [&](const T &a, const T &b) { return phe::Evaluator::Add(a, b); });
 }
 
+template <typename T>
+T Evaluator::Sum(const DenseMatrix<T> &x) const {
+  return Sum(DenseMatrixView<T>(x));
+}
+
 template phe::Ciphertext Evaluator::Sum(const CMatrix &) const;
 template phe::Plaintext Evaluator::Sum(const PMatrix &) const;
+template phe::Ciphertext Evaluator::Sum(const CMatrixView &) const;
+template phe::Plaintext Evaluator::Sum(const PMatrixView &) const;
+
+/*********   Axis-wise Sum and CumSum  ***********/
+namespace {
+
+// chunks shorter than this are not worth a separate task
+constexpr int64_t kMinChunkLen = 16;
+
+// The elements along the reduced axis form a line, e.g. axis 0 makes every
+// column a line. Each line is split into chunks, so that long lines are still
+// processed in parallel when there are fewer lines than threads.
+struct LineLayout {
+  int64_t axis;
+  int64_t lines;
+  int64_t len;
+  int64_t chunk_len;
+  int64_t chunks;  // per line
+
+  template <typename M>
+  decltype(auto) At(M &m, int64_t line, int64_t i) const {
+    return axis == 0 ? m(i, line) : m(line, i);
+  }
+
+  // the task covers [beg, end) of the line
+  void Task(int64_t task, int64_t *line, int64_t *beg, int64_t *end) const {
+    *line = task / chunks;
+    *beg = task % chunks * chunk_len;
+    *end = std::min(*beg + chunk_len, len);
+  }
+};
+
+template <typename T>
+LineLayout MakeLineLayout(const DenseMatrixView<T> &x, int64_t axis) {
+  YACL_ENFORCE(x.ndim() > 0, "axis is not supported for a 0-d tensor");
+  auto norm_axis = axis < 0 ? axis + x.ndim() : axis;
+  YACL_ENFORCE(0 <= norm_axis && norm_axis < x.ndim(),
+               "axis {} is out of bounds for tensor of dimension {}", axis,
+               x.ndim());
+  YACL_ENFORCE(x.size() > 0, "HEU does not support empty tensor currently");
+
+  LineLayout layout{};
+  layout.axis = norm_axis;
+  layout.lines = norm_axis == 0 ? x.cols() : x.rows();
+  layout.len = norm_axis == 0 ? x.rows() : x.cols();
+  int64_t threads = yacl::get_num_threads();
+  if (layout.lines >= threads) {
+    layout.chunk_len = layout.len;
+  } else {
+    auto chunks = (threads + layout.lines - 1) / layout.lines;
+    layout.chunk_len = std::max((layout.len + chunks - 1) / chunks,
+                                std::min(kMinChunkLen, layout.len));
+  }
+  layout.chunks = (layout.len + layout.chunk_len - 1) / layout.chunk_len;
+  return layout;
+}
+
+// Segmented inclusive scan of every line, a new segment starts at position i
+// if is_start[i]. Chunks are scanned independently first, then the carry of
+// all previous chunks is added to the head of each chunk before its first
+// segment start, so there are at most 2 * size() additions in total.
+template <typename T>
+DenseMatrix<T> ScanLines(const phe::Evaluator &evaluator,
+                         const DenseMatrixView<T> &x, const LineLayout &layout,
+                         const std::vector<uint8_t> &is_start) {
+  DenseMatrix<T> out(x.rows(), x.cols(), x.ndim());
+  auto num_tasks = layout.lines * layout.chunks;
+  // 1. local scan of each chunk
+  yacl::parallel_for(0, num_tasks, 1, [&](int64_t beg, int64_t end) {
+    for (auto task = beg; task < end; ++task) {
+      int64_t line, i0, i1;
+      layout.Task(task, &line, &i0, &i1);
+      layout.At(out, line, i0) = layout.At(x, line, i0);
+      for (auto i = i0 + 1; i < i1; ++i) {
+        layout.At(out, line, i) =
+            is_start[i] ? layout.At(x, line, i)
+                        : evaluator.Add(layout.At(out, line, i - 1),
+                                        layout.At(x, line, i));
+      }
+    }
+  });
+  if (layout.chunks == 1) {
+    return out;
+  }
+
+  // 2. the carry of each chunk, i.e. the final value before its head
+  std::vector<std::optional<T>> carry(num_tasks);
+  yacl::parallel_for(0, layout.lines, 1, [&](int64_t beg, int64_t end) {
+    for (auto line = beg; line < end; ++line) {
+      std::optional<T> last;  // final value at the end of the previous chunk
+      for (int64_t c = 0; c < layout.chunks; ++c) {
+        int64_t unused, i0, i1;
+        layout.Task(line * layout.chunks + c, &unused, &i0, &i1);
+        if (!is_start[i0]) {
+          carry[line * layout.chunks + c] = last;
+        }
+        bool has_start = std::any_of(is_start.begin() + i0,
+                                     is_start.begin() + i1,
+                                     [](uint8_t b) { return b != 0; });
+        const auto &local = layout.At(out, line, i1 - 1);
+        last = has_start ? local : evaluator.Add(*last, local);
+      }
+    }
+  });
+
+  // 3. add the carry to the head of each chunk
+  yacl::parallel_for(0, num_tasks, 1, [&](int64_t beg, int64_t end) {
+    for (auto task = beg; task < end; ++task) {
+      if (!carry[task]) {
+        continue;
+      }
+      int64_t line, i0, i1;
+      layout.Task(task, &line, &i0, &i1);
+      for (auto i = i0; i < i1 && !is_start[i]; ++i) {
+        evaluator.AddInplace(&layout.At(out, line, i), *carry[task]);
+      }
+    }
+  });
+  return out;
+}
+
+}  // namespace
+
+template <typename T>
+DenseMatrix<T> Evaluator::Sum(const DenseMatrixView<T> &x,
+                              int64_t axis) const {
+  auto layout = MakeLineLayout(x, axis);
+  // partial sum of each chunk
+  auto num_tasks = layout.lines * layout.chunks;
+  std::vector<T> partial(num_tasks);
+  yacl::parallel_for(0, num_tasks, 1, [&](int64_t beg, int64_t end) {
+    for (auto task = beg; task < end; ++task) {
+      int64_t line, i0, i1;
+      layout.Task(task, &line, &i0, &i1);
+      T sum = layout.At(x, line, i0);
+      for (auto i = i0 + 1; i < i1; ++i) {
+        phe::Evaluator::AddInplace(&sum, layout.At(x, line, i));
+      }
+      partial[task] = std::move(sum);
+    }
+  });
+
+  // then reduce the partial sums of each line as a binary tree
+  DenseMatrix<T> out(layout.lines, 1, x.ndim() - 1);
+  out.ForEach([&](int64_t line, int64_t, T *element) {
+    auto *sums = partial.data() + line * layout.chunks;
+    for (int64_t step = 1; step < layout.chunks; step *= 2) {
+      for (int64_t c = 0; c + step < layout.chunks; c += 2 * step) {
+        phe::Evaluator::AddInplace(&sums[c], sums[c + step]);
+      }
+    }
+    *element = std::move(sums[0]);
+  });
+  return out;
+}
+
+template <typename T>
+DenseMatrix<T> Evaluator::Sum(const DenseMatrix<T> &x, int64_t axis) const {
+  return Sum(DenseMatrixView<T>(x), axis);
+}
+
+template <typename T>
+DenseMatrix<T> Evaluator::SegmentedCumSum(
+    const DenseMatrixView<T> &x, const std::vector<int64_t> &segment_starts,
+    int64_t axis) const {
+  auto layout = MakeLineLayout(x, axis);
+  YACL_ENFORCE(!segment_starts.empty() && segment_starts[0] == 0,
+               "segment_starts must begin with 0");
+  std::vector<uint8_t> is_start(layout.len, 0);
+  for (size_t i = 0; i < segment_starts.size(); ++i) {
+    YACL_ENFORCE(segment_starts[i] < layout.len &&
+                     (i == 0 || segment_starts[i] > segment_starts[i - 1]),
+                 "segment_starts must be strictly increasing and less than "
+                 "{}, got {}",
+                 layout.len, fmt::join(segment_starts, ","));
+    is_start[segment_starts[i]] = 1;
+  }
+  return ScanLines<T>(*this, x, layout, is_start);
+}
+
+template <typename T>
+DenseMatrix<T> Evaluator::SegmentedCumSum(
+    const DenseMatrix<T> &x, const std::vector<int64_t> &segment_starts,
+    int64_t axis) const {
+  return SegmentedCumSum(DenseMatrixView<T>(x), segment_starts, axis);
+}
+
+template <typename T>
+DenseMatrix<T> Evaluator::CumSum(const DenseMatrixView<T> &x,
+                                 int64_t axis) const {
+  return SegmentedCumSum(x, {0}, axis);
+}
+
+template <typename T>
+DenseMatrix<T> Evaluator::CumSum(const DenseMatrix<T> &x, int64_t axis) const {
+  return CumSum(DenseMatrixView<T>(x), axis);
+}
+
+#define INSTANTIATE_AXIS_OPS(T)                                             \
+  template DenseMatrix<T> Evaluator::Sum(const DenseMatrix<T> &, int64_t)   \
+      const;                                                                \
+  template DenseMatrix<T> Evaluator::Sum(const DenseMatrixView<T> &,        \
+                                         int64_t) const;                    \
+  template DenseMatrix<T> Evaluator::CumSum(const DenseMatrix<T> &,         \
+                                            int64_t) const;                 \
+  template DenseMatrix<T> Evaluator::CumSum(const DenseMatrixView<T> &,     \
+                                            int64_t) const;                 \
+  template DenseMatrix<T> Evaluator::SegmentedCumSum(                       \
+      const DenseMatrix<T> &, const std::vector<int64_t> &, int64_t) const; \
+  template DenseMatrix<T> Evaluator::SegmentedCumSum(                       \
+      const DenseMatrixView<T> &, const std::vector<int64_t> &, int64_t) const;
+
+INSTANTIATE_AXIS_OPS(phe::Ciphertext);
+INSTANTIATE_AXIS_OPS(phe::Plaintext);
 
 template <typename T>
 DenseMatrix<T> Evaluator::FeatureWiseBucketSum(
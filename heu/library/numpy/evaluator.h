@@ -14,7 +14,10 @@
 
 #pragma once
 
+#include <vector>
+
 #include "heu/library/numpy/matrix.h"
+#include "heu/library/numpy/sparse_matrix.h"
 #include "heu/library/phe/phe.h"
 
 namespace heu::lib::numpy {
@@ -27,31 +30,80 @@ class Evaluator : public phe::Evaluator {
   explicit Evaluator(phe::Evaluator evaluator)
       : phe::Evaluator(std::move(evaluator)) {}
 
+  // The overloads accepting views read the operands in place, so sliced,
+  // transposed or broadcast operands are never copied.
+
   // dense cwise add
   CMatrix Add(const CMatrix &x, const CMatrix &y) const;
   CMatrix Add(const CMatrix &x, const PMatrix &y) const;
   CMatrix Add(const PMatrix &x, const CMatrix &y) const;
   PMatrix Add(const PMatrix &x, const PMatrix &y) const;
+  CMatrix Add(const CMatrixView &x, const CMatrixView &y) const;
+  CMatrix Add(const CMatrixView &x, const PMatrixView &y) const;
+  CMatrix Add(const PMatrixView &x, const CMatrixView &y) const;
+  PMatrix Add(const PMatrixView &x, const PMatrixView &y) const;
 
   // dense cwise sub
   CMatrix Sub(const CMatrix &x, const CMatrix &y) const;
   CMatrix Sub(const CMatrix &x, const PMatrix &y) const;
   CMatrix Sub(const PMatrix &x, const CMatrix &y) const;
   PMatrix Sub(const PMatrix &x, const PMatrix &y) const;
+  CMatrix Sub(const CMatrixView &x, const CMatrixView &y) const;
+  CMatrix Sub(const CMatrixView &x, const PMatrixView &y) const;
+  CMatrix Sub(const PMatrixView &x, const CMatrixView &y) const;
+  PMatrix Sub(const PMatrixView &x, const PMatrixView &y) const;
 
   // dense cwise mul
   CMatrix Mul(const CMatrix &x, const PMatrix &y) const;
   CMatrix Mul(const PMatrix &x, const CMatrix &y) const;
   PMatrix Mul(const PMatrix &x, const PMatrix &y) const;
+  CMatrix Mul(const CMatrixView &x, const PMatrixView &y) const;
+  CMatrix Mul(const PMatrixView &x, const CMatrixView &y) const;
+  PMatrix Mul(const PMatrixView &x, const PMatrixView &y) const;
 
   // dense matrix mul
   CMatrix MatMul(const CMatrix &x, const PMatrix &y) const;
   CMatrix MatMul(const PMatrix &x, const CMatrix &y) const;
   PMatrix MatMul(const PMatrix &x, const PMatrix &y) const;
+  CMatrix MatMul(const CMatrixView &x, const PMatrixView &y) const;
+  CMatrix MatMul(const PMatrixView &x, const CMatrixView &y) const;
+  PMatrix MatMul(const PMatrixView &x, const PMatrixView &y) const;
+
+  // sparse matrix mul, only the nonzero entries of the sparse operand are
+  // visited. Entries equal to 1 or -1 cost one ciphertext addition.
+  CMatrix MatMul(const SparsePMatrix &x, const CMatrixView &y) const;
+  CMatrix MatMul(const CMatrixView &x, const SparsePMatrix &y) const;
 
   // reduce add
   template <typename T>
   T Sum(const DenseMatrix<T> &x) const;  // x is PMatrix or CMatrix
+  template <typename T>
+  T Sum(const DenseMatrixView<T> &x) const;
+
+  // reduce add along an axis, like numpy.sum(x, axis). axis 0 sums up each
+  // column, axis 1 sums up each row, a negative axis counts from the last.
+  template <typename T>
+  DenseMatrix<T> Sum(const DenseMatrix<T> &x, int64_t axis) const;
+  template <typename T>
+  DenseMatrix<T> Sum(const DenseMatrixView<T> &x, int64_t axis) const;
+
+  // inclusive prefix sum along an axis, like numpy.cumsum(x, axis)
+  template <typename T>
+  DenseMatrix<T> CumSum(const DenseMatrix<T> &x, int64_t axis) const;
+  template <typename T>
+  DenseMatrix<T> CumSum(const DenseMatrixView<T> &x, int64_t axis) const;
+
+  // CumSum() which restarts at every segment start along the axis.
+  // segment_starts must be strictly increasing and begin with 0, like the
+  // indices of numpy.add.reduceat()
+  template <typename T>
+  DenseMatrix<T> SegmentedCumSum(const DenseMatrix<T> &x,
+                                 const std::vector<int64_t> &segment_starts,
+                                 int64_t axis) const;
+  template <typename T>
+  DenseMatrix<T> SegmentedCumSum(const DenseMatrixView<T> &x,
+                                 const std::vector<int64_t> &segment_starts,
+                                 int64_t axis) const;
 
   // reduce add given indices
   template <typename T, typename RowIndices, typename ColIndices>
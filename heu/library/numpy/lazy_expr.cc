@@ -0,0 +1,303 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/numpy/lazy_expr.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace heu::lib::numpy {
+
+enum class ExprOp {
+  kLeaf,
+  kAdd,
+  kSub,
+  kMul,
+  kNegate,
+};
+
+struct LazyExpr::Node {
+  ExprOp op;
+  std::variant<std::monostate, PMatrixView, CMatrixView> leaf;
+  std::shared_ptr<const Node> lhs;
+  std::shared_ptr<const Node> rhs;  // empty for unary ops
+
+  Eigen::Index rows;
+  Eigen::Index cols;
+  int64_t ndim;
+  bool is_ct;
+};
+
+namespace {
+
+using Node = LazyExpr::Node;
+
+// The value of a node at one element. Leaves point to the input element,
+// other nodes own a temporary which the parent node updates in place.
+using Operand = std::variant<const phe::Plaintext *, const phe::Ciphertext *,
+                             phe::Plaintext, phe::Ciphertext>;
+
+template <typename T>
+constexpr bool kIsCiphertext = std::is_same_v<T, phe::Ciphertext>;
+
+template <typename X, typename Y>
+using ResultType = std::conditional_t<kIsCiphertext<X> || kIsCiphertext<Y>,
+                                      phe::Ciphertext, phe::Plaintext>;
+
+template <typename T>
+Operand Own(T &&value) {
+  return Operand(std::in_place_type<std::decay_t<T>>, std::forward<T>(value));
+}
+
+template <typename T>
+Operand Ref(const T &element) {
+  return Operand(std::in_place_type<const T *>, &element);
+}
+
+template <typename T>
+const auto &Deref(const T &v) {
+  if constexpr (std::is_pointer_v<T>) {
+    return *v;
+  } else {
+    return v;
+  }
+}
+
+// returns x op y as a new element
+template <typename X, typename Y>
+Operand Apply(const phe::Evaluator &evaluator, ExprOp op, const X &x,
+              const Y &y) {
+  switch (op) {
+    case ExprOp::kAdd:
+      return Own(evaluator.Add(x, y));
+    case ExprOp::kSub:
+      return Own(evaluator.Sub(x, y));
+    case ExprOp::kMul:
+      if constexpr (kIsCiphertext<X> && kIsCiphertext<Y>) {
+        YACL_THROW_LOGIC_ERROR("ciphertext * ciphertext is not supported");
+      } else {
+        return Own(evaluator.Mul(x, y));
+      }
+    default:
+      YACL_THROW_LOGIC_ERROR("{} is not a binary op", static_cast<int>(op));
+  }
+}
+
+// x op= y, x has the result type
+template <typename X, typename Y>
+void ApplyInplace(const phe::Evaluator &evaluator, ExprOp op, X *x,
+                  const Y &y) {
+  switch (op) {
+    case ExprOp::kAdd:
+      evaluator.AddInplace(x, y);
+      return;
+    case ExprOp::kSub:
+      evaluator.SubInplace(x, y);
+      return;
+    case ExprOp::kMul:
+      if constexpr (kIsCiphertext<X> && kIsCiphertext<Y>) {
+        YACL_THROW_LOGIC_ERROR("ciphertext * ciphertext is not supported");
+      } else {
+        evaluator.MulInplace(x, y);
+        return;
+      }
+    default:
+      YACL_THROW_LOGIC_ERROR("{} is not a binary op", static_cast<int>(op));
+  }
+}
+
+Operand EvalBinary(const phe::Evaluator &evaluator, ExprOp op, Operand a,
+                   Operand b) {
+  return std::visit(
+      [&](auto &x, auto &y) -> Operand {
+        using XT = std::decay_t<decltype(x)>;
+        using YT = std::decay_t<decltype(y)>;
+        using X = std::remove_cv_t<std::remove_pointer_t<XT>>;
+        using Y = std::remove_cv_t<std::remove_pointer_t<YT>>;
+        using R = ResultType<X, Y>;
+
+        // reuse a temporary of the result type instead of allocating
+        if constexpr (!std::is_pointer_v<XT> && std::is_same_v<X, R>) {
+          ApplyInplace(evaluator, op, &x, Deref(y));
+          return Own(std::move(x));
+        } else if constexpr (!std::is_pointer_v<YT> && std::is_same_v<Y, R>) {
+          if (op != ExprOp::kSub) {  // add and mul are commutative
+            ApplyInplace(evaluator, op, &y, Deref(x));
+            return Own(std::move(y));
+          }
+        }
+        return Apply(evaluator, op, Deref(x), Deref(y));
+      },
+      a, b);
+}
+
+Operand EvalNegate(const phe::Evaluator &evaluator, Operand a) {
+  return std::visit(
+      [&](auto &x) -> Operand {
+        if constexpr (std::is_pointer_v<std::decay_t<decltype(x)>>) {
+          return Own(evaluator.Negate(*x));
+        } else {
+          evaluator.NegateInplace(&x);
+          return Own(std::move(x));
+        }
+      },
+      a);
+}
+
+Operand EvalNode(const phe::Evaluator &evaluator, const Node &node,
+                 int64_t row, int64_t col) {
+  switch (node.op) {
+    case ExprOp::kLeaf:
+      return std::visit(
+          [&](const auto &v) -> Operand {
+            if constexpr (std::is_same_v<std::decay_t<decltype(v)>,
+                                         std::monostate>) {
+              YACL_THROW_LOGIC_ERROR("leaf node has no matrix");
+            } else {
+              // broadcast axes of length 1
+              return Ref(v(v.rows() == 1 ? 0 : row, v.cols() == 1 ? 0 : col));
+            }
+          },
+          node.leaf);
+    case ExprOp::kNegate:
+      return EvalNegate(evaluator, EvalNode(evaluator, *node.lhs, row, col));
+    default:
+      return EvalBinary(evaluator, node.op,
+                        EvalNode(evaluator, *node.lhs, row, col),
+                        EvalNode(evaluator, *node.rhs, row, col));
+  }
+}
+
+template <typename View>
+std::shared_ptr<const Node> MakeLeaf(const View &leaf) {
+  YACL_ENFORCE(leaf.size() > 0, "HEU does not support empty tensor currently");
+  return std::make_shared<const Node>(
+      Node{ExprOp::kLeaf, leaf, nullptr, nullptr, leaf.rows(), leaf.cols(),
+           leaf.ndim(), kIsCiphertext<typename View::value_type>});
+}
+
+std::shared_ptr<const Node> MakeBinary(ExprOp op,
+                                       std::shared_ptr<const Node> x,
+                                       std::shared_ptr<const Node> y) {
+  YACL_ENFORCE((x->rows == 1 || y->rows == 1 || x->rows == y->rows) &&
+                   (x->cols == 1 || y->cols == 1 || x->cols == y->cols),
+               "operands could not be broadcast together with shapes {}x{} "
+               "and {}x{}",
+               x->rows, x->cols, y->rows, y->cols);
+  YACL_ENFORCE(op != ExprOp::kMul || !(x->is_ct && y->is_ct),
+               "ciphertext * ciphertext is not supported");
+  Node node{op,
+            std::monostate(),
+            x,
+            y,
+            std::max(x->rows, y->rows),
+            std::max(x->cols, y->cols),
+            std::max(x->ndim, y->ndim),
+            x->is_ct || y->is_ct};
+  return std::make_shared<const Node>(std::move(node));
+}
+
+std::string NodeToString(const Node &node) {
+  switch (node.op) {
+    case ExprOp::kLeaf:
+      return fmt::format("{}({}x{})", node.is_ct ? "c" : "p", node.rows,
+                         node.cols);
+    case ExprOp::kAdd:
+      return fmt::format("({} + {})", NodeToString(*node.lhs),
+                         NodeToString(*node.rhs));
+    case ExprOp::kSub:
+      return fmt::format("({} - {})", NodeToString(*node.lhs),
+                         NodeToString(*node.rhs));
+    case ExprOp::kMul:
+      return fmt::format("({} * {})", NodeToString(*node.lhs),
+                         NodeToString(*node.rhs));
+    case ExprOp::kNegate:
+      return fmt::format("-{}", NodeToString(*node.lhs));
+  }
+  YACL_THROW_LOGIC_ERROR("unknown op {}", static_cast<int>(node.op));
+}
+
+}  // namespace
+
+LazyExpr::LazyExpr(std::shared_ptr<const Node> root) : root_(std::move(root)) {}
+
+LazyExpr::LazyExpr(const PMatrixView &leaf) : root_(MakeLeaf(leaf)) {}
+
+LazyExpr::LazyExpr(const CMatrixView &leaf) : root_(MakeLeaf(leaf)) {}
+
+LazyExpr::LazyExpr(const PMatrix &leaf) : LazyExpr(PMatrixView(leaf)) {}
+
+LazyExpr::LazyExpr(const CMatrix &leaf) : LazyExpr(CMatrixView(leaf)) {}
+
+LazyExpr operator+(const LazyExpr &x, const LazyExpr &y) {
+  return LazyExpr(MakeBinary(ExprOp::kAdd, x.root_, y.root_));
+}
+
+LazyExpr operator-(const LazyExpr &x, const LazyExpr &y) {
+  return LazyExpr(MakeBinary(ExprOp::kSub, x.root_, y.root_));
+}
+
+LazyExpr operator*(const LazyExpr &x, const LazyExpr &y) {
+  return LazyExpr(MakeBinary(ExprOp::kMul, x.root_, y.root_));
+}
+
+LazyExpr operator-(const LazyExpr &x) {
+  const auto &n = *x.root_;
+  return LazyExpr(std::make_shared<const LazyExpr::Node>(
+      LazyExpr::Node{ExprOp::kNegate, std::monostate(), x.root_, nullptr,
+                     n.rows, n.cols, n.ndim, n.is_ct}));
+}
+
+bool LazyExpr::IsCiphertext() const { return root_->is_ct; }
+
+Eigen::Index LazyExpr::rows() const { return root_->rows; }
+
+Eigen::Index LazyExpr::cols() const { return root_->cols; }
+
+int64_t LazyExpr::ndim() const { return root_->ndim; }
+
+Shape LazyExpr::shape() const {
+  std::vector<int64_t> res = {root_->rows, root_->cols};
+  res.resize(root_->ndim);
+  return Shape(res);
+}
+
+std::string LazyExpr::ToString() const { return NodeToString(*root_); }
+
+template <typename T>
+DenseMatrix<T> LazyExpr::Evaluate(const phe::Evaluator &evaluator) const {
+  YACL_ENFORCE(IsCiphertext() == kIsCiphertext<T>,
+               "The expression evaluates to {}, but {} is requested",
+               IsCiphertext() ? "ciphertexts" : "plaintexts",
+               kIsCiphertext<T> ? "ciphertexts" : "plaintexts");
+
+  DenseMatrix<T> out(rows(), cols(), ndim());
+  out.ForEach([&](int64_t row, int64_t col, T *element) {
+    auto res = EvalNode(evaluator, *root_, row, col);
+    if (auto *owned = std::get_if<T>(&res)) {
+      *element = std::move(*owned);
+    } else {
+      // the expression is a single leaf
+      *element = *std::get<const T *>(res);
+    }
+  });
+  return out;
+}
+
+template PMatrix LazyExpr::Evaluate(const phe::Evaluator &) const;
+template CMatrix LazyExpr::Evaluate(const phe::Evaluator &) const;
+
+}  // namespace heu::lib::numpy
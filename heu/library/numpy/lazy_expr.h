@@ -0,0 +1,78 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "heu/library/numpy/matrix.h"
+#include "heu/library/phe/phe.h"
+
+namespace heu::lib::numpy {
+
+// A deferred elementwise expression over PMatrix/CMatrix, e.g.
+//
+//   auto expr = LazyExpr(x) * a + LazyExpr(y) * b - c;
+//   CMatrix res = expr.Evaluate<phe::Ciphertext>(*evaluator);
+//
+// Building an expression only records the operations. Evaluate() computes
+// the whole tree element by element in a single parallel pass, so no
+// intermediate matrix is ever allocated. Operands are broadcast like
+// Evaluator::Add().
+//
+// Leaves are views, the matrices must stay alive until the expression is
+// evaluated. Sub-expressions are immutable and may be shared.
+class LazyExpr {
+ public:
+  LazyExpr(const PMatrixView &leaf);  // NOLINT: implicit by design
+  LazyExpr(const CMatrixView &leaf);  // NOLINT
+  LazyExpr(const PMatrix &leaf);      // NOLINT
+  LazyExpr(const CMatrix &leaf);      // NOLINT
+
+  friend LazyExpr operator+(const LazyExpr &x, const LazyExpr &y);
+  friend LazyExpr operator-(const LazyExpr &x, const LazyExpr &y);
+  // ciphertext * ciphertext is not allowed
+  friend LazyExpr operator*(const LazyExpr &x, const LazyExpr &y);
+  friend LazyExpr operator-(const LazyExpr &x);
+
+  // True if any leaf is a ciphertext, then the result is a CMatrix
+  [[nodiscard]] bool IsCiphertext() const;
+
+  [[nodiscard]] Eigen::Index rows() const;
+  [[nodiscard]] Eigen::Index cols() const;
+  [[nodiscard]] int64_t ndim() const;
+  [[nodiscard]] Shape shape() const;
+
+  // T must be phe::Ciphertext if IsCiphertext(), otherwise phe::Plaintext
+  template <typename T>
+  DenseMatrix<T> Evaluate(const phe::Evaluator &evaluator) const;
+
+  [[nodiscard]] std::string ToString() const;
+
+  friend std::ostream &operator<<(std::ostream &os, const LazyExpr &e) {
+    return os << e.ToString();
+  }
+
+  struct Node;
+
+ private:
+  explicit LazyExpr(std::shared_ptr<const Node> root);
+
+  std::shared_ptr<const Node> root_;
+};
+
+inline auto format_as(const LazyExpr &e) { return fmt::streamed(e); }
+
+}  // namespace heu::lib::numpy
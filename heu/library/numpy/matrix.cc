@@ -14,7 +14,16 @@
 
 #include "heu/library/numpy/matrix.h"
 
+#include <climits>
+#include <cstring>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/wire_format_lite.h"
 
 #include "interconnection/runtime/data_exchange.pb.h"
 
@@ -36,6 +45,58 @@ std::string Typename<phe::Plaintext>::Name = "plaintext";
 template <>
 std::string Typename<std::string>::Name = "string";
 
+namespace {
+
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::io::CodedOutputStream;
+using google::protobuf::internal::WireFormatLite;
+using VNdarray = std::decay_t<
+    decltype(std::declval<pb_ns::DataExchangeProtocol>().v_ndarray())>;
+
+uint32_t BytesFieldTag(int field_number) {
+  return WireFormatLite::MakeTag(field_number,
+                                 WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+}
+
+// Encoded size of a length-delimited field whose payload has `len` bytes
+size_t BytesFieldSize(uint32_t tag, size_t len) {
+  return CodedOutputStream::VarintSize32(tag) +
+         CodedOutputStream::VarintSize64(len) + len;
+}
+
+uint8_t *WriteBytesFieldHeader(uint32_t tag, size_t len, uint8_t *target) {
+  target = CodedOutputStream::WriteTagToArray(tag, target);
+  return CodedOutputStream::WriteVarint64ToArray(len, target);
+}
+
+// Reads the length of a length-delimited field whose payload must fit in the
+// `total` bytes of input, or in the current limit if one is pushed
+int ReadBytesFieldHeader(CodedInputStream *in, size_t total) {
+  uint32_t len;
+  YACL_ENFORCE(in->ReadVarint32(&len), "Pb: truncated length");
+  int64_t remaining = in->BytesUntilLimit();
+  if (remaining < 0) {
+    remaining = static_cast<int64_t>(total) - in->CurrentPosition();
+  }
+  YACL_ENFORCE(len <= static_cast<uint32_t>(INT_MAX) &&
+                   static_cast<int64_t>(len) <= remaining,
+               "Pb: field length {} exceeds the remaining {} bytes", len,
+               remaining);
+  return static_cast<int>(len);
+}
+
+bool IsBytesField(uint32_t tag) {
+  return WireFormatLite::GetTagWireType(tag) ==
+         WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+}
+
+}  // namespace
+
+// Serialize4Ic writes the protobuf wire format of DataExchangeProtocol by
+// hand. Each item is serialized once, and then copied into its precomputed
+// offset in the output buffer in parallel. This avoids building a temporary
+// pb message with a copy of every item. The output is a valid
+// DataExchangeProtocol, and any protobuf implementation can parse it.
 template <typename T>
 yacl::Buffer DenseMatrix<T>::Serialize4Ic() const {
   pb_ns::DataExchangeProtocol dep;
@@ -46,63 +107,170 @@ yacl::Buffer DenseMatrix<T>::Serialize4Ic() const {
   // met here. The standard is 'paillier_ciphertext'. However, the underlying
   // schema is hard to obtain here, so just set the name to 'ciphertext'.
   dep.set_scalar_type_name(Typename<T>::Name);
+  auto header = dep.SerializeAsString();
 
-  auto v_ndarray = dep.mutable_v_ndarray();
+  VNdarray shape_pb;
   auto shape = this->shape();
   for (const auto &s : shape) {
-    v_ndarray->add_shape(s);
+    shape_pb.add_shape(s);
   }
+  auto shape_bytes = shape_pb.SerializeAsString();
 
+  // serialize items, string items are referenced directly
   const T *buf = this->data();
-  auto pb_items = v_ndarray->mutable_items();
-  pb_items->Reserve(size());
-  for (int i = 0; i < size(); ++i) {
-    pb_items->Add();
+  std::vector<yacl::Buffer> items;
+  if constexpr (!std::is_same_v<T, std::string>) {
+    items.resize(size());
+    yacl::parallel_for(0, size(), 1, [&](int64_t beg, int64_t end) {
+      for (int64_t i = beg; i < end; ++i) {
+        items[i] = buf[i].Serialize();
+      }
+    });
   }
+  auto item_view = [&](int64_t i) -> std::string_view {
+    if constexpr (std::is_same_v<T, std::string>) {
+      return buf[i];
+    } else {
+      return std::string_view(items[i]);
+    }
+  };
+
+  // compute the offset of every item
+  const uint32_t item_tag = BytesFieldTag(VNdarray::kItemsFieldNumber);
+  std::vector<size_t> offsets(size() + 1);
+  offsets[0] = shape_bytes.size();
+  for (int64_t i = 0; i < size(); ++i) {
+    offsets[i + 1] = offsets[i] + BytesFieldSize(item_tag, item_view(i).size());
+  }
+  size_t ndarray_size = offsets[size()];
+
+  const uint32_t ndarray_tag =
+      BytesFieldTag(pb_ns::DataExchangeProtocol::kVNdarrayFieldNumber);
+  size_t ndarray_begin = header.size() +
+                         CodedOutputStream::VarintSize32(ndarray_tag) +
+                         CodedOutputStream::VarintSize64(ndarray_size);
+  // LoadFromIc cannot read back what protobuf cannot parse
+  YACL_ENFORCE(ndarray_begin + ndarray_size <= static_cast<size_t>(INT_MAX),
+               "Matrix is too large for protobuf, size={}",
+               ndarray_begin + ndarray_size);
+  yacl::Buffer buffer(ndarray_begin + ndarray_size);
+
+  auto *out = buffer.data<uint8_t>();
+  std::memcpy(out, header.data(), header.size());
+  out = WriteBytesFieldHeader(ndarray_tag, ndarray_size, out + header.size());
+  YACL_ENFORCE(out == buffer.data<uint8_t>() + ndarray_begin);
+  std::memcpy(out, shape_bytes.data(), shape_bytes.size());
+
   yacl::parallel_for(0, size(), 1, [&](int64_t beg, int64_t end) {
     for (int64_t i = beg; i < end; ++i) {
-      if constexpr (std::is_same_v<T, std::string>) {
-        pb_items->at(i) = buf[i];
-      } else {
-        pb_items->at(i) = buf[i].Serialize();
-      }
+      auto item = item_view(i);
+      auto *pos = WriteBytesFieldHeader(item_tag, item.size(),
+                                        out + offsets[i]);
+      std::memcpy(pos, item.data(), item.size());
     }
   });
-
-  yacl::Buffer buffer(dep.ByteSizeLong());
-  YACL_ENFORCE(dep.SerializeToArray(buffer.data<uint8_t>(), buffer.size()),
-               "serialize ndarray fail");
   return buffer;
 }
 
+// LoadFromIc walks the wire format and records the slice of every item, then
+// items are deserialized directly from the input buffer in parallel.
 template <typename T>
 DenseMatrix<T> DenseMatrix<T>::LoadFromIc(yacl::ByteContainerView in) {
-  pb_ns::DataExchangeProtocol dxp;
-  YACL_ENFORCE(dxp.ParseFromArray(in.data(), in.size()),
-               "deserialize ndarray fail");
+  YACL_ENFORCE(in.size() <= static_cast<size_t>(INT_MAX),
+               "Buffer is too large for protobuf, size={}", in.size());
+  const auto *base = reinterpret_cast<const uint8_t *>(in.data());
+  CodedInputStream input(base, static_cast<int>(in.size()));
+
+  std::vector<int64_t> shape;
+  std::vector<std::pair<int, int>> items;  // (offset, length)
+  int scalar_type = 0;
+  bool has_ndarray = false;
 
-  // dxp.scalar_type_name() is useless, do not check
-  YACL_ENFORCE(dxp.scalar_type() == pb_ns::SCALAR_TYPE_OBJECT,
-               "Buffer format illegal, scalar_type={}", dxp.scalar_type());
+  auto fail = [] { YACL_THROW("deserialize ndarray fail"); };
+  while (uint32_t tag = input.ReadTag()) {
+    int field = WireFormatLite::GetTagFieldNumber(tag);
+    if (field == pb_ns::DataExchangeProtocol::kScalarTypeFieldNumber) {
+      uint32_t v;
+      if (!input.ReadVarint32(&v)) {
+        fail();
+      }
+      scalar_type = static_cast<int>(v);
+    } else if (field == pb_ns::DataExchangeProtocol::kVNdarrayFieldNumber) {
+      if (!IsBytesField(tag)) {
+        fail();
+      }
+      has_ndarray = true;
+      auto limit = input.PushLimit(ReadBytesFieldHeader(&input, in.size()));
+      while (uint32_t sub_tag = input.ReadTag()) {
+        int sub_field = WireFormatLite::GetTagFieldNumber(sub_tag);
+        if (sub_field == VNdarray::kItemsFieldNumber) {
+          if (!IsBytesField(sub_tag)) {
+            fail();
+          }
+          int len = ReadBytesFieldHeader(&input, in.size());
+          items.emplace_back(input.CurrentPosition(), len);
+          if (!input.Skip(len)) {
+            fail();
+          }
+        } else if (sub_field == VNdarray::kShapeFieldNumber &&
+                   IsBytesField(sub_tag)) {
+          // packed
+          auto shape_limit =
+              input.PushLimit(ReadBytesFieldHeader(&input, in.size()));
+          while (input.BytesUntilLimit() > 0) {
+            uint64_t v;
+            if (!input.ReadVarint64(&v)) {
+              fail();
+            }
+            shape.push_back(static_cast<int64_t>(v));
+          }
+          input.PopLimit(shape_limit);
+        } else if (sub_field == VNdarray::kShapeFieldNumber) {
+          uint64_t v;
+          if (!input.ReadVarint64(&v)) {
+            fail();
+          }
+          shape.push_back(static_cast<int64_t>(v));
+        } else if (!WireFormatLite::SkipField(&input, sub_tag)) {
+          fail();
+        }
+      }
+      if (!input.ConsumedEntireMessage()) {
+        fail();
+      }
+      input.PopLimit(limit);
+    } else {
+      const auto *fd =
+          pb_ns::DataExchangeProtocol::descriptor()->FindFieldByNumber(field);
+      YACL_ENFORCE(fd == nullptr || fd->containing_oneof() == nullptr,
+                   "unsupported container type {}", field);
+      // dxp.scalar_type_name() is useless, do not check
+      if (!WireFormatLite::SkipField(&input, tag)) {
+        fail();
+      }
+    }
+  }
+  if (!input.ConsumedEntireMessage()) {
+    fail();
+  }
 
-  YACL_ENFORCE(dxp.container_case() ==
-                   pb_ns::DataExchangeProtocol::ContainerCase::kVNdarray,
-               "unsupported container type {}", (int)dxp.container_case());
+  YACL_ENFORCE(scalar_type == pb_ns::SCALAR_TYPE_OBJECT,
+               "Buffer format illegal, scalar_type={}", scalar_type);
+  YACL_ENFORCE(has_ndarray, "Buffer format illegal, v_ndarray not found");
 
-  auto v_ndarray = dxp.v_ndarray();
-  auto s = v_ndarray.shape();
-  DenseMatrix<T> res(s.size() > 0 ? s[0] : 1, s.size() > 1 ? s[1] : 1,
-                     s.size());
+  DenseMatrix<T> res(shape.size() > 0 ? shape[0] : 1,
+                     shape.size() > 1 ? shape[1] : 1, shape.size());
 
   T *buf = res.data();
-  auto pb_items = v_ndarray.items();
-  YACL_ENFORCE(pb_items.size() == res.size(), "Pb: shape and len not match");
+  YACL_ENFORCE(static_cast<int64_t>(items.size()) == res.size(),
+               "Pb: shape and len not match");
   yacl::parallel_for(0, res.size(), 1, [&](int64_t beg, int64_t end) {
     for (int64_t i = beg; i < end; ++i) {
+      const auto *data = base + items[i].first;
       if constexpr (std::is_same_v<T, std::string>) {
-        buf[i] = pb_items.at(i);
+        buf[i].assign(reinterpret_cast<const char *>(data), items[i].second);
       } else {
-        buf[i].Deserialize(pb_items.at(i));
+        buf[i].Deserialize(yacl::ByteContainerView(data, items[i].second));
       }
     }
   });
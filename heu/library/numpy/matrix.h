@@ -36,6 +36,9 @@ template <typename T>
 using kHasSerializeWithMetaMethod =
     decltype(std::declval<T &>().Serialize(std::declval<bool &>()));
 
+template <typename T>
+class DenseMatrixView;
+
 // Vector is cheated as an n*1 matrix
 template <typename T>
 class DenseMatrix {
@@ -224,43 +227,9 @@ class DenseMatrix {
       return Serialize4Ic();
     }
 
-    msgpack::sbuffer buffer;
-    msgpack::packer<msgpack::sbuffer> o(buffer);
-
-    o.pack_array(4);
-    Eigen::Index rows = this->rows();
-    Eigen::Index cols = this->cols();
-    int64_t ndim = this->ndim();
-
-    o.pack(rows);
-    o.pack(cols);
-    o.pack(ndim);
-    o.pack_array(this->size());
-
     const T *buf = this->data();
-    if constexpr (std::experimental::is_detected_v<kHasSerializeWithMetaMethod,
-                                                   T>) {
-      std::vector<yacl::Buffer> tmp;
-      tmp.resize(this->size());
-      // parallel serialize
-      tmp[0] = buf[0].Serialize(/* with_meta = */ true);
-      yacl::parallel_for(1, this->size(), 1, [&](int64_t beg, int64_t end) {
-        for (int64_t i = beg; i < end; ++i) {
-          tmp[i] = buf[i].Serialize();
-        }
-      });
-
-      for (const auto &t : tmp) {
-        o.pack(std::string_view(t));
-      }
-    } else {
-      for (Eigen::Index i = 0; i < this->size(); i++) {
-        o.pack(buf[i]);
-      }
-    }
-
-    auto sz = buffer.size();
-    return {buffer.release(), sz, [](void *ptr) { free(ptr); }};
+    return SerializeElements(rows(), cols(), ndim(),
+                             [buf](int64_t i) -> const T & { return buf[i]; });
   }
 
   static DenseMatrix<T> LoadFrom(
@@ -273,8 +242,11 @@ class DenseMatrix {
 
     size_t zero = 0;
     size_t *off = (offset == nullptr ? &zero : offset);
-    auto msg = msgpack::unpack(reinterpret_cast<const char *>(in.data()),
-                               in.size(), *off);
+    // Strings in msg refer to the input buffer instead of being copied, they
+    // are only used before this function returns.
+    auto msg = msgpack::unpack(
+        reinterpret_cast<const char *>(in.data()), in.size(), *off,
+        [](msgpack::type::object_type, std::size_t, void *) { return true; });
     msgpack::object o = msg.get();
 
     YACL_ENFORCE(o.type == msgpack::type::ARRAY && o.via.array.size == 4,
@@ -314,6 +286,65 @@ class DenseMatrix {
   }
 
  private:
+  template <typename U>
+  friend class DenseMatrixView;
+
+  // Pack the elements in column-major order, get(i) returns the i-th element.
+  // Shared by DenseMatrix and DenseMatrixView.
+  template <typename Getter>
+  static yacl::Buffer SerializeElements(Eigen::Index rows, Eigen::Index cols,
+                                        int64_t ndim, const Getter &get) {
+    int64_t size = rows * cols;
+    if constexpr (std::experimental::is_detected_v<kHasSerializeWithMetaMethod,
+                                                   T>) {
+      std::vector<yacl::Buffer> tmp;
+      tmp.resize(size);
+      // parallel serialize
+      tmp[0] = get(0).Serialize(/* with_meta = */ true);
+      yacl::parallel_for(1, size, 1, [&](int64_t beg, int64_t end) {
+        for (int64_t i = beg; i < end; ++i) {
+          tmp[i] = get(i).Serialize();
+        }
+      });
+
+      // Reserve the whole output, so the buffer is never reallocated (and
+      // copied) during packing. A str header takes at most 5 bytes, and the
+      // array headers and shape take at most 48 bytes.
+      size_t total = 48;
+      for (const auto &t : tmp) {
+        total += t.size() + 5;
+      }
+      msgpack::sbuffer buffer(total);
+      msgpack::packer<msgpack::sbuffer> o(buffer);
+      PackHeader(o, rows, cols, ndim);
+      for (const auto &t : tmp) {
+        o.pack(std::string_view(t));
+      }
+
+      auto sz = buffer.size();
+      return {buffer.release(), sz, [](void *ptr) { free(ptr); }};
+    } else {
+      msgpack::sbuffer buffer;
+      msgpack::packer<msgpack::sbuffer> o(buffer);
+      PackHeader(o, rows, cols, ndim);
+      for (int64_t i = 0; i < size; i++) {
+        o.pack(get(i));
+      }
+
+      auto sz = buffer.size();
+      return {buffer.release(), sz, [](void *ptr) { free(ptr); }};
+    }
+  }
+
+  static void PackHeader(msgpack::packer<msgpack::sbuffer> &o,
+                         Eigen::Index rows, Eigen::Index cols, int64_t ndim) {
+    o.pack_array(4);
+    o.pack(rows);
+    o.pack(cols);
+    o.pack(ndim);
+    o.pack_array(rows * cols);
+  }
+
   // Serialize to interconnection format
   // 序列化成符合互联互通标准的格式
   yacl::Buffer Serialize4Ic() const;
@@ -334,12 +365,191 @@ class DenseMatrix {
   int64_t ndim_;
 };
 
+// A read-only view of a DenseMatrix with arbitrary strides, so slicing,
+// transposing and broadcasting do not copy any element. Element (r, c) is
+// base[r * row_stride + c * col_stride], a stride of 0 repeats the same
+// element along that axis.
+//
+// The view does not own the elements, the viewed matrix must outlive it.
+template <typename T>
+class DenseMatrixView {
+ public:
+  typedef T value_type;
+
+  // view the whole matrix. Implicit, so that all functions accepting a view
+  // also accept a DenseMatrix.
+  DenseMatrixView(const DenseMatrix<T> &m)  // NOLINT
+      : DenseMatrixView(m.data(), m.rows(), m.cols(), m.ndim(), 1, m.rows()) {}
+
+  DenseMatrixView(const T *base, Eigen::Index rows, Eigen::Index cols,
+                  int64_t ndim, int64_t row_stride, int64_t col_stride)
+      : base_(base),
+        rows_(rows),
+        cols_(cols),
+        ndim_(ndim),
+        row_stride_(row_stride),
+        col_stride_(col_stride) {
+    YACL_ENFORCE(ndim <= 2, "HEU tensor dimension cannot exceed 2");
+    if (ndim == 1) {
+      YACL_ENFORCE(cols == 1, "vector's cols must be 1");
+    } else if (ndim == 0) {
+      YACL_ENFORCE(rows == 1 && cols == 1,
+                   "scalar's shape must be 1x1, actual: {}x{}", rows, cols);
+    }
+  }
+
+  const T &operator()(Eigen::Index row, Eigen::Index col) const {
+    return base_[row * row_stride_ + col * col_stride_];
+  }
+
+  // Select rows [row_start, row_start + row_step * row_len) with step
+  // row_step, and the same for cols. Steps can be negative.
+  DenseMatrixView<T> Slice(Eigen::Index row_start, Eigen::Index row_len,
+                           Eigen::Index row_step, Eigen::Index col_start,
+                           Eigen::Index col_len, Eigen::Index col_step) const {
+    CheckSliceRange(row_start, row_len, row_step, rows_);
+    CheckSliceRange(col_start, col_len, col_step, cols_);
+    int64_t offset = 0;
+    if (row_len > 0 && col_len > 0) {
+      offset = row_start * row_stride_ + col_start * col_stride_;
+    }
+    return DenseMatrixView<T>(base_ + offset, row_len, col_len, ndim_,
+                              row_stride_ * row_step, col_stride_ * col_step);
+  }
+
+  // Drop axes of length 1, same as DenseMatrix::GetItem(). A squeezed row
+  // turns the result into a vertical vector.
+  DenseMatrixView<T> Squeeze(bool squeeze_row, bool squeeze_col) const {
+    if (ndim_ == 1) {
+      YACL_ENFORCE(
+          !squeeze_col,
+          "axis doesn't exist, you cannot squeeze shape[1] of a vector");
+    } else if (ndim_ == 0) {
+      YACL_ENFORCE(!squeeze_row && !squeeze_col,
+                   "axis doesn't exist, tensor is 0-d, but you want to squeeze "
+                   "dim 1 and 2");
+    }
+
+    if (squeeze_col && cols_ <= 1) {
+      // vertical vector or scalar
+      int64_t new_dim = ndim_ - 1;
+      if (squeeze_row && rows_ <= 1) {
+        new_dim -= 1;
+      }
+      return {base_, rows_, cols_, new_dim, row_stride_, col_stride_};
+    }
+    if (squeeze_row && rows_ <= 1) {
+      // horizontal vector or scalar
+      return {base_, cols_, rows_, ndim_ - 1, col_stride_, row_stride_};
+    }
+    return *this;
+  }
+
+  DenseMatrixView<T> Transpose() const {
+    YACL_ENFORCE(ndim_ == 2, "you cannot transpose a {}d-tensor", ndim_);
+    return {base_, cols_, rows_, ndim_, col_stride_, row_stride_};
+  }
+
+  // Repeat the view to shape rows x cols like numpy, every axis must either
+  // match or have length 1.
+  DenseMatrixView<T> BroadcastTo(Eigen::Index rows, Eigen::Index cols,
+                                 int64_t ndim) const {
+    YACL_ENFORCE((rows_ == rows || rows_ == 1) && (cols_ == cols || cols_ == 1),
+                 "cannot broadcast a {}x{} tensor to {}x{}", rows_, cols_, rows,
+                 cols);
+    YACL_ENFORCE(ndim >= ndim_, "cannot broadcast a {}-d tensor to {}-d",
+                 ndim_, ndim);
+    return DenseMatrixView<T>(base_, rows, cols, ndim,
+                              rows_ == rows ? row_stride_ : 0,
+                              cols_ == cols ? col_stride_ : 0);
+  }
+
+  // Copy the elements into a new DenseMatrix
+  DenseMatrix<T> Materialize() const {
+    DenseMatrix<T> res(rows_, cols_, ndim_);
+    res.ForEach([this](int64_t row, int64_t col, T *element) {
+      *element = (*this)(row, col);
+    });
+    return res;
+  }
+
+  [[nodiscard]] int64_t ndim() const { return ndim_; }
+
+  [[nodiscard]] Eigen::Index rows() const { return rows_; }
+
+  [[nodiscard]] Eigen::Index cols() const { return cols_; }
+
+  [[nodiscard]] Eigen::Index size() const { return rows_ * cols_; }
+
+  [[nodiscard]] int64_t row_stride() const { return row_stride_; }
+
+  [[nodiscard]] int64_t col_stride() const { return col_stride_; }
+
+  [[nodiscard]] Shape shape() const {
+    std::vector<int64_t> res = {rows_, cols_};
+    res.resize(ndim_);
+    return Shape(res);
+  }
+
+  const T *data() const { return base_; }
+
+  [[nodiscard]] std::string ToString() const {
+    return Materialize().ToString();
+  }
+
+  friend std::ostream &operator<<(std::ostream &os, const DenseMatrixView &m) {
+    return os << m.ToString();
+  }
+
+  // The output is the same as DenseMatrix::Serialize() of the materialized
+  // matrix, so it is loaded by DenseMatrix::LoadFrom()
+  [[nodiscard]] yacl::Buffer Serialize(
+      MatrixSerializeFormat format = MatrixSerializeFormat::Best) const {
+    if (format == MatrixSerializeFormat::Interconnection) {
+      return Materialize().Serialize(format);
+    }
+
+    return DenseMatrix<T>::SerializeElements(
+        rows_, cols_, ndim_, [this](int64_t i) -> const T & {
+          return (*this)(i % rows_, i / rows_);
+        });
+  }
+
+ private:
+  static void CheckSliceRange(Eigen::Index start, Eigen::Index len,
+                              Eigen::Index step, Eigen::Index dim_len) {
+    YACL_ENFORCE(len >= 0, "slice length cannot be negative, got {}", len);
+    if (len == 0) {
+      return;
+    }
+    YACL_ENFORCE(step != 0, "slice step cannot be 0");
+    Eigen::Index last = start + step * (len - 1);
+    YACL_ENFORCE(start >= 0 && start < dim_len && last >= 0 && last < dim_len,
+                 "slice [{}:{}:{}] is out of bounds [0, {})", start,
+                 start + step * len, step, dim_len);
+  }
+
+  const T *base_;
+  Eigen::Index rows_;
+  Eigen::Index cols_;
+  int64_t ndim_;
+  int64_t row_stride_;
+  int64_t col_stride_;
+};
+
 template <typename T>
 inline auto format_as(const DenseMatrix<T> &i) {
   return fmt::streamed(i);
 }
 
+template <typename T>
+inline auto format_as(const DenseMatrixView<T> &i) {
+  return fmt::streamed(i);
+}
+
 using PMatrix = DenseMatrix<phe::Plaintext>;
 using CMatrix = DenseMatrix<phe::Ciphertext>;
+using PMatrixView = DenseMatrixView<phe::Plaintext>;
+using CMatrixView = DenseMatrixView<phe::Ciphertext>;
 
 }  // namespace heu::lib::numpy
@@ -0,0 +1,483 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/numpy/mmap_matrix.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "yacl/utils/parallel.h"
+
+namespace heu::lib::numpy {
+
+namespace {
+
+constexpr char kMagic[8] = {'H', 'E', 'U', 'M', 'M', 'A', 'P', '1'};
+constexpr size_t kHeaderBytes = 64;
+// extra room for ciphertexts larger than the sample used to size the slots
+constexpr size_t kSlotMargin = 16;
+
+struct Header {
+  char magic[8];
+  int64_t rows;
+  int64_t cols;
+  int64_t ndim;
+  uint64_t slot_bytes;
+};
+static_assert(sizeof(Header) <= kHeaderBytes);
+
+// [beg, beg + len) bytes of a mapping, widened to whole pages
+std::pair<uint8_t *, size_t> PageRange(uint8_t *beg, size_t len) {
+  static const auto page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  auto addr = reinterpret_cast<uintptr_t>(beg);
+  auto aligned = addr & ~(page - 1);
+  return {reinterpret_cast<uint8_t *>(aligned), len + (addr - aligned)};
+}
+
+// kHeaderBytes + rows * cols * slot_bytes, or nullopt if it overflows
+std::optional<size_t> FileBytes(int64_t rows, int64_t cols,
+                                uint64_t slot_bytes) {
+  int64_t size = 0;
+  size_t bytes = 0;
+  if (rows <= 0 || cols <= 0 || __builtin_mul_overflow(rows, cols, &size) ||
+      __builtin_mul_overflow(static_cast<uint64_t>(size), slot_bytes,
+                             &bytes) ||
+      __builtin_add_overflow(bytes, kHeaderBytes, &bytes) ||
+      bytes > static_cast<uint64_t>(std::numeric_limits<off_t>::max())) {
+    return std::nullopt;
+  }
+  return bytes;
+}
+
+bool IsLegalShape(int64_t rows, int64_t cols, int64_t ndim) {
+  switch (ndim) {
+    case 0:
+      return rows == 1 && cols == 1;
+    case 1:
+      return cols == 1;
+    case 2:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+MmapCMatrix MmapCMatrix::Create(const std::string &path, int64_t rows,
+                                int64_t cols, int64_t ndim,
+                                size_t slot_bytes) {
+  YACL_ENFORCE(rows > 0 && cols > 0,
+               "HEU does not support empty tensor currently, shape={}x{}",
+               rows, cols);
+  YACL_ENFORCE(IsLegalShape(rows, cols, ndim),
+               "Illegal shape {}x{} for a {}-d tensor", rows, cols, ndim);
+  YACL_ENFORCE(slot_bytes > sizeof(uint32_t), "slot_bytes {} is too small",
+               slot_bytes);
+  auto file_bytes = FileBytes(rows, cols, slot_bytes);
+  YACL_ENFORCE(file_bytes.has_value(),
+               "Shape {}x{} with {}-byte slots is too large", rows, cols,
+               slot_bytes);
+
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  YACL_ENFORCE(fd >= 0, "Cannot create {}: {}", path, std::strerror(errno));
+
+  MmapCMatrix res;
+  res.path_ = path;
+  res.rows_ = rows;
+  res.cols_ = cols;
+  res.ndim_ = ndim;
+  res.slot_bytes_ = slot_bytes;
+  if (::ftruncate(fd, static_cast<off_t>(*file_bytes)) != 0) {
+    auto err = errno;
+    ::close(fd);
+    YACL_THROW("Cannot resize {} to {} bytes: {}", path, *file_bytes,
+               std::strerror(err));
+  }
+  res.Map(fd, true);
+
+  Header header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.rows = rows;
+  header.cols = cols;
+  header.ndim = ndim;
+  header.slot_bytes = slot_bytes;
+  std::memcpy(res.base_, &header, sizeof(header));
+  return res;
+}
+
+MmapCMatrix MmapCMatrix::Open(const std::string &path, bool writable) {
+  int fd = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+  YACL_ENFORCE(fd >= 0, "Cannot open {}: {}", path, std::strerror(errno));
+
+  Header header{};
+  struct stat st {};
+  if (::fstat(fd, &st) != 0 ||
+      ::pread(fd, &header, sizeof(header), 0) !=
+          static_cast<ssize_t>(sizeof(header)) ||
+      std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    ::close(fd);
+    YACL_THROW("{} is not a MmapCMatrix file", path);
+  }
+
+  // a corrupted header must not wrap the expected file size around, nor map
+  // less than the slots it claims
+  auto expected = FileBytes(header.rows, header.cols, header.slot_bytes);
+  if (!IsLegalShape(header.rows, header.cols, header.ndim) ||
+      header.slot_bytes <= sizeof(uint32_t) || !expected.has_value()) {
+    ::close(fd);
+    YACL_THROW("{} has a corrupted header, shape={}x{}, ndim={}, "
+               "slot_bytes={}",
+               path, header.rows, header.cols, header.ndim,
+               header.slot_bytes);
+  }
+  if (static_cast<size_t>(st.st_size) != *expected) {
+    ::close(fd);
+    YACL_THROW("{} is truncated or corrupted, size={}, expected={}", path,
+               st.st_size, *expected);
+  }
+
+  MmapCMatrix res;
+  res.path_ = path;
+  res.rows_ = header.rows;
+  res.cols_ = header.cols;
+  res.ndim_ = header.ndim;
+  res.slot_bytes_ = header.slot_bytes;
+  res.Map(fd, writable);
+  return res;
+}
+
+size_t MmapCMatrix::SlotBytesFor(const phe::Ciphertext &sample) {
+  return sizeof(uint32_t) + sample.Serialize().size() + kSlotMargin;
+}
+
+void MmapCMatrix::Map(int fd, bool writable) {
+  mapped_bytes_ = kHeaderBytes + size() * slot_bytes_;
+  auto prot = PROT_READ | (writable ? PROT_WRITE : 0);
+  void *addr = ::mmap(nullptr, mapped_bytes_, prot, MAP_SHARED, fd, 0);
+  auto err = errno;
+  ::close(fd);  // the mapping keeps the file open
+  YACL_ENFORCE(addr != MAP_FAILED, "Cannot mmap {}: {}", path_,
+               std::strerror(err));
+  base_ = static_cast<uint8_t *>(addr);
+  writable_ = writable;
+}
+
+void MmapCMatrix::Unmap() {
+  if (base_ != nullptr) {
+    ::munmap(base_, mapped_bytes_);
+    base_ = nullptr;
+  }
+}
+
+MmapCMatrix::MmapCMatrix(MmapCMatrix &&other) noexcept {
+  *this = std::move(other);
+}
+
+MmapCMatrix &MmapCMatrix::operator=(MmapCMatrix &&other) noexcept {
+  if (this != &other) {
+    Unmap();
+    path_ = std::move(other.path_);
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    ndim_ = other.ndim_;
+    slot_bytes_ = other.slot_bytes_;
+    writable_ = other.writable_;
+    base_ = std::exchange(other.base_, nullptr);
+    mapped_bytes_ = other.mapped_bytes_;
+  }
+  return *this;
+}
+
+MmapCMatrix::~MmapCMatrix() { Unmap(); }
+
+Shape MmapCMatrix::shape() const {
+  return ndim_ == 1 ? Shape{rows_} : Shape{rows_, cols_};
+}
+
+uint8_t *MmapCMatrix::Slot(int64_t row, int64_t col) const {
+  return base_ + kHeaderBytes + (row * cols_ + col) * slot_bytes_;
+}
+
+CMatrix MmapCMatrix::ReadRows(int64_t row_beg, int64_t row_len) const {
+  YACL_ENFORCE(row_beg >= 0 && row_len > 0 && row_beg + row_len <= rows_,
+               "rows [{}, {}) out of range, total rows={}", row_beg,
+               row_beg + row_len, rows_);
+  CMatrix res(row_len, cols_, ndim_);
+  // the slots are read in file order
+  yacl::parallel_for(0, row_len, 1, [&](int64_t beg, int64_t end) {
+    for (auto r = beg; r < end; ++r) {
+      for (int64_t c = 0; c < cols_; ++c) {
+        const uint8_t *slot = Slot(row_beg + r, c);
+        uint32_t len;
+        std::memcpy(&len, slot, sizeof(len));
+        YACL_ENFORCE(len > 0 && len <= slot_bytes_ - sizeof(len),
+                     "{} is corrupted at ({}, {})", path_, row_beg + r, c);
+        res(r, c).Deserialize(
+            yacl::ByteContainerView(slot + sizeof(len), len));
+      }
+    }
+  });
+  return res;
+}
+
+void MmapCMatrix::WriteRows(int64_t row_beg, const CMatrixView &rows) {
+  YACL_ENFORCE(writable_, "{} is opened as read-only", path_);
+  YACL_ENFORCE(rows.cols() == cols_, "column mismatch, expected {}, got {}",
+               cols_, rows.cols());
+  YACL_ENFORCE(row_beg >= 0 && row_beg + rows.rows() <= rows_,
+               "rows [{}, {}) out of range, total rows={}", row_beg,
+               row_beg + rows.rows(), rows_);
+  yacl::parallel_for(0, rows.rows(), 1, [&](int64_t beg, int64_t end) {
+    for (auto r = beg; r < end; ++r) {
+      for (int64_t c = 0; c < cols_; ++c) {
+        auto buf = rows(r, c).Serialize();
+        auto len = static_cast<uint32_t>(buf.size());
+        YACL_ENFORCE(len <= slot_bytes_ - sizeof(len),
+                     "A ciphertext of {} bytes does not fit in a slot of {} "
+                     "bytes",
+                     len, slot_bytes_);
+        uint8_t *slot = Slot(row_beg + r, c);
+        std::memcpy(slot, &len, sizeof(len));
+        std::memcpy(slot + sizeof(len), buf.data(), len);
+      }
+    }
+  });
+
+  // start writing back now, so dirty pages do not pile up in memory
+  auto [addr, bytes] =
+      PageRange(Slot(row_beg, 0), rows.rows() * cols_ * slot_bytes_);
+  ::msync(addr, bytes, MS_ASYNC);
+}
+
+void MmapCMatrix::Prefetch(int64_t row_beg, int64_t row_len) const {
+  row_len = std::min(row_len, rows_ - row_beg);
+  if (row_beg < 0 || row_len <= 0) {
+    return;
+  }
+  auto [addr, bytes] =
+      PageRange(Slot(row_beg, 0), row_len * cols_ * slot_bytes_);
+  // only a hint, errors are harmless
+  ::madvise(addr, bytes, MADV_WILLNEED);
+}
+
+void MmapCMatrix::Flush() {
+  YACL_ENFORCE(::msync(base_, mapped_bytes_, MS_SYNC) == 0,
+               "Cannot flush {}: {}", path_, std::strerror(errno));
+}
+
+void MmapCMatrix::ForEachChunk(
+    int64_t rows_per_chunk,
+    const std::function<void(int64_t row_beg, const CMatrix &chunk)> &fn)
+    const {
+  YACL_ENFORCE(rows_per_chunk > 0, "rows_per_chunk must be positive, got {}",
+               rows_per_chunk);
+  auto load = [this, rows_per_chunk](int64_t beg) {
+    return ReadRows(beg, std::min(rows_per_chunk, rows_ - beg));
+  };
+
+  auto next = std::async(std::launch::async, load, 0);
+  for (int64_t beg = 0; beg < rows_; beg += rows_per_chunk) {
+    CMatrix chunk = next.get();
+    auto next_beg = beg + rows_per_chunk;
+    if (next_beg < rows_) {
+      // overlap the page-in of the next chunk with fn()
+      Prefetch(next_beg, rows_per_chunk);
+      next = std::async(std::launch::async, load, next_beg);
+    }
+    fn(beg, chunk);
+  }
+}
+
+int64_t MmapCMatrix::RowsPerChunk(size_t chunk_bytes) const {
+  return std::max<int64_t>(1, chunk_bytes / (cols_ * slot_bytes_));
+}
+
+StreamingEvaluator::StreamingEvaluator(
+    std::shared_ptr<const Evaluator> evaluator, int64_t rows_per_chunk)
+    : evaluator_(std::move(evaluator)), rows_per_chunk_(rows_per_chunk) {
+  YACL_ENFORCE(rows_per_chunk_ >= 0, "rows_per_chunk must not be negative");
+}
+
+int64_t StreamingEvaluator::ChunkRows(const MmapCMatrix &x) const {
+  return rows_per_chunk_ > 0 ? rows_per_chunk_
+                             : x.RowsPerChunk(kDefaultChunkBytes);
+}
+
+template <typename F>
+MmapCMatrix StreamingEvaluator::Elementwise(const MmapCMatrix &x,
+                                            const PMatrix &y,
+                                            const std::string &out_path,
+                                            const F &op) const {
+  YACL_ENFORCE((y.rows() == 1 || y.rows() == x.rows()) &&
+                   (y.cols() == 1 || y.cols() == x.cols()) &&
+                   y.ndim() <= x.ndim(),
+               "y with shape {} cannot be broadcast to {}",
+               y.shape().ToString(), x.shape().ToString());
+  auto out = MmapCMatrix::Create(out_path, x.rows(), x.cols(), x.ndim(),
+                                 x.slot_bytes());
+  x.ForEachChunk(ChunkRows(x), [&](int64_t row_beg, const CMatrix &chunk) {
+    PMatrixView y_rows(y);
+    if (y.rows() > 1) {
+      y_rows = y_rows.Slice(row_beg, chunk.rows(), 1, 0, y.cols(), 1);
+    }
+    out.WriteRows(row_beg, op(chunk, y_rows));
+  });
+  return out;
+}
+
+template <typename F>
+MmapCMatrix StreamingEvaluator::Elementwise(const MmapCMatrix &x,
+                                            const MmapCMatrix &y,
+                                            const std::string &out_path,
+                                            const F &op) const {
+  YACL_ENFORCE(x.rows() == y.rows() && x.cols() == y.cols(),
+               "shape mismatch, x-shape={}, y-shape={}", x.shape().ToString(),
+               y.shape().ToString());
+  auto out = MmapCMatrix::Create(out_path, x.rows(), x.cols(),
+                                 std::max(x.ndim(), y.ndim()),
+                                 std::max(x.slot_bytes(), y.slot_bytes()));
+  auto rows_per_chunk = ChunkRows(x);
+  x.ForEachChunk(rows_per_chunk, [&](int64_t row_beg, const CMatrix &chunk) {
+    y.Prefetch(row_beg + chunk.rows(), rows_per_chunk);
+    out.WriteRows(row_beg, op(chunk, y.ReadRows(row_beg, chunk.rows())));
+  });
+  return out;
+}
+
+MmapCMatrix StreamingEvaluator::Add(const MmapCMatrix &x, const MmapCMatrix &y,
+                                    const std::string &out_path) const {
+  return Elementwise(x, y, out_path, [&](const CMatrix &a, const CMatrix &b) {
+    return evaluator_->Add(a, b);
+  });
+}
+
+MmapCMatrix StreamingEvaluator::Add(const MmapCMatrix &x, const PMatrix &y,
+                                    const std::string &out_path) const {
+  return Elementwise(x, y, out_path,
+                     [&](const CMatrix &a, const PMatrixView &b) {
+                       return evaluator_->Add(CMatrixView(a), b);
+                     });
+}
+
+MmapCMatrix StreamingEvaluator::Sub(const MmapCMatrix &x, const MmapCMatrix &y,
+                                    const std::string &out_path) const {
+  return Elementwise(x, y, out_path, [&](const CMatrix &a, const CMatrix &b) {
+    return evaluator_->Sub(a, b);
+  });
+}
+
+MmapCMatrix StreamingEvaluator::Sub(const MmapCMatrix &x, const PMatrix &y,
+                                    const std::string &out_path) const {
+  return Elementwise(x, y, out_path,
+                     [&](const CMatrix &a, const PMatrixView &b) {
+                       return evaluator_->Sub(CMatrixView(a), b);
+                     });
+}
+
+MmapCMatrix StreamingEvaluator::Mul(const MmapCMatrix &x, const PMatrix &y,
+                                    const std::string &out_path) const {
+  return Elementwise(x, y, out_path,
+                     [&](const CMatrix &a, const PMatrixView &b) {
+                       return evaluator_->Mul(CMatrixView(a), b);
+                     });
+}
+
+phe::Ciphertext StreamingEvaluator::Sum(const MmapCMatrix &x) const {
+  std::optional<phe::Ciphertext> sum;
+  x.ForEachChunk(ChunkRows(x), [&](int64_t, const CMatrix &chunk) {
+    auto partial = evaluator_->Sum(chunk);
+    if (sum) {
+      evaluator_->AddInplace(&*sum, partial);
+    } else {
+      sum = std::move(partial);
+    }
+  });
+  return *std::move(sum);
+}
+
+CMatrix StreamingEvaluator::FeatureWiseBucketSum(
+    const MmapCMatrix &x, const Eigen::Ref<RowMatrixXd> &order_map,
+    int bucket_num, bool cumsum) const {
+  YACL_ENFORCE_EQ(order_map.rows(), x.rows(),
+                  "order map and x should have same number of rows.");
+  std::optional<CMatrix> res;
+  x.ForEachChunk(ChunkRows(x), [&](int64_t row_beg, const CMatrix &chunk) {
+    // Evaluator takes a mutable Ref, which a block of a const Ref cannot bind
+    RowMatrixXd chunk_map = order_map.middleRows(row_beg, chunk.rows());
+    auto partial =
+        evaluator_->FeatureWiseBucketSum(chunk, chunk_map, bucket_num);
+    res = res ? evaluator_->Add(*res, partial) : std::move(partial);
+  });
+  if (!cumsum) {
+    return *std::move(res);
+  }
+
+  // the buckets of each feature are a segment
+  std::vector<int64_t> starts;
+  for (int64_t i = 0; i < order_map.cols(); ++i) {
+    starts.push_back(i * bucket_num);
+  }
+  return evaluator_->SegmentedCumSum(*res, starts, 0);
+}
+
+MmapCMatrix StreamingEvaluator::Encrypt(const Encryptor &encryptor,
+                                        const PMatrix &in,
+                                        const std::string &out_path,
+                                        int64_t rows_per_chunk) {
+  YACL_ENFORCE(in.size() > 0, "HEU does not support empty tensor currently");
+  auto slot_bytes = MmapCMatrix::SlotBytesFor(encryptor.Encrypt(in(0, 0)));
+  auto out = MmapCMatrix::Create(out_path, in.rows(), in.cols(), in.ndim(),
+                                 slot_bytes);
+  if (rows_per_chunk <= 0) {
+    rows_per_chunk = out.RowsPerChunk(kDefaultChunkBytes);
+  }
+
+  PMatrixView view(in);
+  for (int64_t beg = 0; beg < in.rows(); beg += rows_per_chunk) {
+    auto len = std::min(rows_per_chunk, in.rows() - beg);
+    out.WriteRows(beg,
+                  encryptor.Encrypt(view.Slice(beg, len, 1, 0, in.cols(), 1)));
+  }
+  return out;
+}
+
+PMatrix StreamingEvaluator::Decrypt(const Decryptor &decryptor,
+                                    const MmapCMatrix &in,
+                                    int64_t rows_per_chunk) {
+  if (rows_per_chunk <= 0) {
+    rows_per_chunk = in.RowsPerChunk(kDefaultChunkBytes);
+  }
+  PMatrix res(in.rows(), in.cols(), in.ndim());
+  in.ForEachChunk(rows_per_chunk, [&](int64_t row_beg, const CMatrix &chunk) {
+    auto pts = decryptor.Decrypt(chunk);
+    pts.ForEach([&](int64_t row, int64_t col, phe::Plaintext *pt) {
+      res(row_beg + row, col) = std::move(*pt);
+    });
+  });
+  return res;
+}
+
+}  // namespace heu::lib::numpy
@@ -0,0 +1,155 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "heu/library/numpy/decryptor.h"
+#include "heu/library/numpy/encryptor.h"
+#include "heu/library/numpy/evaluator.h"
+
+namespace heu::lib::numpy {
+
+// A disk-backed CMatrix for matrices larger than RAM.
+//
+// The file is memory-mapped and holds the ciphertexts in row-major order, each
+// one in a fixed-width slot of slot_bytes bytes, so any row range can be
+// located without an index. Data is accessed in chunks of rows, which are
+// deserialized into ordinary in-memory CMatrix objects.
+//
+// File layout: a 64-byte header (magic, rows, cols, ndim, slot_bytes), then
+// rows * cols slots. A slot is a uint32 length followed by the serialized
+// ciphertext and zero padding.
+class MmapCMatrix {
+ public:
+  // Creates (or truncates) the file at path
+  static MmapCMatrix Create(const std::string &path, int64_t rows,
+                            int64_t cols, int64_t ndim, size_t slot_bytes);
+  static MmapCMatrix Open(const std::string &path, bool writable = false);
+
+  // A slot size large enough for ciphertexts like sample, i.e. of the same
+  // key. The margin covers serialized sizes that vary with leading zeros.
+  static size_t SlotBytesFor(const phe::Ciphertext &sample);
+
+  MmapCMatrix(MmapCMatrix &&other) noexcept;
+  MmapCMatrix &operator=(MmapCMatrix &&other) noexcept;
+  MmapCMatrix(const MmapCMatrix &) = delete;
+  MmapCMatrix &operator=(const MmapCMatrix &) = delete;
+  ~MmapCMatrix();
+
+  [[nodiscard]] int64_t rows() const { return rows_; }
+  [[nodiscard]] int64_t cols() const { return cols_; }
+  [[nodiscard]] int64_t ndim() const { return ndim_; }
+  [[nodiscard]] int64_t size() const { return rows_ * cols_; }
+  [[nodiscard]] Shape shape() const;
+  [[nodiscard]] size_t slot_bytes() const { return slot_bytes_; }
+  [[nodiscard]] const std::string &path() const { return path_; }
+
+  // Reads rows [row_beg, row_beg + row_len) into memory. A 1-d matrix gives
+  // a 1-d chunk.
+  [[nodiscard]] CMatrix ReadRows(int64_t row_beg, int64_t row_len) const;
+  // Writes rows [row_beg, row_beg + rows.rows())
+  void WriteRows(int64_t row_beg, const CMatrixView &rows);
+  // Reads the whole matrix into memory
+  [[nodiscard]] CMatrix Load() const { return ReadRows(0, rows_); }
+
+  // Asks the OS to start paging in the given rows asynchronously
+  void Prefetch(int64_t row_beg, int64_t row_len) const;
+  // Writes the dirty pages back to the file
+  void Flush();
+
+  // Calls fn(row_beg, chunk) for every chunk of rows_per_chunk rows in order.
+  // The next chunk is paged in and deserialized in background while fn runs.
+  void ForEachChunk(
+      int64_t rows_per_chunk,
+      const std::function<void(int64_t row_beg, const CMatrix &chunk)> &fn)
+      const;
+
+  // rows per chunk such that a chunk takes about chunk_bytes of the file
+  [[nodiscard]] int64_t RowsPerChunk(size_t chunk_bytes) const;
+
+ private:
+  MmapCMatrix() = default;
+  void Map(int fd, bool writable);
+  void Unmap();
+  [[nodiscard]] uint8_t *Slot(int64_t row, int64_t col) const;
+
+  std::string path_;
+  int64_t rows_ = 0;
+  int64_t cols_ = 0;
+  int64_t ndim_ = 2;
+  size_t slot_bytes_ = 0;
+  bool writable_ = false;
+  uint8_t *base_ = nullptr;
+  size_t mapped_bytes_ = 0;
+};
+
+// The default amount of data processed at a time
+inline constexpr size_t kDefaultChunkBytes = 256 * 1024 * 1024;
+
+// Streams MmapCMatrix through the in-memory Encryptor, Decryptor and
+// Evaluator chunk by chunk, so at most a few chunks are in memory at a time.
+// If rows_per_chunk is 0, a chunk covers about kDefaultChunkBytes of the file.
+class StreamingEvaluator {
+ public:
+  explicit StreamingEvaluator(std::shared_ptr<const Evaluator> evaluator,
+                              int64_t rows_per_chunk = 0);
+
+  // Elementwise ops, the result is written to a new file at out_path. A
+  // plaintext y is broadcast to the shape of x, a disk-backed y must have the
+  // same shape as x.
+  MmapCMatrix Add(const MmapCMatrix &x, const MmapCMatrix &y,
+                  const std::string &out_path) const;
+  MmapCMatrix Add(const MmapCMatrix &x, const PMatrix &y,
+                  const std::string &out_path) const;
+  MmapCMatrix Sub(const MmapCMatrix &x, const MmapCMatrix &y,
+                  const std::string &out_path) const;
+  MmapCMatrix Sub(const MmapCMatrix &x, const PMatrix &y,
+                  const std::string &out_path) const;
+  MmapCMatrix Mul(const MmapCMatrix &x, const PMatrix &y,
+                  const std::string &out_path) const;
+
+  phe::Ciphertext Sum(const MmapCMatrix &x) const;
+
+  // same as Evaluator::FeatureWiseBucketSum(), the result is small and kept
+  // in memory
+  CMatrix FeatureWiseBucketSum(const MmapCMatrix &x,
+                               const Eigen::Ref<RowMatrixXd> &order_map,
+                               int bucket_num, bool cumsum = false) const;
+
+  // Encrypts in into a new file at out_path
+  static MmapCMatrix Encrypt(const Encryptor &encryptor, const PMatrix &in,
+                             const std::string &out_path,
+                             int64_t rows_per_chunk = 0);
+  static PMatrix Decrypt(const Decryptor &decryptor, const MmapCMatrix &in,
+                         int64_t rows_per_chunk = 0);
+
+ private:
+  [[nodiscard]] int64_t ChunkRows(const MmapCMatrix &x) const;
+
+  template <typename F>
+  MmapCMatrix Elementwise(const MmapCMatrix &x, const PMatrix &y,
+                          const std::string &out_path, const F &op) const;
+  template <typename F>
+  MmapCMatrix Elementwise(const MmapCMatrix &x, const MmapCMatrix &y,
+                          const std::string &out_path, const F &op) const;
+
+  std::shared_ptr<const Evaluator> evaluator_;
+  int64_t rows_per_chunk_;
+};
+
+}  // namespace heu::lib::numpy
@@ -0,0 +1,131 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/numpy/sparse_matrix.h"
+
+#include <utility>
+
+namespace heu::lib::numpy {
+
+SparsePMatrix::SparsePMatrix(phe::SchemaType schema, int64_t rows,
+                             int64_t cols, std::vector<int64_t> indptr,
+                             std::vector<int64_t> indices,
+                             std::vector<phe::Plaintext> values)
+    : schema_(schema),
+      rows_(rows),
+      cols_(cols),
+      indptr_(std::move(indptr)),
+      indices_(std::move(indices)),
+      values_(std::move(values)) {
+  YACL_ENFORCE(rows_ > 0 && cols_ > 0,
+               "HEU does not support empty tensor currently, shape={}x{}",
+               rows_, cols_);
+  YACL_ENFORCE(static_cast<int64_t>(indptr_.size()) == rows_ + 1,
+               "indptr must have rows + 1 = {} items, got {}", rows_ + 1,
+               indptr_.size());
+  YACL_ENFORCE(indices_.size() == values_.size(),
+               "indices and values have different sizes, {} vs {}",
+               indices_.size(), values_.size());
+  YACL_ENFORCE(indptr_.front() == 0 && indptr_.back() == nnz(),
+               "indptr must start with 0 and end with nnz={}, got {} and {}",
+               nnz(), indptr_.front(), indptr_.back());
+  for (int64_t i = 0; i < rows_; ++i) {
+    YACL_ENFORCE(indptr_[i] <= indptr_[i + 1],
+                 "indptr must be non-decreasing, indptr[{}]={} > indptr[{}]={}",
+                 i, indptr_[i], i + 1, indptr_[i + 1]);
+  }
+  for (auto col : indices_) {
+    YACL_ENFORCE(0 <= col && col < cols_,
+                 "column index {} out of range [0, {})", col, cols_);
+  }
+}
+
+SparsePMatrix SparsePMatrix::FromDense(phe::SchemaType schema,
+                                       const PMatrix &dense) {
+  std::vector<int64_t> indptr = {0};
+  std::vector<int64_t> indices;
+  std::vector<phe::Plaintext> values;
+  indptr.reserve(dense.rows() + 1);
+  for (int64_t i = 0; i < dense.rows(); ++i) {
+    for (int64_t j = 0; j < dense.cols(); ++j) {
+      if (!dense(i, j).IsZero()) {
+        indices.push_back(j);
+        values.push_back(dense(i, j));
+      }
+    }
+    indptr.push_back(static_cast<int64_t>(values.size()));
+  }
+  return {schema,
+          dense.rows(),
+          dense.cols(),
+          std::move(indptr),
+          std::move(indices),
+          std::move(values)};
+}
+
+PMatrix SparsePMatrix::ToDense() const {
+  PMatrix res(rows_, cols_);
+  res.ForEach([&](int64_t, int64_t, phe::Plaintext *pt) {
+    *pt = phe::Plaintext(schema_, 0);
+  });
+  for (int64_t i = 0; i < rows_; ++i) {
+    for (auto k = indptr_[i]; k < indptr_[i + 1]; ++k) {
+      // duplicate entries are summed up, same as scipy
+      res(i, indices_[k]) += values_[k];
+    }
+  }
+  return res;
+}
+
+SparsePMatrix SparsePMatrix::Transpose() const {
+  // counting sort by column
+  std::vector<int64_t> indptr(cols_ + 1, 0);
+  for (auto col : indices_) {
+    ++indptr[col + 1];
+  }
+  for (int64_t j = 0; j < cols_; ++j) {
+    indptr[j + 1] += indptr[j];
+  }
+
+  std::vector<int64_t> next(indptr.begin(), indptr.end() - 1);
+  std::vector<int64_t> indices(nnz());
+  std::vector<phe::Plaintext> values(nnz());
+  for (int64_t i = 0; i < rows_; ++i) {
+    for (auto k = indptr_[i]; k < indptr_[i + 1]; ++k) {
+      auto pos = next[indices_[k]]++;
+      indices[pos] = i;
+      values[pos] = values_[k];
+    }
+  }
+  return {schema_,
+          cols_,
+          rows_,
+          std::move(indptr),
+          std::move(indices),
+          std::move(values)};
+}
+
+std::string SparsePMatrix::ToString() const {
+  std::string res =
+      fmt::format("SparsePMatrix(shape={}x{}, nnz={})", rows_, cols_, nnz());
+  for (int64_t i = 0; i < rows_; ++i) {
+    for (auto k = indptr_[i]; k < indptr_[i + 1]; ++k) {
+      res += fmt::format("\n  ({}, {})\t{}", i, indices_[k],
+                         values_[k].ToString());
+    }
+  }
+  return res;
+}
+
+}  // namespace heu::lib::numpy
@@ -0,0 +1,79 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "heu/library/numpy/matrix.h"
+#include "heu/library/phe/phe.h"
+
+namespace heu::lib::numpy {
+
+// A 2-d plaintext matrix in CSR (compressed sparse row) format, the same
+// layout as scipy.sparse.csr_matrix. The nonzeros of row i are
+// values[indptr[i] : indptr[i+1]], located at columns
+// indices[indptr[i] : indptr[i+1]].
+//
+// Evaluator::MatMul() only visits the stored entries, so the cost is
+// proportional to nnz instead of rows * cols.
+class SparsePMatrix {
+ public:
+  SparsePMatrix(phe::SchemaType schema, int64_t rows, int64_t cols,
+                std::vector<int64_t> indptr, std::vector<int64_t> indices,
+                std::vector<phe::Plaintext> values);
+
+  // zeros in dense are not stored
+  static SparsePMatrix FromDense(phe::SchemaType schema, const PMatrix &dense);
+  [[nodiscard]] PMatrix ToDense() const;
+
+  // Returns the CSR form of the transposed matrix, which is also the CSC form
+  // of this matrix. Costs O(nnz).
+  [[nodiscard]] SparsePMatrix Transpose() const;
+
+  [[nodiscard]] phe::SchemaType GetSchemaType() const { return schema_; }
+  [[nodiscard]] int64_t rows() const { return rows_; }
+  [[nodiscard]] int64_t cols() const { return cols_; }
+  [[nodiscard]] int64_t nnz() const {
+    return static_cast<int64_t>(values_.size());
+  }
+  [[nodiscard]] Shape shape() const { return {rows_, cols_}; }
+
+  [[nodiscard]] const std::vector<int64_t> &indptr() const { return indptr_; }
+  [[nodiscard]] const std::vector<int64_t> &indices() const {
+    return indices_;
+  }
+  [[nodiscard]] const std::vector<phe::Plaintext> &values() const {
+    return values_;
+  }
+
+  [[nodiscard]] std::string ToString() const;
+
+  friend std::ostream &operator<<(std::ostream &os, const SparsePMatrix &m) {
+    return os << m.ToString();
+  }
+
+ private:
+  phe::SchemaType schema_;
+  int64_t rows_;
+  int64_t cols_;
+  std::vector<int64_t> indptr_;   // size: rows + 1
+  std::vector<int64_t> indices_;  // size: nnz
+  std::vector<phe::Plaintext> values_;
+};
+
+inline auto format_as(const SparsePMatrix &m) { return fmt::streamed(m); }
+
+}  // namespace heu::lib::numpy
@@ -0,0 +1,102 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/numpy/async.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "heu/library/numpy/test/test_tools.h"
+
+namespace heu::lib::numpy::test {
+
+TEST(HeThreadPoolTest, PriorityWorks) {
+  HeThreadPool pool(1);
+  std::promise<void> gate;
+  auto gate_future = gate.get_future().share();
+  // block the only worker, so the following tasks are queued together
+  auto blocker = pool.Submit([gate_future] { gate_future.wait(); });
+
+  std::mutex mu;
+  std::vector<int> order;
+  auto record = [&](int v) {
+    return [&, v] {
+      std::lock_guard<std::mutex> lock(mu);
+      order.push_back(v);
+    };
+  };
+  std::vector<Future<void>> futures;
+  futures.push_back(pool.Submit(record(0), TaskPriority::kLow));
+  futures.push_back(pool.Submit(record(1), TaskPriority::kNormal));
+  futures.push_back(pool.Submit(record(2), TaskPriority::kHigh));
+  futures.push_back(pool.Submit(record(3), TaskPriority::kHigh));
+  gate.set_value();
+  for (auto &f : futures) {
+    f.get();
+  }
+  EXPECT_EQ(order, (std::vector<int>{2, 3, 1, 0}));
+
+  auto failed = pool.Submit([]() -> int { YACL_THROW("task failed"); });
+  EXPECT_ANY_THROW(failed.get());
+}
+
+class AsyncTest : public ::testing::Test {
+ protected:
+  HeKit he_kit_ = HeKit(phe::HeKit(phe::SchemaType::ZPaillier, 2048));
+  AsyncEncryptor encryptor_{he_kit_.GetEncryptor()};
+  AsyncDecryptor decryptor_{he_kit_.GetDecryptor()};
+  AsyncEvaluator evaluator_{he_kit_.GetEvaluator()};
+};
+
+TEST_F(AsyncTest, PipelineWorks) {
+  auto pts1 = GenMatrix(he_kit_.GetSchemaType(), 10, 4);
+  auto pts2 = GenMatrix(he_kit_.GetSchemaType(), 10, 4, 100);
+
+  auto f1 = encryptor_.Encrypt(pts1);
+  auto f2 = encryptor_.Encrypt(pts2, TaskPriority::kHigh);
+  auto sum = evaluator_.Add(f1.get(), f2.get());
+  auto res = decryptor_.Decrypt(sum.get()).get();
+  AssertMatrixEq(res, he_kit_.GetEvaluator()->Add(pts1, pts2));
+
+  auto ct_sum = evaluator_.Sum(f1.get());
+  EXPECT_EQ(he_kit_.GetDecryptor()->Decrypt(ct_sum.get()),
+            he_kit_.GetEvaluator()->Sum(pts1));
+
+  auto product = evaluator_.MatMul(pts1.Transpose(), f2.get());
+  AssertMatrixEq(decryptor_.DecryptInRange(product.get()).get(),
+                 he_kit_.GetEvaluator()->MatMul(pts1.Transpose(), pts2));
+}
+
+TEST_F(AsyncTest, ChunksWork) {
+  auto pts = GenMatrix(he_kit_.GetSchemaType(), 11, 3);
+  auto chunks = encryptor_.EncryptInChunks(pts, 4);
+  ASSERT_EQ(chunks.size(), 3u);
+
+  int64_t row = 0;
+  for (auto &chunk : chunks) {
+    auto cts = chunk.get();
+    auto dec = decryptor_.DecryptInChunks(cts, 2);
+    for (auto &f : dec) {
+      auto part = f.get();
+      AssertMatrixEq(
+          part, pts.GetItem(Eigen::seqN(row, part.rows()),
+                            Eigen::placeholders::all));
+      row += part.rows();
+    }
+  }
+  EXPECT_EQ(row, pts.rows());
+}
+
+}  // namespace heu::lib::numpy::test
@@ -0,0 +1,115 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/numpy/dj_packing.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace heu::lib::numpy::test {
+
+TEST(DjPackingParamsTest, SelectWorks) {
+  // 96-bit slots, s=1 holds 21 slots in a 2048-bit plaintext
+  auto params = DjPackingParams::Select(10, 1e6, 32, 2048);
+  EXPECT_EQ(params.s, 1u);
+  EXPECT_EQ(params.SlotsPerPlaintext(), 21u);
+
+  // 60 elements: s=3 packs all of them into one ciphertext (4 units), while
+  // s=1 needs 3 ciphertexts (6 units)
+  params = DjPackingParams::Select(60, 1e6, 32, 2048);
+  EXPECT_EQ(params.s, 3u);
+  EXPECT_GE(params.SlotsPerPlaintext(), 60u);
+
+  params = DjPackingParams::Select(1000000, 1e6, 32, 2048, 4);
+  EXPECT_EQ(params.s, 4u);
+
+  auto buf = params.Serialize();
+  DjPackingParams params2;
+  params2.Deserialize(buf);
+  EXPECT_EQ(params2.s, params.s);
+  EXPECT_EQ(params2.padding_bits, params.padding_bits);
+}
+
+class DjPackingTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    for (int i = 0; i < 50; ++i) {
+      x_.push_back((i - 25) * 1.5);
+      y_.push_back(i * 0.25 - 3);
+    }
+  }
+
+  DjPacker packer_ = DjPacker(DjPackingParams::Select(50, 1e4, 16, 1024));
+  HeKit kit_ = packer_.SetupHeKit();
+  std::vector<double> x_, y_;
+};
+
+TEST_F(DjPackingTest, PackUnpackWorks) {
+  auto pts = packer_.Pack(x_);
+  EXPECT_LT(pts.size(), static_cast<int64_t>(x_.size()));
+  EXPECT_EQ(packer_.Unpack(pts, x_.size()), x_);
+}
+
+TEST_F(DjPackingTest, PackRoundsToNearest) {
+  // x * scale falls just below an integer, truncation would lose one unit
+  std::vector<double> values = {0.0029, -0.0029, 0.0113, -0.0232, 0.1667};
+  EXPECT_EQ(packer_.Unpack(packer_.Pack(values), values.size()), values);
+}
+
+TEST_F(DjPackingTest, SlotWiseOpsWork) {
+  const auto &evaluator = *kit_.GetEvaluator();
+  auto ct_x = packer_.Encrypt(*kit_.GetEncryptor(), x_);
+  auto ct_y = packer_.Encrypt(*kit_.GetEncryptor(), y_);
+  EXPECT_EQ(packer_.Decrypt(*kit_.GetDecryptor(), ct_x), x_);
+
+  auto sum = packer_.Add(evaluator, ct_x, ct_y);
+  EXPECT_EQ(sum.used_padding_bits, 1u);
+  auto diff = packer_.Sub(evaluator, ct_x, ct_y);
+  auto neg = packer_.Negate(evaluator, ct_x);
+  auto plain_sum = packer_.Add(evaluator, ct_x, y_);
+  auto mul = packer_.Mul(evaluator, ct_x, 3);
+  auto neg_mul = packer_.Mul(evaluator, ct_y, -5);
+
+  auto res_sum = packer_.Decrypt(*kit_.GetDecryptor(), sum);
+  auto res_diff = packer_.Decrypt(*kit_.GetDecryptor(), diff);
+  auto res_neg = packer_.Decrypt(*kit_.GetDecryptor(), neg);
+  auto res_plain_sum = packer_.Decrypt(*kit_.GetDecryptor(), plain_sum);
+  auto res_mul = packer_.Decrypt(*kit_.GetDecryptor(), mul);
+  auto res_neg_mul = packer_.Decrypt(*kit_.GetDecryptor(), neg_mul);
+  for (size_t i = 0; i < x_.size(); ++i) {
+    EXPECT_DOUBLE_EQ(res_sum[i], x_[i] + y_[i]);
+    EXPECT_DOUBLE_EQ(res_diff[i], x_[i] - y_[i]);
+    EXPECT_DOUBLE_EQ(res_neg[i], -x_[i]);
+    EXPECT_DOUBLE_EQ(res_plain_sum[i], x_[i] + y_[i]);
+    EXPECT_DOUBLE_EQ(res_mul[i], x_[i] * 3);
+    EXPECT_DOUBLE_EQ(res_neg_mul[i], y_[i] * -5);
+  }
+}
+
+TEST_F(DjPackingTest, PaddingOverflowThrows) {
+  auto ct_x = packer_.Encrypt(*kit_.GetEncryptor(), x_);
+  // 16 padding bits are reserved
+  EXPECT_THROW(packer_.Mul(*kit_.GetEvaluator(), ct_x, 1 << 16),
+               yacl::EnforceNotMet);
+  auto acc = ct_x;
+  for (int i = 0; i < 16; ++i) {
+    acc = packer_.Add(*kit_.GetEvaluator(), acc, acc);
+  }
+  EXPECT_EQ(packer_.Decrypt(*kit_.GetDecryptor(), acc)[0], x_[0] * 65536);
+  EXPECT_THROW(packer_.Add(*kit_.GetEvaluator(), acc, acc),
+               yacl::EnforceNotMet);
+}
+
+}  // namespace heu::lib::numpy::test
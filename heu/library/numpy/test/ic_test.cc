@@ -12,10 +12,18 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <string>
+#include <type_traits>
+
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/wire_format_lite.h"
 #include "gtest/gtest.h"
 
 #include "heu/library/numpy/test/test_tools.h"
 
+#include "interconnection/runtime/data_exchange.pb.h"
+
 namespace heu::lib::numpy::test {
 
 TEST(IcTest, CtSerializeIcWorks) {
@@ -41,4 +49,109 @@ TEST(IcTest, CtSerializeIcWorks) {
   AssertMatrixEq(pts1, pts3);
 }
 
+TEST(IcTest, CompatibleWithProtobuf) {
+  namespace pb_ns = org::interconnection::v2::runtime;
+  auto he_kit = HeKit(phe::HeKit(phe::SchemaType::IcPaillier, 2048));
+  auto pts = GenMatrix(he_kit.GetSchemaType(), 7, 3);
+  auto cts = he_kit.GetEncryptor()->Encrypt(pts);
+
+  // the hand-written encoding can be parsed by protobuf
+  auto buf = cts.Serialize(MatrixSerializeFormat::Interconnection);
+  pb_ns::DataExchangeProtocol dxp;
+  ASSERT_TRUE(dxp.ParseFromArray(buf.data(), buf.size()));
+  EXPECT_EQ(dxp.scalar_type(), pb_ns::SCALAR_TYPE_OBJECT);
+  EXPECT_EQ(dxp.scalar_type_name(), "ciphertext");
+  ASSERT_EQ(dxp.v_ndarray().shape_size(), 2);
+  EXPECT_EQ(dxp.v_ndarray().shape(0), 7);
+  EXPECT_EQ(dxp.v_ndarray().shape(1), 3);
+  ASSERT_EQ(dxp.v_ndarray().items_size(), cts.size());
+  for (int i = 0; i < cts.size(); ++i) {
+    phe::Ciphertext ct;
+    ct.Deserialize(dxp.v_ndarray().items(i));
+    EXPECT_EQ(ct, cts.data()[i]);
+  }
+
+  // buffers produced by protobuf can be loaded
+  auto str = dxp.SerializeAsString();
+  auto cts2 = DenseMatrix<phe::Ciphertext>::LoadFrom(
+      str, MatrixSerializeFormat::Interconnection);
+  AssertMatrixEq(cts, cts2);
+
+  // string matrix and empty items
+  DenseMatrix<std::string> strs(2, 2);
+  strs(0, 0) = "";
+  strs(1, 0) = std::string(300, 'x');
+  strs(0, 1) = "heu";
+  strs(1, 1) = "ic";
+  buf = strs.Serialize(MatrixSerializeFormat::Interconnection);
+  auto strs2 = DenseMatrix<std::string>::LoadFrom(
+      buf, MatrixSerializeFormat::Interconnection);
+  ASSERT_EQ(strs2.rows(), 2);
+  ASSERT_EQ(strs2.cols(), 2);
+  for (int i = 0; i < strs.size(); ++i) {
+    EXPECT_EQ(strs2.data()[i], strs.data()[i]);
+  }
+
+  // other containers are rejected
+  pb_ns::DataExchangeProtocol empty;
+  empty.set_scalar_type(pb_ns::SCALAR_TYPE_OBJECT);
+  str = empty.SerializeAsString();
+  EXPECT_ANY_THROW(DenseMatrix<phe::Ciphertext>::LoadFrom(
+      str, MatrixSerializeFormat::Interconnection));
+}
+
+TEST(IcTest, RejectMalformedBuffers) {
+  namespace pb_ns = org::interconnection::v2::runtime;
+  using google::protobuf::io::CodedOutputStream;
+  using google::protobuf::internal::WireFormatLite;
+  using VNdarray = std::decay_t<
+      decltype(std::declval<pb_ns::DataExchangeProtocol>().v_ndarray())>;
+  constexpr int kNdarray = pb_ns::DataExchangeProtocol::kVNdarrayFieldNumber;
+  constexpr int kItems = VNdarray::kItemsFieldNumber;
+  constexpr auto kVarint = WireFormatLite::WIRETYPE_VARINT;
+  constexpr auto kBytes = WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+
+  pb_ns::DataExchangeProtocol dxp;
+  dxp.set_scalar_type(pb_ns::SCALAR_TYPE_OBJECT);
+  const auto header = dxp.SerializeAsString();
+  // header + (tag, varint) + tail
+  auto make = [&](int field, WireFormatLite::WireType type, uint64_t value,
+                  const std::string &tail = "") {
+    std::string out = header;
+    {
+      google::protobuf::io::StringOutputStream os(&out);
+      CodedOutputStream cos(&os);
+      cos.WriteTag(WireFormatLite::MakeTag(field, type));
+      cos.WriteVarint64(value);
+    }
+    return out + tail;
+  };
+  // same, but nested as the payload of a well-formed v_ndarray field
+  auto make_nested = [&](int field, WireFormatLite::WireType type,
+                         uint64_t value, const std::string &tail = "") {
+    auto payload = make(field, type, value, tail).substr(header.size());
+    return make(kNdarray, kBytes, payload.size(), payload);
+  };
+  auto load = [](const std::string &buf) {
+    return DenseMatrix<std::string>::LoadFrom(
+        buf, MatrixSerializeFormat::Interconnection);
+  };
+
+  // well-formed: one item "abc"
+  auto good = make_nested(kItems, kBytes, 3, "abc");
+  ASSERT_EQ(load(good).data()[0], "abc");
+
+  // v_ndarray and items that are not length-delimited
+  EXPECT_ANY_THROW(load(make(kNdarray, kVarint, 3)));
+  EXPECT_ANY_THROW(load(make_nested(kItems, kVarint, 5)));
+  // lengths beyond the buffer or the enclosing message
+  EXPECT_ANY_THROW(load(make(kNdarray, kBytes, 1000, "abc")));
+  EXPECT_ANY_THROW(load(make_nested(kItems, kBytes, 1000, "abc")));
+  // lengths that do not fit in an int
+  EXPECT_ANY_THROW(load(make(kNdarray, kBytes, 0x80000000U, "abc")));
+  EXPECT_ANY_THROW(load(make_nested(kItems, kBytes, 0xffffffffU, "abc")));
+  // truncated
+  EXPECT_ANY_THROW(load(good.substr(0, good.size() - 1)));
+}
+
 }  // namespace heu::lib::numpy::test
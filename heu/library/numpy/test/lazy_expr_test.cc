@@ -0,0 +1,77 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/numpy/lazy_expr.h"
+
+#include "gtest/gtest.h"
+
+#include "heu/library/numpy/test/test_tools.h"
+
+namespace heu::lib::numpy::test {
+
+class LazyExprTest : public ::testing::Test {
+ protected:
+  HeKit he_kit_ = HeKit(phe::HeKit(phe::SchemaType::ZPaillier, 2048));
+  std::shared_ptr<Evaluator> evaluator_ = he_kit_.GetEvaluator();
+};
+
+TEST_F(LazyExprTest, FusedEvalWorks) {
+  auto x = GenMatrix(he_kit_.GetSchemaType(), 6, 4);
+  auto a = GenMatrix(he_kit_.GetSchemaType(), 6, 4, 10);
+  auto y = GenMatrix(he_kit_.GetSchemaType(), 6, 4, 100);
+  auto b = GenMatrix(he_kit_.GetSchemaType(), 1, 4, -5);  // broadcast
+  auto c = GenMatrix(he_kit_.GetSchemaType(), 6, 4, 7);
+  auto cx = he_kit_.GetEncryptor()->Encrypt(x);
+  auto cy = he_kit_.GetEncryptor()->Encrypt(y);
+
+  auto expr = LazyExpr(cx) * a + LazyExpr(cy) * b - c;
+  EXPECT_TRUE(expr.IsCiphertext());
+  EXPECT_EQ(expr.rows(), 6);
+  EXPECT_EQ(expr.cols(), 4);
+
+  auto expected = evaluator_->Sub(
+      evaluator_->Add(evaluator_->Mul(x, a), evaluator_->Mul(y, b)), c);
+  AssertMatrixEq(
+      he_kit_.GetDecryptor()->Decrypt(expr.Evaluate<phe::Ciphertext>(
+          *evaluator_)),
+      expected);
+
+  // plaintext-only expressions, negation and shared sub-expressions
+  auto sum = LazyExpr(x) + y;
+  auto pexpr = -(sum * sum) - a;
+  EXPECT_FALSE(pexpr.IsCiphertext());
+  auto s = evaluator_->Add(x, y);
+  auto pexpected = evaluator_->Sub(
+      evaluator_->Sub(evaluator_->Sub(s, s), evaluator_->Mul(s, s)), a);
+  AssertMatrixEq(pexpr.Evaluate<phe::Plaintext>(*evaluator_), pexpected);
+
+  // ciphertext on the right of sub, and a view as a leaf
+  auto view = CMatrixView(cx).Slice(0, 6, 1, 3, 1, 1);  // the last column
+  auto rexpr = LazyExpr(a) - view;
+  AssertMatrixEq(
+      he_kit_.GetDecryptor()->Decrypt(rexpr.Evaluate<phe::Ciphertext>(
+          *evaluator_)),
+      evaluator_->Sub(a, view.Materialize()));
+}
+
+TEST_F(LazyExprTest, InvalidExprThrows) {
+  auto x = GenMatrix(he_kit_.GetSchemaType(), 6, 4);
+  auto cx = he_kit_.GetEncryptor()->Encrypt(x);
+
+  EXPECT_ANY_THROW(LazyExpr(cx) * cx);
+  EXPECT_ANY_THROW(LazyExpr(x) + GenMatrix(he_kit_.GetSchemaType(), 5, 4));
+  EXPECT_ANY_THROW((LazyExpr(cx) + x).Evaluate<phe::Plaintext>(*evaluator_));
+}
+
+}  // namespace heu::lib::numpy::test
@@ -67,4 +67,54 @@ TEST_P(MatmulTest, MatmulWorks) {
   AssertMatrixEq(ans, he_kit_.GetDecryptor()->Decrypt(cts3));
 }
 
+TEST_P(MatmulTest, SparseMatmulWorks) {
+  int n = std::get<0>(GetParam());
+  int k = std::get<1>(GetParam());
+  int m = std::get<2>(GetParam());
+  auto schema = he_kit_.GetSchemaType();
+  // mostly zeros, the rest are units or random numbers
+  auto dense1 = GenMatrix(schema, n, k, 10);
+  dense1.ForEach([&](int64_t row, int64_t col, phe::Plaintext *pt) {
+    auto kind = (row * 7 + col) % 5;
+    if (kind < 3) {
+      pt->SetValue(0);
+    } else if (kind == 3) {
+      pt->SetValue(row % 2 == 0 ? 1 : -1);
+    }
+  });
+  auto dense2 = dense1.Transpose();
+  auto sparse1 = SparsePMatrix::FromDense(schema, dense1);  // n x k
+  auto sparse2 = SparsePMatrix::FromDense(schema, dense2);  // k x n
+  AssertMatrixEq(sparse1.ToDense(), dense1);
+  AssertMatrixEq(sparse1.Transpose().ToDense(), dense2);
+
+  auto evaluator = he_kit_.GetEvaluator();
+  auto decryptor = he_kit_.GetDecryptor();
+  auto pts = GenMatrix(schema, k, m, 5);
+  auto cts = he_kit_.GetEncryptor()->Encrypt(pts);
+  // sparse * ct
+  AssertMatrixEq(decryptor->Decrypt(evaluator->MatMul(sparse1, cts)),
+                 evaluator->MatMul(dense1, pts));
+  // ct * sparse
+  auto cts_t = he_kit_.GetEncryptor()->Encrypt(pts.Transpose());
+  AssertMatrixEq(decryptor->Decrypt(evaluator->MatMul(cts_t, sparse2)),
+                 evaluator->MatMul(pts.Transpose(), dense2));
+
+  // 1-d ciphertext operands
+  PMatrix vec(k, 1, 1);
+  vec.ForEach([&](int64_t row, int64_t, phe::Plaintext *pt) {
+    *pt = phe::Plaintext(schema, row - 2);
+  });
+  auto cvec = he_kit_.GetEncryptor()->Encrypt(vec);
+  auto res = evaluator->MatMul(sparse1, cvec);
+  EXPECT_EQ(res.ndim(), 1);
+  AssertMatrixEq(decryptor->Decrypt(res), evaluator->MatMul(dense1, vec));
+  res = evaluator->MatMul(cvec, sparse2);
+  EXPECT_EQ(res.ndim(), 1);
+  AssertMatrixEq(decryptor->Decrypt(res), evaluator->MatMul(vec, dense2));
+
+  auto mismatch = SparsePMatrix::FromDense(schema, GenMatrix(schema, m, k + 1));
+  EXPECT_ANY_THROW(evaluator->MatMul(mismatch, cts));
+}
+
 }  // namespace heu::lib::numpy::test
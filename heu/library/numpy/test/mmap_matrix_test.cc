@@ -0,0 +1,140 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/numpy/mmap_matrix.h"
+
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+#include "heu/library/numpy/test/test_tools.h"
+
+namespace heu::lib::numpy::test {
+
+class MmapMatrixTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = std::filesystem::temp_directory_path() /
+           fmt::format("heu_mmap_test_{}", ::getpid());
+    std::filesystem::create_directories(dir_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  std::string Path(const std::string &name) const { return dir_ / name; }
+
+  HeKit he_kit_ = HeKit(phe::HeKit(phe::SchemaType::ZPaillier, 2048));
+  std::filesystem::path dir_;
+};
+
+TEST_F(MmapMatrixTest, ReadWriteWorks) {
+  auto pts = GenMatrix(he_kit_.GetSchemaType(), 23, 3);
+  auto cts = he_kit_.GetEncryptor()->Encrypt(pts);
+  {
+    auto m = MmapCMatrix::Create(Path("x.bin"), 23, 3, 2,
+                                 MmapCMatrix::SlotBytesFor(cts(0, 0)));
+    m.WriteRows(0, CMatrixView(cts).Slice(0, 10, 1, 0, 3, 1));
+    m.WriteRows(10, CMatrixView(cts).Slice(10, 13, 1, 0, 3, 1));
+    m.Flush();
+  }
+
+  auto m = MmapCMatrix::Open(Path("x.bin"));
+  EXPECT_EQ(m.rows(), 23);
+  EXPECT_EQ(m.cols(), 3);
+  AssertMatrixEq(he_kit_.GetDecryptor()->Decrypt(m.Load()), pts);
+  AssertMatrixEq(he_kit_.GetDecryptor()->Decrypt(m.ReadRows(5, 4)),
+                 pts.GetItem(Eigen::seqN(5, 4), Eigen::placeholders::all));
+  EXPECT_ANY_THROW(m.ReadRows(20, 4));
+  EXPECT_ANY_THROW(m.WriteRows(0, cts));  // read-only
+
+  int64_t rows = 0;
+  m.ForEachChunk(5, [&](int64_t row_beg, const CMatrix &chunk) {
+    EXPECT_EQ(row_beg, rows);
+    rows += chunk.rows();
+  });
+  EXPECT_EQ(rows, 23);
+}
+
+TEST_F(MmapMatrixTest, RejectCorruptedHeader) {
+  // header fields after the 8-byte magic: rows, cols, ndim
+  auto corrupt = [&](const std::string &name, int64_t rows, int64_t cols,
+                     int64_t ndim) {
+    MmapCMatrix::Create(Path(name), 2, 2, 2, 64).Flush();
+    std::fstream f(Path(name),
+                   std::ios::in | std::ios::out | std::ios::binary);
+    int64_t fields[3] = {rows, cols, ndim};
+    f.seekp(8);
+    f.write(reinterpret_cast<const char *>(fields), sizeof(fields));
+  };
+
+  // rows * cols * slot_bytes wraps around 2^64
+  corrupt("a.bin", int64_t{1} << 40, int64_t{1} << 20, 2);
+  EXPECT_ANY_THROW(MmapCMatrix::Open(Path("a.bin")));
+  corrupt("b.bin", 2, 2, 3);
+  EXPECT_ANY_THROW(MmapCMatrix::Open(Path("b.bin")));
+  corrupt("c.bin", 2, 2, -1);
+  EXPECT_ANY_THROW(MmapCMatrix::Open(Path("c.bin")));
+  // claims more slots than the file holds
+  corrupt("d.bin", 4, 2, 2);
+  EXPECT_ANY_THROW(MmapCMatrix::Open(Path("d.bin")));
+  corrupt("e.bin", 2, 2, 2);
+  EXPECT_NO_THROW(MmapCMatrix::Open(Path("e.bin")));
+
+  EXPECT_ANY_THROW(MmapCMatrix::Create(Path("f.bin"), int64_t{1} << 40,
+                                       int64_t{1} << 20, 2, 64));
+  EXPECT_ANY_THROW(MmapCMatrix::Create(Path("g.bin"), 2, 2, 1, 64));
+}
+
+TEST_F(MmapMatrixTest, StreamingWorks) {
+  auto encryptor = he_kit_.GetEncryptor();
+  auto decryptor = he_kit_.GetDecryptor();
+  auto evaluator = he_kit_.GetEvaluator();
+  StreamingEvaluator streaming(evaluator, /* rows_per_chunk = */ 7);
+
+  auto pts = GenMatrix(he_kit_.GetSchemaType(), 30, 4);
+  auto pts2 = GenMatrix(he_kit_.GetSchemaType(), 30, 4, 100);
+  auto row = GenMatrix(he_kit_.GetSchemaType(), 1, 4, -3);
+  auto x = StreamingEvaluator::Encrypt(*encryptor, pts, Path("x.bin"), 8);
+  auto y = StreamingEvaluator::Encrypt(*encryptor, pts2, Path("y.bin"));
+  AssertMatrixEq(StreamingEvaluator::Decrypt(*decryptor, x, 9), pts);
+
+  auto check = [&](const MmapCMatrix &res, const PMatrix &expected) {
+    AssertMatrixEq(StreamingEvaluator::Decrypt(*decryptor, res), expected);
+  };
+  check(streaming.Add(x, y, Path("a.bin")), evaluator->Add(pts, pts2));
+  check(streaming.Sub(x, y, Path("b.bin")), evaluator->Sub(pts, pts2));
+  check(streaming.Add(x, pts2, Path("c.bin")), evaluator->Add(pts, pts2));
+  check(streaming.Sub(x, row, Path("d.bin")), evaluator->Sub(pts, row));
+  check(streaming.Mul(x, pts2, Path("e.bin")), evaluator->Mul(pts, pts2));
+  EXPECT_EQ(decryptor->Decrypt(streaming.Sum(x)), evaluator->Sum(pts));
+
+  RowMatrixXd order_map =
+      RowMatrixXd::NullaryExpr(30, 2, [](int64_t i, int64_t j) {
+        return static_cast<int8_t>(i * (j + 1) % 3);
+      });
+  for (bool cumsum : {false, true}) {
+    AssertMatrixEq(
+        decryptor->Decrypt(
+            streaming.FeatureWiseBucketSum(x, order_map, 3, cumsum)),
+        evaluator->FeatureWiseBucketSum(pts, order_map, 3, cumsum));
+  }
+
+  EXPECT_ANY_THROW(streaming.Add(x, GenMatrix(he_kit_.GetSchemaType(), 2, 4),
+                                 Path("f.bin")));
+}
+
+}  // namespace heu::lib::numpy::test
@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "heu/library/numpy/test/test_tools.h"
@@ -119,6 +122,75 @@ TEST_F(NumpyTest, SumWorks) {
             899 * 900 / 2);
 }
 
+TEST_F(NumpyTest, AxisSumWorks) {
+  // m(i, j) = i * 40 + j
+  auto m = GenMatrix(he_kit_.GetSchemaType(), 70, 40);
+  auto cm = he_kit_.GetEncryptor()->Encrypt(m);
+  auto evaluator = he_kit_.GetEvaluator();
+  auto decryptor = he_kit_.GetDecryptor();
+
+  auto col_sum = decryptor->Decrypt(evaluator->Sum(cm, 0));
+  ASSERT_EQ(col_sum.ndim(), 1);
+  ASSERT_EQ(col_sum.rows(), 40);
+  for (int64_t j = 0; j < 40; ++j) {
+    EXPECT_EQ(col_sum(j, 0).GetValue<int64_t>(), 40 * 69 * 70 / 2 + 70 * j);
+  }
+
+  auto row_sum = evaluator->Sum(m, -1);
+  ASSERT_EQ(row_sum.rows(), 70);
+  for (int64_t i = 0; i < 70; ++i) {
+    EXPECT_EQ(row_sum(i, 0).GetValue<int64_t>(), 40 * 40 * i + 39 * 40 / 2);
+  }
+
+  // a 1-d tensor is reduced to a scalar
+  auto vec = GenVector(he_kit_.GetSchemaType(), 100);
+  auto total = evaluator->Sum(vec, 0);
+  EXPECT_EQ(total.ndim(), 0);
+  EXPECT_EQ(total(0, 0), evaluator->Sum(vec));
+  EXPECT_ANY_THROW(evaluator->Sum(vec, 1));
+}
+
+TEST_F(NumpyTest, CumSumWorks) {
+  auto m = GenMatrix(he_kit_.GetSchemaType(), 300, 3);
+  auto cm = he_kit_.GetEncryptor()->Encrypt(m);
+  auto evaluator = he_kit_.GetEvaluator();
+  auto decryptor = he_kit_.GetDecryptor();
+
+  auto check = [&](const PMatrix &res, int64_t axis,
+                   const std::vector<int64_t> &starts) {
+    ASSERT_EQ(res.rows(), m.rows());
+    ASSERT_EQ(res.cols(), m.cols());
+    for (int64_t i = 0; i < m.rows(); ++i) {
+      for (int64_t j = 0; j < m.cols(); ++j) {
+        auto pos = axis == 0 ? i : j;
+        bool restart = std::find(starts.begin(), starts.end(), pos) !=
+                       starts.end();
+        auto expected =
+            restart ? m(i, j)
+                    : (axis == 0 ? res(i - 1, j) : res(i, j - 1)) + m(i, j);
+        EXPECT_EQ(res(i, j), expected) << "at " << i << ", " << j;
+      }
+    }
+  };
+
+  check(decryptor->Decrypt(evaluator->CumSum(cm, 0)), 0, {0});
+  check(evaluator->CumSum(m, 1), 1, {0});
+  std::vector<int64_t> starts = {0, 1, 17, 18, 150, 299};
+  check(decryptor->Decrypt(evaluator->SegmentedCumSum(cm, starts, 0)), 0,
+        starts);
+  check(evaluator->SegmentedCumSum(m, {0, 2}, -1), 1, {0, 2});
+
+  // the last element of each segment is the segment sum
+  auto seg = evaluator->SegmentedCumSum(m, starts, 0);
+  EXPECT_EQ(seg(149, 2), evaluator->Sum(m.GetItem(Eigen::seqN(18, 132),
+                                                  Eigen::seqN(2, 1))));
+
+  EXPECT_ANY_THROW(evaluator->SegmentedCumSum(m, {1, 5}, 0));
+  EXPECT_ANY_THROW(evaluator->SegmentedCumSum(m, {0, 5, 5}, 0));
+  EXPECT_ANY_THROW(evaluator->SegmentedCumSum(m, {0, 300}, 0));
+  EXPECT_ANY_THROW(evaluator->CumSum(m, 2));
+}
+
 TEST_F(NumpyTest, SelectSumWorks) {
   // plaintext case
   auto m = GenMatrix(he_kit_.GetSchemaType(), 30, 30);
@@ -205,4 +277,76 @@ TEST_F(NumpyTest, RangeCheckWorks) {
   EXPECT_NO_THROW(he_kit_.GetDecryptor()->Decrypt(cmatrix));
 }
 
+TEST_F(NumpyTest, DecryptToSinkWorks) {
+  // larger than one decryption batch
+  auto pmatrix = GenMatrix(he_kit_.GetSchemaType(), 300, 7);
+  auto cmatrix = he_kit_.GetEncryptor()->Encrypt(pmatrix);
+
+  std::vector<int64_t> res(pmatrix.size(), -1);
+  he_kit_.GetDecryptor()->DecryptInRangeTo(
+      cmatrix,
+      [&](int64_t beg, absl::Span<phe::Plaintext> pts) {
+        for (size_t i = 0; i < pts.size(); ++i) {
+          res[beg + i] = pts[i].GetValue<int64_t>();
+        }
+      },
+      64);
+  for (int64_t i = 0; i < pmatrix.size(); ++i) {
+    ASSERT_EQ(res[i], pmatrix.data()[i].GetValue<int64_t>());
+  }
+
+  he_kit_.GetEvaluator()->MulInplace(
+      &cmatrix(100, 5), phe::Plaintext(he_kit_.GetSchemaType(),
+                                       std::numeric_limits<int64_t>::max()));
+  EXPECT_ANY_THROW(he_kit_.GetDecryptor()->DecryptInRangeTo(
+      cmatrix, [](int64_t, absl::Span<phe::Plaintext>) {}, 64));
+}
+
+TEST_F(NumpyTest, MatrixViewWorks) {
+  auto pts = GenMatrix(he_kit_.GetSchemaType(), 8, 6);
+  auto cts = he_kit_.GetEncryptor()->Encrypt(pts);
+  auto evaluator = he_kit_.GetEvaluator();
+  auto decryptor = he_kit_.GetDecryptor();
+
+  // rows 1, 3, 5 and cols 4, 2, 0
+  auto pv = PMatrixView(pts).Slice(1, 3, 2, 4, 3, -2);
+  auto cv = CMatrixView(cts).Slice(1, 3, 2, 4, 3, -2);
+  auto expected = pts.GetItem(Eigen::seqN(1, 3, 2), Eigen::seqN(4, 3, -2));
+  EXPECT_EQ(pv.data(), &pts(1, 4));  // nothing is copied
+  AssertMatrixEq(pv.Materialize(), expected);
+  AssertMatrixEq(PMatrix::LoadFrom(pv.Serialize()), expected);
+  AssertMatrixEq(decryptor->Decrypt(cv), expected);
+  AssertMatrixEq(decryptor->Decrypt(he_kit_.GetEncryptor()->Encrypt(pv)),
+                 expected);
+  EXPECT_EQ(decryptor->Decrypt(evaluator->Sum(cv)), evaluator->Sum(expected));
+
+  // elementwise ops on strided and transposed views
+  AssertMatrixEq(decryptor->Decrypt(evaluator->Add(cv, pv)),
+                 evaluator->Add(expected, expected));
+  AssertMatrixEq(
+      decryptor->Decrypt(evaluator->Sub(cv.Transpose(), pv.Transpose())),
+      evaluator->Sub(expected, expected).Transpose());
+  AssertMatrixEq(
+      decryptor->Decrypt(evaluator->MatMul(PMatrixView(pts).Transpose(), cts)),
+      evaluator->MatMul(pts.Transpose(), pts));
+
+  // broadcasting only changes the strides
+  auto row = PMatrixView(pts).Slice(2, 1, 1, 0, 6, 1);
+  auto broadcast = row.BroadcastTo(8, 6, 2);
+  EXPECT_EQ(broadcast.row_stride(), 0);
+  AssertMatrixEq(evaluator->Add(pts, broadcast),
+                 evaluator->Add(pts, row.Materialize()));
+  AssertMatrixEq(decryptor->Decrypt(evaluator->Mul(cts, row)),
+                 evaluator->Mul(pts, row.Materialize()));
+
+  // squeezing a row gives a vector
+  AssertMatrixEq(
+      row.Squeeze(true, false).Materialize(),
+      pts.GetItem(Eigen::seqN(2, 1), Eigen::placeholders::all, true));
+
+  EXPECT_ANY_THROW(PMatrixView(pts).Slice(0, 9, 1, 0, 1, 1));
+  EXPECT_ANY_THROW(PMatrixView(pts).Slice(5, 4, -2, 0, 1, 1));
+  EXPECT_ANY_THROW(row.BroadcastTo(8, 5, 2));
+}
+
 }  // namespace heu::lib::numpy::test
@@ -50,17 +50,27 @@ class PyUtils {
   static decltype(auto) PickleSupport() {
     return pybind11::pickle(
         [](const T &obj) {  // __getstate__
-          auto buffer = obj.Serialize();
+          yacl::Buffer buffer;
+          {
+            // (de)serializing a big matrix may take seconds
+            pybind11::gil_scoped_release release;
+            buffer = obj.Serialize();
+          }
           return pybind11::bytes(buffer.template data<char>(), buffer.size());
         },
-        [](const pybind11::bytes &buffer) {  // __setstate__
+        // __setstate__ accepts bytes and any other contiguous buffer, such
+        // as the memoryview of an out-of-band pickle buffer, without copy
+        [](const pybind11::buffer &buffer) {
+          pybind11::buffer_info info = buffer.request();
+          yacl::ByteContainerView view(info.ptr, info.size * info.itemsize);
+          pybind11::gil_scoped_release release;
           if constexpr (std::experimental::is_detected_v<kHasLoadFromMethod,
                                                          T>) {
             // T has a static LoadFrom() function
-            return T::LoadFrom(static_cast<std::string_view>(buffer));
+            return T::LoadFrom(view);
           } else {
             T obj;
-            obj.Deserialize(static_cast<std::string_view>(buffer));
+            obj.Deserialize(view);
             return obj;
           }
         });
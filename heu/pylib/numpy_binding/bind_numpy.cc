@@ -14,12 +14,22 @@
 
 #include "heu/pylib/numpy_binding/bind_numpy.h"
 
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <optional>
+
+#include "pybind11/numpy.h"
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
 
+#include "heu/library/numpy/async.h"
+#include "heu/library/numpy/dj_packing.h"
+#include "heu/library/numpy/lazy_expr.h"
 #include "heu/library/numpy/matrix.h"
 #include "heu/library/numpy/numpy.h"
 #include "heu/library/numpy/random.h"
+#include "heu/library/numpy/sparse_matrix.h"
 #include "heu/library/numpy/toolbox.h"
 #include "heu/library/phe/base/serializable_types.h"
 #include "heu/pylib/numpy_binding/extension_functions.h"
@@ -36,14 +46,55 @@ namespace hnp = ::heu::lib::numpy;
 
 namespace {
 
+// Heavy functions release the GIL so that other python threads can run. All
+// python arguments are converted to C++ types by pybind11 before the GIL is
+// released.
+using ReleaseGil = py::call_guard<py::gil_scoped_release>;
+
 template <typename T>
 void BindMatrixCommon(py::class_<hnp::DenseMatrix<T>> &clazz) {
   clazz.def("__str__", &hnp::DenseMatrix<T>::ToString)
       .def(PyUtils::PickleSupport<hnp::DenseMatrix<T>>())
+      .def(
+          "__reduce_ex__",
+          [](const py::object &self, int protocol) {
+            auto buffer = std::make_unique<yacl::Buffer>();
+            {
+              const auto &m = self.cast<const hnp::DenseMatrix<T> &>();
+              py::gil_scoped_release release;
+              *buffer = m.Serialize();
+            }
+
+            py::object state;
+            if (protocol >= 5) {
+              // Hand the serialized buffer to pickle without copy, so that it
+              // can be transferred out-of-band. The numpy array keeps the
+              // buffer alive.
+              auto size = static_cast<py::ssize_t>(buffer->size());
+              auto *data = buffer->data<uint8_t>();
+              py::capsule owner(buffer.release(), [](void *ptr) {
+                delete static_cast<yacl::Buffer *>(ptr);
+              });
+              py::array_t<uint8_t> arr(size, data, owner);
+              state = py::module_::import("pickle").attr("PickleBuffer")(arr);
+            } else {
+              state = py::bytes(buffer->data<char>(), buffer->size());
+            }
+            // same as the default reduce of pybind11 objects, the state is
+            // passed to __setstate__
+            return py::make_tuple(
+                py::module_::import("copyreg").attr("__newobj__"),
+                py::make_tuple(py::type::of(self)), state);
+          },
+          py::arg("protocol"))
       .def(
           "serialize",
           [](const hnp::DenseMatrix<T> &m, hnp::MatrixSerializeFormat format) {
-            auto buffer = m.Serialize(format);
+            yacl::Buffer buffer;
+            {
+              py::gil_scoped_release release;
+              buffer = m.Serialize(format);
+            }
             return pybind11::bytes(buffer.template data<char>(), buffer.size());
           },
           py::arg("format") = hnp::MatrixSerializeFormat::Best,
@@ -51,9 +102,10 @@ void BindMatrixCommon(py::class_<hnp::DenseMatrix<T>> &clazz) {
       .def_static(
           "load_from",
           [](const pybind11::bytes &buffer, hnp::MatrixSerializeFormat format) {
+            auto view = static_cast<std::string_view>(buffer);
+            py::gil_scoped_release release;
             // T has a static LoadFrom() function
-            return hnp::DenseMatrix<T>::LoadFrom(
-                static_cast<std::string_view>(buffer), format);
+            return hnp::DenseMatrix<T>::LoadFrom(view, format);
           },
           py::arg("bytes_buffer"),
           py::arg("format") = hnp::MatrixSerializeFormat::Best,
@@ -73,6 +125,62 @@ void BindMatrixCommon(py::class_<hnp::DenseMatrix<T>> &clazz) {
       .def("__setitem__", &PySlicer<T>::SetItem, "Set self[key] to value");
 }
 
+// Views share the elements of the viewed array, so every function creating a
+// view keeps its parent alive
+template <typename T>
+void BindMatrixView(pybind11::module &m, py::class_<hnp::DenseMatrix<T>> &clazz,
+                    const char *name) {
+  using View = hnp::DenseMatrixView<T>;
+  py::class_<View>(m, name)
+      .def(py::init<const hnp::DenseMatrix<T> &>(), py::arg("array"),
+           py::keep_alive<1, 2>(), "View the whole array")
+      .def("__str__", &View::ToString)
+      .def(
+          "serialize",
+          [](const View &v, hnp::MatrixSerializeFormat format) {
+            yacl::Buffer buffer;
+            {
+              py::gil_scoped_release release;
+              buffer = v.Serialize(format);
+            }
+            return pybind11::bytes(buffer.template data<char>(), buffer.size());
+          },
+          py::arg("format") = hnp::MatrixSerializeFormat::Best,
+          "serialize the viewed elements to bytes, which can be loaded by "
+          "load_from() of the array type")
+      .def("transpose", &View::Transpose, py::keep_alive<0, 1>(),
+           "Transpose the view without copy")
+      .def(
+          "broadcast_to",
+          [](const View &v, const hnp::Shape &shape) {
+            return v.BroadcastTo(shape.RowsAlloc(), shape.ColsAlloc(),
+                                 shape.Ndim());
+          },
+          py::arg("shape"), py::keep_alive<0, 1>(),
+          "Broadcast the view to a new shape without copy")
+      .def("materialize", &View::Materialize, ReleaseGil(),
+           "Copy the viewed elements into a new array")
+      .def_property_readonly("rows", &View::rows, "Get the number of rows")
+      .def_property_readonly("cols", &View::cols, "Get the number of cols")
+      .def_property_readonly("size", &View::size,
+                             "Number of elements in the view")
+      .def_property_readonly("ndim", &View::ndim,
+                             "The view's number of dimensions")
+      .def_property_readonly("shape", &View::shape, "The view's shape")
+      .def("__getitem__", &PySlicer<T>::GetView, py::keep_alive<0, 1>(),
+           "Return self[key] as a view, key can only contain integers and "
+           "slices");
+  // so that an array can be passed to any function accepting a view, the
+  // conversion goes through the constructor above
+  py::implicitly_convertible<hnp::DenseMatrix<T>, View>();
+
+  clazz.def(
+      "view", [](const hnp::DenseMatrix<T> &self) { return View(self); },
+      py::keep_alive<0, 1>(),
+      "Return a view of the whole array. Slicing, transposing and "
+      "broadcasting a view do not copy any element");
+}
+
 template <typename T, typename... ARGS>
 void BindToNumpy(py::class_<hnp::PMatrix> &clazz, ARGS &&...args) {
   // We can not accept EncoderParamsT type because we cannot get schema info
@@ -148,6 +256,496 @@ void BindArrayForClass(PyClassT &m, const PyArgT &edr_arg) {
           .c_str());
 }
 
+template <typename EncoderT>
+hnp::SparsePMatrix EncodeCsr(phe::SchemaType schema, const py::tuple &shape,
+                             const py::object &indptr,
+                             const py::object &indices, const py::array &data,
+                             const EncoderT &encoder) {
+  using IndexArray =
+      py::array_t<int64_t, py::array::c_style | py::array::forcecast>;
+  YACL_ENFORCE(shape.size() == 2, "sparse array must be 2-d, got {}-d",
+               shape.size());
+  auto to_vector = [](const py::object &obj) {
+    auto arr = obj.cast<IndexArray>();
+    return std::vector<int64_t>(arr.data(), arr.data() + arr.size());
+  };
+
+  std::vector<phe::Plaintext> values;
+  if (data.size() > 0) {
+    auto pts = EncodeNdarray<EncoderT>(data, encoder);
+    values.assign(std::make_move_iterator(pts.data()),
+                  std::make_move_iterator(pts.data() + pts.size()));
+  }
+  return {schema,
+          shape[0].cast<int64_t>(),
+          shape[1].cast<int64_t>(),
+          to_vector(indptr),
+          to_vector(indices),
+          std::move(values)};
+}
+
+// scipy.sparse is not a dependency, any object providing tocsr() is accepted
+template <typename EncoderT>
+hnp::SparsePMatrix EncodeSparse(phe::SchemaType schema,
+                                const py::object &matrix,
+                                const EncoderT &encoder) {
+  auto csr = matrix.attr("tocsr")();
+  return EncodeCsr(schema, csr.attr("shape").template cast<py::tuple>(),
+                   csr.attr("indptr"), csr.attr("indices"),
+                   csr.attr("data").template cast<py::array>(), encoder);
+}
+
+template <typename EncoderParamT, typename PyClassT, typename PyArgT>
+void BindSparseArrayForClass(PyClassT &m, const PyArgT &edr_arg) {
+  m.def(
+      "sparse_array",
+      [](const phe::HeKitPublicBase &self, const py::object &matrix,
+         const EncoderParamT &encoder) {
+        return EncodeSparse(self.GetSchemaType(), matrix,
+                            encoder.Instance(self.GetSchemaType()));
+      },
+      py::arg("matrix"), edr_arg,
+      fmt::format("Create a sparse plaintext array from a scipy.sparse matrix "
+                  "using {}, zeros are not stored",
+                  py::type_id<EncoderParamT>())
+          .c_str());
+  m.def(
+      "sparse_array",
+      [](const phe::HeKitPublicBase &self, const py::tuple &shape,
+         const py::object &indptr, const py::object &indices,
+         const py::array &data, const EncoderParamT &encoder) {
+        return EncodeCsr(self.GetSchemaType(), shape, indptr, indices, data,
+                         encoder.Instance(self.GetSchemaType()));
+      },
+      py::arg("shape"), py::arg("indptr"), py::arg("indices"), py::arg("data"),
+      edr_arg,
+      fmt::format("Create a sparse plaintext array from CSR arrays using {}, "
+                  "the layout is the same as scipy.sparse.csr_matrix",
+                  py::type_id<EncoderParamT>())
+          .c_str());
+}
+
+// Fused encode and encrypt, no intermediate plaintext array is built
+template <typename EncoderParamT, typename PyClassT, typename PyArgT>
+void BindEncryptNdarray(PyClassT &m, const PyArgT &edr_arg) {
+  using EncoderT =
+      decltype(std::declval<EncoderParamT &>().Instance(phe::SchemaType()));
+
+  m.def(
+      "encrypt_ndarray",
+      [](const hnp::Encryptor &self, const py::array &ndarray,
+         const EncoderParamT &encoder) {
+        return EncryptNdarray<EncoderT>(self, ndarray,
+                                        encoder.Instance(self.GetSchemaType()));
+      },
+      py::arg("ndarray"), edr_arg,
+      fmt::format("Encode a numpy ndarray using {} and encrypt it directly, "
+                  "equivalent to encrypt(kit.array(ndarray, encoder_params)) "
+                  "but faster and uses less memory",
+                  py::type_id<EncoderParamT>())
+          .c_str());
+  m.def(
+      "encrypt_ndarray",
+      [](const hnp::Encryptor &self, const py::object &ptr,
+         const EncoderParamT &encoder) {
+        return ParseEncryptNdarray<EncoderT>(
+            self, ptr, encoder.Instance(self.GetSchemaType()));
+      },
+      py::arg("object"), edr_arg,
+      fmt::format("Encode an array-like object using {} and encrypt it "
+                  "directly",
+                  py::type_id<EncoderParamT>())
+          .c_str());
+
+  m.def("encrypt_ndarray", &EncryptNdarray<EncoderT>, py::arg("ndarray"),
+        py::arg("encoder"),
+        fmt::format("Encode a numpy ndarray using {} and encrypt it directly, "
+                    "equivalent to encrypt(hnp.array(ndarray, encoder)) but "
+                    "faster and uses less memory",
+                    py::type_id<EncoderT>())
+            .c_str());
+  m.def("encrypt_ndarray", &ParseEncryptNdarray<EncoderT>, py::arg("object"),
+        py::arg("encoder"),
+        fmt::format("Encode an array-like object using {} and encrypt it "
+                    "directly",
+                    py::type_id<EncoderT>())
+            .c_str());
+}
+
+// Fused decrypt and decode, no intermediate plaintext array is built
+template <typename T, typename PyClassT, typename... ARGS>
+void BindDecryptToNdarray(PyClassT &m, ARGS &&...args) {
+  m.def("decrypt_to_ndarray",
+        py::overload_cast<const hnp::Decryptor &, const hnp::CMatrix &,
+                          const T &, std::optional<size_t>>(
+            &DecryptToNdarray<T>),
+        py::arg("ciphertext_array"), std::forward<ARGS>(args)...,
+        py::arg("range_bits") = std::optional<size_t>(),
+        fmt::format("Decrypt a ciphertext array and decode it using {} "
+                    "directly, equivalent to decrypt(ciphertext_array)."
+                    "to_numpy(encoder) but faster and uses less memory. If "
+                    "range_bits is set, the same range checking as "
+                    "decrypt_in_range() is applied.",
+                    py::type_id<T>())
+            .c_str());
+}
+
+using PyDoubleArray =
+    py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+absl::Span<const double> ToSpan(const PyDoubleArray &arr) {
+  YACL_ENFORCE(arr.ndim() == 1, "Only 1-d array is supported, got {}-d",
+               arr.ndim());
+  return absl::MakeConstSpan(arr.data(), arr.size());
+}
+
+void BindDjPacking(pybind11::module &m) {
+  py::class_<hnp::DjPackingParams>(m, "DjPackingParams")
+      .def(py::init<size_t, uint32_t, int64_t, size_t>(), py::arg("key_size"),
+           py::arg("s"), py::arg("scale") = (int64_t)1e6,
+           py::arg("padding_bits") = 32)
+      .def_static("select", &hnp::DjPackingParams::Select,
+                  py::arg("vector_len"), py::arg("scale") = (int64_t)1e6,
+                  py::arg("padding_bits") = 32, py::arg("key_size") = 2048,
+                  py::arg("max_s") = 8,
+                  "Choose the Damgard-Jurik parameter s that minimizes the "
+                  "total ciphertext size of a vector with vector_len "
+                  "elements.\n"
+                  "scale (int): floats are multiplied by scale and stored as "
+                  "int64 in each slot.\n"
+                  "padding_bits (int): headroom of each slot, every addition "
+                  "consumes 1 bit and a multiplication by c consumes "
+                  "c.bit_length() bits.")
+      .def_readonly("key_size", &hnp::DjPackingParams::key_size)
+      .def_readonly("s", &hnp::DjPackingParams::s)
+      .def_readonly("scale", &hnp::DjPackingParams::scale)
+      .def_readonly("padding_bits", &hnp::DjPackingParams::padding_bits)
+      .def_property_readonly(
+          "slots_per_plaintext",
+          py::overload_cast<>(&hnp::DjPackingParams::SlotsPerPlaintext,
+                              py::const_),
+          "Number of elements packed into one ciphertext")
+      .def("__str__", &hnp::DjPackingParams::ToString)
+      .def("__repr__", &hnp::DjPackingParams::ToString)
+      .def(PyUtils::PickleSupport<hnp::DjPackingParams>())
+      .doc() = "Parameters of the Damgard-Jurik packing mode";
+
+  py::class_<hnp::DjPackedCMatrix>(m, "DjPackedCiphertextArray")
+      .def_readonly("ciphertexts", &hnp::DjPackedCMatrix::cts,
+                    "The packed ciphertexts, a 1-d CiphertextArray")
+      .def_readonly("size", &hnp::DjPackedCMatrix::size,
+                    "Number of packed elements")
+      .def_readonly("used_padding_bits",
+                    &hnp::DjPackedCMatrix::used_padding_bits,
+                    "Padding bits consumed by carries in each slot")
+      .def("__len__", [](const hnp::DjPackedCMatrix &x) { return x.size; })
+      .def("__str__", &hnp::DjPackedCMatrix::ToString)
+      .def("__repr__", &hnp::DjPackedCMatrix::ToString);
+
+  py::class_<hnp::DjPacker>(m, "DjPacker")
+      .def(py::init<hnp::DjPackingParams>(), py::arg("params"))
+      .def_property_readonly("params", &hnp::DjPacker::GetParams)
+      .def("setup", &hnp::DjPacker::SetupHeKit, py::return_value_policy::move,
+           ReleaseGil(),
+           "Generate a Damgard-Jurik HeKit whose s matches params")
+      .def(
+          "encrypt",
+          [](const hnp::DjPacker &self, const hnp::Encryptor &encryptor,
+             const PyDoubleArray &values) {
+            auto span = ToSpan(values);
+            py::gil_scoped_release release;
+            return self.Encrypt(encryptor, span);
+          },
+          py::arg("encryptor"), py::arg("ndarray"),
+          "Pack and encrypt a 1-d numpy array")
+      .def(
+          "decrypt",
+          [](const hnp::DjPacker &self, const hnp::Decryptor &decryptor,
+             const hnp::DjPackedCMatrix &in) {
+            std::vector<double> res;
+            {
+              py::gil_scoped_release release;
+              res = self.Decrypt(decryptor, in);
+            }
+            return py::array_t<double>(res.size(), res.data());
+          },
+          py::arg("decryptor"), py::arg("packed_array"),
+          "Decrypt and unpack to a 1-d numpy array")
+      .def("add",
+           py::overload_cast<const hnp::Evaluator &,
+                             const hnp::DjPackedCMatrix &,
+                             const hnp::DjPackedCMatrix &>(&hnp::DjPacker::Add,
+                                                           py::const_),
+           py::arg("evaluator"), py::arg("x"), py::arg("y"), ReleaseGil(),
+           "Slot-wise addition")
+      .def(
+          "add",
+          [](const hnp::DjPacker &self, const hnp::Evaluator &evaluator,
+             const hnp::DjPackedCMatrix &x, const PyDoubleArray &y) {
+            auto span = ToSpan(y);
+            py::gil_scoped_release release;
+            return self.Add(evaluator, x, span);
+          },
+          py::arg("evaluator"), py::arg("x"), py::arg("y"),
+          "Slot-wise addition with a plaintext numpy array")
+      .def("sub", &hnp::DjPacker::Sub, py::arg("evaluator"), py::arg("x"),
+           py::arg("y"), ReleaseGil(), "Slot-wise subtraction")
+      .def("negate", &hnp::DjPacker::Negate, py::arg("evaluator"),
+           py::arg("x"), ReleaseGil(), "Slot-wise negation")
+      .def("mul", &hnp::DjPacker::Mul, py::arg("evaluator"), py::arg("x"),
+           py::arg("scalar"), ReleaseGil(),
+           "Multiply every slot by an integer scalar, the scale is unchanged")
+      .doc() =
+      "Damgard-Jurik packing mode: pack many fixed-point numbers into one "
+      "ciphertext, and compute on them slot-wise";
+}
+
+template <typename T>
+void BindFuture(pybind11::module &m, const char *name) {
+  py::class_<hnp::Future<T>>(m, name)
+      .def(
+          "done",
+          [](const hnp::Future<T> &self) {
+            return self.wait_for(std::chrono::seconds(0)) ==
+                   std::future_status::ready;
+          },
+          "Return True if the task is finished")
+      .def(
+          "result",
+          [](const hnp::Future<T> &self, std::optional<double> timeout) -> T {
+            bool ready = true;
+            {
+              py::gil_scoped_release release;
+              if (timeout.has_value()) {
+                ready = self.wait_for(std::chrono::duration<double>(
+                            *timeout)) == std::future_status::ready;
+              } else {
+                self.wait();
+              }
+            }
+            if (!ready) {
+              PyErr_SetString(PyExc_TimeoutError, "Task is not finished yet");
+              throw py::error_already_set();
+            }
+            return self.get();
+          },
+          py::arg("timeout") = py::none(),
+          "Wait for the task and return its result. Raise TimeoutError if "
+          "the task is not finished within timeout seconds, or re-raise the "
+          "exception of the task")
+      .def(
+          "__await__",
+          [](const py::object &self) {
+            // wait in the default executor of the running loop, the GIL is
+            // released while waiting
+            auto asyncio = py::module_::import("asyncio");
+            auto loop = asyncio.attr("get_running_loop")();
+            return loop
+                .attr("run_in_executor")(py::none(), self.attr("result"))
+                .attr("__await__")();
+          });
+}
+
+// The async version of evaluator operations, X and Y are PMatrix or CMatrix
+template <typename X, typename Y, bool kWithMul, typename PyClassT>
+void BindAsyncBinaryOps(PyClassT &clazz) {
+  clazz.def(
+      "add_async",
+      [](std::shared_ptr<hnp::Evaluator> self, const X &x, const Y &y,
+         hnp::TaskPriority priority) {
+        return hnp::AsyncEvaluator(std::move(self)).Add(x, y, priority);
+      },
+      py::arg("x"), py::arg("y"),
+      py::arg("priority") = hnp::TaskPriority::kNormal, ReleaseGil());
+  clazz.def(
+      "sub_async",
+      [](std::shared_ptr<hnp::Evaluator> self, const X &x, const Y &y,
+         hnp::TaskPriority priority) {
+        return hnp::AsyncEvaluator(std::move(self)).Sub(x, y, priority);
+      },
+      py::arg("x"), py::arg("y"),
+      py::arg("priority") = hnp::TaskPriority::kNormal, ReleaseGil());
+  if constexpr (kWithMul) {
+    clazz.def(
+        "mul_async",
+        [](std::shared_ptr<hnp::Evaluator> self, const X &x, const Y &y,
+           hnp::TaskPriority priority) {
+          return hnp::AsyncEvaluator(std::move(self)).Mul(x, y, priority);
+        },
+        py::arg("x"), py::arg("y"),
+        py::arg("priority") = hnp::TaskPriority::kNormal, ReleaseGil());
+    clazz.def(
+        "matmul_async",
+        [](std::shared_ptr<hnp::Evaluator> self, const X &x, const Y &y,
+           hnp::TaskPriority priority) {
+          return hnp::AsyncEvaluator(std::move(self)).MatMul(x, y, priority);
+        },
+        py::arg("x"), py::arg("y"),
+        py::arg("priority") = hnp::TaskPriority::kNormal, ReleaseGil());
+  }
+}
+
+// Async APIs return a future immediately, the work is done in a dedicated HE
+// thread pool. Futures are awaitable in asyncio.
+void BindAsync(pybind11::module &m) {
+  py::enum_<hnp::TaskPriority>(m, "TaskPriority")
+      .value("Low", hnp::TaskPriority::kLow)
+      .value("Normal", hnp::TaskPriority::kNormal)
+      .value("High", hnp::TaskPriority::kHigh)
+      .export_values();
+
+  BindFuture<hnp::PMatrix>(m, "PlaintextArrayFuture");
+  BindFuture<hnp::CMatrix>(m, "CiphertextArrayFuture");
+  BindFuture<phe::Plaintext>(m, "PlaintextFuture");
+  BindFuture<phe::Ciphertext>(m, "CiphertextFuture");
+
+  py::class_<hnp::Encryptor, std::shared_ptr<hnp::Encryptor>> encryptor(
+      m.attr("Encryptor"));
+  encryptor
+      .def(
+          "encrypt_async",
+          [](std::shared_ptr<hnp::Encryptor> self, const hnp::PMatrix &in,
+             hnp::TaskPriority priority) {
+            return hnp::AsyncEncryptor(std::move(self)).Encrypt(in, priority);
+          },
+          py::arg("plaintext_array"),
+          py::arg("priority") = hnp::TaskPriority::kNormal, ReleaseGil(),
+          "Encrypt plaintext array asynchronously, return a future")
+      .def(
+          "encrypt_in_chunks",
+          [](std::shared_ptr<hnp::Encryptor> self, const hnp::PMatrix &in,
+             int64_t rows_per_chunk, hnp::TaskPriority priority) {
+            return hnp::AsyncEncryptor(std::move(self))
+                .EncryptInChunks(in, rows_per_chunk, priority);
+          },
+          py::arg("plaintext_array"), py::arg("rows_per_chunk"),
+          py::arg("priority") = hnp::TaskPriority::kNormal, ReleaseGil(),
+          "Encrypt every rows_per_chunk rows asynchronously, return a list of "
+          "futures. Earlier chunks can be sent while later ones are still "
+          "being encrypted");
+
+  py::class_<hnp::Decryptor, std::shared_ptr<hnp::Decryptor>> decryptor(
+      m.attr("Decryptor"));
+  decryptor
+      .def(
+          "decrypt_async",
+          [](std::shared_ptr<hnp::Decryptor> self, const hnp::CMatrix &in,
+             hnp::TaskPriority priority) {
+            return hnp::AsyncDecryptor(std::move(self)).Decrypt(in, priority);
+          },
+          py::arg("ciphertext_array"),
+          py::arg("priority") = hnp::TaskPriority::kNormal, ReleaseGil(),
+          "Decrypt ciphertext array asynchronously, return a future")
+      .def(
+          "decrypt_in_range_async",
+          [](std::shared_ptr<hnp::Decryptor> self, const hnp::CMatrix &in,
+             size_t range_bits, hnp::TaskPriority priority) {
+            return hnp::AsyncDecryptor(std::move(self))
+                .DecryptInRange(in, range_bits, priority);
+          },
+          py::arg("ciphertext_array"), py::arg("range_bits") = 128,
+          py::arg("priority") = hnp::TaskPriority::kNormal, ReleaseGil(),
+          "Asynchronous version of decrypt_in_range, return a future")
+      .def(
+          "decrypt_in_chunks",
+          [](std::shared_ptr<hnp::Decryptor> self, const hnp::CMatrix &in,
+             int64_t rows_per_chunk, hnp::TaskPriority priority) {
+            return hnp::AsyncDecryptor(std::move(self))
+                .DecryptInChunks(in, rows_per_chunk, priority);
+          },
+          py::arg("ciphertext_array"), py::arg("rows_per_chunk"),
+          py::arg("priority") = hnp::TaskPriority::kNormal, ReleaseGil(),
+          "Decrypt every rows_per_chunk rows asynchronously, return a list of "
+          "futures");
+
+  py::class_<hnp::Evaluator, std::shared_ptr<hnp::Evaluator>> evaluator(
+      m.attr("Evaluator"));
+  BindAsyncBinaryOps<hnp::CMatrix, hnp::CMatrix, false>(evaluator);
+  BindAsyncBinaryOps<hnp::CMatrix, hnp::PMatrix, true>(evaluator);
+  BindAsyncBinaryOps<hnp::PMatrix, hnp::CMatrix, true>(evaluator);
+  BindAsyncBinaryOps<hnp::PMatrix, hnp::PMatrix, true>(evaluator);
+  evaluator
+      .def(
+          "sum_async",
+          [](std::shared_ptr<hnp::Evaluator> self, const hnp::PMatrix &x,
+             hnp::TaskPriority priority) {
+            return hnp::AsyncEvaluator(std::move(self)).Sum(x, priority);
+          },
+          py::arg("x"), py::arg("priority") = hnp::TaskPriority::kNormal,
+          ReleaseGil())
+      .def(
+          "sum_async",
+          [](std::shared_ptr<hnp::Evaluator> self, const hnp::CMatrix &x,
+             hnp::TaskPriority priority) {
+            return hnp::AsyncEvaluator(std::move(self)).Sum(x, priority);
+          },
+          py::arg("x"), py::arg("priority") = hnp::TaskPriority::kNormal,
+          ReleaseGil());
+}
+
+// The leaves of an expression are not copied, so every expression keeps its
+// operands alive
+template <typename T>
+void BindLazyLeaf(py::class_<hnp::LazyExpr> &expr, py::class_<T> clazz) {
+  expr.def(py::init<const T &>(), py::arg("leaf"), py::keep_alive<1, 2>());
+  py::implicitly_convertible<T, hnp::LazyExpr>();
+  clazz.def(
+      "lazy", [](const T &self) { return hnp::LazyExpr(self); },
+      py::keep_alive<0, 1>(),
+      "Start a lazy elementwise expression, which is evaluated in one pass "
+      "without temporary arrays");
+}
+
+void BindLazyExpr(pybind11::module &m) {
+  py::class_<hnp::LazyExpr> expr(m, "LazyExpression");
+  BindLazyLeaf(expr, py::class_<hnp::PMatrix>(m.attr("PlaintextArray")));
+  BindLazyLeaf(expr, py::class_<hnp::CMatrix>(m.attr("CiphertextArray")));
+  BindLazyLeaf(expr,
+               py::class_<hnp::PMatrixView>(m.attr("PlaintextArrayView")));
+  BindLazyLeaf(expr,
+               py::class_<hnp::CMatrixView>(m.attr("CiphertextArrayView")));
+
+  using Expr = const hnp::LazyExpr &;
+  expr.def("__str__", &hnp::LazyExpr::ToString)
+      .def("__add__", [](Expr x, Expr y) { return x + y; }, py::is_operator(),
+           py::keep_alive<0, 1>(), py::keep_alive<0, 2>())
+      .def("__radd__", [](Expr x, Expr y) { return y + x; },
+           py::is_operator(), py::keep_alive<0, 1>(), py::keep_alive<0, 2>())
+      .def("__sub__", [](Expr x, Expr y) { return x - y; }, py::is_operator(),
+           py::keep_alive<0, 1>(), py::keep_alive<0, 2>())
+      .def("__rsub__", [](Expr x, Expr y) { return y - x; },
+           py::is_operator(), py::keep_alive<0, 1>(), py::keep_alive<0, 2>())
+      .def("__mul__", [](Expr x, Expr y) { return x * y; }, py::is_operator(),
+           py::keep_alive<0, 1>(), py::keep_alive<0, 2>())
+      .def("__rmul__", [](Expr x, Expr y) { return y * x; },
+           py::is_operator(), py::keep_alive<0, 1>(), py::keep_alive<0, 2>())
+      .def("__neg__", [](Expr x) { return -x; }, py::keep_alive<0, 1>())
+      .def_property_readonly("is_ciphertext", &hnp::LazyExpr::IsCiphertext,
+                             "True if the result is a CiphertextArray")
+      .def_property_readonly("shape", &hnp::LazyExpr::shape,
+                             "The shape of the result")
+      .def(
+          "evaluate",
+          [](Expr self, const hnp::Evaluator &evaluator) -> py::object {
+            if (self.IsCiphertext()) {
+              auto res = [&] {
+                py::gil_scoped_release release;
+                return self.Evaluate<phe::Ciphertext>(evaluator);
+              }();
+              return py::cast(std::move(res));
+            }
+            auto res = [&] {
+              py::gil_scoped_release release;
+              return self.Evaluate<phe::Plaintext>(evaluator);
+            }();
+            return py::cast(std::move(res));
+          },
+          py::arg("evaluator"),
+          "Evaluate the whole expression element by element in one pass. "
+          "Returns a CiphertextArray if any operand is encrypted, otherwise a "
+          "PlaintextArray");
+}
+
 }  // namespace
 
 void PyBindNumpy(pybind11::module &m) {
@@ -202,8 +800,12 @@ void PyBindNumpy(pybind11::module &m) {
       "to_bytes",
       [](const hnp::PMatrix &pm, size_t bytes_per_int,
          const std::string &endian) {
-        auto buf = hnp::Toolbox::PMatrixToBytes(pm, bytes_per_int,
-                                                PyUtils::PyEndianToCpp(endian));
+        auto cpp_endian = PyUtils::PyEndianToCpp(endian);
+        yacl::Buffer buf;
+        {
+          py::gil_scoped_release release;
+          buf = hnp::Toolbox::PMatrixToBytes(pm, bytes_per_int, cpp_endian);
+        }
         return py::bytes(buf.data<char>(), buf.size());  // this is a copy
       },
       py::arg("bytes_per_int"), py::arg("endian"),
@@ -215,6 +817,22 @@ void PyBindNumpy(pybind11::module &m) {
   // bind cmatrix
   auto cmatrix = py::class_<hnp::CMatrix>(m, "CiphertextArray");
   BindMatrixCommon(cmatrix);
+  BindMatrixView(m, pmatrix, "PlaintextArrayView");
+  BindMatrixView(m, cmatrix, "CiphertextArrayView");
+  py::class_<hnp::SparsePMatrix>(m, "SparsePlaintextArray")
+      .def("__str__", &hnp::SparsePMatrix::ToString)
+      .def("to_dense", &hnp::SparsePMatrix::ToDense, ReleaseGil(),
+           "Convert to a dense PlaintextArray")
+      .def("transpose", &hnp::SparsePMatrix::Transpose, ReleaseGil(),
+           "Return the transposed sparse array")
+      .def_property_readonly("rows", &hnp::SparsePMatrix::rows,
+                             "Get the number of rows")
+      .def_property_readonly("cols", &hnp::SparsePMatrix::cols,
+                             "Get the number of cols")
+      .def_property_readonly("nnz", &hnp::SparsePMatrix::nnz,
+                             "Get the number of stored entries")
+      .def_property_readonly("shape", &hnp::SparsePMatrix::shape,
+                             "Get the shape of array");
   auto strmatrix = py::class_<hnp::DenseMatrix<std::string>>(m, "StringArray");
   BindMatrixCommon(strmatrix);
 
@@ -230,10 +848,12 @@ void PyBindNumpy(pybind11::module &m) {
   py::class_<hnp::Random>(m, "random")
       .def_static("randint", &hnp::Random::RandInt, py::arg("min"),
                   py::arg("max"), py::arg("shape"),
+                  ReleaseGil(),
                   "Return a random integer array from the “discrete uniform” "
                   "distribution in interval [min, max)")
       .def_static("randbits", &hnp::Random::RandBits, py::arg("schema"),
                   py::arg("bits"), py::arg("shape"),
+                  ReleaseGil(),
                   "Return a random integer array where each element is 'bits' "
                   "bits long");
 
@@ -254,6 +874,12 @@ void PyBindNumpy(pybind11::module &m) {
                                                  py::arg("encoder_params"));
   BindArrayForClass<PyBatchFloatEncoderParams>(he_kit,
                                                py::arg("encoder_params"));
+  BindSparseArrayForClass<PyBigintEncoderParams>(
+      he_kit, py::arg("encoder_params") = PyBigintEncoderParams());
+  BindSparseArrayForClass<PyIntegerEncoderParams>(he_kit,
+                                                  py::arg("encoder_params"));
+  BindSparseArrayForClass<PyFloatEncoderParams>(he_kit,
+                                                py::arg("encoder_params"));
 
   m.def(
       "setup",
@@ -261,7 +887,7 @@ void PyBindNumpy(pybind11::module &m) {
         return hnp::HeKit(phe::HeKit(schema_type, key_size));
       },
       py::arg("schema_type"), py::arg("key_size"),
-      py::return_value_policy::move,
+      py::return_value_policy::move, ReleaseGil(),
       "Setup phe (numpy) environment by schema type and key size");
 
   m.def(
@@ -271,7 +897,7 @@ void PyBindNumpy(pybind11::module &m) {
             phe::HeKit(phe::ParseSchemaType(schema_string), key_size));
       },
       py::arg("schema_string"), py::arg("key_size"),
-      py::return_value_policy::move,
+      py::return_value_policy::move, ReleaseGil(),
       "Setup phe (numpy) environment by schema string and key size");
 
   m.def(
@@ -280,7 +906,7 @@ void PyBindNumpy(pybind11::module &m) {
         return hnp::HeKit(phe::HeKit(schema_type));
       },
       py::arg("schema_type") = phe::SchemaType::ZPaillier,
-      py::return_value_policy::move,
+      py::return_value_policy::move, ReleaseGil(),
       "Setup phe (numpy) environment by schema type");
 
   m.def(
@@ -289,6 +915,7 @@ void PyBindNumpy(pybind11::module &m) {
         return hnp::HeKit(phe::HeKit(phe::ParseSchemaType(schema_string)));
       },
       py::arg("schema_string") = "z-paillier", py::return_value_policy::move,
+      ReleaseGil(),
       "Setup phe (numpy) environment by schema string");
 
   // api for evaluator party
@@ -308,6 +935,12 @@ void PyBindNumpy(pybind11::module &m) {
                                                  py::arg("encoder_params"));
   BindArrayForClass<PyBatchFloatEncoderParams>(dhe_kit,
                                                py::arg("encoder_params"));
+  BindSparseArrayForClass<PyBigintEncoderParams>(
+      dhe_kit, py::arg("encoder_params") = PyBigintEncoderParams());
+  BindSparseArrayForClass<PyIntegerEncoderParams>(dhe_kit,
+                                                  py::arg("encoder_params"));
+  BindSparseArrayForClass<PyFloatEncoderParams>(dhe_kit,
+                                                py::arg("encoder_params"));
 
   m.def(
       "setup",
@@ -318,7 +951,9 @@ void PyBindNumpy(pybind11::module &m) {
       "Setup phe (numpy) environment by an already generated public key");
 
   /****** encryption ******/
-  py::class_<hnp::Encryptor, std::shared_ptr<hnp::Encryptor>>(m, "Encryptor")
+  auto encryptor =
+      py::class_<hnp::Encryptor, std::shared_ptr<hnp::Encryptor>>(m,
+                                                                  "Encryptor")
       // This is a workaround. If we use inheritance, the function of the same
       // name in parent (phe::Encryptor) will be hidden, which may be a bug of
       // pybind11
@@ -328,19 +963,37 @@ void PyBindNumpy(pybind11::module &m) {
       .def("encrypt",
            py::overload_cast<const phe::Plaintext &>(&hnp::Encryptor::Encrypt,
                                                      py::const_),
-           py::arg("plaintext"),
+           py::arg("plaintext"), ReleaseGil(),
            "Encrypt plaintext (scalar) to ciphertext (scalar)")
       .def("encrypt",
            py::overload_cast<const hnp::PMatrix &>(&hnp::Encryptor::Encrypt,
                                                    py::const_),
-           py::arg("plaintext_array"),
+           py::arg("plaintext_array"), ReleaseGil(),
            "Encrypt plaintext array to ciphertext array")
+      .def("encrypt",
+           py::overload_cast<const hnp::PMatrixView &>(
+               &hnp::Encryptor::Encrypt, py::const_),
+           py::arg("plaintext_array_view"), ReleaseGil(),
+           "Encrypt the viewed plaintexts to ciphertext array")
       .def("encrypt_with_audit", &hnp::Encryptor::EncryptWithAudit,
+           ReleaseGil(),
            "Encrypt and build audit string including "
            "plaintext/random/ciphertext info");
+  BindEncryptNdarray<PyBigintEncoderParams>(
+      encryptor, py::arg("encoder_params") = PyBigintEncoderParams());
+  BindEncryptNdarray<PyIntegerEncoderParams>(encryptor,
+                                             py::arg("encoder_params"));
+  BindEncryptNdarray<PyFloatEncoderParams>(encryptor,
+                                           py::arg("encoder_params"));
+  BindEncryptNdarray<PyBatchIntegerEncoderParams>(encryptor,
+                                                  py::arg("encoder_params"));
+  BindEncryptNdarray<PyBatchFloatEncoderParams>(encryptor,
+                                                py::arg("encoder_params"));
 
   /****** decryption ******/
-  py::class_<hnp::Decryptor, std::shared_ptr<hnp::Decryptor>>(m, "Decryptor")
+  auto decryptor =
+      py::class_<hnp::Decryptor, std::shared_ptr<hnp::Decryptor>>(m,
+                                                                  "Decryptor")
       // This is a workaround. If we use inheritance, the function of the same
       // name in parent (phe::Decryptor) will be hidden, which may be a bug of
       // pybind11
@@ -349,17 +1002,22 @@ void PyBindNumpy(pybind11::module &m) {
       .def("decrypt",
            py::overload_cast<const phe::Ciphertext &>(&hnp::Decryptor::Decrypt,
                                                       py::const_),
-           py::arg("ciphertext"),
+           py::arg("ciphertext"), ReleaseGil(),
            "Decrypt ciphertext (scalar) to plaintext (scalar)")
       .def("decrypt",
            py::overload_cast<const hnp::CMatrix &>(&hnp::Decryptor::Decrypt,
                                                    py::const_),
-           py::arg("ciphertext_array"),
+           py::arg("ciphertext_array"), ReleaseGil(),
            "Decrypt ciphertext array to plaintext array")
+      .def("decrypt",
+           py::overload_cast<const hnp::CMatrixView &>(
+               &hnp::Decryptor::Decrypt, py::const_),
+           py::arg("ciphertext_array_view"), ReleaseGil(),
+           "Decrypt the viewed ciphertexts to plaintext array")
       .def("decrypt_in_range",
            py::overload_cast<const phe::Ciphertext &, size_t>(
                &hnp::Decryptor::DecryptInRange, py::const_),
-           py::arg("ciphertext"), py::arg("range_bits") = 128,
+           py::arg("ciphertext"), py::arg("range_bits") = 128, ReleaseGil(),
            "Decrypt ciphertext (scalar) and make sure plaintext is in range "
            "(-2^range_bits, 2^range_bits). Range checking is used to block OU "
            "plaintext overflow attack, see HEU documentation for details.\n"
@@ -367,11 +1025,24 @@ void PyBindNumpy(pybind11::module &m) {
       .def("decrypt_in_range",
            py::overload_cast<const hnp::CMatrix &, size_t>(
                &hnp::Decryptor::DecryptInRange, py::const_),
-           py::arg("CMatrix"), py::arg("range_bits") = 128,
+           py::arg("CMatrix"), py::arg("range_bits") = 128, ReleaseGil(),
            "Decrypt ciphertext array and make sure each plaintext is in range "
            "(-2^range_bits, 2^range_bits). Range checking is used to block OU "
            "plaintext overflow attack, see HEU documentation for details.\n"
-           "throws an exception if plaintext is out of range.");
+           "throws an exception if plaintext is out of range.")
+      .def("decrypt_in_range",
+           py::overload_cast<const hnp::CMatrixView &, size_t>(
+               &hnp::Decryptor::DecryptInRange, py::const_),
+           py::arg("ciphertext_array_view"), py::arg("range_bits") = 128,
+           ReleaseGil(),
+           "Decrypt the viewed ciphertexts with range checking, see the "
+           "CMatrix version for details");
+  BindDecryptToNdarray<PyBigintDecoder>(
+      decryptor, py::arg("encoder") = PyBigintDecoder());
+  BindDecryptToNdarray<PyIntegerEncoder>(decryptor, py::arg("encoder"));
+  BindDecryptToNdarray<PyFloatEncoder>(decryptor, py::arg("encoder"));
+  BindDecryptToNdarray<PyBatchIntegerEncoder>(decryptor, py::arg("encoder"));
+  BindDecryptToNdarray<PyBatchFloatEncoder>(decryptor, py::arg("encoder"));
 
   /****** evaluation ******/
   py::class_<hnp::Evaluator, std::shared_ptr<hnp::Evaluator>>(m, "Evaluator")
@@ -380,43 +1051,207 @@ void PyBindNumpy(pybind11::module &m) {
       // pybind11
       .def_property_readonly(
           "phe", [](hnp::Evaluator &self) -> phe::Evaluator & { return self; })
-      .def("add", py::overload_cast<const hnp::CMatrix &, const hnp::CMatrix &>(
-                      &hnp::Evaluator::Add, py::const_))
-      .def("add", py::overload_cast<const hnp::CMatrix &, const hnp::PMatrix &>(
-                      &hnp::Evaluator::Add, py::const_))
-      .def("add", py::overload_cast<const hnp::PMatrix &, const hnp::CMatrix &>(
-                      &hnp::Evaluator::Add, py::const_))
-      .def("add", py::overload_cast<const hnp::PMatrix &, const hnp::PMatrix &>(
-                      &hnp::Evaluator::Add, py::const_))
-
-      .def("sub", py::overload_cast<const hnp::CMatrix &, const hnp::CMatrix &>(
-                      &hnp::Evaluator::Sub, py::const_))
-      .def("sub", py::overload_cast<const hnp::CMatrix &, const hnp::PMatrix &>(
-                      &hnp::Evaluator::Sub, py::const_))
-      .def("sub", py::overload_cast<const hnp::PMatrix &, const hnp::CMatrix &>(
-                      &hnp::Evaluator::Sub, py::const_))
-      .def("sub", py::overload_cast<const hnp::PMatrix &, const hnp::PMatrix &>(
-                      &hnp::Evaluator::Sub, py::const_))
-
-      .def("mul", py::overload_cast<const hnp::CMatrix &, const hnp::PMatrix &>(
-                      &hnp::Evaluator::Mul, py::const_))
-      .def("mul", py::overload_cast<const hnp::PMatrix &, const hnp::CMatrix &>(
-                      &hnp::Evaluator::Mul, py::const_))
-      .def("mul", py::overload_cast<const hnp::PMatrix &, const hnp::PMatrix &>(
-                      &hnp::Evaluator::Mul, py::const_))
+      .def("add",
+           py::overload_cast<const hnp::CMatrix &, const hnp::CMatrix &>(
+               &hnp::Evaluator::Add, py::const_),
+           ReleaseGil())
+      .def("add",
+           py::overload_cast<const hnp::CMatrix &, const hnp::PMatrix &>(
+               &hnp::Evaluator::Add, py::const_),
+           ReleaseGil())
+      .def("add",
+           py::overload_cast<const hnp::PMatrix &, const hnp::CMatrix &>(
+               &hnp::Evaluator::Add, py::const_),
+           ReleaseGil())
+      .def("add",
+           py::overload_cast<const hnp::PMatrix &, const hnp::PMatrix &>(
+               &hnp::Evaluator::Add, py::const_),
+           ReleaseGil())
+
+      .def("sub",
+           py::overload_cast<const hnp::CMatrix &, const hnp::CMatrix &>(
+               &hnp::Evaluator::Sub, py::const_),
+           ReleaseGil())
+      .def("sub",
+           py::overload_cast<const hnp::CMatrix &, const hnp::PMatrix &>(
+               &hnp::Evaluator::Sub, py::const_),
+           ReleaseGil())
+      .def("sub",
+           py::overload_cast<const hnp::PMatrix &, const hnp::CMatrix &>(
+               &hnp::Evaluator::Sub, py::const_),
+           ReleaseGil())
+      .def("sub",
+           py::overload_cast<const hnp::PMatrix &, const hnp::PMatrix &>(
+               &hnp::Evaluator::Sub, py::const_),
+           ReleaseGil())
+
+      .def("mul",
+           py::overload_cast<const hnp::CMatrix &, const hnp::PMatrix &>(
+               &hnp::Evaluator::Mul, py::const_),
+           ReleaseGil())
+      .def("mul",
+           py::overload_cast<const hnp::PMatrix &, const hnp::CMatrix &>(
+               &hnp::Evaluator::Mul, py::const_),
+           ReleaseGil())
+      .def("mul",
+           py::overload_cast<const hnp::PMatrix &, const hnp::PMatrix &>(
+               &hnp::Evaluator::Mul, py::const_),
+           ReleaseGil())
 
       .def("matmul",
            py::overload_cast<const hnp::PMatrix &, const hnp::PMatrix &>(
-               &hnp::Evaluator::MatMul, py::const_))
+               &hnp::Evaluator::MatMul, py::const_),
+           ReleaseGil())
       .def("matmul",
            py::overload_cast<const hnp::PMatrix &, const hnp::CMatrix &>(
-               &hnp::Evaluator::MatMul, py::const_))
+               &hnp::Evaluator::MatMul, py::const_),
+           ReleaseGil())
       .def("matmul",
            py::overload_cast<const hnp::CMatrix &, const hnp::PMatrix &>(
-               &hnp::Evaluator::MatMul, py::const_))
+               &hnp::Evaluator::MatMul, py::const_),
+           ReleaseGil())
 
-      .def("sum", &hnp::Evaluator::Sum<phe::Plaintext>)
-      .def("sum", &hnp::Evaluator::Sum<phe::Ciphertext>)
+      .def("sum",
+           py::overload_cast<const hnp::PMatrix &>(
+               &hnp::Evaluator::Sum<phe::Plaintext>, py::const_),
+           ReleaseGil())
+      .def("sum",
+           py::overload_cast<const hnp::CMatrix &>(
+               &hnp::Evaluator::Sum<phe::Ciphertext>, py::const_),
+           ReleaseGil())
+
+      // The view versions are tried after the array versions, so arrays never
+      // go through the implicit conversion to views
+      .def("add",
+           py::overload_cast<const hnp::CMatrixView &,
+                             const hnp::CMatrixView &>(&hnp::Evaluator::Add,
+                                                       py::const_),
+           ReleaseGil())
+      .def("add",
+           py::overload_cast<const hnp::CMatrixView &,
+                             const hnp::PMatrixView &>(&hnp::Evaluator::Add,
+                                                       py::const_),
+           ReleaseGil())
+      .def("add",
+           py::overload_cast<const hnp::PMatrixView &,
+                             const hnp::CMatrixView &>(&hnp::Evaluator::Add,
+                                                       py::const_),
+           ReleaseGil())
+      .def("add",
+           py::overload_cast<const hnp::PMatrixView &,
+                             const hnp::PMatrixView &>(&hnp::Evaluator::Add,
+                                                       py::const_),
+           ReleaseGil())
+      .def("sub",
+           py::overload_cast<const hnp::CMatrixView &,
+                             const hnp::CMatrixView &>(&hnp::Evaluator::Sub,
+                                                       py::const_),
+           ReleaseGil())
+      .def("sub",
+           py::overload_cast<const hnp::CMatrixView &,
+                             const hnp::PMatrixView &>(&hnp::Evaluator::Sub,
+                                                       py::const_),
+           ReleaseGil())
+      .def("sub",
+           py::overload_cast<const hnp::PMatrixView &,
+                             const hnp::CMatrixView &>(&hnp::Evaluator::Sub,
+                                                       py::const_),
+           ReleaseGil())
+      .def("sub",
+           py::overload_cast<const hnp::PMatrixView &,
+                             const hnp::PMatrixView &>(&hnp::Evaluator::Sub,
+                                                       py::const_),
+           ReleaseGil())
+      .def("mul",
+           py::overload_cast<const hnp::CMatrixView &,
+                             const hnp::PMatrixView &>(&hnp::Evaluator::Mul,
+                                                       py::const_),
+           ReleaseGil())
+      .def("mul",
+           py::overload_cast<const hnp::PMatrixView &,
+                             const hnp::CMatrixView &>(&hnp::Evaluator::Mul,
+                                                       py::const_),
+           ReleaseGil())
+      .def("mul",
+           py::overload_cast<const hnp::PMatrixView &,
+                             const hnp::PMatrixView &>(&hnp::Evaluator::Mul,
+                                                       py::const_),
+           ReleaseGil())
+      .def("matmul",
+           py::overload_cast<const hnp::PMatrixView &,
+                             const hnp::PMatrixView &>(&hnp::Evaluator::MatMul,
+                                                       py::const_),
+           ReleaseGil())
+      .def("matmul",
+           py::overload_cast<const hnp::PMatrixView &,
+                             const hnp::CMatrixView &>(&hnp::Evaluator::MatMul,
+                                                       py::const_),
+           ReleaseGil())
+      .def("matmul",
+           py::overload_cast<const hnp::CMatrixView &,
+                             const hnp::PMatrixView &>(&hnp::Evaluator::MatMul,
+                                                       py::const_),
+           ReleaseGil())
+      .def("matmul",
+           py::overload_cast<const hnp::SparsePMatrix &,
+                             const hnp::CMatrixView &>(&hnp::Evaluator::MatMul,
+                                                       py::const_),
+           ReleaseGil(),
+           "Sparse-dense matmul, only the stored entries of the sparse array "
+           "are computed")
+      .def("matmul",
+           py::overload_cast<const hnp::CMatrixView &,
+                             const hnp::SparsePMatrix &>(
+               &hnp::Evaluator::MatMul, py::const_),
+           ReleaseGil(),
+           "Dense-sparse matmul, only the stored entries of the sparse array "
+           "are computed")
+      .def("sum",
+           py::overload_cast<const hnp::PMatrixView &>(
+               &hnp::Evaluator::Sum<phe::Plaintext>, py::const_),
+           ReleaseGil())
+      .def("sum",
+           py::overload_cast<const hnp::CMatrixView &>(
+               &hnp::Evaluator::Sum<phe::Ciphertext>, py::const_),
+           ReleaseGil())
+      .def("sum",
+           py::overload_cast<const hnp::PMatrixView &, int64_t>(
+               &hnp::Evaluator::Sum<phe::Plaintext>, py::const_),
+           py::arg("x"), py::arg("axis"), ReleaseGil(),
+           "Sum along an axis, same as numpy.sum(x, axis)")
+      .def("sum",
+           py::overload_cast<const hnp::CMatrixView &, int64_t>(
+               &hnp::Evaluator::Sum<phe::Ciphertext>, py::const_),
+           py::arg("x"), py::arg("axis"), ReleaseGil(),
+           "Sum along an axis, same as numpy.sum(x, axis)")
+      .def("cumsum",
+           py::overload_cast<const hnp::PMatrixView &, int64_t>(
+               &hnp::Evaluator::CumSum<phe::Plaintext>, py::const_),
+           py::arg("x"), py::arg("axis"), ReleaseGil(),
+           "Cumulative sum along an axis, same as numpy.cumsum(x, axis)")
+      .def("cumsum",
+           py::overload_cast<const hnp::CMatrixView &, int64_t>(
+               &hnp::Evaluator::CumSum<phe::Ciphertext>, py::const_),
+           py::arg("x"), py::arg("axis"), ReleaseGil(),
+           "Cumulative sum along an axis, same as numpy.cumsum(x, axis)")
+      .def("segmented_cumsum",
+           py::overload_cast<const hnp::PMatrixView &,
+                             const std::vector<int64_t> &, int64_t>(
+               &hnp::Evaluator::SegmentedCumSum<phe::Plaintext>, py::const_),
+           py::arg("x"), py::arg("segment_starts"), py::arg("axis"),
+           ReleaseGil(),
+           "Cumulative sum along an axis which restarts at every segment "
+           "start. segment_starts must be strictly increasing and begin with "
+           "0, like the indices of numpy.add.reduceat()")
+      .def("segmented_cumsum",
+           py::overload_cast<const hnp::CMatrixView &,
+                             const std::vector<int64_t> &, int64_t>(
+               &hnp::Evaluator::SegmentedCumSum<phe::Ciphertext>, py::const_),
+           py::arg("x"), py::arg("segment_starts"), py::arg("axis"),
+           ReleaseGil(),
+           "Cumulative sum along an axis which restarts at every segment "
+           "start. segment_starts must be strictly increasing and begin with "
+           "0, like the indices of numpy.add.reduceat()")
 
       .def("select_sum",
            &heu::pylib::ExtensionFunctions<phe::Plaintext>::SelectSum,
@@ -439,6 +1274,7 @@ void PyBindNumpy(pybind11::module &m) {
       .def(
           "feature_wise_bucket_sum",
           &heu::pylib::ExtensionFunctions<phe::Plaintext>::FeatureWiseBucketSum,
+          ReleaseGil(),
           "Take elements in x according to order_map to caculate the row sum \n"
           "at each bin.\n"
           "(Plaintext)\n"
@@ -457,6 +1293,7 @@ void PyBindNumpy(pybind11::module &m) {
       .def("feature_wise_bucket_sum",
            &heu::pylib::ExtensionFunctions<
                phe::Ciphertext>::FeatureWiseBucketSum,
+           ReleaseGil(),
            "Take elements in x according to order_map to caculate the row sum\n"
            "at each bin.\n"
            "(Ciphertext)\n"
@@ -477,6 +1314,7 @@ void PyBindNumpy(pybind11::module &m) {
           "batch_feature_wise_bucket_sum",
           &heu::pylib::ExtensionFunctions<
               phe::Plaintext>::BatchFeatureWiseBucketSum,
+          ReleaseGil(),
           "Take elements in x according to order_map to caculate the row sum \n"
           "at each bin for each subgroup\n"
           "(Plaintext)\n"
@@ -496,6 +1334,7 @@ void PyBindNumpy(pybind11::module &m) {
           "batch_feature_wise_bucket_sum",
           &heu::pylib::ExtensionFunctions<
               phe::Ciphertext>::BatchFeatureWiseBucketSum,
+          ReleaseGil(),
           "Take elements in x according to order_map to caculate the row sum \n"
           "at each bin for each subgroup\n"
           "(Ciphertext)\n"
@@ -512,12 +1351,23 @@ void PyBindNumpy(pybind11::module &m) {
           "return list of dense matrix<T>, the row bin sum results. \n"
           "Each element has shape (bucket_num * feature_num, x.cols()).\n");
 
+  /****** async api ******/
+  BindAsync(m);
+
+  /****** lazy elementwise expressions ******/
+  BindLazyExpr(m);
+
+  /****** Damgard-Jurik packing mode ******/
+  BindDjPacking(m);
+
   // pure numpy functions that support xgb
   m.def("tree_predict", &heu::pylib::PureNumpyExtensionFunctions::TreePredict,
+        ReleaseGil(),
         "Compute tree predict based on split features and points, the tree is "
         "complete.\n");
   m.def("tree_predict_with_indices",
         &heu::pylib::PureNumpyExtensionFunctions::TreePredictWithIndices,
+        ReleaseGil(),
         "Compute tree predict based on split features and points, the tree may "
         "be unbalanced.\n");
 }
@@ -14,7 +14,10 @@
 
 #include "heu/pylib/numpy_binding/extension_functions.h"
 
+#include <optional>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include "fmt/ranges.h"
 #include "yacl/utils/parallel.h"
@@ -25,11 +28,19 @@
 
 namespace heu::pylib {
 
-// todo: place make sure this function is thread safe.
+namespace {
+
+// The python-free form of a select key, cols is empty if all columns are
+// selected
+struct SelectIndices {
+  std::vector<int64_t> rows;
+  std::optional<std::vector<int64_t>> cols;
+};
+
+// Must be called with the GIL held
 template <typename T>
-T ExtensionFunctions<T>::SelectSum(const hnp::Evaluator &evaluator,
-                                   const hnp::DenseMatrix<T> &p_matrix,
-                                   const py::object &key) {
+SelectIndices ParseSelectKey(const hnp::DenseMatrix<T> &p_matrix,
+                             const py::object &key) {
   if (py::isinstance<py::tuple>(key)) {
     auto idx_tuple = py::cast<py::tuple>(key);
 
@@ -44,8 +55,7 @@ T ExtensionFunctions<T>::SelectSum(const hnp::Evaluator &evaluator,
       bool sq_row, sq_col;
       auto s_row = slice_tool::Parse(idx_tuple[0], p_matrix.rows(), &sq_row);
       auto s_col = slice_tool::Parse(idx_tuple[1], p_matrix.cols(), &sq_col);
-
-      return evaluator.SelectSum(p_matrix, s_row.indices, s_col.indices);
+      return {std::move(s_row.indices), std::move(s_col.indices)};
     }
 
     // break if: continue to process 1-d case
@@ -55,10 +65,19 @@ T ExtensionFunctions<T>::SelectSum(const hnp::Evaluator &evaluator,
   // key dimension is less than tensor dimension
   bool sq_row;
   auto s_row = slice_tool::Parse(key, p_matrix.rows(), &sq_row);
-  return evaluator.SelectSum(p_matrix, s_row.indices, Eigen::placeholders::all);
+  return {std::move(s_row.indices), std::nullopt};
 }
 
-namespace {
+// Thread safe, no python object is touched
+template <typename T>
+T DoSelectSum(const hnp::Evaluator &evaluator,
+              const hnp::DenseMatrix<T> &p_matrix,
+              const SelectIndices &indices) {
+  if (indices.cols.has_value()) {
+    return evaluator.SelectSum(p_matrix, indices.rows, *indices.cols);
+  }
+  return evaluator.SelectSum(p_matrix, indices.rows, Eigen::placeholders::all);
+}
 
 // we move this function here to avoid gcc warning:
 //    '<lambda(int64_t, int64_t)>' declared with greater visibility than the
@@ -66,12 +85,11 @@ namespace {
 template <typename T>
 hnp::DenseMatrix<T> DoBatchSelectSum(const hnp::Evaluator &evaluator,
                                      const hnp::DenseMatrix<T> &p_matrix,
-                                     const std::vector<py::object> &key) {
-  auto res = hnp::DenseMatrix<T>(key.size());
-  yacl::parallel_for(0, key.size(), 1, [&](int64_t beg, int64_t end) {
+                                     const std::vector<SelectIndices> &keys) {
+  auto res = hnp::DenseMatrix<T>(keys.size());
+  yacl::parallel_for(0, keys.size(), 1, [&](int64_t beg, int64_t end) {
     for (int64_t x = beg; x < end; ++x) {
-      res.data()[x] =
-          ExtensionFunctions<T>::SelectSum(evaluator, p_matrix, key[x]);
+      res.data()[x] = DoSelectSum(evaluator, p_matrix, keys[x]);
     }
   });
   return res;
@@ -79,11 +97,29 @@ hnp::DenseMatrix<T> DoBatchSelectSum(const hnp::Evaluator &evaluator,
 
 }  // namespace
 
+template <typename T>
+T ExtensionFunctions<T>::SelectSum(const hnp::Evaluator &evaluator,
+                                   const hnp::DenseMatrix<T> &p_matrix,
+                                   const py::object &key) {
+  auto indices = ParseSelectKey(p_matrix, key);
+
+  py::gil_scoped_release release;
+  return DoSelectSum(evaluator, p_matrix, indices);
+}
+
 template <typename T>
 hnp::DenseMatrix<T> ExtensionFunctions<T>::BatchSelectSum(
     const hnp::Evaluator &evaluator, const hnp::DenseMatrix<T> &p_matrix,
     const std::vector<py::object> &key) {
-  return DoBatchSelectSum(evaluator, p_matrix, key);
+  // python objects can only be parsed by the thread holding the GIL
+  std::vector<SelectIndices> indices;
+  indices.reserve(key.size());
+  for (const auto &k : key) {
+    indices.push_back(ParseSelectKey(p_matrix, k));
+  }
+
+  py::gil_scoped_release release;
+  return DoBatchSelectSum(evaluator, p_matrix, indices);
 }
 
 template <typename T>
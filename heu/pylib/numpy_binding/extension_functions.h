@@ -33,6 +33,8 @@ using RowVector = const Eigen::Matrix<int8_t, 1, Eigen::Dynamic>;
 template <typename T>
 class ExtensionFunctions {
  public:
+  // SelectSum and BatchSelectSum must be called with the GIL held. The keys
+  // are parsed first, and then the GIL is released during summation.
   static T SelectSum(const lib::numpy::Evaluator &e,
                      const lib::numpy::DenseMatrix<T> &x,
                      const pybind11::object &key);
@@ -14,9 +14,16 @@
 
 #pragma once
 
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 #include "pybind11/numpy.h"
 #include "pybind11/pybind11.h"
+#include "yacl/utils/parallel.h"
 
+#include "heu/library/numpy/encryptor.h"
 #include "heu/library/numpy/matrix.h"
 #include "heu/library/phe/phe.h"
 #include "heu/pylib/common/traits.h"
@@ -24,15 +31,59 @@
 
 namespace heu::pylib {
 
+// The default post-processing of encoded plaintexts: keep them as they are
+struct KeepPlaintext {
+  phe::Plaintext operator()(phe::Plaintext &&pt) const { return std::move(pt); }
+};
+
+template <typename PostFn>
+using PostResult = std::invoke_result_t<const PostFn &, phe::Plaintext &&>;
+
+// Fill res with post(encode(row, col)), where encode() needs the GIL.
+// Elements are encoded chunk by chunk into a scratch buffer with the GIL held,
+// then post-processed in parallel without the GIL, so that an expensive post
+// (e.g. encryption) is not serialized by the interpreter, and no full
+// plaintext matrix is materialized.
+template <typename T, typename EncodeFn, typename PostFn>
+void EncodeWithGilInChunks(hnp::DenseMatrix<T> *res, const EncodeFn &encode,
+                           bool parallel_encode, const PostFn &post) {
+  constexpr int64_t kChunkSize = 4096;
+  std::vector<phe::Plaintext> scratch(std::min(kChunkSize, res->size()));
+  T *out = res->data();
+  int64_t rows = res->rows();
+  for (int64_t beg = 0; beg < res->size(); beg += kChunkSize) {
+    auto len = std::min(kChunkSize, res->size() - beg);
+    auto encode_range = [&](int64_t b, int64_t e) {
+      for (int64_t i = b; i < e; ++i) {
+        scratch[i] = encode((beg + i) % rows, (beg + i) / rows);
+      }
+    };
+    if (parallel_encode) {
+      yacl::parallel_for(0, len, 1, encode_range);
+    } else {
+      encode_range(0, len);
+    }
+
+    py::gil_scoped_release release;
+    yacl::parallel_for(0, len, 1, [&](int64_t b, int64_t e) {
+      for (int64_t i = b; i < e; ++i) {
+        out[beg + i] = post(std::move(scratch[i]));
+      }
+    });
+  }
+}
+
 // scalar encoding
+// Each encoded plaintext is passed to post() and the results are collected,
+// KeepPlaintext collects the plaintexts themselves.
 template <
-    typename EL_TYPE, typename Encoder_t,
+    typename EL_TYPE, typename Encoder_t, typename PostFn,
     typename std::enable_if_t<std::is_same_v<Encoder_t, PyIntegerEncoder> ||
                                   std::is_same_v<Encoder_t, PyFloatEncoder> ||
                                   std::is_same_v<Encoder_t, PyBigintEncoder>,
                               int> = 0>
-hnp::DenseMatrix<phe::Plaintext> DoEncodeMatrix(const py::array &ndarray,
-                                                const Encoder_t &encoder) {
+hnp::DenseMatrix<PostResult<PostFn>> DoEncodeMatrix(
+    const py::array &ndarray, const Encoder_t &encoder, const PostFn &post) {
   YACL_ENFORCE(ndarray.ndim() <= 2,
                "HEU currently supports up to 2-dimensional tensor");
   auto bi = ndarray.request();
@@ -40,18 +91,35 @@ hnp::DenseMatrix<phe::Plaintext> DoEncodeMatrix(const py::array &ndarray,
   // for 1-dim array: always convert to column vector
   auto rows = bi.ndim > 0 ? bi.shape[0] : 1;
   auto cols = bi.ndim > 1 ? bi.shape[1] : 1;
-  hnp::DenseMatrix<phe::Plaintext> res(rows, cols, bi.ndim);
+  hnp::DenseMatrix<PostResult<PostFn>> res(rows, cols, bi.ndim);
 
   if (ndarray.ndim() == 0) {
-    res(0, 0) = encoder.Encode(*reinterpret_cast<EL_TYPE *>(bi.ptr));
+    res(0, 0) = post(encoder.Encode(*reinterpret_cast<EL_TYPE *>(bi.ptr)));
     return res;
   }
 
   auto r = ndarray.unchecked<EL_TYPE, -1>();
-  res.ForEach([&](int64_t row, int64_t col,
-                  phe::Plaintext *pt) { *pt = encoder.Encode(r(row, col)); },
-              !std::is_same_v<Encoder_t, PyBigintEncoder> ||
-                  !std::is_same_v<EL_TYPE, PyObject *>);
+  if constexpr (std::is_same_v<EL_TYPE, PyObject *>) {
+    // python objects are converted by the interpreter, so keep the GIL
+    bool parallel = !std::is_same_v<Encoder_t, PyBigintEncoder>;
+    if constexpr (std::is_same_v<PostFn, KeepPlaintext>) {
+      res.ForEach(
+          [&](int64_t row, int64_t col, phe::Plaintext *pt) {
+            *pt = encoder.Encode(r(row, col));
+          },
+          parallel);
+    } else {
+      EncodeWithGilInChunks(
+          &res,
+          [&](int64_t row, int64_t col) { return encoder.Encode(r(row, col)); },
+          parallel, post);
+    }
+  } else {
+    py::gil_scoped_release release;
+    res.ForEach([&](int64_t row, int64_t col, PostResult<PostFn> *out) {
+      *out = post(encoder.Encode(r(row, col)));
+    });
+  }
   return res;
 }
 
@@ -61,13 +129,13 @@ hnp::DenseMatrix<phe::Plaintext> DoEncodeMatrix(const py::array &ndarray,
 // [[g1, h1],      [[p1],
 //  [g2, h2],  ==>  [p2],
 //  [g3, h3]]       [p3]]
-template <typename EL_TYPE, typename Encoder_t,
+template <typename EL_TYPE, typename Encoder_t, typename PostFn,
           typename std::enable_if_t<
               std::is_same_v<Encoder_t, PyBatchIntegerEncoder> ||
                   std::is_same_v<Encoder_t, PyBatchFloatEncoder>,
               int> = 0>
-hnp::DenseMatrix<phe::Plaintext> DoEncodeMatrix(const py::array &ndarray,
-                                                const Encoder_t &encoder) {
+hnp::DenseMatrix<PostResult<PostFn>> DoEncodeMatrix(
+    const py::array &ndarray, const Encoder_t &encoder, const PostFn &post) {
   YACL_ENFORCE(ndarray.ndim() > 0 && ndarray.ndim() <= 2,
                "HEU only supports 1-dim or 2-dim array currently");
 
@@ -80,18 +148,34 @@ hnp::DenseMatrix<phe::Plaintext> DoEncodeMatrix(const py::array &ndarray,
   // support shape of (2,) and (n, 2)
   auto rows = ndarray.ndim() == 1 ? 1 : ndarray.shape(0);
   auto cols = 1;
-  hnp::DenseMatrix<phe::Plaintext> res(rows, cols, ndarray.ndim());
+  hnp::DenseMatrix<PostResult<PostFn>> res(rows, cols, ndarray.ndim());
   auto r = ndarray.unchecked<EL_TYPE, -1>();
 
   if (ndarray.ndim() == 1) {
     // input size must be 1x2
-    res(0, 0) = encoder.Encode(r(0), r(1));
+    res(0, 0) = post(encoder.Encode(r(0), r(1)));
     return res;
   }
 
-  res.ForEach([&](int64_t row, int64_t, phe::Plaintext *pt) {
-    *pt = encoder.Encode(r(row, 0), r(row, 1));
-  });
+  if constexpr (std::is_same_v<EL_TYPE, PyObject *>) {
+    if constexpr (std::is_same_v<PostFn, KeepPlaintext>) {
+      res.ForEach([&](int64_t row, int64_t, phe::Plaintext *pt) {
+        *pt = encoder.Encode(r(row, 0), r(row, 1));
+      });
+    } else {
+      EncodeWithGilInChunks(
+          &res,
+          [&](int64_t row, int64_t) {
+            return encoder.Encode(r(row, 0), r(row, 1));
+          },
+          true, post);
+    }
+  } else {
+    py::gil_scoped_release release;
+    res.ForEach([&](int64_t row, int64_t, PostResult<PostFn> *out) {
+      *out = post(encoder.Encode(r(row, 0), r(row, 1)));
+    });
+  }
   return res;
 }
 
@@ -120,42 +204,48 @@ hnp::DenseMatrix<phe::Plaintext> DoEncodeMatrix(const py::array &ndarray,
 // dtype 21 is datetime64  char: M kind: M
 // dtype 22 is timedelta64 char: m kind: m
 // dtype 23 is float16     char: e kind: f
-template <typename Encoder_t>
-hnp::DenseMatrix<phe::Plaintext> EncodeNdarray(const py::array &ndarray,
-                                               const Encoder_t &encoder) {
+template <typename Encoder_t, typename PostFn>
+hnp::DenseMatrix<PostResult<PostFn>> EncodeNdarrayThen(
+    const py::array &ndarray, const Encoder_t &encoder, const PostFn &post) {
   switch (ndarray.dtype().num()) {
     case 1:
-      return DoEncodeMatrix<int8_t>(ndarray, encoder);
+      return DoEncodeMatrix<int8_t>(ndarray, encoder, post);
     case 2:
-      return DoEncodeMatrix<uint8_t>(ndarray, encoder);
+      return DoEncodeMatrix<uint8_t>(ndarray, encoder, post);
     case 3:
-      return DoEncodeMatrix<int16_t>(ndarray, encoder);
+      return DoEncodeMatrix<int16_t>(ndarray, encoder, post);
     case 4:
-      return DoEncodeMatrix<uint16_t>(ndarray, encoder);
+      return DoEncodeMatrix<uint16_t>(ndarray, encoder, post);
     case 5:
-      return DoEncodeMatrix<int32_t>(ndarray, encoder);
+      return DoEncodeMatrix<int32_t>(ndarray, encoder, post);
     case 6:
-      return DoEncodeMatrix<uint32_t>(ndarray, encoder);
+      return DoEncodeMatrix<uint32_t>(ndarray, encoder, post);
     case 7:
-      return DoEncodeMatrix<int64_t>(ndarray, encoder);
+      return DoEncodeMatrix<int64_t>(ndarray, encoder, post);
     case 8:
-      return DoEncodeMatrix<uint64_t>(ndarray, encoder);
+      return DoEncodeMatrix<uint64_t>(ndarray, encoder, post);
     case 9:
-      return DoEncodeMatrix<int64_t>(ndarray, encoder);
+      return DoEncodeMatrix<int64_t>(ndarray, encoder, post);
     case 10:
-      return DoEncodeMatrix<uint64_t>(ndarray, encoder);
+      return DoEncodeMatrix<uint64_t>(ndarray, encoder, post);
     case 11:
-      return DoEncodeMatrix<float>(ndarray, encoder);
+      return DoEncodeMatrix<float>(ndarray, encoder, post);
     case 12:
-      return DoEncodeMatrix<double>(ndarray, encoder);
+      return DoEncodeMatrix<double>(ndarray, encoder, post);
     case 17:
-      return DoEncodeMatrix<PyObject *>(ndarray, encoder);
+      return DoEncodeMatrix<PyObject *>(ndarray, encoder, post);
     default:
       YACL_THROW_ARGUMENT_ERROR("Unsupported numpy ndarray with dtype '{}'",
                                 std::string(py::str(ndarray.dtype())));
   }
 }
 
+template <typename Encoder_t>
+hnp::DenseMatrix<phe::Plaintext> EncodeNdarray(const py::array &ndarray,
+                                               const Encoder_t &encoder) {
+  return EncodeNdarrayThen(ndarray, encoder, KeepPlaintext());
+}
+
 py::array ParseNumpyNdarray(PyObject *ptr, int extra_flags) {
   YACL_ENFORCE(ptr != nullptr,
                "HEU cannot create a numpy.ndarray from nullptr");
@@ -173,4 +263,23 @@ hnp::DenseMatrix<phe::Plaintext> ParseEncodeNdarray(const py::object &ptr,
                        encoder);
 }
 
+// Fused encode and encrypt. Each element is encrypted right after it is
+// encoded, no intermediate plaintext matrix is built.
+template <typename Encoder_t>
+hnp::DenseMatrix<phe::Ciphertext> EncryptNdarray(
+    const hnp::Encryptor &encryptor, const py::array &ndarray,
+    const Encoder_t &encoder) {
+  return EncodeNdarrayThen(ndarray, encoder, [&](const phe::Plaintext &pt) {
+    return encryptor.Encrypt(pt);
+  });
+}
+
+template <typename Encoder_t>
+hnp::DenseMatrix<phe::Ciphertext> ParseEncryptNdarray(
+    const hnp::Encryptor &encryptor, const py::object &ptr,
+    const Encoder_t &encoder) {
+  return EncryptNdarray(
+      encryptor, ParseNumpyNdarray(ptr.ptr(), py::array::forcecast), encoder);
+}
+
 }  // namespace heu::pylib
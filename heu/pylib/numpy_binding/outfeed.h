@@ -14,10 +14,13 @@
 
 #pragma once
 
+#include <optional>
+
 #include "pybind11/numpy.h"
 #include "pybind11/pybind11.h"
 #include "yacl/utils/parallel.h"
 
+#include "heu/library/numpy/decryptor.h"
 #include "heu/library/numpy/matrix.h"
 #include "heu/library/phe/phe.h"
 #include "heu/pylib/common/traits.h"
@@ -84,6 +87,8 @@ py::array DecodeNdarray(
   if constexpr (std::is_base_of_v<Encoder_t, PyBigintDecoder>) {
     pfunc(0, in.size());
   } else {
+    // the output buffer is already allocated, no python object is touched
+    py::gil_scoped_release release;
     yacl::parallel_for(0, in.size(), kHeOpGrainSize, pfunc);
   }
   return res;
@@ -120,26 +125,138 @@ py::array DecodeNdarray(
     return res;
   }
 
-  if (in.ndim() == 1 && in.rows() > 1) {
-    yacl::parallel_for(0, in.size(), kHeOpGrainSize,
-                       [&](int64_t beg, int64_t end) {
-                         for (int64_t row = beg; row < end; ++row) {
-                           const auto &pt = in(row);
-                           r(row, 0) = encoder.template Decode<0>(pt);
-                           r(row, 1) = encoder.template Decode<1>(pt);
-                         }
-                       });
+  {
+    // no python object is touched
+    py::gil_scoped_release release;
+    if (in.ndim() == 1 && in.rows() > 1) {
+      yacl::parallel_for(0, in.size(), kHeOpGrainSize,
+                         [&](int64_t beg, int64_t end) {
+                           for (int64_t row = beg; row < end; ++row) {
+                             const auto &pt = in(row);
+                             r(row, 0) = encoder.template Decode<0>(pt);
+                             r(row, 1) = encoder.template Decode<1>(pt);
+                           }
+                         });
+    } else {
+      yacl::parallel_for(0, in.size(), kHeOpGrainSize,
+                         [&](int64_t beg, int64_t end) {
+                           for (int64_t row = beg; row < end; ++row) {
+                             const auto &pt = in(row, 0);
+                             r(row, 0) = encoder.template Decode<0>(pt);
+                             r(row, 1) = encoder.template Decode<1>(pt);
+                           }
+                         });
+    }
+  }
+
+  return res;
+}
+
+// Decrypt in, with range checking if range_bits is set. Plaintexts are passed
+// to sink batch by batch, the GIL must be released by caller.
+inline void DecryptWithSink(const hnp::Decryptor &decryptor,
+                            const hnp::CMatrix &in,
+                            std::optional<size_t> range_bits,
+                            const hnp::Decryptor::PlaintextSink &sink) {
+  if (range_bits.has_value()) {
+    decryptor.DecryptInRangeTo(in, sink, *range_bits);
   } else {
-    yacl::parallel_for(0, in.size(), kHeOpGrainSize,
-                       [&](int64_t beg, int64_t end) {
-                         for (int64_t row = beg; row < end; ++row) {
-                           const auto &pt = in(row, 0);
-                           r(row, 0) = encoder.template Decode<0>(pt);
-                           r(row, 1) = encoder.template Decode<1>(pt);
-                         }
-                       });
+    decryptor.DecryptTo(in, sink);
+  }
+}
+
+// Fused decrypt and decode. Each batch of plaintexts is decoded into the
+// output numpy array right after decryption, no PMatrix is built.
+template <typename Encoder_t>
+py::array DecryptToNdarray(
+    const hnp::Decryptor &decryptor, const hnp::CMatrix &in,
+    const std::enable_if_t<std::is_same_v<Encoder_t, PyIntegerEncoder> ||
+                               std::is_same_v<Encoder_t, PyFloatEncoder> ||
+                               std::is_same_v<Encoder_t, PyBigintDecoder>,
+                           Encoder_t> &encoder,
+    std::optional<size_t> range_bits) {
+  using PlainT = typename Encoder_t::DefaultPlainT;
+  if constexpr (std::is_same_v<Encoder_t, PyBigintDecoder>) {
+    // decoding to python ints needs the GIL, so decrypt as a whole first
+    hnp::PMatrix pts;
+    {
+      py::gil_scoped_release release;
+      pts = range_bits.has_value() ? decryptor.DecryptInRange(in, *range_bits)
+                                   : decryptor.Decrypt(in);
+    }
+    return DecodeNdarray<Encoder_t>(pts, encoder);
+  } else {
+    if (in.ndim() == 0) {
+      auto pt = range_bits.has_value()
+                    ? decryptor.DecryptInRange(in(0, 0), *range_bits)
+                    : decryptor.Decrypt(in(0, 0));
+      return py::array(encoder.DecodeAsPyObj(pt));
+    }
+
+    int64_t rows = in.rows();
+    int64_t cols = in.cols();
+    py::array res;
+    if (in.ndim() == 1) {
+      res = py::array(py::dtype(Encoder_t::DefaultPyTypeFormat),
+                      py::array::ShapeContainer({rows}));
+    } else {
+      res = py::array(py::dtype(Encoder_t::DefaultPyTypeFormat), {rows, cols});
+    }
+
+    // in is column major while res is row major. The position is computed
+    // once per batch, then moved along the column.
+    auto *out = static_cast<PlainT *>(res.mutable_data());
+    py::gil_scoped_release release;
+    DecryptWithSink(decryptor, in, range_bits,
+                    [&](int64_t beg, absl::Span<phe::Plaintext> pts) {
+                      int64_t row = beg % rows;
+                      int64_t col = beg / rows;
+                      for (const auto &pt : pts) {
+                        out[row * cols + col] =
+                            encoder.template Decode<PlainT>(pt);
+                        if (++row == rows) {
+                          row = 0;
+                          ++col;
+                        }
+                      }
+                    });
+    return res;
+  }
+}
+
+// Fused decrypt and batch decode
+template <typename Encoder_t>
+py::array DecryptToNdarray(
+    const hnp::Decryptor &decryptor, const hnp::CMatrix &in,
+    const std::enable_if_t<std::is_same_v<Encoder_t, PyBatchIntegerEncoder> ||
+                               std::is_same_v<Encoder_t, PyBatchFloatEncoder>,
+                           Encoder_t> &encoder,
+    std::optional<size_t> range_bits) {
+  YACL_ENFORCE(in.cols() == 1,
+               "The size of innermost dimension must be 1 when using "
+               "BatchIntegerEncoder/BatchFloatEncoder");
+
+  int64_t rows = in.rows();
+  py::array res;
+  if (in.ndim() <= 1 && rows == 1) {
+    // in matrix is 1x1, or a scalar
+    res = py::array(py::dtype(Encoder_t::DefaultPyTypeFormat),
+                    py::array::ShapeContainer({2}));
+  } else {
+    res = py::array(py::dtype(Encoder_t::DefaultPyTypeFormat), {rows, 2});
   }
 
+  auto *out =
+      static_cast<typename Encoder_t::DefaultPlainT *>(res.mutable_data());
+  py::gil_scoped_release release;
+  DecryptWithSink(decryptor, in, range_bits,
+                  [&](int64_t beg, absl::Span<phe::Plaintext> pts) {
+                    auto *p = out + beg * 2;
+                    for (const auto &pt : pts) {
+                      *p++ = encoder.template Decode<0>(pt);
+                      *p++ = encoder.template Decode<1>(pt);
+                    }
+                  });
   return res;
 }
 
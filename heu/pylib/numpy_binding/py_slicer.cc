@@ -119,6 +119,38 @@ void PySlicer<T>::SetItem(hnp::DenseMatrix<T> *p_matrix, const py::object &key,
   MatrixAssign(p_matrix, s_row, slice_tool::All(p_matrix->cols()), value);
 }
 
+template <typename T>
+py::object PySlicer<T>::GetView(const hnp::DenseMatrixView<T> &view,
+                                const py::object &key) {
+  slice_tool::StridedSlice s_row;
+  slice_tool::StridedSlice s_col = {0, view.cols(), 1, false};
+  if (py::isinstance<py::tuple>(key)) {
+    auto idx_tuple = py::cast<py::tuple>(key);
+
+    YACL_ENFORCE(static_cast<int64_t>(idx_tuple.size()) <= view.ndim(),
+                 "too many indices for array, array is {}-dimensional, but "
+                 "{} were indexed. slice key={}",
+                 view.ndim(), idx_tuple.size(),
+                 static_cast<std::string>(py::str(key)));
+    YACL_ENFORCE(idx_tuple.size() > 0, "empty index is not supported");
+
+    s_row = slice_tool::ParseStrided(idx_tuple[0], view.rows());
+    if (idx_tuple.size() == 2) {
+      s_col = slice_tool::ParseStrided(idx_tuple[1], view.cols());
+    }
+  } else {
+    s_row = slice_tool::ParseStrided(key, view.rows());
+  }
+
+  auto res = view.Slice(s_row.start, s_row.items, s_row.step, s_col.start,
+                        s_col.items, s_col.step)
+                 .Squeeze(s_row.squeeze, s_col.squeeze);
+  if (res.ndim() == 0) {
+    return py::cast(res(0, 0));
+  }
+  return py::cast(res);
+}
+
 template class PySlicer<lib::phe::Plaintext>;
 template class PySlicer<lib::phe::Ciphertext>;
 template class PySlicer<std::string>;
@@ -31,6 +31,11 @@ class PySlicer {
   static void SetItem(lib::numpy::DenseMatrix<T> *p_matrix,
                       const pybind11::object &key,
                       const pybind11::object &value);
+
+  // Same as GetItem(), but returns a view instead of a copy. Only integers and
+  // slices are supported.
+  static pybind11::object GetView(const lib::numpy::DenseMatrixView<T> &view,
+                                  const pybind11::object &key);
 };
 
 }  // namespace heu::pylib
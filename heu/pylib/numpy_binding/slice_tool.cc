@@ -85,6 +85,25 @@ PySlice<std::vector<int64_t>> Parse(const pybind11::object &src,
   return res;
 }
 
+StridedSlice ParseStrided(const pybind11::object &src, ssize_t dim_len) {
+  if (py::isinstance<py::slice>(src)) {
+    auto s = py::cast<py::slice>(src);
+    ssize_t start = 0, stop = 0, step = 0, items = 0;
+    YACL_ENFORCE(s.compute(dim_len, &start, &stop, &step, &items),
+                 "Failed to solve slice {}", py::str(s).operator std::string());
+    return {start, items, step, false};
+  }
+
+  if (py::isinstance<py::int_>(src)) {
+    return {ComputeInt(src, dim_len), 1, 1, true};
+  }
+
+  YACL_THROW_ARGUMENT_ERROR(
+      "A view can only be indexed by integers and slices, got {}. Index the "
+      "array instead, which returns a copy",
+      static_cast<std::string>(py::str(src.get_type())));
+}
+
 auto All(ssize_t dim_len) -> PySlice<decltype(Eigen::placeholders::all)> {
   return {dim_len, Eigen::placeholders::all};
 };
@@ -38,6 +38,18 @@ PySlice<std::vector<int64_t>> Parse(const pybind11::object &src,
                                     ssize_t dim_len,
                                     bool *should_squeeze = nullptr);
 
+// a slice with constant step, which can be taken without copy
+struct StridedSlice {
+  int64_t start;
+  int64_t items;
+  int64_t step;
+  bool squeeze;  // true if src is an integer
+};
+
+// parse an integer or a python slice object into a StridedSlice.
+// index arrays are rejected since they cannot be expressed by strides
+StridedSlice ParseStrided(const pybind11::object &src, ssize_t dim_len);
+
 // express python slice [:] in PySlice struct.
 auto All(ssize_t dim_len) -> PySlice<decltype(Eigen::placeholders::all)>;
 
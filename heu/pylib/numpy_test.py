@@ -11,6 +11,7 @@
 #  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 #  See the License for the specific language governing permissions and
 #  limitations under the License.
+import asyncio
 import pickle
 import sys
 import unittest
@@ -127,6 +128,56 @@ class BasicCase(unittest.TestCase):
                 harr, input, self.kit.batch_float_encoder(scale=2**62)
             )
 
+    def test_encrypt_ndarray(self):
+        nparr = np.random.randint(-10000, 10000, (20, 30))
+        self.assert_array_equal(self.encryptor.encrypt_ndarray(nparr), nparr)
+        self.assert_array_equal(self.encryptor.encrypt_ndarray([1, 2, 3]), [1, 2, 3])
+
+        # object dtype is encoded with the GIL and encrypted in chunks
+        objarr = np.array([[2**100, -(2**90)], [3, 4]] * 3000, dtype=object)
+        self.assert_array_equal(self.encryptor.encrypt_ndarray(objarr), objarr)
+
+        edr = phe.FloatEncoder(self.kit.get_schema())
+        nparr = np.random.rand(10, 5)
+        ct = self.encryptor.encrypt_ndarray(nparr, edr)
+        np.testing.assert_almost_equal(
+            self.decryptor.decrypt(ct).to_numpy(edr), nparr, decimal=5
+        )
+        ct = self.encryptor.encrypt_ndarray(nparr, phe.FloatEncoderParams())
+        np.testing.assert_almost_equal(
+            self.decryptor.decrypt(ct).to_numpy(edr), nparr, decimal=5
+        )
+
+    def test_decrypt_to_ndarray(self):
+        nparr = np.random.randint(-10000, 10000, (20, 30))
+        ct = self.encryptor.encrypt(self.kit.array(nparr))
+        np.testing.assert_array_equal(self.decryptor.decrypt_to_ndarray(ct), nparr)
+        edr = phe.IntegerEncoder(self.kit.get_schema())
+        np.testing.assert_array_equal(
+            self.decryptor.decrypt_to_ndarray(ct, edr, range_bits=64), nparr
+        )
+        ct = self.encryptor.encrypt(self.kit.array(nparr[0]))
+        np.testing.assert_array_equal(
+            self.decryptor.decrypt_to_ndarray(ct, edr), nparr[0]
+        )
+
+        edr = phe.FloatEncoder(self.kit.get_schema())
+        nparr = np.random.rand(10, 5)
+        ct = self.encryptor.encrypt(self.kit.array(nparr, edr))
+        np.testing.assert_almost_equal(
+            self.decryptor.decrypt_to_ndarray(ct, edr), nparr, decimal=5
+        )
+
+        edr = phe.BatchIntegerEncoder(self.kit.get_schema())
+        nparr = np.random.randint(-10000, 10000, (10, 2))
+        ct = self.encryptor.encrypt(self.kit.array(nparr, edr))
+        np.testing.assert_array_equal(self.decryptor.decrypt_to_ndarray(ct, edr), nparr)
+
+        # range checking is applied in the same pass
+        ct = self.encryptor.encrypt(self.kit.array([2**100, 1]))
+        with self.assertRaises(RuntimeError):
+            self.decryptor.decrypt_to_ndarray(ct, range_bits=64)
+
     def test_encrypt_with_audit(self):
         pt1 = self.kit.array([[1], [3]])
         ct1, audit = self.encryptor.encrypt_with_audit(pt1)
@@ -296,6 +347,41 @@ class BasicCase(unittest.TestCase):
         self.assert_array_equal(self.evaluator.add(harr2, harr2), nparr2 + nparr2)
         self.assert_array_equal(self.evaluator.sub(harr2, harr2), nparr2 - nparr2)
 
+    def test_async(self):
+        nparr1 = np.random.randint(-10000, 10000, (30, 20))
+        harr1 = self.kit.array(nparr1)
+        nparr2 = np.random.randint(-10000, 10000, (30, 20))
+        harr2 = self.kit.array(nparr2)
+
+        f1 = self.encryptor.encrypt_async(harr1)
+        f2 = self.encryptor.encrypt_async(harr2, hnp.TaskPriority.High)
+        ct1, ct2 = f1.result(), f2.result(timeout=60)
+        self.assertTrue(f1.done())
+        self.assert_array_equal(
+            self.evaluator.add_async(ct1, ct2).result(), nparr1 + nparr2
+        )
+        self.assert_array_equal(
+            self.evaluator.mul_async(ct1, harr2).result(),
+            np.multiply(nparr1, nparr2),
+        )
+        self.assertEqual(
+            self.decryptor.decrypt(self.evaluator.sum_async(ct1).result()),
+            phe.Plaintext(self.kit.get_schema(), int(nparr1.sum())),
+        )
+
+        # pipeline: decrypt the first chunks while the rest is being encrypted
+        chunks = self.encryptor.encrypt_in_chunks(harr1, 8)
+        self.assertEqual(len(chunks), 4)
+        res = [self.decryptor.decrypt_async(c.result()) for c in chunks]
+        res = np.vstack([f.result().to_numpy() for f in res])
+        np.testing.assert_array_equal(res, nparr1)
+
+        async def run():
+            ct = await self.encryptor.encrypt_async(harr1)
+            return await self.decryptor.decrypt_async(ct)
+
+        self.assert_array_equal(asyncio.run(run()), nparr1)
+
     def test_serialize(self):
         edr_params = pickle.dumps(phe.BigintEncoderParams())
 
@@ -320,6 +406,24 @@ class BasicCase(unittest.TestCase):
             np.array([[16, 19], [36, 43]]) @ np.array([1, 2]),
         )
 
+    def test_pickle_out_of_band(self):
+        nparr = np.random.randint(-10000, 10000, (20, 30))
+        ct = self.encryptor.encrypt(self.kit.array(nparr))
+
+        buffers = []
+        data = pickle.dumps(ct, protocol=5, buffer_callback=buffers.append)
+        self.assertEqual(len(buffers), 1)
+        # the payload is not copied into the pickle stream
+        self.assertLess(len(data), 200)
+        ct2 = pickle.loads(data, buffers=[memoryview(b) for b in buffers])
+        self.assert_array_equal(ct2, nparr)
+
+        # in-band and older protocols still work
+        for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+            self.assert_array_equal(
+                pickle.loads(pickle.dumps(ct, protocol=protocol)), nparr
+            )
+
     def test_serialize_ic(self):
         arr = self.kit.array([[16, 19], [36, 43]])
         buf1 = arr.serialize(hnp.MatrixSerializeFormat.Interconnection)
@@ -411,6 +515,177 @@ class BasicCase(unittest.TestCase):
         harr[-1] = phe.Plaintext(self.kit.get_schema(), 666)
         self.assert_array_equal(harr, nparr)
 
+    def test_view(self):
+        nparr = np.arange(48).reshape((8, 6))
+        harr = self.kit.array(nparr)
+        ct = self.encryptor.encrypt(harr)
+        hview = harr.view()
+        cview = ct.view()
+        self.assertEqual(tuple(hview.shape), (8, 6))
+
+        for key in [
+            (slice(1, 7, 2), slice(None, None, -2)),
+            (slice(None), 3),
+            (2, slice(1, 5)),
+            slice(-3, None),
+            4,
+        ]:
+            self.assert_array_equal(hview[key].materialize(), nparr[key])
+            self.assert_array_equal(self.decryptor.decrypt(cview[key]), nparr[key])
+        self.assertEqual(int(hview[2, 3]), nparr[2, 3])
+        self.assert_array_equal(
+            hview[1:4][::-1, 2:].materialize(), nparr[1:4][::-1, 2:]
+        )
+        with self.assertRaises(RuntimeError):
+            hview[[1, 2]]
+
+        # evaluation reads the views in place
+        sub = cview[::2, 1:4]
+        self.assert_array_equal(
+            self.evaluator.add(sub, hview[::2, 1:4]), nparr[::2, 1:4] * 2
+        )
+        self.assert_array_equal(
+            self.evaluator.mul(hview.transpose(), ct.transpose()), nparr.T * nparr.T
+        )
+        self.assert_array_equal(
+            self.evaluator.matmul(hview.transpose(), ct), nparr.T @ nparr
+        )
+        row = hview[2:3]
+        self.assert_array_equal(
+            self.evaluator.sub(ct, row.broadcast_to((8, 6))), nparr - nparr[2:3]
+        )
+        self.assertEqual(
+            int(self.decryptor.decrypt(self.evaluator.sum(sub))),
+            nparr[::2, 1:4].sum(),
+        )
+        self.assert_array_equal(
+            self.decryptor.decrypt(self.encryptor.encrypt(hview[::3])), nparr[::3]
+        )
+
+        # a serialized view loads as an array
+        buf = sub.serialize()
+        self.assert_array_equal(hnp.CiphertextArray.load_from(buf), nparr[::2, 1:4])
+
+        # views keep the viewed array alive
+        view = self.kit.array(nparr).view()[1:3]
+        self.assert_array_equal(view.materialize(), nparr[1:3])
+
+    def test_lazy_expression(self):
+        x = np.arange(24).reshape((6, 4))
+        a = np.arange(24, 48).reshape((6, 4))
+        y = np.arange(-12, 12).reshape((6, 4))
+        b = np.array([[3, -1, 0, 7]])  # broadcast along rows
+        c = np.full((6, 4), 5)
+        cx = self.encryptor.encrypt(self.kit.array(x))
+        cy = self.encryptor.encrypt(self.kit.array(y))
+        ha, hb, hc = self.kit.array(a), self.kit.array(b), self.kit.array(c)
+
+        expr = cx.lazy() * ha + cy.lazy() * hb - hc
+        self.assertTrue(expr.is_ciphertext)
+        self.assertEqual(tuple(expr.shape), (6, 4))
+        res = expr.evaluate(self.evaluator)
+        self.assertIsInstance(res, hnp.CiphertextArray)
+        self.assert_array_equal(res, x * a + y * b - c)
+
+        # reversed operators, negation and views as leaves
+        self.assert_array_equal((hc - (-expr)).evaluate(self.evaluator), x * a + y * b)
+        self.assert_array_equal(
+            (ha * cx.view()[:, 1:2]).evaluate(self.evaluator), a * x[:, 1:2]
+        )
+
+        pexpr = ha.lazy() * hb - hc
+        self.assertFalse(pexpr.is_ciphertext)
+        self.assert_array_equal(pexpr.evaluate(self.evaluator), a * b - c)
+
+        with self.assertRaises(RuntimeError):
+            cx.lazy() * cy
+        with self.assertRaises(RuntimeError):
+            ha.lazy() + self.kit.array(np.arange(5))
+
+    def test_axis_sum_and_cumsum(self):
+        nparr = np.arange(-30, 30).reshape((20, 3))
+        harr = self.kit.array(nparr)
+        carr = self.encryptor.encrypt(harr)
+
+        for axis in [0, 1, -1]:
+            self.assert_array_equal(
+                self.evaluator.sum(carr, axis), nparr.sum(axis=axis)
+            )
+            self.assert_array_equal(
+                self.evaluator.sum(harr, axis=axis), nparr.sum(axis=axis)
+            )
+            self.assert_array_equal(
+                self.evaluator.cumsum(carr, axis), nparr.cumsum(axis=axis)
+            )
+            self.assert_array_equal(
+                self.evaluator.cumsum(harr, axis), nparr.cumsum(axis=axis)
+            )
+        self.assert_array_equal(
+            self.evaluator.cumsum(carr[::-2, 1], 0), nparr[::-2, 1].cumsum()
+        )
+
+        starts = [0, 3, 4, 15]
+        expected = np.concatenate(
+            [seg.cumsum(axis=0) for seg in np.split(nparr, starts[1:])]
+        )
+        self.assert_array_equal(
+            self.evaluator.segmented_cumsum(carr, starts, 0), expected
+        )
+        self.assert_array_equal(
+            self.evaluator.segmented_cumsum(harr, [0, 2], axis=1),
+            np.concatenate([nparr[:, :2].cumsum(axis=1), nparr[:, 2:]], axis=1),
+        )
+        with self.assertRaises(RuntimeError):
+            self.evaluator.segmented_cumsum(carr, [0, 5, 2], 0)
+        with self.assertRaises(RuntimeError):
+            self.evaluator.sum(carr, 2)
+
+    def test_sparse_matmul(self):
+        dense = np.zeros((6, 8), dtype=np.int64)
+        dense[0, 1] = 1
+        dense[0, 5] = -1
+        dense[2, 0] = 7
+        dense[2, 7] = 1
+        dense[5, 3] = -4
+        # build the CSR arrays by hand, scipy.sparse is not a dependency
+        indptr = [0]
+        indices = []
+        for row in dense:
+            indices.extend(np.flatnonzero(row))
+            indptr.append(len(indices))
+        data = dense[dense != 0]
+
+        sparse = self.kit.sparse_array(dense.shape, indptr, indices, data)
+        self.assertEqual(sparse.nnz, 5)
+        self.assertEqual(tuple(sparse.shape), (6, 8))
+        self.assert_array_equal(sparse.to_dense(), dense)
+        self.assert_array_equal(sparse.transpose().to_dense(), dense.T)
+
+        y = np.arange(24).reshape((8, 3))
+        self.assert_array_equal(
+            self.evaluator.matmul(sparse, self.encryptor.encrypt(self.kit.array(y))),
+            dense @ y,
+        )
+        x = np.arange(12).reshape((2, 6))
+        cx = self.encryptor.encrypt(self.kit.array(x))
+        self.assert_array_equal(self.evaluator.matmul(cx, sparse), x @ dense)
+        self.assert_array_equal(self.evaluator.matmul(cx[1], sparse), x[1] @ dense)
+
+        # any object providing tocsr() is accepted, e.g. scipy.sparse matrices
+        class FakeSparse:
+            def tocsr(self):
+                return self
+
+        fake = FakeSparse()
+        fake.shape = dense.shape
+        fake.indptr = np.array(indptr)
+        fake.indices = np.array(indices)
+        fake.data = data
+        self.assert_array_equal(self.kit.sparse_array(fake).to_dense(), dense)
+
+        with self.assertRaises(RuntimeError):
+            self.evaluator.matmul(sparse, cx)
+
     def test_ciphertext_slice_2d(self):
         nparr = np.arange(49).reshape((7, 7))
         harr = self.kit.array(nparr)
@@ -654,5 +929,41 @@ class BasicCase(unittest.TestCase):
         ).all()
 
 
+class DjPackingCase(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls.packer = hnp.DjPacker(hnp.DjPackingParams(1024, 2, scale=100))
+        cls.kit = cls.packer.setup()
+        cls.encryptor = cls.kit.encryptor()
+        cls.decryptor = cls.kit.decryptor()
+        cls.evaluator = cls.kit.evaluator()
+
+    def test_round_trip(self):
+        # x * scale is not exact for these, e.g. 0.29 * 100 = 28.999...
+        values = np.array([0.29, -0.29, 0.57, -0.57, 1.15, -123.45, 0.0])
+        # more elements than slots, so the last plaintext is partially filled
+        values = np.resize(values, 2 * self.packer.params.slots_per_plaintext + 3)
+
+        packed = self.packer.encrypt(self.encryptor, values)
+        self.assertEqual(len(packed), len(values))
+        self.assertGreater(len(packed.ciphertexts), 1)
+        res = self.packer.decrypt(self.decryptor, packed)
+        self.assertTrue(np.array_equal(res, values), f"{res} != {values}")
+
+        res = self.packer.decrypt(
+            self.decryptor,
+            self.packer.add(self.evaluator, packed, values),
+        )
+        np.testing.assert_allclose(res, values * 2)
+        res = self.packer.decrypt(
+            self.decryptor, self.packer.mul(self.evaluator, packed, -3)
+        )
+        np.testing.assert_allclose(res, values * -3)
+
+        params = pickle.loads(pickle.dumps(self.packer.params))
+        self.assertEqual(params.s, 2)
+        self.assertEqual(params.scale, 100)
+
+
 if __name__ == "__main__":
     unittest.main()
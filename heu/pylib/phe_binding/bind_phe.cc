@@ -28,6 +28,13 @@ namespace heu::pylib {
 namespace py = ::pybind11;
 namespace phe = ::heu::lib::phe;
 
+// Key generation, encryption and decryption may take milliseconds to seconds,
+// so the GIL is released to let other python threads run. pybind11 converts
+// all arguments before the GIL is released. Scalar evaluator ops take only
+// microseconds, about the cost of releasing and reacquiring the GIL, so they
+// keep it.
+using ReleaseGil = py::call_guard<py::gil_scoped_release>;
+
 void PyBindPhe(pybind11::module &m) {
   py::register_local_exception<yacl::Exception>(m, "PheRuntimeError",
                                                 PyExc_RuntimeError);
@@ -239,7 +246,7 @@ void PyBindPhe(pybind11::module &m) {
         return {schema_type, key_size};
       },
       py::arg("schema_type"), py::arg("key_size"),
-      py::return_value_policy::move,
+      py::return_value_policy::move, ReleaseGil(),
       "Setup phe environment by schema type and key size");
 
   m.def(
@@ -248,14 +255,15 @@ void PyBindPhe(pybind11::module &m) {
         return {phe::ParseSchemaType(schema_string), key_size};
       },
       py::arg("schema_string"), py::arg("key_size"),
-      py::return_value_policy::move,
+      py::return_value_policy::move, ReleaseGil(),
       "Setup phe environment by schema string and key size");
 
   m.def(
       "setup",
       [](phe::SchemaType schema_type) { return phe::HeKit(schema_type); },
       py::arg("schema_type") = phe::SchemaType::ZPaillier,
-      py::return_value_policy::move, "Setup phe environment by schema type");
+      py::return_value_policy::move, ReleaseGil(),
+      "Setup phe environment by schema type");
 
   m.def(
       "setup",
@@ -263,14 +271,14 @@ void PyBindPhe(pybind11::module &m) {
         return phe::HeKit(phe::ParseSchemaType(schema_string));
       },
       py::arg("schema_string") = "z-paillier", py::return_value_policy::move,
-      "Setup phe environment by schema string");
+      ReleaseGil(), "Setup phe environment by schema string");
 
   m.def(
       "setup",
       [](std::shared_ptr<phe::PublicKey> pk, std::shared_ptr<phe::SecretKey> sk)
           -> phe::HeKit { return phe::HeKit(std::move(pk), std::move(sk)); },
       py::arg("public_key"), py::arg("secret_key"),
-      py::return_value_policy::move,
+      py::return_value_policy::move, ReleaseGil(),
       "Setup phe environment by pre-generated pk and sk");
 
   // api for evaluator party
@@ -289,18 +297,19 @@ void PyBindPhe(pybind11::module &m) {
   /****** encryption ******/
   py::class_<phe::Encryptor, std::shared_ptr<phe::Encryptor>>(m, "Encryptor")
       .def("encrypt", &phe::Encryptor::Encrypt, py::arg("plaintext"),
-           "Encrypt plaintext to ciphertext")
+           ReleaseGil(), "Encrypt plaintext to ciphertext")
       .def(
           "encrypt_raw",
           [](const phe::Encryptor &encryptor, const py::int_ &num) {
-            return encryptor.Encrypt(
-                PyUtils::PyIntToPlaintext(encryptor.GetSchemaType(), num));
+            auto pt = PyUtils::PyIntToPlaintext(encryptor.GetSchemaType(), num);
+            py::gil_scoped_release release;
+            return encryptor.Encrypt(pt);
           },
           py::arg("cleartext"),
           "Encode and encrypt an integer cleartext. The encoding behavior is "
           "similar to BigintEncoder")
       .def("encrypt_with_audit", &phe::Encryptor::EncryptWithAudit,
-           py::arg("plaintext"),
+           py::arg("plaintext"), ReleaseGil(),
            "Encrypt and build audit string including "
            "plaintext/random/ciphertext");
 
@@ -309,9 +318,10 @@ void PyBindPhe(pybind11::module &m) {
       .def("decrypt",
            py::overload_cast<const phe::Ciphertext &>(&phe::Decryptor::Decrypt,
                                                       py::const_),
-           py::arg("ciphertext"), "Decrypt ciphertext to plaintext")
+           py::arg("ciphertext"), ReleaseGil(),
+           "Decrypt ciphertext to plaintext")
       .def("decrypt_in_range", &phe::Decryptor::DecryptInRange,
-           py::arg("ciphertext"), py::arg("range_bits") = 128,
+           py::arg("ciphertext"), py::arg("range_bits") = 128, ReleaseGil(),
            "Decrypt ciphertext and make sure plaintext is in range "
            "(-2^range_bits, 2^range_bits). Range checking is used to block OU "
            "plaintext overflow attack, see HEU documentation for details.\n"
@@ -319,7 +329,12 @@ void PyBindPhe(pybind11::module &m) {
       .def(
           "decrypt_raw",
           [](const phe::Decryptor &decryptor, const phe::Ciphertext &ct) {
-            return PyUtils::PlaintextToPyInt(decryptor.Decrypt(ct));
+            phe::Plaintext pt;
+            {
+              py::gil_scoped_release release;
+              pt = decryptor.Decrypt(ct);
+            }
+            return PyUtils::PlaintextToPyInt(pt);
           },
           py::arg("ciphertext"),
           "Decrypt and decoding. The decoding behavior is similar to "
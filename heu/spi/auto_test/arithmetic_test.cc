@@ -410,6 +410,75 @@ TEST_P(ArithmeticTest, TestEvaluateInplace) {
                                    512, 512));
 }
 
+TEST_P(ArithmeticTest, TestEvaluateBroadcast) {
+  auto edr = TryGetEncoder("plain", 1);
+
+  std::vector<int64_t> pts_vec = {1, -1, 0, 2, -3};
+  const auto pts = edr->Encode(pts_vec);
+  const auto cts = enc_->Encrypt(pts);
+  const auto bias = edr->Encode((int64_t)10);
+  const auto scale = edr->Encode((int64_t)-3);
+
+  // add
+  Item res = eval_->Add(cts, bias);
+  EXPECT_THAT(edr->DecodeInt64(dec_->Decrypt(res)),
+              testing::ElementsAre(11, 9, 10, 12, 7));
+  res = eval_->Add(bias, cts);
+  EXPECT_THAT(edr->DecodeInt64(dec_->Decrypt(res)),
+              testing::ElementsAre(11, 9, 10, 12, 7));
+  res = eval_->Add(pts, enc_->Encrypt(bias));
+  EXPECT_THAT(edr->DecodeInt64(dec_->Decrypt(res)),
+              testing::ElementsAre(11, 9, 10, 12, 7));
+  res = eval_->Add(cts, enc_->Encrypt(bias));
+  EXPECT_THAT(edr->DecodeInt64(dec_->Decrypt(res)),
+              testing::ElementsAre(11, 9, 10, 12, 7));
+  res = eval_->Add(pts, bias);
+  EXPECT_THAT(edr->DecodeInt64(res), testing::ElementsAre(11, 9, 10, 12, 7));
+
+  // sub
+  res = eval_->Sub(cts, bias);
+  EXPECT_THAT(edr->DecodeInt64(dec_->Decrypt(res)),
+              testing::ElementsAre(-9, -11, -10, -8, -13));
+  res = eval_->Sub(bias, cts);
+  EXPECT_THAT(edr->DecodeInt64(dec_->Decrypt(res)),
+              testing::ElementsAre(9, 11, 10, 8, 13));
+
+  // mul
+  res = eval_->Mul(cts, scale);
+  EXPECT_THAT(edr->DecodeInt64(dec_->Decrypt(res)),
+              testing::ElementsAre(-3, 3, 0, -6, 9));
+  res = eval_->Mul(scale, cts);
+  EXPECT_THAT(edr->DecodeInt64(dec_->Decrypt(res)),
+              testing::ElementsAre(-3, 3, 0, -6, 9));
+  res = eval_->Mul(enc_->Encrypt(scale), pts);
+  EXPECT_THAT(edr->DecodeInt64(dec_->Decrypt(res)),
+              testing::ElementsAre(-3, 3, 0, -6, 9));
+  for (int64_t s : {0, 1, -1}) {
+    res = eval_->Mul(cts, edr->Encode(s));
+    EXPECT_THAT(edr->DecodeInt64(dec_->Decrypt(res)),
+                testing::ElementsAre(s, -s, 0, 2 * s, -3 * s));
+  }
+
+  // inplace
+  auto cts1 = enc_->Encrypt(pts);
+  eval_->AddInplace(&cts1, bias);
+  EXPECT_THAT(edr->DecodeInt64(dec_->Decrypt(cts1)),
+              testing::ElementsAre(11, 9, 10, 12, 7));
+  eval_->SubInplace(&cts1, bias);
+  EXPECT_THAT(edr->DecodeInt64(dec_->Decrypt(cts1)),
+              testing::ElementsAre(1, -1, 0, 2, -3));
+  eval_->MulInplace(&cts1, scale);
+  EXPECT_THAT(edr->DecodeInt64(dec_->Decrypt(cts1)),
+              testing::ElementsAre(-3, 3, 0, -6, 9));
+
+  // a scalar ciphertext becomes a vector
+  auto ct = enc_->Encrypt(bias);
+  eval_->AddInplace(&ct, pts);
+  EXPECT_EQ(kit_->GetItemTool()->ItemSize(ct), 5);
+  EXPECT_THAT(edr->DecodeInt64(dec_->Decrypt(ct)),
+              testing::ElementsAre(11, 9, 10, 12, 7));
+}
+
 TEST_P(ArithmeticTest, TestSwapRows) {
   if (kit_->GetFeatureSet() == FeatureSet::AdditivePHE) {
     GTEST_SKIP();
@@ -60,6 +60,12 @@ namespace heu::spi {
 
 // Call:
 //   virtual T FuncName(const TX& x, const TY& y) const = 0;
+// and, if one side is a ciphertext vector and the other a plaintext scalar:
+//   virtual void FuncName(absl::Span<const CiphertextT> x, const PlaintextT& y,
+//                         absl::Span<CiphertextT> out) const;
+//   virtual void FuncName(const PlaintextT& x, absl::Span<const CiphertextT> y,
+//                         absl::Span<CiphertextT> out) const;
+// The scalar operand is broadcast by reference, it is never materialized.
 #define CallBinaryFunc(FuncName, TX, TY)                                      \
   do {                                                                        \
     using RES_T = decltype(FuncName(std::declval<const TX>(),                 \
@@ -86,14 +92,52 @@ namespace heu::spi {
         });                                                                   \
         return Item::Take(std::move(res), RuntimeType(RES_T));                \
       }                                                                       \
+      case yacl::OperandType::Scalar2Vector: {                                \
+        const TX &xs = x.As<TX>();                                            \
+        auto ysp = y.AsSpan<TY>();                                            \
+        std::vector<RES_T> res;                                               \
+        res.resize(ysp.length());                                             \
+        if constexpr (std::is_same_v<TX, PlaintextT> &&                       \
+                      std::is_same_v<TY, CiphertextT>) {                      \
+          FuncName(xs, ysp, absl::MakeSpan(res));                             \
+        } else {                                                              \
+          yacl::parallel_for(0, ysp.length(), [&](int64_t beg, int64_t end) { \
+            for (int64_t i = beg; i < end; ++i) {                             \
+              res[i] = FuncName(xs, ysp[i]);                                  \
+            }                                                                 \
+          });                                                                 \
+        }                                                                     \
+        return Item::Take(std::move(res), RuntimeType(RES_T));                \
+      }                                                                       \
+      case yacl::OperandType::Vector2Scalar: {                                \
+        auto xsp = x.AsSpan<TX>();                                            \
+        const TY &ys = y.As<TY>();                                            \
+        std::vector<RES_T> res;                                               \
+        res.resize(xsp.length());                                             \
+        if constexpr (std::is_same_v<TX, CiphertextT> &&                      \
+                      std::is_same_v<TY, PlaintextT>) {                       \
+          FuncName(xsp, ys, absl::MakeSpan(res));                             \
+        } else {                                                              \
+          yacl::parallel_for(0, xsp.length(), [&](int64_t beg, int64_t end) { \
+            for (int64_t i = beg; i < end; ++i) {                             \
+              res[i] = FuncName(xsp[i], ys);                                  \
+            }                                                                 \
+          });                                                                 \
+        }                                                                     \
+        return Item::Take(std::move(res), RuntimeType(RES_T));                \
+      }                                                                       \
       default:                                                                \
-        YACL_THROW("Scalar sketch method [{}] doesn't support broadcast now", \
+        YACL_THROW("Scalar sketch method [{}]: unknown operand type",         \
                    #FuncName);                                                \
     }                                                                         \
   } while (0)
 
 // Call:
 //   virtual void FuncName(TX* x, const TY& y) const = 0;
+// and, if x is a ciphertext vector and y a plaintext scalar:
+//   virtual void FuncName(absl::Span<CiphertextT> x,
+//                         const PlaintextT& y) const;
+// If x is a scalar and y is a vector, x becomes a vector.
 #define CallBinaryInplaceFunc(FuncName, TX, TY)                               \
   do {                                                                        \
     switch (*x, y) {                                                          \
@@ -115,8 +159,34 @@ namespace heu::spi {
         });                                                                   \
         return;                                                               \
       }                                                                       \
+      case yacl::OperandType::Scalar2Vector: {                                \
+        auto ysp = y.AsSpan<TY>();                                            \
+        std::vector<TX> res(ysp.length(), *x->As<TX *>());                    \
+        yacl::parallel_for(0, ysp.length(), [&](int64_t beg, int64_t end) {   \
+          for (int64_t i = beg; i < end; ++i) {                               \
+            FuncName(&res[i], ysp[i]);                                        \
+          }                                                                   \
+        });                                                                   \
+        *x = Item::Take(std::move(res), RuntimeType(TX));                     \
+        return;                                                               \
+      }                                                                       \
+      case yacl::OperandType::Vector2Scalar: {                                \
+        auto xsp = x->AsSpan<TX>();                                           \
+        const TY &ys = y.As<TY>();                                            \
+        if constexpr (std::is_same_v<TX, CiphertextT> &&                      \
+                      std::is_same_v<TY, PlaintextT>) {                       \
+          FuncName(xsp, ys);                                                  \
+        } else {                                                              \
+          yacl::parallel_for(0, xsp.length(), [&](int64_t beg, int64_t end) { \
+            for (int64_t i = beg; i < end; ++i) {                             \
+              FuncName(&xsp[i], ys);                                          \
+            }                                                                 \
+          });                                                                 \
+        }                                                                     \
+        return;                                                               \
+      }                                                                       \
       default:                                                                \
-        YACL_THROW("Scalar sketch method [{}] doesn't support broadcast now", \
+        YACL_THROW("Scalar sketch method [{}]: unknown operand type",         \
                    #FuncName);                                                \
     }                                                                         \
   } while (0)
@@ -186,6 +186,71 @@ TEST_F(TestWessVecCall, TestVecInplace) {
   ExpectItemEq<DummyCt>(cts, {":= boot(ct1)", ":= boot(ct2)", ":= boot(ct3)"});
 }
 
+TEST_F(TestWessVecCall, TestBroadcast) {
+  std::vector<DummyPt> pts_vec = {DummyPt("1"), DummyPt("2"), DummyPt("3")};
+  auto pts = Item::Ref(pts_vec, ContentType::Plaintext);
+  std::vector<DummyCt> cts_vec = {DummyCt("1"), DummyCt("2"), DummyCt("3")};
+  auto cts = Item::Ref(cts_vec, ContentType::Ciphertext);
+  Item pt = {DummyPt("7"), ContentType::Plaintext};
+  Item ct = {DummyCt("7"), ContentType::Ciphertext};
+
+  // add
+  Item res = we_->Add(cts, pt);
+  ExpectItemEq<DummyCt>(res, {"ct1+pt7", "ct2+pt7", "ct3+pt7"});
+  res = we_->Add(pt, cts);
+  ExpectItemEq<DummyCt>(res, {"pt7+ct1", "pt7+ct2", "pt7+ct3"});
+  res = we_->Add(cts, ct);
+  ExpectItemEq<DummyCt>(res, {"ct1+ct7", "ct2+ct7", "ct3+ct7"});
+  res = we_->Add(ct, pts);
+  ExpectItemEq<DummyCt>(res, {"ct7+pt1", "ct7+pt2", "ct7+pt3"});
+  res = we_->Add(pts, pt);
+  ExpectItemEq<DummyPt>(res, {"pt1+pt7", "pt2+pt7", "pt3+pt7"});
+
+  // sub
+  res = we_->Sub(cts, pt);
+  ExpectItemEq<DummyCt>(res, {"ct1-pt7", "ct2-pt7", "ct3-pt7"});
+  res = we_->Sub(pt, cts);
+  ExpectItemEq<DummyCt>(res, {"pt7-ct1", "pt7-ct2", "pt7-ct3"});
+  res = we_->Sub(pts, ct);
+  ExpectItemEq<DummyCt>(res, {"pt1-ct7", "pt2-ct7", "pt3-ct7"});
+
+  // mul
+  res = we_->Mul(cts, pt);
+  ExpectItemEq<DummyCt>(res, {"ct1*pt7", "ct2*pt7", "ct3*pt7"});
+  res = we_->Mul(pt, cts);
+  ExpectItemEq<DummyCt>(res, {"pt7*ct1", "pt7*ct2", "pt7*ct3"});
+  res = we_->Mul(ct, pts);
+  ExpectItemEq<DummyCt>(res, {"ct7*pt1", "ct7*pt2", "ct7*pt3"});
+  res = we_->Mul(pt, pts);
+  ExpectItemEq<DummyPt>(res, {"pt7*pt1", "pt7*pt2", "pt7*pt3"});
+}
+
+TEST_F(TestWessVecCall, TestBroadcastInplace) {
+  std::vector<DummyPt> pts_vec = {DummyPt("1"), DummyPt("2"), DummyPt("3")};
+  auto pts = Item::Ref(pts_vec, ContentType::Plaintext);
+  std::vector<DummyCt> cts_vec = {DummyCt("1"), DummyCt("2"), DummyCt("3")};
+  auto cts = Item::Ref(cts_vec, ContentType::Ciphertext);
+  Item pt = {DummyPt("7"), ContentType::Plaintext};
+
+  we_->AddInplace(&cts, pt);
+  ExpectItemEq<DummyCt>(cts, {"ct1+=pt7", "ct2+=pt7", "ct3+=pt7"});
+  cts_vec = {DummyCt("1"), DummyCt("2"), DummyCt("3")};
+  we_->SubInplace(&cts, pt);
+  ExpectItemEq<DummyCt>(cts, {"ct1-=pt7", "ct2-=pt7", "ct3-=pt7"});
+  cts_vec = {DummyCt("1"), DummyCt("2"), DummyCt("3")};
+  we_->MulInplace(&cts, pt);
+  ExpectItemEq<DummyCt>(cts, {"ct1*=pt7", "ct2*=pt7", "ct3*=pt7"});
+
+  cts_vec = {DummyCt("1"), DummyCt("2"), DummyCt("3")};
+  Item ct = {DummyCt("7"), ContentType::Ciphertext};
+  we_->AddInplace(&cts, ct);
+  ExpectItemEq<DummyCt>(cts, {"ct1+=ct7", "ct2+=ct7", "ct3+=ct7"});
+
+  // a scalar x becomes a vector
+  we_->MulInplace(&ct, pts);
+  ExpectItemEq<DummyCt>(ct, {"ct7*=pt1", "ct7*=pt2", "ct7*=pt3"});
+}
+
 TEST_F(TestWessVecCall, TestVecException) {
   std::vector<DummyPt> pts_vec = {DummyPt("1"), DummyPt("2"), DummyPt("3")};
   auto pts = Item::Ref(pts_vec, ContentType::Plaintext);
@@ -22,6 +22,9 @@
 
 #include <cstdint>
 
+#include "absl/types/span.h"
+#include "yacl/utils/parallel.h"
+
 #include "heu/spi/he/sketches/scalar/helpful_macros.h"
 #include "heu/spi/he/word_evaluator.h"
 
@@ -105,6 +108,94 @@ class WordEvaluatorScalarSketch : public WordEvaluator {
   virtual void MulInplace(CiphertextT *a, const PlaintextT &b) const = 0;
   virtual void MulInplace(CiphertextT *a, const CiphertextT &b) const = 0;
 
+  // CTs = CTs op PT
+  // CTs = PT op CTs
+  // CTs op= PT
+  // The same plaintext is applied to every ciphertext, e.g. adding a bias or
+  // scaling by a constant. The defaults call the element-wise ops above, libs
+  // may override them to preprocess the plaintext only once. 'out' has the
+  // same length as the ciphertext span and may alias it.
+  virtual void Add(absl::Span<const CiphertextT> a, const PlaintextT &b,
+                   absl::Span<CiphertextT> out) const {
+    yacl::parallel_for(0, a.size(), [&](int64_t beg, int64_t end) {
+      for (int64_t i = beg; i < end; ++i) {
+        out[i] = Add(a[i], b);
+      }
+    });
+  }
+
+  virtual void Add(const PlaintextT &a, absl::Span<const CiphertextT> b,
+                   absl::Span<CiphertextT> out) const {
+    yacl::parallel_for(0, b.size(), [&](int64_t beg, int64_t end) {
+      for (int64_t i = beg; i < end; ++i) {
+        out[i] = Add(a, b[i]);
+      }
+    });
+  }
+
+  virtual void AddInplace(absl::Span<CiphertextT> a,
+                          const PlaintextT &b) const {
+    yacl::parallel_for(0, a.size(), [&](int64_t beg, int64_t end) {
+      for (int64_t i = beg; i < end; ++i) {
+        AddInplace(&a[i], b);
+      }
+    });
+  }
+
+  virtual void Sub(absl::Span<const CiphertextT> a, const PlaintextT &b,
+                   absl::Span<CiphertextT> out) const {
+    yacl::parallel_for(0, a.size(), [&](int64_t beg, int64_t end) {
+      for (int64_t i = beg; i < end; ++i) {
+        out[i] = Sub(a[i], b);
+      }
+    });
+  }
+
+  virtual void Sub(const PlaintextT &a, absl::Span<const CiphertextT> b,
+                   absl::Span<CiphertextT> out) const {
+    yacl::parallel_for(0, b.size(), [&](int64_t beg, int64_t end) {
+      for (int64_t i = beg; i < end; ++i) {
+        out[i] = Sub(a, b[i]);
+      }
+    });
+  }
+
+  virtual void SubInplace(absl::Span<CiphertextT> a,
+                          const PlaintextT &b) const {
+    yacl::parallel_for(0, a.size(), [&](int64_t beg, int64_t end) {
+      for (int64_t i = beg; i < end; ++i) {
+        SubInplace(&a[i], b);
+      }
+    });
+  }
+
+  virtual void Mul(absl::Span<const CiphertextT> a, const PlaintextT &b,
+                   absl::Span<CiphertextT> out) const {
+    yacl::parallel_for(0, a.size(), [&](int64_t beg, int64_t end) {
+      for (int64_t i = beg; i < end; ++i) {
+        out[i] = Mul(a[i], b);
+      }
+    });
+  }
+
+  virtual void Mul(const PlaintextT &a, absl::Span<const CiphertextT> b,
+                   absl::Span<CiphertextT> out) const {
+    yacl::parallel_for(0, b.size(), [&](int64_t beg, int64_t end) {
+      for (int64_t i = beg; i < end; ++i) {
+        out[i] = Mul(a, b[i]);
+      }
+    });
+  }
+
+  virtual void MulInplace(absl::Span<CiphertextT> a,
+                          const PlaintextT &b) const {
+    yacl::parallel_for(0, a.size(), [&](int64_t beg, int64_t end) {
+      for (int64_t i = beg; i < end; ++i) {
+        MulInplace(&a[i], b);
+      }
+    });
+  }
+
   virtual PlaintextT Square(const PlaintextT &a) const = 0;
   virtual CiphertextT Square(const CiphertextT &a) const = 0;
   virtual void SquareInplace(PlaintextT *a) const = 0;
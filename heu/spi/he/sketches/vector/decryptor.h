@@ -0,0 +1,39 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "heu/spi/he/decryptor.h"
+#include "heu/spi/he/sketches/vector/helpful_macros.h"
+
+namespace heu::spi {
+
+template <typename PlaintextT, typename CiphertextT>
+class DecryptorVectorSketch : public Decryptor {
+ public:
+  virtual void Decrypt(const absl::Span<const CiphertextT> &cts,
+                       absl::Span<PlaintextT> out) const = 0;
+  virtual std::vector<PlaintextT> Decrypt(
+      const absl::Span<const CiphertextT> &cts) const = 0;
+
+ private:
+  VecDefineUnaryFuncCStyle(Decrypt, CiphertextT, PlaintextT);
+  VecDefineUnaryFuncCT(Decrypt);
+};
+
+}  // namespace heu::spi
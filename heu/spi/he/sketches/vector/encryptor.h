@@ -0,0 +1,81 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_join.h"
+#include "absl/types/span.h"
+
+#include "heu/spi/he/encryptor.h"
+#include "heu/spi/he/sketches/vector/helpful_macros.h"
+
+namespace heu::spi {
+
+template <typename PlaintextT, typename CiphertextT>
+class EncryptorVectorSketch : public Encryptor {
+ public:
+  virtual std::vector<CiphertextT> Encrypt(
+      const absl::Span<const PlaintextT> &plaintexts) const = 0;
+  virtual void Encrypt(const absl::Span<const PlaintextT> &plaintexts,
+                       absl::Span<CiphertextT> out) const = 0;
+
+  virtual std::vector<CiphertextT> EncryptZeroT(size_t count) const = 0;
+
+  virtual std::vector<CiphertextT> SemiEncrypt(
+      const absl::Span<const PlaintextT> &plaintexts) const = 0;
+
+  // Encrypt plaintexts and record all pseudorandom data for audit, one audit
+  // string per plaintext.
+  virtual void EncryptWithAudit(const absl::Span<const PlaintextT> &plaintexts,
+                                absl::Span<CiphertextT> ct_out,
+                                absl::Span<std::string> audit_out) const = 0;
+
+ private:
+  VecDefineUnaryFuncPT(Encrypt);
+  VecDefineUnaryFuncCStyle(Encrypt, PlaintextT, CiphertextT);
+
+  VecDefineUnaryFuncPT(SemiEncrypt);
+
+  Item EncryptZero() const override {
+    auto res = EncryptZeroT(1);
+    return Item(std::move(res[0]), ContentType::Ciphertext);
+  }
+
+  Item EncryptZero(size_t count) const override {
+    return Item::Take(EncryptZeroT(count), ContentType::Ciphertext);
+  }
+
+  void EncryptWithAudit(const Item &x, Item *ct_out,
+                        std::string *audit_out) const override {
+    if (x.IsArray()) {
+      auto xsp = x.AsSpan<PlaintextT>();
+      auto ysp = ct_out->ResizeAndSpan<CiphertextT>(xsp.size());
+      std::vector<std::string> audits(xsp.size());
+      EncryptWithAudit(xsp, ysp, absl::MakeSpan(audits));
+      audit_out->assign(absl::StrJoin(audits, "||"));
+    } else {
+      EncryptWithAudit(absl::MakeConstSpan(&x.As<PlaintextT>(), 1),
+                       absl::MakeSpan(ct_out->As<CiphertextT *>(), 1),
+                       absl::MakeSpan(audit_out, 1));
+    };
+
+    ct_out->MarkAsCiphertext();
+  }
+};
+
+}  // namespace heu::spi
@@ -0,0 +1,281 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "heu/spi/he/item.h"
+
+// The vector version of sketches/scalar/helpful_macros.h. A scalar item is
+// viewed as a span of length 1, so the lib always gets a batch.
+
+namespace heu::spi {
+
+#define RuntimeType(T)                                      \
+  std::is_same_v<CiphertextT, T>  ? ContentType::Ciphertext \
+  : std::is_same_v<PlaintextT, T> ? ContentType::Plaintext  \
+                                  : ContentType::Others
+
+// Call:
+//   virtual std::vector<R> FuncName(const absl::Span<const T>& x) const = 0;
+//   virtual std::vector<R> FuncName(const absl::Span<const T>& x, ...) const;
+#define VecCallUnaryFunc(FuncName, T, x, ...)                                 \
+  do {                                                                        \
+    using RES_T = typename decltype(FuncName(                                 \
+        std::declval<absl::Span<const T>>(), ##__VA_ARGS__))::value_type;     \
+                                                                              \
+    if (x.IsArray()) {                                                        \
+      return Item::Take(FuncName(x.AsSpan<T>(), ##__VA_ARGS__),               \
+                        RuntimeType(RES_T));                                  \
+    } else {                                                                  \
+      auto res = FuncName(absl::MakeConstSpan(&x.As<T>(), 1), ##__VA_ARGS__); \
+      return {std::move(res[0]), RuntimeType(RES_T)};                         \
+    }                                                                         \
+  } while (0)
+
+// Call:
+//   virtual void FuncName(absl::Span<T> x) const = 0;
+//   virtual void FuncName(absl::Span<T> x, ...) const = 0;
+#define VecCallUnaryInplaceFunc(FuncName, T, x, ...)            \
+  do {                                                          \
+    if (x->IsArray()) {                                         \
+      FuncName(x->AsSpan<T>(), ##__VA_ARGS__);                  \
+    } else {                                                    \
+      FuncName(absl::MakeSpan(x->As<T *>(), 1), ##__VA_ARGS__); \
+    }                                                           \
+  } while (0)
+
+// Call:
+//   virtual std::vector<R> FuncName(const absl::Span<const TX>& x,
+//                                   const absl::Span<const TY>& y) const = 0;
+// and, if one side is a ciphertext vector and the other a plaintext scalar:
+//   virtual std::vector<CiphertextT> FuncName(
+//       const absl::Span<const CiphertextT>& x, const PlaintextT& y) const;
+//   virtual std::vector<CiphertextT> FuncName(
+//       const PlaintextT& x, const absl::Span<const CiphertextT>& y) const;
+// Other broadcast combinations repeat the scalar operand into a vector.
+#define VecCallBinaryFunc(FuncName, TX, TY)                                 \
+  do {                                                                      \
+    using RES_T = typename decltype(FuncName(                               \
+        std::declval<absl::Span<const TX>>(),                               \
+        std::declval<absl::Span<const TY>>()))::value_type;                 \
+                                                                            \
+    switch (x, y) {                                                         \
+      case yacl::OperandType::Scalar2Scalar: {                              \
+        auto res = FuncName(absl::MakeConstSpan(&x.As<TX>(), 1),            \
+                            absl::MakeConstSpan(&y.As<TY>(), 1));           \
+        return {std::move(res[0]), RuntimeType(RES_T)};                     \
+      }                                                                     \
+      case yacl::OperandType::Vector2Vector: {                              \
+        auto xsp = x.AsSpan<TX>();                                          \
+        auto ysp = y.AsSpan<TY>();                                          \
+        YACL_ENFORCE_EQ(                                                    \
+            xsp.length(), ysp.length(),                                     \
+            "operands must have the same length, x.len={}, y.len={}",       \
+            xsp.length(), ysp.length());                                    \
+        return Item::Take(FuncName(xsp, ysp), RuntimeType(RES_T));          \
+      }                                                                     \
+      case yacl::OperandType::Scalar2Vector: {                              \
+        auto ysp = y.AsSpan<TY>();                                          \
+        if constexpr (std::is_same_v<TX, PlaintextT> &&                     \
+                      std::is_same_v<TY, CiphertextT>) {                    \
+          return Item::Take(FuncName(x.As<TX>(), ysp), RuntimeType(RES_T)); \
+        } else {                                                            \
+          std::vector<TX> xs(ysp.length(), x.As<TX>());                     \
+          return Item::Take(FuncName(absl::MakeConstSpan(xs), ysp),         \
+                            RuntimeType(RES_T));                            \
+        }                                                                   \
+      }                                                                     \
+      case yacl::OperandType::Vector2Scalar: {                              \
+        auto xsp = x.AsSpan<TX>();                                          \
+        if constexpr (std::is_same_v<TX, CiphertextT> &&                    \
+                      std::is_same_v<TY, PlaintextT>) {                     \
+          return Item::Take(FuncName(xsp, y.As<TY>()), RuntimeType(RES_T)); \
+        } else {                                                            \
+          std::vector<TY> ys(xsp.length(), y.As<TY>());                     \
+          return Item::Take(FuncName(xsp, absl::MakeConstSpan(ys)),         \
+                            RuntimeType(RES_T));                            \
+        }                                                                   \
+      }                                                                     \
+      default:                                                              \
+        YACL_THROW("Vector sketch method [{}]: unknown operand type",       \
+                   #FuncName);                                              \
+    }                                                                       \
+  } while (0)
+
+// Call:
+//   virtual void FuncName(absl::Span<TX> x,
+//                         const absl::Span<const TY>& y) const = 0;
+// and, if x is a ciphertext vector and y a plaintext scalar:
+//   virtual void FuncName(absl::Span<CiphertextT> x,
+//                         const PlaintextT& y) const;
+// If x is a scalar and y is a vector, x becomes a vector.
+#define VecCallBinaryInplaceFunc(FuncName, TX, TY)                    \
+  do {                                                                \
+    switch (*x, y) {                                                  \
+      case yacl::OperandType::Scalar2Scalar: {                        \
+        FuncName(absl::MakeSpan(x->As<TX *>(), 1),                    \
+                 absl::MakeConstSpan(&y.As<TY>(), 1));                \
+        return;                                                       \
+      }                                                               \
+      case yacl::OperandType::Vector2Vector: {                        \
+        auto xsp = x->AsSpan<TX>();                                   \
+        auto ysp = y.AsSpan<TY>();                                    \
+        YACL_ENFORCE_EQ(                                              \
+            xsp.length(), ysp.length(),                               \
+            "operands must have the same length, x.len={}, y.len={}", \
+            xsp.length(), ysp.length());                              \
+        FuncName(xsp, ysp);                                           \
+        return;                                                       \
+      }                                                               \
+      case yacl::OperandType::Scalar2Vector: {                        \
+        auto ysp = y.AsSpan<TY>();                                    \
+        std::vector<TX> res(ysp.length(), *x->As<TX *>());            \
+        FuncName(absl::MakeSpan(res), ysp);                           \
+        *x = Item::Take(std::move(res), RuntimeType(TX));             \
+        return;                                                       \
+      }                                                               \
+      case yacl::OperandType::Vector2Scalar: {                        \
+        auto xsp = x->AsSpan<TX>();                                   \
+        if constexpr (std::is_same_v<TX, CiphertextT> &&              \
+                      std::is_same_v<TY, PlaintextT>) {               \
+          FuncName(xsp, y.As<TY>());                                  \
+        } else {                                                      \
+          std::vector<TY> ys(xsp.length(), y.As<TY>());               \
+          FuncName(xsp, absl::MakeConstSpan(ys));                     \
+        }                                                             \
+        return;                                                       \
+      }                                                               \
+      default:                                                        \
+        YACL_THROW("Vector sketch method [{}]: unknown operand type", \
+                   #FuncName);                                        \
+    }                                                                 \
+  } while (0)
+
+//==================================//
+//      Define whole function       //
+//==================================//
+
+// From:
+//   virtual Item FuncName(const Item& x) const = 0;
+// To:
+//   virtual std::vector<T> FuncName(const absl::Span<const T>& x) const = 0;
+#define VecDefineUnaryFuncBoth(FuncName)                             \
+  Item FuncName(const Item &x) const override {                      \
+    if (x.IsCiphertext()) {                                          \
+      VecCallUnaryFunc(FuncName, CiphertextT, x);                    \
+    } else if (x.IsPlaintext()) {                                    \
+      VecCallUnaryFunc(FuncName, PlaintextT, x);                     \
+    } else {                                                         \
+      YACL_THROW("Function {}: Unsupported item type {}", #FuncName, \
+                 x.GetContentType());                                \
+    }                                                                \
+  }
+
+#define VecDefineUnaryFuncCT(FuncName)                                 \
+  Item FuncName(const Item &x) const override {                        \
+    YACL_ENFORCE(x.IsCiphertext(),                                     \
+                 #FuncName ": input arg must be a cipher, real is {}", \
+                 x.ToString());                                        \
+    VecCallUnaryFunc(FuncName, CiphertextT, x);                        \
+  }
+
+#define VecDefineUnaryFuncPT(FuncName)                                    \
+  Item FuncName(const Item &x) const override {                           \
+    YACL_ENFORCE(x.IsPlaintext(),                                         \
+                 #FuncName ": input arg must be a plaintext, real is {}", \
+                 x.ToString());                                           \
+    VecCallUnaryFunc(FuncName, PlaintextT, x);                            \
+  }
+
+// From:
+//   virtual void FuncName(const Item &x, Item *out) const = 0;
+// To:
+//   virtual void FuncName(const absl::Span<const TX>& x,
+//                         absl::Span<TY> out) const = 0;
+#define VecDefineUnaryFuncCStyle(FuncName, TX, TY)         \
+  void FuncName(const Item &x, Item *out) const override { \
+    if (x.IsArray()) {                                     \
+      auto xsp = x.AsSpan<TX>();                           \
+      FuncName(xsp, out->ResizeAndSpan<TY>(xsp.size()));   \
+    } else {                                               \
+      FuncName(absl::MakeConstSpan(&x.As<TX>(), 1),        \
+               absl::MakeSpan(out->As<TY *>(), 1));        \
+    };                                                     \
+    out->MarkAs(RuntimeType(TY));                          \
+  }
+
+// From:
+//   virtual void FuncName(Item* x) const = 0;
+// To:
+//   virtual void FuncName(absl::Span<T> x) const = 0;
+#define VecDefineUnaryInplaceFunc(FuncName)              \
+  void FuncName(Item *x) const override {                \
+    if (x->IsCiphertext()) {                             \
+      VecCallUnaryInplaceFunc(FuncName, CiphertextT, x); \
+    } else {                                             \
+      VecCallUnaryInplaceFunc(FuncName, PlaintextT, x);  \
+    }                                                    \
+  }
+
+#define VecDefineUnaryInplaceFuncOnlyCipher(FuncName)                  \
+  void FuncName(Item *x) const override {                              \
+    YACL_ENFORCE(x->IsCiphertext(),                                    \
+                 #FuncName ": input arg must be a cipher, real is {}", \
+                 x->ToString());                                       \
+    VecCallUnaryInplaceFunc(FuncName, CiphertextT, x);                 \
+  }
+
+// From:
+//   virtual Item FuncName(const Item& x, const Item& y) const = 0;
+// To:
+//   virtual std::vector<T> FuncName(const absl::Span<const T>& x,
+//                                   const absl::Span<const T>& y) const = 0;
+#define VecDefineBinaryFunc(FuncName)                          \
+  Item FuncName(const Item &x, const Item &y) const override { \
+    if (x.IsCiphertext()) {                                    \
+      if (y.IsCiphertext()) {                                  \
+        VecCallBinaryFunc(FuncName, CiphertextT, CiphertextT); \
+      } else {                                                 \
+        VecCallBinaryFunc(FuncName, CiphertextT, PlaintextT);  \
+      }                                                        \
+    } else { /* x is plaintext */                              \
+      if (y.IsCiphertext()) {                                  \
+        VecCallBinaryFunc(FuncName, PlaintextT, CiphertextT);  \
+      } else {                                                 \
+        VecCallBinaryFunc(FuncName, PlaintextT, PlaintextT);   \
+      }                                                        \
+    }                                                          \
+  }
+
+// From:
+//   virtual void FuncName(Item* x, const Item& y) const = 0;
+// To:
+//   virtual void FuncName(absl::Span<T> x,
+//                         const absl::Span<const T>& y) const = 0;
+#define VecDefineBinaryInplaceFunc(FuncName)                          \
+  void FuncName(Item *x, const Item &y) const override {              \
+    if (x->IsCiphertext()) {                                          \
+      if (y.IsCiphertext()) {                                         \
+        VecCallBinaryInplaceFunc(FuncName, CiphertextT, CiphertextT); \
+      } else {                                                        \
+        VecCallBinaryInplaceFunc(FuncName, CiphertextT, PlaintextT);  \
+      }                                                               \
+    } /* no plaintext branch */                                       \
+  }
+
+}  // namespace heu::spi
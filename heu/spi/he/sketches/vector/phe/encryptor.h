@@ -0,0 +1,33 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "heu/spi/he/sketches/vector/encryptor.h"
+
+namespace heu::spi {
+
+template <typename PlaintextT, typename CiphertextT>
+class PheEncryptorVectorSketch
+    : public EncryptorVectorSketch<PlaintextT, CiphertextT> {
+ public:
+  std::vector<CiphertextT> SemiEncrypt(
+      const absl::Span<const PlaintextT> &plaintexts) const override {
+    return this->Encrypt(plaintexts);
+  }
+};
+
+}  // namespace heu::spi
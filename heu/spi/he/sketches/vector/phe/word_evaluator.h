@@ -0,0 +1,145 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "heu/spi/he/sketches/vector/word_evaluator.h"
+
+namespace heu::spi {
+
+template <typename PlaintextT, typename CiphertextT>
+class PheWordEvaluatorVectorSketch
+    : public WordEvaluatorVectorSketch<PlaintextT, CiphertextT> {
+ public:
+  //===   Arithmetic Operations   ===//
+
+  std::vector<CiphertextT> Mul(
+      const absl::Span<const CiphertextT> &,
+      const absl::Span<const CiphertextT> &) const override {
+    YACL_THROW(
+        "Phe schema does not support ciphertext multiplication, please switch "
+        "to FHE schemas");
+  }
+
+  void MulInplace(absl::Span<CiphertextT>,
+                  const absl::Span<const CiphertextT> &) const override {
+    YACL_THROW(
+        "Phe schema does not support ciphertext multiplication, please switch "
+        "to FHE schemas");
+  }
+
+  std::vector<CiphertextT> Square(
+      const absl::Span<const CiphertextT> &) const override {
+    YACL_THROW(
+        "Phe schema does not support ciphertext square, please switch to FHE "
+        "schemas");
+  }
+
+  void SquareInplace(absl::Span<CiphertextT>) const override {
+    YACL_THROW(
+        "Phe schema does not support ciphertext square, please switch to FHE "
+        "schemas");
+  }
+
+  std::vector<CiphertextT> Pow(const absl::Span<const CiphertextT> &,
+                               int64_t) const override {
+    YACL_THROW(
+        "Phe schema does not support ciphertext pow, please switch to FHE "
+        "schemas");
+  }
+
+  void PowInplace(absl::Span<CiphertextT>, int64_t) const override {
+    YACL_THROW(
+        "Phe schema does not support ciphertext pow, please switch to FHE "
+        "schemas");
+  }
+
+  //===   FHE only operations   ===//
+
+  std::vector<CiphertextT> Relinearize(
+      const absl::Span<const CiphertextT> &a) const override {
+    // nothing to do; PHE ciphertexts are always linearized.
+    return {a.begin(), a.end()};
+  }
+
+  void RelinearizeInplace(absl::Span<CiphertextT>) const override {
+    // nothing to do; PHE ciphertexts are always linearized.
+  }
+
+  std::vector<CiphertextT> ModSwitch(
+      const absl::Span<const CiphertextT> &) const override {
+    YACL_THROW(
+        "Phe schema does not support modulus switch, please switch to FHE "
+        "schemas");
+  }
+
+  void ModSwitchInplace(absl::Span<CiphertextT>) const override {
+    YACL_THROW(
+        "Phe schema does not support modulus switch, please switch to FHE "
+        "schemas");
+  }
+
+  std::vector<CiphertextT> Rescale(
+      const absl::Span<const CiphertextT> &) const override {
+    YACL_THROW(
+        "Phe schema does not support rescaling, please switch to FHE schemas");
+  }
+
+  void RescaleInplace(absl::Span<CiphertextT>) const override {
+    YACL_THROW(
+        "Phe schema does not support rescaling, please switch to FHE schemas");
+  }
+
+  std::vector<CiphertextT> SwapRows(
+      const absl::Span<const CiphertextT> &) const override {
+    YACL_THROW(
+        "Phe schema does not support swap rows, please switch to FHE schemas");
+  }
+
+  void SwapRowsInplace(absl::Span<CiphertextT>) const override {
+    YACL_THROW(
+        "Phe schema does not support swap rows, please switch to FHE schemas");
+  }
+
+  std::vector<CiphertextT> Conjugate(
+      const absl::Span<const CiphertextT> &) const override {
+    YACL_THROW(
+        "Phe schema does not support conjugate, please switch to FHE schemas");
+  }
+
+  void ConjugateInplace(absl::Span<CiphertextT>) const override {
+    YACL_THROW(
+        "Phe schema does not support conjugate, please switch to FHE schemas");
+  }
+
+  std::vector<CiphertextT> Rotate(const absl::Span<const CiphertextT> &,
+                                  int) const override {
+    YACL_THROW(
+        "Phe schema does not support rotating, please switch to FHE schemas");
+  }
+
+  void RotateInplace(absl::Span<CiphertextT>, int) const override {
+    YACL_THROW(
+        "Phe schema does not support rotating, please switch to FHE schemas");
+  }
+
+  void BootstrapInplace(absl::Span<CiphertextT>) const override {
+    // nothing to do, PHE ciphertexts are always fresh.
+  }
+};
+
+}  // namespace heu::spi
@@ -19,12 +19,13 @@
 
 #include "absl/types/span.h"
 
+#include "heu/spi/he/sketches/vector/helpful_macros.h"
 #include "heu/spi/he/word_evaluator.h"
 
 // ================================================================ //
 // <<<              Sketch 接口与 SPI 接口基本类似                 >>> //
 // <<<            此处仅以 WordEvaluator 为例展示接口              >>> //
-// <<< 其它 Encryptor/Evaluator/Decryptor 接口变化同理，此处不再展开 >>> //
+// <<<    Word/Gate/Binary Evaluator 接口变化同理，此处不再展开     >>> //
 // ================================================================ //
 
 namespace heu::spi {
@@ -54,7 +55,9 @@ class WordEvaluatorVectorSketch : public WordEvaluator {
       const absl::Span<const PlaintextT> &b) const = 0;
   virtual std::vector<CiphertextT> Add(
       const absl::Span<const PlaintextT> &a,
-      const absl::Span<const CiphertextT> &b) const = 0;
+      const absl::Span<const CiphertextT> &b) const {
+    return Add(b, a);
+  }
   virtual std::vector<CiphertextT> Add(
       const absl::Span<const CiphertextT> &a,
       const absl::Span<const PlaintextT> &b) const = 0;
@@ -68,28 +71,45 @@ class WordEvaluatorVectorSketch : public WordEvaluator {
   virtual void AddInplace(absl::Span<CiphertextT> a,
                           const absl::Span<const CiphertextT> &b) const = 0;
 
-  // PT = PT + PT
-  // CT = PT + CT
-  // CT = CT + PT
-  // CT = CT + CT
-  // CT += PT
-  // CT += CT
+  // PT = PT - PT
+  // CT = PT - CT
+  // CT = CT - PT
+  // CT = CT - CT
   virtual std::vector<PlaintextT> Sub(
       const absl::Span<const PlaintextT> &a,
-      const absl::Span<const PlaintextT> &b) const = 0;
+      const absl::Span<const PlaintextT> &b) const {
+    return Add(a, Negate(b));
+  }
+
   virtual std::vector<CiphertextT> Sub(
       const absl::Span<const PlaintextT> &a,
-      const absl::Span<const CiphertextT> &b) const = 0;
+      const absl::Span<const CiphertextT> &b) const {
+    return Add(Negate(b), a);
+  }
+
   virtual std::vector<CiphertextT> Sub(
       const absl::Span<const CiphertextT> &a,
-      const absl::Span<const PlaintextT> &b) const = 0;
+      const absl::Span<const PlaintextT> &b) const {
+    return Add(a, Negate(b));
+  }
+
   virtual std::vector<CiphertextT> Sub(
       const absl::Span<const CiphertextT> &a,
-      const absl::Span<const CiphertextT> &b) const = 0;
+      const absl::Span<const CiphertextT> &b) const {
+    return Add(a, Negate(b));
+  }
+
+  // CT -= PT
+  // CT -= CT
   virtual void SubInplace(absl::Span<CiphertextT> a,
-                          const absl::Span<const PlaintextT> &b) const = 0;
+                          const absl::Span<const PlaintextT> &b) const {
+    AddInplace(a, Negate(b));
+  }
+
   virtual void SubInplace(absl::Span<CiphertextT> a,
-                          const absl::Span<const CiphertextT> &b) const = 0;
+                          const absl::Span<const CiphertextT> &b) const {
+    AddInplace(a, Negate(b));
+  }
 
   // PT = PT * PT [AHE/FHE]
   // CT = PT * CT [AHE/FHE]
@@ -100,7 +120,9 @@ class WordEvaluatorVectorSketch : public WordEvaluator {
       const absl::Span<const PlaintextT> &b) const = 0;
   virtual std::vector<CiphertextT> Mul(
       const absl::Span<const PlaintextT> &a,
-      const absl::Span<const CiphertextT> &b) const = 0;
+      const absl::Span<const CiphertextT> &b) const {
+    return Mul(b, a);
+  }
   virtual std::vector<CiphertextT> Mul(
       const absl::Span<const CiphertextT> &a,
       const absl::Span<const PlaintextT> &b) const = 0;
@@ -112,6 +134,55 @@ class WordEvaluatorVectorSketch : public WordEvaluator {
   virtual void MulInplace(absl::Span<CiphertextT> a,
                           const absl::Span<const CiphertextT> &b) const = 0;
 
+  // CTs = CTs op PT
+  // CTs = PT op CTs
+  // CTs op= PT
+  // The same plaintext is applied to every ciphertext, e.g. adding a bias or
+  // scaling by a constant. The defaults repeat the plaintext into a vector,
+  // libs should override them to preprocess the plaintext only once instead.
+  virtual std::vector<CiphertextT> Add(const absl::Span<const CiphertextT> &a,
+                                       const PlaintextT &b) const {
+    std::vector<PlaintextT> bs(a.size(), b);
+    return Add(a, absl::MakeConstSpan(bs));
+  }
+  virtual std::vector<CiphertextT> Add(
+      const PlaintextT &a, const absl::Span<const CiphertextT> &b) const {
+    return Add(b, a);
+  }
+  virtual void AddInplace(absl::Span<CiphertextT> a,
+                          const PlaintextT &b) const {
+    std::vector<PlaintextT> bs(a.size(), b);
+    AddInplace(a, absl::MakeConstSpan(bs));
+  }
+
+  virtual std::vector<CiphertextT> Sub(const absl::Span<const CiphertextT> &a,
+                                       const PlaintextT &b) const {
+    return Add(a, NegateOne(b));
+  }
+  virtual std::vector<CiphertextT> Sub(
+      const PlaintextT &a, const absl::Span<const CiphertextT> &b) const {
+    return Add(Negate(b), a);
+  }
+  virtual void SubInplace(absl::Span<CiphertextT> a,
+                          const PlaintextT &b) const {
+    AddInplace(a, NegateOne(b));
+  }
+
+  virtual std::vector<CiphertextT> Mul(const absl::Span<const CiphertextT> &a,
+                                       const PlaintextT &b) const {
+    std::vector<PlaintextT> bs(a.size(), b);
+    return Mul(a, absl::MakeConstSpan(bs));
+  }
+  virtual std::vector<CiphertextT> Mul(
+      const PlaintextT &a, const absl::Span<const CiphertextT> &b) const {
+    return Mul(b, a);
+  }
+  virtual void MulInplace(absl::Span<CiphertextT> a,
+                          const PlaintextT &b) const {
+    std::vector<PlaintextT> bs(a.size(), b);
+    MulInplace(a, absl::MakeConstSpan(bs));
+  }
+
   virtual std::vector<PlaintextT> Square(
       const absl::Span<const PlaintextT> &a) const = 0;
   virtual std::vector<CiphertextT> Square(
@@ -171,6 +242,83 @@ class WordEvaluatorVectorSketch : public WordEvaluator {
   virtual std::vector<CiphertextT> Rotate(
       const absl::Span<const CiphertextT> &a, int steps) const = 0;
   virtual void RotateInplace(absl::Span<CiphertextT> a, int steps) const = 0;
+
+  // Refresh the noise budget of ciphertext 'a'.
+  // Require Lib to support FeatureSet::FHE.
+  virtual void BootstrapInplace(absl::Span<CiphertextT> a) const = 0;
+
+ private:
+  PlaintextT NegateOne(const PlaintextT &a) const {
+    return std::move(Negate(absl::MakeConstSpan(&a, 1))[0]);
+  }
+
+  //===   Arithmetic Operations   ===//
+
+  VecDefineUnaryFuncBoth(Negate);
+  VecDefineUnaryInplaceFunc(NegateInplace);
+
+  VecDefineBinaryFunc(Add);
+  VecDefineBinaryInplaceFunc(AddInplace);
+
+  VecDefineBinaryFunc(Sub);
+  VecDefineBinaryInplaceFunc(SubInplace);
+
+  VecDefineBinaryFunc(Mul);
+  VecDefineBinaryInplaceFunc(MulInplace);
+
+  VecDefineUnaryFuncBoth(Square);
+  VecDefineUnaryInplaceFunc(SquareInplace);
+
+  Item Pow(const Item &x, int64_t exponent) const override {
+    if (x.IsCiphertext()) {
+      VecCallUnaryFunc(Pow, CiphertextT, x, exponent);
+    } else {
+      VecCallUnaryFunc(Pow, PlaintextT, x, exponent);
+    }
+  }
+
+  void PowInplace(Item *x, int64_t exponent) const override {
+    if (x->IsCiphertext()) {
+      VecCallUnaryInplaceFunc(PowInplace, CiphertextT, x, exponent);
+    } else {
+      VecCallUnaryInplaceFunc(PowInplace, PlaintextT, x, exponent);
+    }
+  }
+
+  //===   Ciphertext maintains   ===//
+
+  VecDefineUnaryInplaceFuncOnlyCipher(Randomize);
+
+  VecDefineUnaryFuncCT(Relinearize);
+  VecDefineUnaryInplaceFuncOnlyCipher(RelinearizeInplace);
+
+  VecDefineUnaryFuncCT(ModSwitch);
+  VecDefineUnaryInplaceFuncOnlyCipher(ModSwitchInplace);
+
+  VecDefineUnaryFuncCT(Rescale);
+  VecDefineUnaryInplaceFuncOnlyCipher(RescaleInplace);
+
+  //===   Galois automorphism   ===//
+
+  VecDefineUnaryFuncCT(SwapRows);
+  VecDefineUnaryInplaceFuncOnlyCipher(SwapRowsInplace);
+
+  VecDefineUnaryFuncCT(Conjugate);
+  VecDefineUnaryInplaceFuncOnlyCipher(ConjugateInplace);
+
+  Item Rotate(const Item &x, int steps) const override {
+    YACL_ENFORCE(x.IsCiphertext(), "input arg must be a cipher, real is {}",
+                 x.ToString());
+    VecCallUnaryFunc(Rotate, CiphertextT, x, steps);
+  }
+
+  void RotateInplace(Item *x, int steps) const override {
+    YACL_ENFORCE(x->IsCiphertext(), "input arg must be a cipher, real is {}",
+                 x->ToString());
+    VecCallUnaryInplaceFunc(RotateInplace, CiphertextT, x, steps);
+  }
+
+  VecDefineUnaryInplaceFuncOnlyCipher(BootstrapInplace);
 };
 
 }  // namespace heu::spi
@@ -14,11 +14,54 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <new>
 #include <vector>
 
+#include "absl/types/span.h"
+
 namespace heu::spi {
 
+namespace internal {
+
+// std::allocator that aligns the buffer to kAlign bytes, e.g. a cache line
+template <typename T, size_t kAlign>
+struct AlignedAllocator {
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, kAlign>;
+  };
+
+  AlignedAllocator() noexcept = default;
+
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, kAlign> &) noexcept {}
+
+  T *allocate(size_t n) {
+    return static_cast<T *>(
+        ::operator new(n * sizeof(T), std::align_val_t(kAlign)));
+  }
+
+  void deallocate(T *p, size_t) noexcept {
+    ::operator delete(p, std::align_val_t(kAlign));
+  }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, kAlign> &) const noexcept {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const AlignedAllocator<U, kAlign> &) const noexcept {
+    return false;
+  }
+};
+
+}  // namespace internal
+
 class Poly : public std::vector<uint64_t> {
  public:
   using std::vector<uint64_t>::vector;
@@ -26,11 +69,68 @@ class Poly : public std::vector<uint64_t> {
 
 // Polys can store a batch of independent Polys, or sub-polynomials decomposed
 // by RNS.
+//
+// All coefficients live in one flat buffer aligned to a cache line, poly i
+// takes [i * PolyDegree(), (i + 1) * PolyDegree()). Operators that take Moduli
+// reduce poly i modulo moduli[i % moduli.size()], so an RnsPoly keeps its
+// limbs in the order of the moduli, and a batch of RnsPolys is stored one
+// after another.
 class Polys {
  public:
-  // add public functions here
+  static constexpr size_t kAlignment = 64;
+
+  Polys() = default;
+
+  // num_polys zero polynomials of poly_degree coefficients
+  Polys(size_t num_polys, size_t poly_degree)
+      : num_polys_(num_polys),
+        poly_degree_(poly_degree),
+        data_(num_polys * poly_degree) {}
+
+  size_t NumPolys() const { return num_polys_; }
+
+  size_t PolyDegree() const { return poly_degree_; }
+
+  bool Empty() const { return data_.empty(); }
+
+  // Reshapes to num_polys x poly_degree, the coefficients are zeroed
+  void Resize(size_t num_polys, size_t poly_degree) {
+    num_polys_ = num_polys;
+    poly_degree_ = poly_degree;
+    data_.assign(num_polys * poly_degree, 0);
+  }
+
+  // The whole buffer, NumPolys() * PolyDegree() coefficients
+  uint64_t *Data() { return data_.data(); }
+
+  const uint64_t *Data() const { return data_.data(); }
+
+  // Coefficients of poly i
+  absl::Span<uint64_t> operator[](size_t i) {
+    return absl::MakeSpan(data_.data() + i * poly_degree_, poly_degree_);
+  }
+
+  absl::Span<const uint64_t> operator[](size_t i) const {
+    return absl::MakeConstSpan(data_.data() + i * poly_degree_, poly_degree_);
+  }
+
+  Poly GetPoly(size_t i) const {
+    auto coeffs = (*this)[i];
+    return Poly(coeffs.begin(), coeffs.end());
+  }
+
+  bool operator==(const Polys &other) const {
+    return num_polys_ == other.num_polys_ &&
+           poly_degree_ == other.poly_degree_ && data_ == other.data_;
+  }
+
+  bool operator!=(const Polys &other) const { return !(*this == other); }
+
  private:
-  std::vector<Poly> polys_;
+  size_t num_polys_ = 0;
+  size_t poly_degree_ = 0;
+  std::vector<uint64_t, internal::AlignedAllocator<uint64_t, kAlignment>>
+      data_;
 };
 
 using Moduli = std::vector<uint64_t>;